@@ -61,6 +61,7 @@ function (add_module)
 
   if (ADD_MODULE_LIBRARY_TYPE STREQUAL SHARED)
     install(TARGETS ${ADD_MODULE_TARGET} LIBRARY DESTINATION lib/syslog-ng COMPONENT ${ADD_MODULE_TARGET})
+    set_property(GLOBAL APPEND PROPERTY SYSLOG_NG_MODULES ${ADD_MODULE_TARGET})
   endif()
 
 endfunction ()
@@ -26,10 +26,13 @@
 #include "messages.h"
 #include "children.h"
 #include "dnscache.h"
+#include "host-resolve-async.h"
 #include "alarms.h"
 #include "stats/stats-registry.h"
 #include "metrics/metrics.h"
 #include "healthcheck/healthcheck-stats.h"
+#include "profiler/stack-sampler.h"
+#include "cpu-affinity.h"
 #include "logmsg/logmsg.h"
 #include "logsource.h"
 #include "logwriter.h"
@@ -222,6 +225,7 @@ app_startup(void)
   hostname_global_init();
   dns_caching_global_init();
   dns_caching_thread_init();
+  host_resolve_async_global_init();
   afinter_global_init();
   child_manager_init();
   alarm_init();
@@ -229,6 +233,8 @@ app_startup(void)
   stats_init();
   metrics_global_init();
   healthcheck_stats_global_init();
+  stack_sampler_global_init();
+  cpu_affinity_global_init();
   tzset();
   log_msg_global_init();
   log_source_global_init();
@@ -282,12 +288,15 @@ app_shutdown(void)
 
   afinter_global_deinit();
   metrics_global_deinit();
+  stack_sampler_global_deinit();
+  cpu_affinity_global_deinit();
   stats_destroy();
   child_manager_deinit();
   g_list_foreach(application_hooks, (GFunc) g_free, NULL);
   g_list_free(application_hooks);
   g_list_free_full(application_thread_init_hooks, g_free);
   g_list_free_full(application_thread_deinit_hooks, g_free);
+  host_resolve_async_global_deinit();
   dns_caching_thread_deinit();
   dns_caching_global_deinit();
   hostname_global_deinit();
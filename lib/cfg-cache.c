@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "cfg-cache.h"
+#include "resolved-configurable-paths.h"
+#include "messages.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+#define CFG_CACHE_MAGIC "# syslog-ng preprocessed configuration cache, format 1"
+
+struct _CfgCache
+{
+  gchar *filename;
+  /* "<kind>\t<escaped name>" -> stamp, stamps are compared textually on load */
+  GHashTable *dependencies;
+  /* a dependency was modified too recently for its timestamp to be trusted */
+  gboolean racy;
+};
+
+/* configuration parsing happens in the main thread, only one cache records at a time */
+static CfgCache *recording_cache;
+
+static gchar *
+_format_file_stamp(const gchar *filename, gboolean *racy)
+{
+  struct stat st;
+
+  if (stat(filename, &st) < 0)
+    return g_strdup("missing");
+
+  if (racy && st.st_mtime >= time(NULL) - 1)
+    *racy = TRUE;
+
+  return g_strdup_printf("%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT ":%" G_GUINT64_FORMAT,
+                         (gint64) st.st_mtime, (gint64) st.st_ctime,
+                         (gint64) st.st_size, (guint64) st.st_ino);
+}
+
+static gchar *
+_format_env_stamp(const gchar *value)
+{
+  if (!value)
+    return g_strdup("unset");
+
+  gchar *escaped = g_strescape(value, NULL);
+  gchar *stamp = g_strdup_printf("=%s", escaped);
+  g_free(escaped);
+  return stamp;
+}
+
+static void
+_record_dependency(CfgCache *self, const gchar *kind, const gchar *name, gchar *stamp)
+{
+  gchar *escaped_name = g_strescape(name, NULL);
+  gchar *key = g_strdup_printf("%s\t%s", kind, escaped_name);
+  g_free(escaped_name);
+
+  /* the first observation wins, that is what the preprocessor has seen */
+  if (g_hash_table_contains(self->dependencies, key))
+    {
+      g_free(key);
+      g_free(stamp);
+      return;
+    }
+  g_hash_table_insert(self->dependencies, key, stamp);
+}
+
+void
+cfg_cache_record_file(const gchar *filename)
+{
+  if (!recording_cache)
+    return;
+
+  _record_dependency(recording_cache, "file", filename, _format_file_stamp(filename, &recording_cache->racy));
+}
+
+void
+cfg_cache_record_env(const gchar *name, const gchar *value)
+{
+  if (!recording_cache)
+    return;
+
+  _record_dependency(recording_cache, "env", name, _format_env_stamp(value));
+}
+
+void
+cfg_cache_start_recording(CfgCache *self)
+{
+  g_assert(recording_cache == NULL);
+
+  g_hash_table_remove_all(self->dependencies);
+  self->racy = FALSE;
+  recording_cache = self;
+}
+
+void
+cfg_cache_stop_recording(CfgCache *self)
+{
+  g_assert(recording_cache == self);
+
+  recording_cache = NULL;
+}
+
+static const gchar *
+_get_module_path(void)
+{
+  return resolved_configurable_paths.initial_module_path ? : "";
+}
+
+static void
+_format_header(GString *header, const gchar *main_filename)
+{
+  gchar *escaped;
+
+  g_string_append(header, CFG_CACHE_MAGIC "\n");
+  g_string_append(header, "version\t" SYSLOG_NG_VERSION "\n");
+
+  escaped = g_strescape(main_filename, NULL);
+  g_string_append_printf(header, "main\t%s\n", escaped);
+  g_free(escaped);
+
+  escaped = g_strescape(_get_module_path(), NULL);
+  g_string_append_printf(header, "module-path\t%s\n", escaped);
+  g_free(escaped);
+}
+
+static gchar *
+_recompute_stamp(const gchar *kind, const gchar *escaped_name)
+{
+  gchar *name = g_strcompress(escaped_name);
+  gchar *stamp = NULL;
+
+  if (strcmp(kind, "file") == 0)
+    stamp = _format_file_stamp(name, NULL);
+  else if (strcmp(kind, "env") == 0)
+    stamp = _format_env_stamp(g_getenv(name));
+
+  g_free(name);
+  return stamp;
+}
+
+static gboolean
+_is_dependency_unchanged(CfgCache *self, const gchar *line)
+{
+  gchar **fields = g_strsplit(line, "\t", 3);
+  gboolean result = FALSE;
+
+  if (g_strv_length(fields) == 3)
+    {
+      gchar *stamp = _recompute_stamp(fields[0], fields[1]);
+
+      result = stamp && strcmp(stamp, fields[2]) == 0;
+      if (!result)
+        msg_debug("Configuration cache is stale, dependency changed",
+                  evt_tag_str("cache", self->filename),
+                  evt_tag_str("kind", fields[0]),
+                  evt_tag_str("name", fields[1]));
+      g_free(stamp);
+    }
+  g_strfreev(fields);
+  return result;
+}
+
+/*
+ * Returns the cached preprocessed configuration, if all of its recorded
+ * dependencies are unchanged, NULL otherwise.
+ */
+GString *
+cfg_cache_load(CfgCache *self, const gchar *main_filename)
+{
+  gchar *contents = NULL;
+  gsize length = 0;
+  GString *result = NULL;
+
+  if (!g_file_get_contents(self->filename, &contents, &length, NULL))
+    return NULL;
+
+  GString *expected_header = g_string_sized_new(256);
+  _format_header(expected_header, main_filename);
+
+  if (length < expected_header->len || memcmp(contents, expected_header->str, expected_header->len) != 0)
+    {
+      msg_debug("Configuration cache was created for a different configuration or syslog-ng version",
+                evt_tag_str("cache", self->filename));
+      goto exit;
+    }
+
+  gchar *line = contents + expected_header->len;
+  gchar *end = contents + length;
+  while (line < end)
+    {
+      gchar *eol = memchr(line, '\n', end - line);
+      if (!eol)
+        break;
+      *eol = 0;
+
+      if (g_str_has_prefix(line, "expanded-config\t"))
+        {
+          gchar *body = eol + 1;
+          gchar *endptr;
+          guint64 body_length = g_ascii_strtoull(line + strlen("expanded-config\t"), &endptr, 10);
+
+          if (*endptr == 0 && body_length == (guint64) (end - body))
+            result = g_string_new_len(body, body_length);
+          break;
+        }
+      if (!_is_dependency_unchanged(self, line))
+        goto exit;
+
+      line = eol + 1;
+    }
+
+  if (!result)
+    msg_warning("Configuration cache file is truncated or corrupt, ignoring",
+                evt_tag_str("cache", self->filename));
+
+exit:
+  g_string_free(expected_header, TRUE);
+  g_free(contents);
+  return result;
+}
+
+static void
+_format_dependency(gpointer key, gpointer value, gpointer user_data)
+{
+  GString *output = (GString *) user_data;
+
+  g_string_append_printf(output, "%s\t%s\n", (const gchar *) key, (const gchar *) value);
+}
+
+static gboolean
+_write_file_atomically(const gchar *filename, const GString *content)
+{
+  gchar *tmp_filename = g_strdup_printf("%s.tmp", filename);
+  gboolean success = FALSE;
+
+  /* the expanded configuration may contain credentials */
+  gint fd = open(tmp_filename, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0)
+    goto exit;
+
+  const gchar *p = content->str;
+  gsize remaining = content->len;
+  while (remaining > 0)
+    {
+      gssize written = write(fd, p, remaining);
+      if (written < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          gint saved_errno = errno;
+          close(fd);
+          unlink(tmp_filename);
+          errno = saved_errno;
+          goto exit;
+        }
+      p += written;
+      remaining -= written;
+    }
+  if (close(fd) < 0 || rename(tmp_filename, filename) < 0)
+    {
+      gint saved_errno = errno;
+      unlink(tmp_filename);
+      errno = saved_errno;
+      goto exit;
+    }
+  success = TRUE;
+
+exit:
+  g_free(tmp_filename);
+  return success;
+}
+
+gboolean
+cfg_cache_store(CfgCache *self, const gchar *main_filename, GString *preprocessed_config)
+{
+  if (self->racy)
+    {
+      msg_debug("Not updating configuration cache, a dependency has just been modified",
+                evt_tag_str("cache", self->filename));
+      return FALSE;
+    }
+
+  GString *output = g_string_sized_new(preprocessed_config->len + 4096);
+
+  _format_header(output, main_filename);
+  g_hash_table_foreach(self->dependencies, _format_dependency, output);
+  g_string_append_printf(output, "expanded-config\t%" G_GSIZE_FORMAT "\n", preprocessed_config->len);
+  g_string_append_len(output, preprocessed_config->str, preprocessed_config->len);
+
+  gboolean success = _write_file_atomically(self->filename, output);
+  if (!success)
+    msg_warning("Error writing configuration cache",
+                evt_tag_str("cache", self->filename),
+                evt_tag_error("error"));
+  else
+    msg_debug("Configuration cache updated",
+              evt_tag_str("cache", self->filename),
+              evt_tag_int("dependencies", g_hash_table_size(self->dependencies)));
+
+  g_string_free(output, TRUE);
+  return success;
+}
+
+CfgCache *
+cfg_cache_new(const gchar *filename)
+{
+  CfgCache *self = g_new0(CfgCache, 1);
+
+  self->filename = g_strdup(filename);
+  self->dependencies = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  return self;
+}
+
+void
+cfg_cache_free(CfgCache *self)
+{
+  if (recording_cache == self)
+    recording_cache = NULL;
+
+  g_hash_table_unref(self->dependencies);
+  g_free(self->filename);
+  g_free(self);
+}
+
+/* used when the cached configuration turns out to be unusable, e.g. it does not parse */
+void
+cfg_cache_invalidate(CfgCache *self)
+{
+  if (unlink(self->filename) < 0 && errno != ENOENT)
+    msg_warning("Error removing configuration cache",
+                evt_tag_str("cache", self->filename),
+                evt_tag_error("error"));
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef CFG_CACHE_H_INCLUDED
+#define CFG_CACHE_H_INCLUDED 1
+
+#include "syslog-ng.h"
+
+/*
+ * CfgCache stores the fully preprocessed form of a configuration (includes
+ * inlined, block references and generators expanded, backticks
+ * substituted) along with a manifest of everything the expansion depended
+ * on: the files and directories that were read and the environment
+ * variables that were looked up.  As long as none of those change, the
+ * cached text can be parsed directly, skipping the preprocessing phase.
+ *
+ * Block generators are assumed to be deterministic, e.g. their output
+ * only depends on their arguments.
+ */
+typedef struct _CfgCache CfgCache;
+
+CfgCache *cfg_cache_new(const gchar *filename);
+void cfg_cache_free(CfgCache *self);
+
+void cfg_cache_start_recording(CfgCache *self);
+void cfg_cache_stop_recording(CfgCache *self);
+
+/* called by the lexer while preprocessing, no-op unless a cache is recording */
+void cfg_cache_record_file(const gchar *filename);
+void cfg_cache_record_env(const gchar *name, const gchar *value);
+
+GString *cfg_cache_load(CfgCache *self, const gchar *main_filename);
+gboolean cfg_cache_store(CfgCache *self, const gchar *main_filename, GString *preprocessed_config);
+void cfg_cache_invalidate(CfgCache *self);
+
+#endif
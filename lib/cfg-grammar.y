@@ -267,6 +267,9 @@ main_location_print (FILE *yyo, YYLTYPE const * const yylocp)
 %token KW_SYSLOG_STATS                10405
 %token KW_HEALTHCHECK_FREQ            10406
 %token KW_WORKER_PARTITION_KEY        10407
+%token KW_WORKER_CPUS                 10408
+%token KW_PROFILE_SAMPLE_RATE         10409
+%token KW_STACK_SAMPLE_FREQUENCY      10410
 
 %token KW_CHAIN_HOSTNAMES             10090
 %token KW_NORMALIZE_HOSTNAMES         10091
@@ -282,6 +285,7 @@ main_location_print (FILE *yyo, YYLTYPE const * const yylocp)
 %token KW_USE_DNS                     10110
 %token KW_USE_FQDN                    10111
 %token KW_CUSTOM_DOMAIN               10112
+%token KW_ASYNC                       10113
 
 %token KW_DNS_CACHE                   10120
 %token KW_DNS_CACHE_SIZE              10121
@@ -293,17 +297,20 @@ main_location_print (FILE *yyo, YYLTYPE const * const yylocp)
 %token KW_PERSIST_ONLY                10140
 %token KW_USE_RCPTID                  10141
 %token KW_USE_UNIQID                  10142
+%token KW_UNIQID_STRICT_ORDER         10143
 
 %token KW_TZ_CONVERT                  10150
 %token KW_TS_FORMAT                   10151
 %token KW_FRAC_DIGITS                 10152
 
 %token KW_LOG_FIFO_SIZE               10160
+%token KW_LOG_FIFO_SIZE_BYTES         10161
 %token KW_LOG_FETCH_LIMIT             10162
 %token KW_LOG_IW_SIZE                 10163
 %token KW_LOG_PREFIX                  10164
 %token KW_PROGRAM_OVERRIDE            10165
 %token KW_HOST_OVERRIDE               10166
+%token KW_QUEUE_MEMORY_LIMIT          10167
 
 %token KW_THROTTLE                    10170
 %token KW_THREADED                    10171
@@ -1113,7 +1120,10 @@ options_item
 	| KW_PASS_UNIX_CREDENTIALS '(' yesno ')' { configuration->pass_unix_credentials = $3; }
 	| KW_USE_RCPTID '(' yesno ')'		{ cfg_set_use_uniqid($3); }
 	| KW_USE_UNIQID '(' yesno ')'		{ cfg_set_use_uniqid($3); }
+	| KW_UNIQID_STRICT_ORDER '(' yesno ')'	{ configuration->uniqid_strict_order = $3; }
 	| KW_LOG_FIFO_SIZE '(' positive_integer ')'	{ configuration->log_fifo_size = $3; }
+	| KW_LOG_FIFO_SIZE_BYTES '(' nonnegative_integer64 ')'	{ configuration->log_fifo_size_bytes = $3; }
+	| KW_QUEUE_MEMORY_LIMIT '(' nonnegative_integer64 ')'	{ configuration->queue_memory_limit = $3; }
 	| KW_LOG_IW_SIZE '(' positive_integer ')'	{ msg_warning("WARNING: Support for the global log-iw-size() option was removed, please use a per-source log-iw-size()", cfg_lexer_format_location_tag(lexer, &@1)); }
 	| KW_LOG_FETCH_LIMIT '(' positive_integer ')'	{ msg_warning("WARNING: Support for the global log-fetch-limit() option was removed, please use a per-source log-fetch-limit()", cfg_lexer_format_location_tag(lexer, &@1)); }
 	| KW_LOG_MSG_SIZE '(' positive_integer ')'	{ configuration->log_msg_size = $3; }
@@ -1164,6 +1174,8 @@ stats_group_option
 	| KW_MAX_DYNAMIC '(' nonnegative_integer ')'   { last_stats_options->max_dynamic = $3; }
 	| KW_SYSLOG_STATS '(' yesnoauto ')'     { last_stats_options->syslog_stats = $3; }
 	| KW_HEALTHCHECK_FREQ '(' nonnegative_integer ')' { last_healthcheck_options->freq = $3; }
+	| KW_PROFILE_SAMPLE_RATE '(' nonnegative_integer ')' { last_stats_options->profile_sample_rate = $3; }
+	| KW_STACK_SAMPLE_FREQUENCY '(' nonnegative_integer ')' { last_stats_options->stack_sample_frequency = $3; }
 	;
 
 dns_cache_option
@@ -1201,7 +1213,8 @@ yesnoauto
 
 dnsmode
 	: yesno					{ $$ = $1; }
-	| KW_PERSIST_ONLY                       { $$ = 2; }
+	| KW_PERSIST_ONLY                       { $$ = HOST_RESOLVE_DNS_PERSIST_ONLY; }
+	| KW_ASYNC                              { $$ = HOST_RESOLVE_DNS_ASYNC; }
 	;
 
 nonnegative_integer64
@@ -1400,6 +1413,7 @@ dest_driver_option
         /* NOTE: plugins need to set "last_driver" in order to incorporate this rule in their grammar */
 
 	: KW_LOG_FIFO_SIZE '(' positive_integer ')'	{ ((LogDestDriver *) last_driver)->log_fifo_size = $3; }
+	| KW_LOG_FIFO_SIZE_BYTES '(' nonnegative_integer64 ')'	{ ((LogDestDriver *) last_driver)->log_fifo_size_bytes = $3; }
 	| KW_THROTTLE '(' nonnegative_integer ')'         { ((LogDestDriver *) last_driver)->throttle = $3; }
         | inner_dest
         | driver_option
@@ -1413,6 +1427,13 @@ threaded_dest_driver_batch_option
 threaded_dest_driver_workers_option
         : KW_WORKERS '(' positive_integer ')'  { log_threaded_dest_driver_set_num_workers(last_driver, $3); }
         | KW_WORKER_PARTITION_KEY '(' template_content ')' { log_threaded_dest_driver_set_worker_partition_key_ref(last_driver, $3); }
+        | KW_WORKER_CPUS '(' string ')'
+          {
+            GError *error = NULL;
+
+            CHECK_ERROR_GERROR(log_threaded_dest_driver_set_worker_cpus(last_driver, $3, &error), @3, error, "Error parsing worker-cpus()");
+            free($3);
+          }
         ;
 
 /* implies dest_driver_option */
@@ -1450,6 +1471,13 @@ threaded_source_driver_option
 
 threaded_source_driver_workers_option
         : KW_WORKERS '(' positive_integer ')' { log_threaded_source_driver_set_num_workers(last_driver, $3); }
+        | KW_WORKER_CPUS '(' string ')'
+          {
+            GError *error = NULL;
+
+            CHECK_ERROR_GERROR(log_threaded_source_driver_set_worker_cpus(last_driver, $3, &error), @3, error, "Error parsing worker-cpus()");
+            free($3);
+          }
         ;
 
 threaded_fetcher_driver_option
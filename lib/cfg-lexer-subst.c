@@ -25,6 +25,7 @@
 #include "cfg-lexer-subst.h"
 #include "cfg-args.h"
 #include "cfg-grammar.h"
+#include "cfg-cache.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -59,10 +60,11 @@ _lookup_value(CfgLexerSubst *self, const gchar *name)
     ;
   else if (self->globals && (arg = cfg_args_get(self->globals, name)))
     ;
-  else if ((arg = g_getenv(name)))
-    ;
   else
-    arg = NULL;
+    {
+      arg = g_getenv(name);
+      cfg_cache_record_env(name, arg);
+    }
 
   return arg;
 }
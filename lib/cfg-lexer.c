@@ -24,6 +24,7 @@
 
 #include "cfg-lexer.h"
 #include "cfg-lexer-subst.h"
+#include "cfg-cache.h"
 #include "cfg-block-generator.h"
 #include "cfg-grammar.h"
 #include "cfg.h"
@@ -344,6 +345,7 @@ cfg_lexer_include_level_file_open_buffer(CfgLexer *self, CfgIncludeLevel *level)
   filename = (gchar *) level->file.files->data;
   level->file.files = g_slist_delete_link(level->file.files, level->file.files);
 
+  cfg_cache_record_file(filename);
   include_file = fopen(filename, "r");
   if (!include_file)
     {
@@ -607,6 +609,8 @@ cfg_lexer_include_file_simple(CfgLexer *self, const gchar *filename)
 
   if (S_ISDIR(st.st_mode))
     {
+      /* files added to or removed from the directory change its mtime */
+      cfg_cache_record_file(filename);
       if (!cfg_lexer_include_directory(self, level, filename))
         {
           cfg_lexer_drop_include_level(self, level);
@@ -685,6 +689,10 @@ cfg_lexer_include_file_glob_at(CfgLexer *self, CfgIncludeLevel *level, const gch
   size_t i;
   int r;
 
+  gchar *dirname = g_path_get_dirname(pattern);
+  cfg_cache_record_file(dirname);
+  g_free(dirname);
+
   r = glob(pattern, GLOB_NOMAGIC, _cfg_lexer_glob_err, &globbuf);
 
   if (r != 0 || globbuf.gl_pathc == 0)
@@ -773,6 +781,29 @@ cfg_lexer_include_file_glob(CfgLexer *self, const gchar *filename_)
   return TRUE;
 }
 
+/* a file showing up earlier in the include path would change the result of
+ * the lookup, record the directories it could appear in */
+static void
+cfg_lexer_record_include_path_candidates(CfgLexer *self, const gchar *filename_)
+{
+  const gchar *path = _get_include_path(self);
+
+  if (filename_[0] == '/' || !path)
+    return;
+
+  gchar **dirs = g_strsplit(path, G_SEARCHPATH_SEPARATOR_S, 0);
+  for (gint i = 0; dirs[i]; i++)
+    {
+      gchar *candidate = g_build_filename(dirs[i], filename_, NULL);
+      gchar *dirname = g_path_get_dirname(candidate);
+
+      cfg_cache_record_file(dirname);
+      g_free(dirname);
+      g_free(candidate);
+    }
+  g_strfreev(dirs);
+}
+
 gboolean
 cfg_lexer_include_file(CfgLexer *self, const gchar *filename_)
 {
@@ -783,6 +814,7 @@ cfg_lexer_include_file(CfgLexer *self, const gchar *filename_)
             evt_tag_str("filename", filename_),
             evt_tag_str("include-path", _get_include_path(self)));
 
+  cfg_lexer_record_include_path_candidates(self, filename_);
 
   filename = find_file_in_path(_get_include_path(self), filename_, G_FILE_TEST_EXISTS);
   if (!filename || stat(filename, &st) < 0)
@@ -1145,6 +1177,7 @@ cfg_lexer_preprocess(CfgLexer *self, gint tok, CFG_STYPE *yylval, CFG_LTYPE *yyl
 
   if (tok == LL_IDENTIFIER &&
       self->cfg &&
+      !self->preprocessed_input &&
       (p = cfg_lexer_find_generator_plugin(self, self->cfg, cfg_lexer_get_context_type(self), yylval->cptr)))
     {
       if (!cfg_lexer_parse_and_run_block_generator(self, p, yylval))
@@ -1319,6 +1352,27 @@ cfg_lexer_new_buffer(GlobalConfig *cfg, const gchar *buffer, gsize length)
   return self;
 }
 
+/* Parses the output of an earlier preprocessing run (see CfgCache), its
+ * pragmas are processed, except for those that have already been resolved
+ * into the text (@include and @requires) */
+CfgLexer *
+cfg_lexer_new_preprocessed(GlobalConfig *cfg, const gchar *filename, const gchar *buffer, gsize length)
+{
+  CfgLexer *self;
+  CfgIncludeLevel *level;
+
+  self = g_new0(CfgLexer, 1);
+  cfg_lexer_init(self, cfg);
+  self->preprocessed_input = TRUE;
+
+  level = &self->include_stack[0];
+  cfg_lexer_init_include_level_buffer(self, level, filename, buffer, length);
+  cfg_lexer_include_level_open_buffer(self, level);
+  cfg_lexer_include_level_resume_from_buffer(self, level);
+
+  return self;
+}
+
 void
 cfg_lexer_free(CfgLexer *self)
 {
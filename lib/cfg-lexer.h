@@ -194,7 +194,9 @@ struct _CfgLexer
   GString *token_pretext;
   GString *token_text;
   GlobalConfig *cfg;
-  guint first_non_pragma_seen:1, ignore_pragma:1;
+  /* the input is the output of an earlier preprocessing run: includes are
+   * already inlined and block references already expanded */
+  guint first_non_pragma_seen:1, ignore_pragma:1, preprocessed_input:1;
 };
 
 /* pattern buffer */
@@ -238,6 +240,7 @@ void cfg_lexer_free_token(CFG_STYPE *token);
 
 CfgLexer *cfg_lexer_new(GlobalConfig *cfg, FILE *file, const gchar *filename, GString *preprocess_output);
 CfgLexer *cfg_lexer_new_buffer(GlobalConfig *cfg, const gchar *buffer, gsize length);
+CfgLexer *cfg_lexer_new_preprocessed(GlobalConfig *cfg, const gchar *filename, const gchar *buffer, gsize length);
 void  cfg_lexer_free(CfgLexer *self);
 
 gint cfg_lexer_lookup_context_type_by_name(const gchar *name);
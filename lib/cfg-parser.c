@@ -105,6 +105,8 @@ static CfgLexerKeyword main_keywords[] =
   { "max_dynamics",       KW_MAX_DYNAMIC },
   { "syslog_stats",       KW_SYSLOG_STATS },
   { "healthcheck_freq",   KW_HEALTHCHECK_FREQ},
+  { "profile_sample_rate", KW_PROFILE_SAMPLE_RATE },
+  { "stack_sample_frequency", KW_STACK_SAMPLE_FREQUENCY },
   { "min_iw_size_per_reader", KW_MIN_IW_SIZE_PER_READER },
   { "flush_lines",        KW_FLUSH_LINES },
   { "flush_timeout",      KW_FLUSH_TIMEOUT, KWS_OBSOLETE, "Some drivers support batch-timeout() instead that you can specify at the destination level." },
@@ -144,9 +146,12 @@ static CfgLexerKeyword main_keywords[] =
   { "threaded",           KW_THREADED },
   { "use_rcptid",         KW_USE_RCPTID, KWS_OBSOLETE, "This has been deprecated, try use_uniqid() instead" },
   { "use_uniqid",         KW_USE_UNIQID },
+  { "uniqid_strict_order", KW_UNIQID_STRICT_ORDER },
   { "log_level",          KW_LOG_LEVEL },
 
   { "log_fifo_size",      KW_LOG_FIFO_SIZE },
+  { "log_fifo_size_bytes", KW_LOG_FIFO_SIZE_BYTES },
+  { "queue_memory_limit", KW_QUEUE_MEMORY_LIMIT },
   { "log_fetch_limit",    KW_LOG_FETCH_LIMIT },
   { "log_iw_size",        KW_LOG_IW_SIZE },
   { "log_msg_size",       KW_LOG_MSG_SIZE },
@@ -171,6 +176,7 @@ static CfgLexerKeyword main_keywords[] =
   { "template_function",  KW_TEMPLATE_FUNCTION },
   { "on_error",           KW_ON_ERROR },
   { "persist_only",       KW_PERSIST_ONLY },
+  { "async",              KW_ASYNC },
   { "dns_cache_hosts",    KW_DNS_CACHE_HOSTS },
   { "dns_cache",          KW_DNS_CACHE },
   { "dns_cache_size",     KW_DNS_CACHE_SIZE },
@@ -187,6 +193,7 @@ static CfgLexerKeyword main_keywords[] =
   { "retries",            KW_RETRIES },
   { "workers",            KW_WORKERS },
   { "worker_partition_key", KW_WORKER_PARTITION_KEY },
+  { "worker_cpus",        KW_WORKER_CPUS },
   { "batch_lines",        KW_BATCH_LINES },
   { "batch_timeout",      KW_BATCH_TIMEOUT },
 
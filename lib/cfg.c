@@ -32,6 +32,8 @@
 #include "userdb.h"
 #include "logmsg/logmsg.h"
 #include "dnscache.h"
+#include "host-resolve-async.h"
+#include "logqueue.h"
 #include "serialize.h"
 #include "plugin.h"
 #include "cfg-parser.h"
@@ -44,6 +46,7 @@
 #include "mainloop.h"
 #include "timeutils/format.h"
 #include "apphook.h"
+#include "profiler/stack-sampler.h"
 
 #include <sys/types.h>
 #include <signal.h>
@@ -288,12 +291,15 @@ cfg_init(GlobalConfig *cfg)
         }
     }
 
-  if (!rcptid_init(cfg->state, cfg->use_uniqid))
+  if (!rcptid_init(cfg->state, cfg->use_uniqid, cfg->uniqid_strict_order))
     return FALSE;
 
   stats_reinit(&cfg->stats_options);
+  stack_sampler_set_frequency(cfg->stats_options.stack_sample_frequency);
 
   dns_caching_update_options(&cfg->dns_cache_options);
+  host_resolve_async_set_expiry(cfg->dns_cache_options.expire, cfg->dns_cache_options.expire_failed);
+  log_queue_set_global_memory_limit(cfg->queue_memory_limit);
   hostname_reinit(cfg->custom_domain);
   host_resolve_options_init_globals(&cfg->host_resolve_options);
   log_template_options_init(&cfg->template_options, cfg);
@@ -427,11 +433,9 @@ cfg_register_builtin_plugins(GlobalConfig *self)
   log_proto_register_builtin_plugins(&self->plugin_context);
 }
 
-GlobalConfig *
-cfg_new(gint version)
+static void
+_cfg_init_instance(GlobalConfig *self, gint version)
 {
-  GlobalConfig *self = g_new0(GlobalConfig, 1);
-
   self->module_config = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) module_config_free);
   self->globals = cfg_args_new();
   self->user_version = version;
@@ -477,6 +481,14 @@ cfg_new(gint version)
   self->use_plugin_discovery = TRUE;
 
   cfg_register_builtin_plugins(self);
+}
+
+GlobalConfig *
+cfg_new(gint version)
+{
+  GlobalConfig *self = g_new0(GlobalConfig, 1);
+
+  _cfg_init_instance(self, version);
   return self;
 }
 
@@ -489,6 +501,76 @@ cfg_new_snippet(void)
   return self;
 }
 
+static void
+_cfg_file_path_free(gpointer data)
+{
+  CfgFilePath *self = (CfgFilePath *)data;
+
+  g_free(self->file_path);
+  g_free(self->path_type);
+  g_free(self);
+}
+
+static void
+_cfg_free_instance(GlobalConfig *self)
+{
+  g_free(self->file_template_name);
+  g_free(self->proto_template_name);
+  log_template_unref(self->file_template);
+  log_template_unref(self->proto_template);
+  log_template_options_destroy(&self->template_options);
+  host_resolve_options_destroy(&self->host_resolve_options);
+
+  if (self->bad_hostname_compiled)
+    regfree(&self->bad_hostname);
+  g_free(self->recv_time_zone);
+  g_free(self->bad_hostname_re);
+  dns_cache_options_destroy(&self->dns_cache_options);
+  g_free(self->custom_domain);
+  plugin_context_deinit_instance(&self->plugin_context);
+  cfg_tree_free_instance(&self->tree);
+  g_hash_table_unref(self->module_config);
+  cfg_args_unref(self->globals);
+
+  if (self->state)
+    persist_state_free(self->state);
+
+  if (self->preprocess_config)
+    g_string_free(self->preprocess_config, TRUE);
+  if (self->original_config)
+    g_string_free(self->original_config, TRUE);
+
+  g_list_free_full(self->file_list, _cfg_file_path_free);
+
+  g_free(self->user_config_id);
+  g_free(self->config_hash);
+}
+
+void
+cfg_free(GlobalConfig *self)
+{
+  g_assert(self->persist == NULL);
+
+  _cfg_free_instance(self);
+  g_free(self);
+}
+
+/*
+ * Drops everything a failed parse has left behind in @self, as if it was
+ * just created by cfg_new(), keeping what the caller has set up before
+ * reading the configuration.
+ */
+static void
+_cfg_reset(GlobalConfig *self, gint version, gboolean use_plugin_discovery)
+{
+  g_assert(self->persist == NULL);
+
+  _cfg_free_instance(self);
+  memset(self, 0, sizeof(*self));
+  _cfg_init_instance(self, version);
+  self->use_plugin_discovery = use_plugin_discovery;
+}
+
 /* This function creates a GlobalConfig instance that shares the set of
  * available plugins as a master one.  */
 GlobalConfig *
@@ -593,16 +675,6 @@ _load_file_into_string(const gchar *fname)
   return content;
 }
 
-static void
-_cfg_file_path_free(gpointer data)
-{
-  CfgFilePath *self = (CfgFilePath *)data;
-
-  g_free(self->file_path);
-  g_free(self->path_type);
-  g_free(self);
-}
-
 static inline const gchar *
 _format_config_hash(GlobalConfig *self, gchar *str, size_t str_size)
 {
@@ -638,8 +710,52 @@ cfg_hash_config(GlobalConfig *self)
   SHA256((const guchar *) self->preprocess_config->str, self->preprocess_config->len, self->config_hash);
 }
 
+/*
+ * Returns FALSE if the cached configuration cannot be used, in which case
+ * @self is left as it was, ready for reading the configuration file.
+ */
+static gboolean
+cfg_read_cached_config(GlobalConfig *self, const gchar *fname, CfgCache *cache)
+{
+  GString *cached_config = cfg_cache_load(cache, fname);
+
+  if (!cached_config)
+    return FALSE;
+
+  msg_debug("Using cached preprocessed configuration",
+            evt_tag_str(EVT_TAG_FILENAME, fname));
+
+  gint version = self->user_version;
+  gboolean use_plugin_discovery = self->use_plugin_discovery;
+
+  self->preprocess_config = cached_config;
+  self->original_config = _load_file_into_string(fname);
+
+  CfgLexer *lexer = cfg_lexer_new_preprocessed(self, fname, cached_config->str, cached_config->len);
+  if (!cfg_run_parser(self, lexer, &main_parser, (gpointer *) &self, NULL))
+    {
+      msg_warning("Error parsing cached preprocessed configuration, discarding the cache and reading "
+                  "the configuration file instead",
+                  evt_tag_str(EVT_TAG_FILENAME, fname));
+
+      cfg_cache_invalidate(cache);
+      _cfg_reset(self, version, use_plugin_discovery);
+      cfg_discover_candidate_modules(self);
+      self->filename = fname;
+      return FALSE;
+    }
+
+  cfg_hash_config(self);
+  return TRUE;
+}
+
+/*
+ * If @cache is specified, the preprocessed form of the configuration is
+ * taken from there as long as none of the files it was expanded from have
+ * changed, and the cache is updated otherwise.
+ */
 gboolean
-cfg_read_config(GlobalConfig *self, const gchar *fname, gchar *preprocess_into)
+cfg_read_config_with_cache(GlobalConfig *self, const gchar *fname, CfgCache *cache, gchar *preprocess_into)
 {
   FILE *cfg_file;
   gint res;
@@ -648,16 +764,29 @@ cfg_read_config(GlobalConfig *self, const gchar *fname, gchar *preprocess_into)
 
   self->filename = fname;
 
+  if (cache && !preprocess_into && cfg_read_cached_config(self, fname, cache))
+    return TRUE;
+
   if ((cfg_file = fopen(fname, "r")) != NULL)
     {
       CfgLexer *lexer;
       self->preprocess_config = g_string_sized_new(8192);
       self->original_config = _load_file_into_string(fname);
 
+      if (cache)
+        cfg_cache_start_recording(cache);
+
       lexer = cfg_lexer_new(self, cfg_file, fname, self->preprocess_config);
       res = cfg_run_parser(self, lexer, &main_parser, (gpointer *) &self, NULL);
       fclose(cfg_file);
 
+      if (cache)
+        {
+          cfg_cache_stop_recording(cache);
+          if (res)
+            cfg_cache_store(cache, fname, self->preprocess_config);
+        }
+
       cfg_hash_config(self);
 
       if (preprocess_into)
@@ -681,43 +810,10 @@ cfg_read_config(GlobalConfig *self, const gchar *fname, gchar *preprocess_into)
   return FALSE;
 }
 
-void
-cfg_free(GlobalConfig *self)
+gboolean
+cfg_read_config(GlobalConfig *self, const gchar *fname, gchar *preprocess_into)
 {
-  g_assert(self->persist == NULL);
-
-  g_free(self->file_template_name);
-  g_free(self->proto_template_name);
-  log_template_unref(self->file_template);
-  log_template_unref(self->proto_template);
-  log_template_options_destroy(&self->template_options);
-  host_resolve_options_destroy(&self->host_resolve_options);
-
-  if (self->bad_hostname_compiled)
-    regfree(&self->bad_hostname);
-  g_free(self->recv_time_zone);
-  g_free(self->bad_hostname_re);
-  dns_cache_options_destroy(&self->dns_cache_options);
-  g_free(self->custom_domain);
-  plugin_context_deinit_instance(&self->plugin_context);
-  cfg_tree_free_instance(&self->tree);
-  g_hash_table_unref(self->module_config);
-  cfg_args_unref(self->globals);
-
-  if (self->state)
-    persist_state_free(self->state);
-
-  if (self->preprocess_config)
-    g_string_free(self->preprocess_config, TRUE);
-  if (self->original_config)
-    g_string_free(self->original_config, TRUE);
-
-  g_list_free_full(self->file_list, _cfg_file_path_free);
-
-  g_free(self->user_config_id);
-  g_free(self->config_hash);
-
-  g_free(self);
+  return cfg_read_config_with_cache(self, fname, NULL, preprocess_into);
 }
 
 void
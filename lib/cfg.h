@@ -28,6 +28,7 @@
 #include "syslog-ng.h"
 #include "cfg-tree.h"
 #include "cfg-lexer.h"
+#include "cfg-cache.h"
 #include "cfg-parser.h"
 #include "cfg-persist.h"
 #include "plugin.h"
@@ -94,6 +95,8 @@ struct _GlobalConfig
   gint type_cast_strictness;
 
   gint log_fifo_size;
+  gint64 log_fifo_size_bytes;
+  gint64 queue_memory_limit;
   gint log_msg_size;
   gboolean trim_large_messages;
   gint log_level;
@@ -101,6 +104,7 @@ struct _GlobalConfig
   gboolean create_dirs;
   FilePermOptions file_perm_options;
   gboolean use_uniqid;
+  gboolean uniqid_strict_order;
 
   gboolean keep_timestamp;
 
@@ -162,6 +166,7 @@ gboolean cfg_run_parser(GlobalConfig *self, CfgLexer *lexer, CfgParser *parser,
 gboolean cfg_run_parser_with_main_context(GlobalConfig *self, CfgLexer *lexer, CfgParser *parser, gpointer *result,
                                           gpointer arg, const gchar *desc);
 gboolean cfg_read_config(GlobalConfig *cfg, const gchar *fname, gchar *preprocess_into);
+gboolean cfg_read_config_with_cache(GlobalConfig *cfg, const gchar *fname, CfgCache *cache, gchar *preprocess_into);
 void cfg_shutdown(GlobalConfig *self);
 gboolean cfg_is_shutting_down(GlobalConfig *cfg);
 void cfg_free(GlobalConfig *self);
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "cpu-affinity.h"
+#include "messages.h"
+#include "stats/stats-registry.h"
+#include "stats/stats-cluster-single.h"
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/* the mask passed to sched_setaffinity() cannot hold larger CPU numbers */
+#ifdef __linux__
+#define CPU_AFFINITY_MAX_CPU (CPU_SETSIZE - 1)
+#else
+#define CPU_AFFINITY_MAX_CPU 4095
+#endif
+
+struct _CpuAffinity
+{
+  gchar *cpu_list;
+  GArray *cpus;
+};
+
+static struct
+{
+  StatsCounterItem *bound_threads;
+  StatsCounterItem *errors;
+} cpu_affinity_stats;
+
+static gboolean
+_parse_cpu_number(const gchar *s, gint *cpu)
+{
+  gchar *end;
+  gint64 value;
+
+  if (!g_ascii_isdigit(*s))
+    return FALSE;
+
+  value = g_ascii_strtoll(s, &end, 10);
+  if (*end != 0 || value > CPU_AFFINITY_MAX_CPU)
+    return FALSE;
+
+  *cpu = (gint) value;
+  return TRUE;
+}
+
+static gboolean
+_parse_cpu_range(CpuAffinity *self, const gchar *range)
+{
+  gchar **bounds = g_strsplit(range, "-", 2);
+  gint first, last;
+  gboolean result = FALSE;
+
+  if (!_parse_cpu_number(g_strstrip(bounds[0]), &first))
+    goto exit;
+
+  last = first;
+  if (bounds[1] && !_parse_cpu_number(g_strstrip(bounds[1]), &last))
+    goto exit;
+
+  if (last < first)
+    goto exit;
+
+  for (gint cpu = first; cpu <= last; cpu++)
+    g_array_append_val(self->cpus, cpu);
+  result = TRUE;
+
+exit:
+  g_strfreev(bounds);
+  return result;
+}
+
+CpuAffinity *
+cpu_affinity_new(const gchar *cpu_list, GError **error)
+{
+  CpuAffinity *self = g_new0(CpuAffinity, 1);
+  gchar **ranges = g_strsplit(cpu_list, ",", -1);
+
+  self->cpu_list = g_strdup(cpu_list);
+  self->cpus = g_array_new(FALSE, FALSE, sizeof(gint));
+
+  for (gint i = 0; ranges[i]; i++)
+    {
+      if (!_parse_cpu_range(self, ranges[i]))
+        {
+          g_set_error(error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+                      "Invalid CPU list %s, expected a comma separated list of CPU numbers or ranges, like 0-3,8, "
+                      "with CPU numbers up to %d", cpu_list, CPU_AFFINITY_MAX_CPU);
+          g_strfreev(ranges);
+          cpu_affinity_free(self);
+          return NULL;
+        }
+    }
+  g_strfreev(ranges);
+
+  if (self->cpus->len == 0)
+    {
+      g_set_error(error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE, "Empty CPU list");
+      cpu_affinity_free(self);
+      return NULL;
+    }
+
+  return self;
+}
+
+void
+cpu_affinity_free(CpuAffinity *self)
+{
+  g_array_free(self->cpus, TRUE);
+  g_free(self->cpu_list);
+  g_free(self);
+}
+
+const gchar *
+cpu_affinity_get_cpu_list(const CpuAffinity *self)
+{
+  return self->cpu_list;
+}
+
+gint
+cpu_affinity_get_cpu_count(const CpuAffinity *self)
+{
+  return self->cpus->len;
+}
+
+gint
+cpu_affinity_get_cpu(const CpuAffinity *self, gint index)
+{
+  return g_array_index(self->cpus, gint, index);
+}
+
+/* The thread is allowed to run on any CPU of the set, we leave balancing
+ * within the set to the scheduler.  As Linux allocates pages on the NUMA
+ * node of the thread first touching them, this also keeps the buffers
+ * allocated by the thread local if the set is confined to a single node.
+ */
+gboolean
+cpu_affinity_apply_to_current_thread(const CpuAffinity *self)
+{
+#ifdef __linux__
+  cpu_set_t mask;
+
+  CPU_ZERO(&mask);
+  for (gint i = 0; i < self->cpus->len; i++)
+    CPU_SET(cpu_affinity_get_cpu(self, i), &mask);
+
+  if (sched_setaffinity(0, sizeof(mask), &mask) < 0)
+    {
+      stats_counter_inc(cpu_affinity_stats.errors);
+      msg_warning("Error setting CPU affinity of worker thread",
+                  evt_tag_str("cpus", self->cpu_list),
+                  evt_tag_error("error"));
+      return FALSE;
+    }
+
+  stats_counter_inc(cpu_affinity_stats.bound_threads);
+  msg_debug("CPU affinity of worker thread set",
+            evt_tag_str("cpus", self->cpu_list),
+            evt_tag_int("current_cpu", sched_getcpu()));
+  return TRUE;
+#else
+  stats_counter_inc(cpu_affinity_stats.errors);
+  msg_warning_once("WARNING: CPU affinity is not supported on this platform, ignoring CPU list",
+                   evt_tag_str("cpus", self->cpu_list));
+  return FALSE;
+#endif
+}
+
+void
+cpu_affinity_global_init(void)
+{
+  StatsClusterKey sc_key;
+
+  stats_lock();
+  stats_cluster_single_key_set(&sc_key, "cpu_affinity_bound_threads_total", NULL, 0);
+  stats_register_counter(0, &sc_key, SC_TYPE_SINGLE_VALUE, &cpu_affinity_stats.bound_threads);
+  stats_cluster_single_key_set(&sc_key, "cpu_affinity_errors_total", NULL, 0);
+  stats_register_counter(0, &sc_key, SC_TYPE_SINGLE_VALUE, &cpu_affinity_stats.errors);
+  stats_unlock();
+}
+
+void
+cpu_affinity_global_deinit(void)
+{
+  StatsClusterKey sc_key;
+
+  stats_lock();
+  stats_cluster_single_key_set(&sc_key, "cpu_affinity_bound_threads_total", NULL, 0);
+  stats_unregister_counter(&sc_key, SC_TYPE_SINGLE_VALUE, &cpu_affinity_stats.bound_threads);
+  stats_cluster_single_key_set(&sc_key, "cpu_affinity_errors_total", NULL, 0);
+  stats_unregister_counter(&sc_key, SC_TYPE_SINGLE_VALUE, &cpu_affinity_stats.errors);
+  stats_unlock();
+}
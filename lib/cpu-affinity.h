@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef CPU_AFFINITY_H_INCLUDED
+#define CPU_AFFINITY_H_INCLUDED 1
+
+#include "syslog-ng.h"
+
+/* a set of CPUs that a worker thread is allowed to run on, parsed from
+ * the usual "0-3,8,10-11" cpulist notation
+ *
+ * The number of threads bound to their set and the number of failed
+ * attempts are exposed as cpu_affinity_bound_threads_total and
+ * cpu_affinity_errors_total.
+ *
+ * Out of scope: explicit NUMA placement (libnuma), pairing destination
+ * workers with the node of their sources and per-CPU counters.  Memory
+ * locality comes from first-touch page placement of the bound thread, and
+ * the set is only applied as a whole, the scheduler balances within it.
+ */
+typedef struct _CpuAffinity CpuAffinity;
+
+CpuAffinity *cpu_affinity_new(const gchar *cpu_list, GError **error);
+void cpu_affinity_free(CpuAffinity *self);
+
+const gchar *cpu_affinity_get_cpu_list(const CpuAffinity *self);
+gint cpu_affinity_get_cpu_count(const CpuAffinity *self);
+gint cpu_affinity_get_cpu(const CpuAffinity *self, gint index);
+
+gboolean cpu_affinity_apply_to_current_thread(const CpuAffinity *self);
+
+void cpu_affinity_global_init(void);
+void cpu_affinity_global_deinit(void);
+
+#endif
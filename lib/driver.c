@@ -269,8 +269,11 @@ _create_memory_queue(LogDestDriver *self, const gchar *persist_name, gint stats_
   GlobalConfig *cfg = log_pipe_get_config(&self->super.super);
 
   gint log_fifo_size = self->log_fifo_size < 0 ? cfg->log_fifo_size : self->log_fifo_size;
+  gint64 log_fifo_size_bytes = self->log_fifo_size_bytes < 0 ? cfg->log_fifo_size_bytes : self->log_fifo_size_bytes;
 
-  return log_queue_fifo_new(log_fifo_size, persist_name, stats_level, driver_sck_builder, queue_sck_builder);
+  LogQueue *queue = log_queue_fifo_new(log_fifo_size, persist_name, stats_level, driver_sck_builder, queue_sck_builder);
+  log_queue_fifo_set_memory_limit(queue, log_fifo_size_bytes);
+  return queue;
 }
 
 /* returns a reference */
@@ -426,6 +429,7 @@ log_dest_driver_init_instance(LogDestDriver *self, GlobalConfig *cfg)
   self->acquire_queue = log_dest_driver_acquire_memory_queue;
   self->release_queue = log_dest_driver_release_queue_method;
   self->log_fifo_size = -1;
+  self->log_fifo_size_bytes = -1;
   self->throttle = 0;
 }
 
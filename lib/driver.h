@@ -172,6 +172,7 @@ struct _LogDestDriver
   GList *queues;
 
   gint log_fifo_size;
+  gint64 log_fifo_size_bytes;
   gint throttle;
   StatsCounterItem *queued_global_messages;
 };
@@ -23,19 +23,15 @@
  */
 
 #include "filter-in-list.h"
+#include "lookup-table.h"
 #include "logmsg/logmsg.h"
 #include "str-utils.h"
 
-#include <errno.h>
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-
 typedef struct _FilterInList
 {
   FilterExprNode super;
   NVHandle value_handle;
-  GTree *tree;
+  LookupTableHandle *table;
 } FilterInList;
 
 static gboolean
@@ -49,7 +45,7 @@ filter_in_list_eval(FilterExprNode *s, LogMessage **msgs, gint num_msg, LogTempl
   value = log_msg_get_value(msg, self->value_handle, &len);
   APPEND_ZERO(value, value, len);
 
-  gboolean result = (g_tree_lookup(self->tree, value) != NULL);
+  gboolean result = lookup_table_handle_contains(self->table, value, len);
   msg_trace("in-list() evaluation started",
             evt_tag_str("value", value),
             evt_tag_msg_reference(msg));
@@ -62,37 +58,30 @@ filter_in_list_free(FilterExprNode *s)
 {
   FilterInList *self = (FilterInList *)s;
 
-  g_tree_destroy(self->tree);
+  lookup_table_handle_unref(self->table);
 }
 
 FilterExprNode *
 filter_in_list_new(const gchar *list_file, const gchar *property)
 {
   FilterInList *self;
-  FILE *stream;
-  gchar line[16384];
+  GError *error = NULL;
+  LookupTableHandle *table;
 
-  stream = fopen(list_file, "r");
-  if (!stream)
+  table = lookup_table_handle_get(list_file, LOOKUP_TABLE_FORMAT_LIST, &error);
+  if (!table)
     {
       msg_error("Error opening in-list filter list file",
                 evt_tag_str("file", list_file),
-                evt_tag_error("errno"));
+                evt_tag_str("error", error->message));
+      g_clear_error(&error);
       return NULL;
     }
 
   self = g_new0(FilterInList, 1);
   filter_expr_node_init_instance(&self->super);
   self->value_handle = log_msg_get_value_handle(property);
-  self->tree = g_tree_new_full((GCompareDataFunc)strcmp, NULL, g_free, NULL);
-
-  while (fgets(line, sizeof(line), stream) != NULL)
-    {
-      line[strlen(line) - 1] = '\0';
-      if (line[0])
-        g_tree_insert(self->tree, g_strdup(line), GINT_TO_POINTER(1));
-    }
-  fclose(stream);
+  self->table = table;
 
   self->super.eval = filter_in_list_eval;
   self->super.free_fn = filter_in_list_free;
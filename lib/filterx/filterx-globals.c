@@ -48,6 +48,7 @@
 #include "filterx/expr-unset.h"
 #include "filterx/filterx-eval.h"
 #include "filterx/func-keys.h"
+#include "filterx/func-lookup-table.h"
 
 static GHashTable *filterx_builtin_simple_functions = NULL;
 static GHashTable *filterx_builtin_function_ctors = NULL;
@@ -152,6 +153,8 @@ _ctors_init(void)
   g_assert(filterx_builtin_function_ctor_register("includes", filterx_function_includes_new));
   g_assert(filterx_builtin_function_ctor_register("strftime", filterx_function_strftime_new));
   g_assert(filterx_builtin_function_ctor_register("keys", filterx_function_keys_new));
+  g_assert(filterx_builtin_function_ctor_register("in_list", filterx_function_in_list_new));
+  g_assert(filterx_builtin_function_ctor_register("lookup_table", filterx_function_lookup_table_new));
 }
 
 static void
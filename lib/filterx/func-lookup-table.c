@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "filterx/func-lookup-table.h"
+#include "filterx/object-extractor.h"
+#include "filterx/object-primitive.h"
+#include "filterx/object-string.h"
+#include "filterx/object-null.h"
+#include "filterx/filterx-eval.h"
+#include "lookup-table.h"
+#include "scratch-buffers.h"
+
+typedef struct FilterXFunctionLookupTable_
+{
+  FilterXFunction super;
+  FilterXExpr *key_expr;
+  LookupTableHandle *table;
+  const gchar *usage;
+} FilterXFunctionLookupTable;
+
+static gboolean
+_eval_key(FilterXFunctionLookupTable *self, FilterXObject **key_object, const gchar **key, gsize *key_len)
+{
+  *key_object = filterx_expr_eval(self->key_expr);
+  if (!*key_object)
+    return FALSE;
+
+  if (!filterx_object_extract_string_ref(*key_object, key, key_len))
+    {
+      filterx_eval_push_error_info("First argument must be a string", &self->super.super,
+                                   (gchar *) self->usage, FALSE);
+      filterx_object_unref(*key_object);
+      return FALSE;
+    }
+  return TRUE;
+}
+
+static FilterXObject *
+_in_list_eval(FilterXExpr *s)
+{
+  FilterXFunctionLookupTable *self = (FilterXFunctionLookupTable *) s;
+  FilterXObject *key_object;
+  const gchar *key;
+  gsize key_len;
+
+  if (!_eval_key(self, &key_object, &key, &key_len))
+    return NULL;
+
+  gboolean found = lookup_table_handle_contains(self->table, key, key_len);
+  filterx_object_unref(key_object);
+  return filterx_boolean_new(found);
+}
+
+static FilterXObject *
+_lookup_table_eval(FilterXExpr *s)
+{
+  FilterXFunctionLookupTable *self = (FilterXFunctionLookupTable *) s;
+  FilterXObject *key_object;
+  const gchar *key;
+  gsize key_len;
+
+  if (!_eval_key(self, &key_object, &key, &key_len))
+    return NULL;
+
+  ScratchBuffersMarker marker;
+  GString *value = scratch_buffers_alloc_and_mark(&marker);
+
+  FilterXObject *result;
+  if (lookup_table_handle_lookup(self->table, key, key_len, value))
+    result = filterx_string_new(value->str, value->len);
+  else
+    result = filterx_null_new();
+
+  scratch_buffers_reclaim_marked(marker);
+  filterx_object_unref(key_object);
+  return result;
+}
+
+static FilterXExpr *
+_optimize(FilterXExpr *s)
+{
+  FilterXFunctionLookupTable *self = (FilterXFunctionLookupTable *) s;
+
+  self->key_expr = filterx_expr_optimize(self->key_expr);
+  return filterx_function_optimize_method(&self->super);
+}
+
+static gboolean
+_init(FilterXExpr *s, GlobalConfig *cfg)
+{
+  FilterXFunctionLookupTable *self = (FilterXFunctionLookupTable *) s;
+
+  if (!filterx_expr_init(self->key_expr, cfg))
+    return FALSE;
+
+  return filterx_function_init_method(&self->super, cfg);
+}
+
+static void
+_deinit(FilterXExpr *s, GlobalConfig *cfg)
+{
+  FilterXFunctionLookupTable *self = (FilterXFunctionLookupTable *) s;
+
+  filterx_expr_deinit(self->key_expr, cfg);
+  filterx_function_deinit_method(&self->super, cfg);
+}
+
+static void
+_free(FilterXExpr *s)
+{
+  FilterXFunctionLookupTable *self = (FilterXFunctionLookupTable *) s;
+
+  filterx_expr_unref(self->key_expr);
+  lookup_table_handle_unref(self->table);
+  filterx_function_free_method(&self->super);
+}
+
+static gboolean
+_extract_args(FilterXFunctionLookupTable *self, FilterXFunctionArgs *args, LookupTableFormat format,
+              GError **error)
+{
+  if (filterx_function_args_len(args) != 2)
+    {
+      g_set_error(error, FILTERX_FUNCTION_ERROR, FILTERX_FUNCTION_ERROR_CTOR_FAIL,
+                  "invalid number of arguments. %s", self->usage);
+      return FALSE;
+    }
+
+  gsize filename_len;
+  const gchar *filename = filterx_function_args_get_literal_string(args, 1, &filename_len);
+  if (!filename)
+    {
+      g_set_error(error, FILTERX_FUNCTION_ERROR, FILTERX_FUNCTION_ERROR_CTOR_FAIL,
+                  "second argument must be string literal. %s", self->usage);
+      return FALSE;
+    }
+
+  GError *load_error = NULL;
+  self->table = lookup_table_handle_get(filename, format, &load_error);
+  if (!self->table)
+    {
+      g_set_error(error, FILTERX_FUNCTION_ERROR, FILTERX_FUNCTION_ERROR_CTOR_FAIL,
+                  "%s. %s", load_error->message, self->usage);
+      g_clear_error(&load_error);
+      return FALSE;
+    }
+
+  self->key_expr = filterx_function_args_get_expr(args, 0);
+  return TRUE;
+}
+
+static FilterXExpr *
+_function_lookup_table_new(FilterXFunctionArgs *args, const gchar *function_name, LookupTableFormat format,
+                           FilterXObject *(*eval)(FilterXExpr *s), const gchar *usage, GError **error)
+{
+  FilterXFunctionLookupTable *self = g_new0(FilterXFunctionLookupTable, 1);
+  filterx_function_init_instance(&self->super, function_name);
+  self->super.super.eval = eval;
+  self->super.super.optimize = _optimize;
+  self->super.super.init = _init;
+  self->super.super.deinit = _deinit;
+  self->super.super.free_fn = _free;
+  self->usage = usage;
+
+  if (!_extract_args(self, args, format, error) ||
+      !filterx_function_args_check(args, error))
+    goto error;
+
+  filterx_function_args_free(args);
+  return &self->super.super;
+
+error:
+  filterx_function_args_free(args);
+  filterx_expr_unref(&self->super.super);
+  return NULL;
+}
+
+FilterXExpr *
+filterx_function_in_list_new(FilterXFunctionArgs *args, GError **error)
+{
+  return _function_lookup_table_new(args, "in_list", LOOKUP_TABLE_FORMAT_LIST, _in_list_eval,
+                                    FILTERX_FUNC_IN_LIST_USAGE, error);
+}
+
+FilterXExpr *
+filterx_function_lookup_table_new(FilterXFunctionArgs *args, GError **error)
+{
+  return _function_lookup_table_new(args, "lookup_table", LOOKUP_TABLE_FORMAT_TSV, _lookup_table_eval,
+                                    FILTERX_FUNC_LOOKUP_TABLE_USAGE, error);
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+#include "libtest/filterx-lib.h"
+
+#include "filterx/func-lookup-table.h"
+#include "filterx/object-string.h"
+#include "filterx/object-primitive.h"
+#include "filterx/object-null.h"
+#include "filterx/expr-literal.h"
+#include "filterx/filterx-eval.h"
+
+#include "apphook.h"
+#include "scratch-buffers.h"
+
+#include <glib/gstdio.h>
+#include <utime.h>
+
+static gchar *test_dir;
+static gchar *list_file;
+static gchar *tsv_file;
+
+static void
+_write_file(const gchar *filename, const gchar *content)
+{
+  struct utimbuf times = { .actime = time(NULL) - 60, .modtime = time(NULL) - 60 };
+
+  cr_assert(g_file_set_contents(filename, content, -1, NULL));
+  cr_assert(utime(filename, &times) == 0);
+}
+
+static FilterXFunctionArgs *
+_create_args(FilterXObject *key, const gchar *filename)
+{
+  GList *args = NULL;
+  args = g_list_append(args, filterx_function_arg_new(NULL, filterx_non_literal_new(key)));
+  args = g_list_append(args, filterx_function_arg_new(NULL, filterx_literal_new(filterx_string_new(filename, -1))));
+  return filterx_function_args_new(args, NULL);
+}
+
+static FilterXObject *
+_eval(FilterXExpr *(*ctor)(FilterXFunctionArgs *, GError **), FilterXObject *key, const gchar *filename)
+{
+  GError *error = NULL;
+  FilterXExpr *fn = ctor(_create_args(key, filename), &error);
+  cr_assert_not_null(fn);
+  cr_assert_null(error);
+
+  FilterXObject *result = filterx_expr_eval(fn);
+  filterx_expr_unref(fn);
+  return result;
+}
+
+static void
+_assert_in_list(const gchar *key, gboolean expected)
+{
+  FilterXObject *result = _eval(filterx_function_in_list_new, filterx_string_new(key, -1), list_file);
+  cr_assert_not_null(result);
+
+  gboolean value;
+  cr_assert(filterx_boolean_unwrap(result, &value));
+  cr_assert_eq(value, expected, "unexpected in_list() result for key: %s", key);
+  filterx_object_unref(result);
+}
+
+Test(filterx_func_lookup_table, in_list)
+{
+  _assert_in_list("192.168.1.1", TRUE);
+  _assert_in_list("evil.example.com", TRUE);
+  _assert_in_list("192.168.1.2", FALSE);
+  _assert_in_list("", FALSE);
+}
+
+Test(filterx_func_lookup_table, lookup_table_returns_the_value)
+{
+  FilterXObject *result = _eval(filterx_function_lookup_table_new, filterx_string_new("192.168.1.1", -1), tsv_file);
+  cr_assert_not_null(result);
+  cr_assert(filterx_object_is_type(result, &FILTERX_TYPE_NAME(string)));
+
+  gsize len;
+  const gchar *value = filterx_string_get_value_ref(result, &len);
+  cr_assert_eq(len, strlen("scanner"));
+  cr_assert(memcmp(value, "scanner", len) == 0);
+  filterx_object_unref(result);
+}
+
+Test(filterx_func_lookup_table, lookup_table_returns_null_for_missing_keys)
+{
+  FilterXObject *result = _eval(filterx_function_lookup_table_new, filterx_string_new("10.0.0.1", -1), tsv_file);
+  cr_assert_not_null(result);
+  cr_assert(filterx_object_is_type(result, &FILTERX_TYPE_NAME(null)));
+  filterx_object_unref(result);
+}
+
+Test(filterx_func_lookup_table, non_string_key_is_an_error)
+{
+  FilterXObject *result = _eval(filterx_function_in_list_new, filterx_integer_new(42), list_file);
+  cr_assert_null(result);
+  cr_assert_str_eq(filterx_eval_get_last_error(), "First argument must be a string");
+  filterx_eval_clear_errors();
+}
+
+Test(filterx_func_lookup_table, missing_file_fails_at_construction)
+{
+  gchar *missing_file = g_build_filename(test_dir, "missing.list", NULL);
+  GError *error = NULL;
+
+  FilterXExpr *fn = filterx_function_in_list_new(_create_args(filterx_string_new("foo", -1), missing_file), &error);
+  cr_assert_null(fn);
+  cr_assert_not_null(error);
+  g_clear_error(&error);
+  g_free(missing_file);
+}
+
+Test(filterx_func_lookup_table, invalid_number_of_arguments)
+{
+  GList *args = g_list_append(NULL, filterx_function_arg_new(NULL, filterx_non_literal_new(filterx_string_new("foo",
+                                                             -1))));
+  GError *error = NULL;
+
+  FilterXExpr *fn = filterx_function_lookup_table_new(filterx_function_args_new(args, NULL), &error);
+  cr_assert_null(fn);
+  cr_assert_not_null(error);
+  cr_assert_str_eq(error->message, "invalid number of arguments. " FILTERX_FUNC_LOOKUP_TABLE_USAGE);
+  g_clear_error(&error);
+}
+
+static void
+setup(void)
+{
+  app_startup();
+  init_libtest_filterx();
+  test_dir = g_dir_make_tmp("test_func_lookup_table_XXXXXX", NULL);
+  cr_assert_not_null(test_dir);
+  list_file = g_build_filename(test_dir, "ioc.list", NULL);
+  tsv_file = g_build_filename(test_dir, "ioc.tsv", NULL);
+  _write_file(list_file, "192.168.1.1\nevil.example.com\n");
+  _write_file(tsv_file, "192.168.1.1\tscanner\nevil.example.com\tphishing\n");
+}
+
+static void
+teardown(void)
+{
+  g_unlink(list_file);
+  g_unlink(tsv_file);
+  g_rmdir(test_dir);
+  g_free(list_file);
+  g_free(tsv_file);
+  g_free(test_dir);
+  scratch_buffers_explicit_gc();
+  deinit_libtest_filterx();
+  app_shutdown();
+}
+
+TestSuite(filterx_func_lookup_table, .init = setup, .fini = teardown);
@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "host-resolve-async.h"
+#include "messages.h"
+
+#include <netinet/in.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Reverse DNS lookups performed off the reader threads.
+ *
+ * A lookup that misses the cache is queued to a small pool of resolver
+ * threads and the caller gets NULL back immediately, so it can continue
+ * with the IP address.  Once the answer arrives, it is stored in a
+ * process-wide cache, which is shared by all reader threads and is split
+ * into shards to keep lock contention low.  Concurrent misses for the same
+ * address are coalesced into a single request, as the pending request is
+ * stored in the cache as well.
+ *
+ * Both the cache and the number of outstanding requests are bounded: when
+ * a shard is full of pending entries, or HOST_RESOLVE_ASYNC_MAX_QUEUED
+ * requests are already waiting for the resolver threads, the address is
+ * not resolved at all and the caller uses the IP address, so a flood of
+ * unique senders cannot grow memory usage or the resolution latency
+ * without limits.
+ */
+
+#define HOST_RESOLVE_ASYNC_SHARDS         16
+#define HOST_RESOLVE_ASYNC_SHARD_SIZE     1024
+#define HOST_RESOLVE_ASYNC_MAX_THREADS    4
+
+typedef struct _HostResolveAsyncKey
+{
+  gint family;
+  guint8 addr[16];
+} HostResolveAsyncKey;
+
+typedef struct _HostResolveAsyncEntry
+{
+  HostResolveAsyncKey key;
+  gboolean pending;
+  gboolean positive;
+  time_t resolved;
+  gchar *hostname;
+} HostResolveAsyncEntry;
+
+typedef struct _HostResolveAsyncRequest
+{
+  GSockAddr *saddr;
+  HostResolveAsyncKey key;
+  HostResolveAsyncFunc resolve;
+} HostResolveAsyncRequest;
+
+typedef struct _HostResolveAsyncShard
+{
+  GMutex lock;
+  GHashTable *entries;
+} HostResolveAsyncShard;
+
+static struct
+{
+  HostResolveAsyncShard shards[HOST_RESOLVE_ASYNC_SHARDS];
+  GThreadPool *resolvers;
+  GMutex resolvers_lock;
+  /* signalled under resolvers_lock when the last queued request finishes */
+  GCond idle_cond;
+  /* requests submitted to the resolvers and not finished yet */
+  gint queued;
+  gboolean stopping;
+  gint expire;
+  gint expire_failed;
+} host_resolve_async;
+
+static guint
+_key_hash(gconstpointer k)
+{
+  const HostResolveAsyncKey *key = (const HostResolveAsyncKey *) k;
+  guint hash = key->family;
+
+  for (gsize i = 0; i < sizeof(key->addr); i++)
+    hash = (hash << 5) - hash + key->addr[i];
+  return hash;
+}
+
+static gboolean
+_key_equal(gconstpointer a, gconstpointer b)
+{
+  return memcmp(a, b, sizeof(HostResolveAsyncKey)) == 0;
+}
+
+static gboolean
+_key_init(HostResolveAsyncKey *key, GSockAddr *saddr)
+{
+  memset(key, 0, sizeof(*key));
+  key->family = saddr->sa.sa_family;
+
+  if (saddr->sa.sa_family == AF_INET)
+    {
+      memcpy(key->addr, &((struct sockaddr_in *) &saddr->sa)->sin_addr, sizeof(struct in_addr));
+      return TRUE;
+    }
+#if SYSLOG_NG_ENABLE_IPV6
+  if (saddr->sa.sa_family == AF_INET6)
+    {
+      memcpy(key->addr, &((struct sockaddr_in6 *) &saddr->sa)->sin6_addr, sizeof(struct in6_addr));
+      return TRUE;
+    }
+#endif
+  return FALSE;
+}
+
+static HostResolveAsyncShard *
+_get_shard(const HostResolveAsyncKey *key)
+{
+  return &host_resolve_async.shards[_key_hash(key) % HOST_RESOLVE_ASYNC_SHARDS];
+}
+
+static void
+_entry_free(HostResolveAsyncEntry *entry)
+{
+  g_free(entry->hostname);
+  g_free(entry);
+}
+
+static gboolean
+_entry_is_expired(HostResolveAsyncEntry *entry, time_t now)
+{
+  if (entry->pending)
+    return FALSE;
+
+  gint expire = entry->positive ? host_resolve_async.expire : host_resolve_async.expire_failed;
+  return entry->resolved + expire <= now;
+}
+
+static gboolean
+_remove_resolved_entry(gpointer key, gpointer value, gpointer user_data)
+{
+  return !((HostResolveAsyncEntry *) value)->pending;
+}
+
+static gboolean
+_reserve_request(void)
+{
+  if (g_atomic_int_add(&host_resolve_async.queued, 1) < HOST_RESOLVE_ASYNC_MAX_QUEUED)
+    return TRUE;
+
+  g_atomic_int_add(&host_resolve_async.queued, -1);
+  return FALSE;
+}
+
+static void
+_release_request(void)
+{
+  if (!g_atomic_int_dec_and_test(&host_resolve_async.queued))
+    return;
+
+  g_mutex_lock(&host_resolve_async.resolvers_lock);
+  g_cond_broadcast(&host_resolve_async.idle_cond);
+  g_mutex_unlock(&host_resolve_async.resolvers_lock);
+}
+
+static void
+_request_free(HostResolveAsyncRequest *request)
+{
+  g_sockaddr_unref(request->saddr);
+  g_free(request);
+}
+
+static void
+_resolve_request(gpointer data, gpointer user_data)
+{
+  HostResolveAsyncRequest *request = (HostResolveAsyncRequest *) data;
+  gchar buf[256];
+
+  /* the queue is drained on shutdown, without resolving anything */
+  if (g_atomic_int_get(&host_resolve_async.stopping))
+    {
+      _request_free(request);
+      _release_request();
+      return;
+    }
+
+  const gchar *hostname = request->resolve(request->saddr, buf, sizeof(buf));
+
+  HostResolveAsyncShard *shard = _get_shard(&request->key);
+  g_mutex_lock(&shard->lock);
+
+  HostResolveAsyncEntry *entry = g_hash_table_lookup(shard->entries, &request->key);
+  if (entry)
+    {
+      entry->pending = FALSE;
+      entry->positive = (hostname != NULL);
+      entry->hostname = g_strdup(hostname);
+      entry->resolved = time(NULL);
+    }
+
+  g_mutex_unlock(&shard->lock);
+  _request_free(request);
+  _release_request();
+}
+
+static gboolean
+_submit_request(GSockAddr *saddr, const HostResolveAsyncKey *key, HostResolveAsyncFunc resolve)
+{
+  GError *error = NULL;
+  gboolean result;
+
+  g_mutex_lock(&host_resolve_async.resolvers_lock);
+  if (!host_resolve_async.resolvers)
+    host_resolve_async.resolvers = g_thread_pool_new(_resolve_request, NULL, HOST_RESOLVE_ASYNC_MAX_THREADS,
+                                                     FALSE, &error);
+
+  if (host_resolve_async.resolvers)
+    {
+      HostResolveAsyncRequest *request = g_new0(HostResolveAsyncRequest, 1);
+
+      request->saddr = g_sockaddr_ref(saddr);
+      request->key = *key;
+      request->resolve = resolve;
+      result = g_thread_pool_push(host_resolve_async.resolvers, request, &error);
+      if (!result)
+        _request_free(request);
+    }
+  else
+    {
+      result = FALSE;
+    }
+  g_mutex_unlock(&host_resolve_async.resolvers_lock);
+
+  if (!result)
+    {
+      msg_error("Error starting asynchronous DNS resolution",
+                evt_tag_str("error", error ? error->message : "unknown"));
+      g_clear_error(&error);
+    }
+  return result;
+}
+
+/* Returns the cached hostname copied into @buf, or NULL if the address is
+ * not resolved yet.  A negative answer (failed lookup) also returns NULL,
+ * with @positive set to FALSE, as the caller falls back to the IP address
+ * either way. */
+const gchar *
+host_resolve_async_lookup(GSockAddr *saddr, HostResolveAsyncFunc resolve,
+                          gchar *buf, gsize buf_len, gboolean *positive)
+{
+  HostResolveAsyncKey key;
+  const gchar *result = NULL;
+  gboolean submit = FALSE;
+
+  *positive = FALSE;
+  if (!_key_init(&key, saddr))
+    return NULL;
+
+  HostResolveAsyncShard *shard = _get_shard(&key);
+  time_t now = time(NULL);
+
+  g_mutex_lock(&shard->lock);
+  HostResolveAsyncEntry *entry = g_hash_table_lookup(shard->entries, &key);
+
+  if (entry && _entry_is_expired(entry, now))
+    {
+      g_hash_table_remove(shard->entries, &key);
+      entry = NULL;
+    }
+
+  if (!entry)
+    {
+      if (g_hash_table_size(shard->entries) >= HOST_RESOLVE_ASYNC_SHARD_SIZE)
+        g_hash_table_foreach_remove(shard->entries, _remove_resolved_entry, NULL);
+
+      if (g_hash_table_size(shard->entries) >= HOST_RESOLVE_ASYNC_SHARD_SIZE || !_reserve_request())
+        {
+          g_mutex_unlock(&shard->lock);
+          msg_debug("Too many pending asynchronous DNS lookups, using the IP address");
+          return NULL;
+        }
+
+      entry = g_new0(HostResolveAsyncEntry, 1);
+      entry->key = key;
+      entry->pending = TRUE;
+      g_hash_table_insert(shard->entries, &entry->key, entry);
+      submit = TRUE;
+    }
+  else if (!entry->pending && entry->positive)
+    {
+      g_strlcpy(buf, entry->hostname, buf_len);
+      *positive = TRUE;
+      result = buf;
+    }
+  g_mutex_unlock(&shard->lock);
+
+  if (submit && !_submit_request(saddr, &key, resolve))
+    {
+      _release_request();
+      g_mutex_lock(&shard->lock);
+      g_hash_table_remove(shard->entries, &key);
+      g_mutex_unlock(&shard->lock);
+    }
+
+  return result;
+}
+
+void
+host_resolve_async_set_expiry(gint expire, gint expire_failed)
+{
+  host_resolve_async.expire = expire;
+  host_resolve_async.expire_failed = expire_failed;
+}
+
+/* blocks until all the submitted lookups have updated the cache */
+void
+host_resolve_async_wait_idle(void)
+{
+  g_mutex_lock(&host_resolve_async.resolvers_lock);
+  while (g_atomic_int_get(&host_resolve_async.queued) > 0)
+    g_cond_wait(&host_resolve_async.idle_cond, &host_resolve_async.resolvers_lock);
+  g_mutex_unlock(&host_resolve_async.resolvers_lock);
+}
+
+void
+host_resolve_async_global_init(void)
+{
+  for (gint i = 0; i < HOST_RESOLVE_ASYNC_SHARDS; i++)
+    {
+      g_mutex_init(&host_resolve_async.shards[i].lock);
+      host_resolve_async.shards[i].entries = g_hash_table_new_full(_key_hash, _key_equal, NULL,
+                                                                   (GDestroyNotify) _entry_free);
+    }
+  g_mutex_init(&host_resolve_async.resolvers_lock);
+  g_cond_init(&host_resolve_async.idle_cond);
+  host_resolve_async.resolvers = NULL;
+  host_resolve_async.queued = 0;
+  host_resolve_async.stopping = FALSE;
+  host_resolve_async_set_expiry(3600, 60);
+}
+
+void
+host_resolve_async_global_deinit(void)
+{
+  /* the queued requests are drained without being resolved, so that they
+   * are freed, and the running ones are waited for, as they update the
+   * shards */
+  g_atomic_int_set(&host_resolve_async.stopping, TRUE);
+  if (host_resolve_async.resolvers)
+    g_thread_pool_free(host_resolve_async.resolvers, FALSE, TRUE);
+  host_resolve_async.resolvers = NULL;
+  g_cond_clear(&host_resolve_async.idle_cond);
+  g_mutex_clear(&host_resolve_async.resolvers_lock);
+
+  for (gint i = 0; i < HOST_RESOLVE_ASYNC_SHARDS; i++)
+    {
+      g_hash_table_destroy(host_resolve_async.shards[i].entries);
+      g_mutex_clear(&host_resolve_async.shards[i].lock);
+    }
+}
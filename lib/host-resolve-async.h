@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef HOST_RESOLVE_ASYNC_H_INCLUDED
+#define HOST_RESOLVE_ASYNC_H_INCLUDED 1
+
+#include "syslog-ng.h"
+#include "gsockaddr.h"
+
+/* the number of lookups waiting for a resolver thread, addresses over this are not resolved */
+#define HOST_RESOLVE_ASYNC_MAX_QUEUED 256
+
+/* performs the actual (blocking) reverse lookup, returns @buf or NULL */
+typedef const gchar *(*HostResolveAsyncFunc)(GSockAddr *saddr, gchar *buf, gsize buf_len);
+
+const gchar *host_resolve_async_lookup(GSockAddr *saddr, HostResolveAsyncFunc resolve,
+                                       gchar *buf, gsize buf_len, gboolean *positive);
+void host_resolve_async_set_expiry(gint expire, gint expire_failed);
+void host_resolve_async_wait_idle(void);
+
+void host_resolve_async_global_init(void);
+void host_resolve_async_global_deinit(void);
+
+#endif
@@ -23,6 +23,7 @@
 #include "host-resolve.h"
 #include "hostname.h"
 #include "dnscache.h"
+#include "host-resolve-async.h"
 #include "messages.h"
 #include "cfg.h"
 #include "tls-support.h"
@@ -323,6 +324,16 @@ resolve_address_using_gethostbyaddr(GSockAddr *saddr, gchar *buf, gsize buf_len)
 
 #endif
 
+static const gchar *
+resolve_address(GSockAddr *saddr, gchar *buf, gsize buf_len)
+{
+#ifdef SYSLOG_NG_HAVE_GETNAMEINFO
+  return resolve_address_using_getnameinfo(saddr, buf, buf_len);
+#else
+  return resolve_address_using_gethostbyaddr(saddr, buf, buf_len);
+#endif
+}
+
 static void *
 sockaddr_to_dnscache_key(GSockAddr *saddr)
 {
@@ -360,13 +371,18 @@ resolve_sockaddr_to_inet_or_inet6_hostname(gsize *result_len, GSockAddr *saddr,
         return hostname_apply_options_fqdn(hname_len, result_len, hname, positive, host_resolve_options);
     }
 
-  if (!hname && host_resolve_options->use_dns && host_resolve_options->use_dns != 2)
+  gboolean resolved = TRUE;
+  if (!hname && host_resolve_options->use_dns == HOST_RESOLVE_DNS_ASYNC)
     {
-#ifdef SYSLOG_NG_HAVE_GETNAMEINFO
-      hname = resolve_address_using_getnameinfo(saddr, hostname_buffer, sizeof(hostname_buffer));
-#else
-      hname = resolve_address_using_gethostbyaddr(saddr, hostname_buffer, sizeof(hostname_buffer));
-#endif
+      hname = host_resolve_async_lookup(saddr, resolve_address, hostname_buffer, sizeof(hostname_buffer), &positive);
+
+      /* still pending: don't cache the IP address in the per-thread cache,
+       * so that the name is picked up once it arrives */
+      resolved = (hname != NULL);
+    }
+  else if (!hname && host_resolve_options->use_dns && host_resolve_options->use_dns != HOST_RESOLVE_DNS_PERSIST_ONLY)
+    {
+      hname = resolve_address(saddr, hostname_buffer, sizeof(hostname_buffer));
       positive = (hname != NULL);
     }
 
@@ -375,7 +391,7 @@ resolve_sockaddr_to_inet_or_inet6_hostname(gsize *result_len, GSockAddr *saddr,
       hname = g_sockaddr_format(saddr, hostname_buffer, sizeof(hostname_buffer), GSA_ADDRESS_ONLY);
       positive = FALSE;
     }
-  if (host_resolve_options->use_dns_cache)
+  if (host_resolve_options->use_dns_cache && resolved)
     dns_caching_store(saddr->sa.sa_family, dnscache_key, hname, positive);
 
   return hostname_apply_options_fqdn(-1, result_len, hname, positive, host_resolve_options);
@@ -26,6 +26,17 @@
 #include "syslog-ng.h"
 #include "gsockaddr.h"
 
+/* values of HostResolveOptions->use_dns */
+enum
+{
+  HOST_RESOLVE_DNS_NO = 0,
+  HOST_RESOLVE_DNS_YES = 1,
+  HOST_RESOLVE_DNS_PERSIST_ONLY = 2,
+  /* don't block the caller on a cache miss, use the IP address until the
+   * name is resolved in the background */
+  HOST_RESOLVE_DNS_ASYNC = 3,
+};
+
 typedef struct _HostResolveOptions
 {
   gboolean use_dns;
@@ -319,9 +319,24 @@ _fixup_entry(NVHandle old_handle, NVEntry *entry, NVIndexEntry *index_entry, gpo
   return FALSE;
 }
 
+static gboolean
+_validate_entry_with_same_registry(NVHandle handle, NVEntry *entry, NVIndexEntry *index_entry, gpointer user_data)
+{
+  LogMessageSerializationState *state = (LogMessageSerializationState *) user_data;
+
+  /* this return of TRUE indicates failure, as it terminates the foreach loop */
+  return !_validate_entry(state, entry) || !_update_entry(state, entry);
+}
+
 gboolean
 log_msg_fixup_handles_after_deserialization(LogMessageSerializationState *state)
 {
+  /* handles are only ever allocated, never reassigned by a registry, so a
+   * message written with this very registry instance needs no remapping,
+   * only validation */
+  if (state->same_registry)
+    return !nv_table_foreach_entry(state->nvtable, _validate_entry_with_same_registry, state);
+
   LogMessage *msg = state->msg;
   NVTable *nvtable = state->nvtable;
   NVHandle _updated_sdata_handles[msg->num_sdata];
@@ -78,6 +78,7 @@ _serialize_message(LogMessageSerializationState *state)
   serialize_write_uint8(sa, msg->num_sdata);
   serialize_write_uint8(sa, msg->alloc_sdata);
   serialize_write_uint32_array(sa, (guint32 *) msg->sdata, msg->num_sdata);
+  serialize_write_uint64(sa, log_msg_registry_get_instance_id());
 
   if (state->flags & LMSF_COMPACTION)
     nv_table_serialize_with_compaction(state, msg->payload);
@@ -91,7 +92,7 @@ log_msg_serialize_with_ts_processed(LogMessage *self, SerializeArchive *sa, cons
 {
   LogMessageSerializationState state = { 0 };
 
-  state.version = LGM_V26;
+  state.version = LGM_V27;
   state.msg = self;
   state.sa = sa;
   state.processed = processed;
@@ -126,12 +127,27 @@ _deserialize_sdata(LogMessageSerializationState *state)
   if ((state->version < LGM_V26) && !serialize_read_uint16_array(sa, (guint32 *) self->sdata, self->num_sdata))
     return FALSE;
 
-  if ((state->version == LGM_V26) && !serialize_read_uint32_array(sa, (guint32 *) self->sdata, self->num_sdata))
+  if ((state->version >= LGM_V26) && !serialize_read_uint32_array(sa, (guint32 *) self->sdata, self->num_sdata))
     return FALSE;
 
   return TRUE;
 }
 
+static gboolean
+_deserialize_registry_instance_id(LogMessageSerializationState *state)
+{
+  guint64 registry_instance_id;
+
+  if (state->version < LGM_V27)
+    return TRUE;
+
+  if (!serialize_read_uint64(state->sa, &registry_instance_id))
+    return FALSE;
+
+  state->same_registry = (registry_instance_id == log_msg_registry_get_instance_id());
+  return TRUE;
+}
+
 NVTable *
 _nv_table_deserialize_selector(LogMessageSerializationState *state)
 {
@@ -147,7 +163,7 @@ _nv_table_deserialize_selector(LogMessageSerializationState *state)
 
       return state->nvtable;
     }
-  else if (state->version == LGM_V26)
+  else if (state->version >= LGM_V26)
     {
       return nv_table_deserialize(state);
     }
@@ -197,6 +213,9 @@ _deserialize_message_version_2x(LogMessageSerializationState *state)
   if (!_deserialize_sdata(state))
     return FALSE;
 
+  if (!_deserialize_registry_instance_id(state))
+    return FALSE;
+
   nv_table_unref(msg->payload);
   msg->payload = _nv_table_deserialize_selector(state);
   if (!msg->payload)
@@ -499,7 +518,7 @@ _check_msg_version(LogMessageSerializationState *state)
   if (!serialize_read_uint8(state->sa, &state->version))
     return FALSE;
 
-  if (state->version < LGM_V10 || state->version > LGM_V26)
+  if (state->version < LGM_V10 || state->version > LGM_V27)
     {
       msg_error("Error deserializing log message, unsupported version",
                 evt_tag_int("version", state->version));
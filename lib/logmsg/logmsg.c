@@ -41,6 +41,7 @@
 #include "ack-tracker/ack_tracker.h"
 #include "apphook.h"
 #include "scratch-buffers.h"
+#include "memory-reservation.h"
 #include "str-format.h"
 
 #include <glib/gprintf.h>
@@ -122,6 +123,32 @@
  * stuff, but that shouldn't have that much of an overhead.
  */
 
+/* name -> handle lookups are cached per-thread, so that parsers setting
+ * values by name (like the RFC5424 SDATA parser, which does that for each
+ * SD-PARAM) do not have to take the registry lock for each value.  The
+ * cache is direct mapped, a colliding name simply evicts the old one.
+ *
+ * TODO: this only cuts the per-parameter cost of the eager SDATA parse.
+ * Materializing SDATA lazily, on first access, is a follow-up: it needs a
+ * way to parse into messages that are already shared between destination
+ * threads and read through const accessors. */
+#define LOGMSG_HANDLE_CACHE_SIZE      128
+#define LOGMSG_HANDLE_CACHE_NAME_MAX  64
+
+typedef struct _LogMessageHandleCacheEntry
+{
+  gchar name[LOGMSG_HANDLE_CACHE_NAME_MAX];
+  NVHandle handle;
+} LogMessageHandleCacheEntry;
+
+/* bumped whenever the registry is recreated, invalidating the per-thread caches */
+static gint logmsg_registry_generation = 1;
+
+/* identifies the handle space of this registry instance, even across
+ * processes, so deserialization can tell whether the handles in a
+ * serialized message are still valid as they are */
+static guint64 logmsg_registry_instance_id;
+
 TLS_BLOCK_START
 {
   /* message that is being processed by the current thread. Its ack/ref changes are cached */
@@ -138,6 +165,12 @@ TLS_BLOCK_START
   gboolean logmsg_cached_abort;
   /* suspend flag in the current thread for acks */
   gboolean logmsg_cached_suspend;
+
+  struct
+  {
+    gint generation;
+    LogMessageHandleCacheEntry entries[LOGMSG_HANDLE_CACHE_SIZE];
+  } logmsg_handle_cache;
 }
 TLS_BLOCK_END;
 
@@ -147,6 +180,7 @@ TLS_BLOCK_END;
 #define logmsg_cached_ack_needed    __tls_deref(logmsg_cached_ack_needed)
 #define logmsg_cached_abort         __tls_deref(logmsg_cached_abort)
 #define logmsg_cached_suspend       __tls_deref(logmsg_cached_suspend)
+#define logmsg_handle_cache         __tls_deref(logmsg_handle_cache)
 
 #define LOGMSG_REFCACHE_SUSPEND_SHIFT                 31 /* number of bits to shift to get the SUSPEND flag */
 #define LOGMSG_REFCACHE_SUSPEND_MASK          0x80000000 /* bit mask to extract the SUSPEND flag */
@@ -419,8 +453,23 @@ log_msg_update_num_matches(LogMessage *self, NVHandle handle)
     }
 }
 
-NVHandle
-log_msg_get_value_handle(const gchar *value_name)
+static LogMessageHandleCacheEntry *
+_handle_cache_lookup(const gchar *value_name)
+{
+  gint generation = g_atomic_int_get(&logmsg_registry_generation);
+
+  if (G_UNLIKELY(logmsg_handle_cache.generation != generation))
+    {
+      memset(logmsg_handle_cache.entries, 0, sizeof(logmsg_handle_cache.entries));
+      logmsg_handle_cache.generation = generation;
+    }
+
+  guint slot = g_str_hash(value_name) & (LOGMSG_HANDLE_CACHE_SIZE - 1);
+  return &logmsg_handle_cache.entries[slot];
+}
+
+static NVHandle
+_alloc_value_handle(const gchar *value_name)
 {
   NVHandle handle;
 
@@ -435,6 +484,27 @@ log_msg_get_value_handle(const gchar *value_name)
   return handle;
 }
 
+NVHandle
+log_msg_get_value_handle(const gchar *value_name)
+{
+  gsize value_name_len = strlen(value_name);
+
+  if (value_name_len >= LOGMSG_HANDLE_CACHE_NAME_MAX)
+    return _alloc_value_handle(value_name);
+
+  LogMessageHandleCacheEntry *entry = _handle_cache_lookup(value_name);
+  if (entry->handle && memcmp(entry->name, value_name, value_name_len + 1) == 0)
+    return entry->handle;
+
+  NVHandle handle = _alloc_value_handle(value_name);
+  if (handle)
+    {
+      memcpy(entry->name, value_name, value_name_len + 1);
+      entry->handle = handle;
+    }
+  return handle;
+}
+
 gboolean
 log_msg_is_value_name_valid(const gchar *value)
 {
@@ -516,7 +586,9 @@ log_msg_alloc_queue_node(LogMessage *msg, const LogPathOptions *path_options)
        */
       if (nodes < 32 && nodes <= msg->num_nodes)
         logmsg_queue_node_max = msg->num_nodes + 1;
-      node = g_slice_new(LogMessageQueueNode);
+      node = memory_reservation_alloc(sizeof(LogMessageQueueNode));
+      if (!node)
+        node = g_slice_new(LogMessageQueueNode);
       node->embedded = FALSE;
     }
   log_msg_init_queue_node(msg, node, path_options);
@@ -533,10 +605,29 @@ log_msg_alloc_dynamic_queue_node(LogMessage *msg, const LogPathOptions *path_opt
   return node;
 }
 
+/* the memory held by a queued message, including its node when that is allocated separately */
+gsize
+log_msg_queue_node_get_size(LogMessageQueueNode *node)
+{
+  gsize size = log_msg_get_size(node->msg);
+
+  if (node->embedded)
+    return size;
+
+  if (memory_reservation_owns(node))
+    return size + memory_reservation_get_chunk_size(node);
+  return size + sizeof(*node);
+}
+
 void
 log_msg_free_queue_node(LogMessageQueueNode *node)
 {
-  if (!node->embedded)
+  if (node->embedded)
+    return;
+
+  if (memory_reservation_owns(node))
+    memory_reservation_free(node);
+  else
     g_slice_free(LogMessageQueueNode, node);
 }
 
@@ -604,7 +695,7 @@ log_msg_set_value_with_type(LogMessage *self, NVHandle handle,
 
   if (!log_msg_chk_flag(self, LF_STATE_OWN_PAYLOAD))
     {
-      self->payload = nv_table_clone(self->payload, name_len + value_len + 2);
+      self->payload = nv_table_clone(self->payload, NV_ENTRY_DIRECT_SIZE(name_len, value_len) + sizeof(NVIndexEntry));
       log_msg_set_flag(self, LF_STATE_OWN_PAYLOAD);
       self->allocated_bytes += self->payload->size;
       stats_counter_add(count_allocated_bytes, self->payload->size);
@@ -725,7 +816,7 @@ log_msg_set_value_indirect_with_type(LogMessage *self, NVHandle handle,
 
   if (!log_msg_chk_flag(self, LF_STATE_OWN_PAYLOAD))
     {
-      self->payload = nv_table_clone(self->payload, name_len + 1);
+      self->payload = nv_table_clone(self->payload, NV_ENTRY_INDIRECT_SIZE(name_len) + sizeof(NVIndexEntry));
       log_msg_set_flag(self, LF_STATE_OWN_PAYLOAD);
     }
 
@@ -871,6 +962,9 @@ log_msg_clear_matches(LogMessage *self)
   log_msg_truncate_matches(self, 0);
 }
 
+/* TODO: tags up to LOGMSG_TAGS_BITS are stored inline, the rest in an
+ * array reallocated as tags are set.  A fixed size bitmap that avoids the
+ * allocation for higher tag ids is a follow-up. */
 #if GLIB_SIZEOF_LONG != GLIB_SIZEOF_VOID_P
 #error "The tags bit array assumes that long is the same size as the pointer"
 #endif
@@ -1630,6 +1724,7 @@ log_msg_free(LogMessage *self)
 void
 log_msg_drop(LogMessage *msg, const LogPathOptions *path_options, AckType ack_type)
 {
+  pipe_profiler_record_drop(ack_type);
   log_msg_ack(msg, path_options, ack_type);
   log_msg_unref(msg);
 }
@@ -2020,11 +2115,21 @@ log_msg_tags_init(void)
   log_tags_register_predefined_tag("syslog.rfc5424_missing_message", LM_T_SYSLOG_RFC5424_MISSING_MESSAGE);
 }
 
+guint64
+log_msg_registry_get_instance_id(void)
+{
+  return logmsg_registry_instance_id;
+}
+
 void
 log_msg_registry_init(void)
 {
   gint i;
 
+  do
+    logmsg_registry_instance_id = ((guint64) g_random_int() << 32) | g_random_int();
+  while (logmsg_registry_instance_id == 0);
+
   logmsg_registry = nv_registry_new(builtin_value_names, NVHANDLE_MAX_VALUE);
   nv_registry_add_alias(logmsg_registry, LM_V_MESSAGE, "MSG");
   nv_registry_add_alias(logmsg_registry, LM_V_MESSAGE, "MSGONLY");
@@ -2065,6 +2170,7 @@ log_msg_registry_deinit(void)
 {
   nv_registry_free(logmsg_registry);
   logmsg_registry = NULL;
+  g_atomic_int_inc(&logmsg_registry_generation);
 }
 
 void
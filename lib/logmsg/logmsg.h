@@ -579,6 +579,7 @@ void log_msg_refcache_stop(void);
 
 void log_msg_registry_init(void);
 void log_msg_registry_deinit(void);
+guint64 log_msg_registry_get_instance_id(void);
 void log_msg_global_init(void);
 void log_msg_global_deinit(void);
 void log_msg_stats_global_init(void);
@@ -587,6 +588,7 @@ void log_msg_registry_foreach(GHFunc func, gpointer user_data);
 gint log_msg_lookup_time_stamp_name(const gchar *name);
 
 gssize log_msg_get_size(LogMessage *self);
+gsize log_msg_queue_node_get_size(LogMessageQueueNode *node);
 
 #define evt_tag_msg_reference(msg)             \
     evt_tag_printf("msg", "%p", (msg)),        \
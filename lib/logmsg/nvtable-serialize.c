@@ -27,6 +27,7 @@
 #include "logmsg/nvtable-serialize.h"
 #include "logmsg/nvtable-serialize-endianutils.h"
 #include "logmsg/logmsg.h"
+#include "logmsg/logmsg-serialize.h"
 #include "messages.h"
 
 #include <stdlib.h>
@@ -63,15 +64,43 @@ _deserialize_dynamic_entries(SerializeArchive *sa, NVTable *res)
 }
 
 static gboolean
-_read_struct(SerializeArchive *sa, NVTable *res)
+_has_to_swap_bytes(guint8 flags)
+{
+  return !!(flags & NVT_SF_BE) != (G_BYTE_ORDER == G_BIG_ENDIAN);
+}
+
+static inline gsize
+_get_struct_entries_size(NVTable *self)
 {
-  return _deserialize_static_entries(sa, res) && _deserialize_dynamic_entries(sa, res);
+  return self->num_static_entries * sizeof(self->static_entries[0]) + self->index_size * sizeof(NVIndexEntry);
 }
 
+/* since LGM_V27 the static entries and the index are stored in native byte
+ * order, as a single blob, so they are read with a single copy */
 static gboolean
-_has_to_swap_bytes(guint8 flags)
+_read_struct_native(SerializeArchive *sa, NVTable *res, gboolean swap_bytes)
 {
-  return !!(flags & NVT_SF_BE) != (G_BYTE_ORDER == G_BIG_ENDIAN);
+  if (!serialize_read_blob(sa, res->static_entries, _get_struct_entries_size(res)))
+    return FALSE;
+
+  if (swap_bytes)
+    {
+      guint32 *words = res->static_entries;
+      gsize num_words = _get_struct_entries_size(res) / sizeof(guint32);
+
+      for (gsize i = 0; i < num_words; i++)
+        words[i] = GUINT32_SWAP_LE_BE(words[i]);
+    }
+  return TRUE;
+}
+
+static gboolean
+_read_struct(LogMessageSerializationState *state, NVTable *res, guint8 flags)
+{
+  if (state->version >= LGM_V27)
+    return _read_struct_native(state->sa, res, _has_to_swap_bytes(flags));
+
+  return _deserialize_static_entries(state->sa, res) && _deserialize_dynamic_entries(state->sa, res);
 }
 
 static inline gboolean
@@ -181,7 +210,7 @@ nv_table_deserialize(LogMessageSerializationState *state)
 
   state->nvtable_flags = meta_data.flags;
   state->nvtable = res;
-  if (!_read_struct(sa, res))
+  if (!_read_struct(state, res, meta_data.flags))
     goto error;
 
   if (!_read_payload(sa, res))
@@ -204,12 +233,21 @@ error:
  **********************************************************************/
 
 static void
-_write_struct(SerializeArchive *sa, NVTable *self)
+_write_struct(LogMessageSerializationState *state, NVTable *self)
 {
+  SerializeArchive *sa = state->sa;
+
   serialize_write_uint32(sa, self->size);
   serialize_write_uint32(sa, self->used);
   serialize_write_uint16(sa, self->index_size);
   serialize_write_uint8(sa, self->num_static_entries);
+
+  if (state->version >= LGM_V27)
+    {
+      serialize_write_blob(sa, self->static_entries, _get_struct_entries_size(self));
+      return;
+    }
+
   serialize_write_uint32_array(sa, self->static_entries, self->num_static_entries);
   serialize_write_uint32_array(sa, (guint32 *) nv_table_get_index(self), self->index_size * 2);
 }
@@ -245,7 +283,7 @@ nv_table_serialize(LogMessageSerializationState *state, NVTable *self)
   _fill_meta_data(self, &meta_data);
   _write_meta_data(sa, &meta_data);
 
-  _write_struct(sa, self);
+  _write_struct(state, self);
 
   _write_payload(sa, self);
   return TRUE;
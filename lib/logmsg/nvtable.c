@@ -807,6 +807,17 @@ nv_table_unref(NVTable *self)
  * @additional_space: specifies how much additional space is needed in
  *                    the newly allocated clone
  *
+ * The clone is always grown by @additional_space, even if @self happens to
+ * have enough free space.  The typical caller is a copy-on-write clone of a
+ * LogMessage that is about to store a new value: sizing the clone with the
+ * free space of the original in mind could leave the clone full, causing an
+ * nv_table_realloc() right after the clone, copying the payload twice.
+ *
+ * TODO: the clone still copies the whole payload.  A copy-on-write overlay
+ * (a small per-clone table falling through to the shared parent) would
+ * avoid that, but lookups, foreach, indirect values, the SDATA index and
+ * serialization all assume a single flat table, so it is left as a
+ * follow-up.
  **/
 NVTable *
 nv_table_clone(NVTable *self, gint additional_space)
@@ -814,10 +825,7 @@ nv_table_clone(NVTable *self, gint additional_space)
   NVTable *new;
   gint new_size;
 
-  if (nv_table_get_bottom(self) - nv_table_get_ofs_table_top(self) < additional_space)
-    new_size = self->size;
-  else
-    new_size = self->size + (NV_TABLE_BOUND(additional_space));
+  new_size = self->size + NV_TABLE_BOUND(additional_space);
 
   if (new_size > NV_TABLE_MAX_BYTES)
     new_size = NV_TABLE_MAX_BYTES;
@@ -38,6 +38,8 @@ typedef struct _LogMessageSerializationState
   NVTable *nvtable;
   guint8 nvtable_flags;
   guint8 handle_changed;
+  /* the message was serialized with the same NVHandle registry, no need to remap handles */
+  gboolean same_registry;
   NVHandle *updated_sdata_handles;
   NVIndexEntry *updated_index;
   const UnixTime *processed;
@@ -235,7 +235,7 @@ Test(log_message, test_rcptid_is_automatically_assigned_to_a_newly_created_log_m
 {
   LogMessage *msg;
   PersistState *state = clean_and_create_persist_state_for_test("test_values.persist");
-  rcptid_init(state, TRUE);
+  rcptid_init(state, TRUE, FALSE);
 
   msg = log_msg_new_empty();
   cr_assert_eq(msg->rcptid, 1, "rcptid is not automatically set");
@@ -370,6 +370,28 @@ Test(log_message, test_log_msg_get_value_with_time_related_macro)
   log_msg_unref(msg);
 }
 
+Test(log_message, test_log_msg_get_value_handle_returns_the_same_handle_on_repeated_lookups)
+{
+  NVHandle sd_handle = log_msg_get_value_handle(".SDATA.origin.ip");
+  NVHandle handle = log_msg_get_value_handle("some_value_name");
+  const gchar *long_name = "a_value_name_that_is_longer_than_what_fits_into_the_per_thread_cache_entries";
+
+  cr_assert_neq(sd_handle, 0);
+  cr_assert_neq(handle, 0);
+  cr_assert_neq(sd_handle, handle);
+
+  for (gint i = 0; i < 3; i++)
+    {
+      cr_assert_eq(log_msg_get_value_handle(".SDATA.origin.ip"), sd_handle);
+      cr_assert_eq(log_msg_get_value_handle("some_value_name"), handle);
+      cr_assert_eq(log_msg_get_value_handle(long_name), log_msg_get_value_handle(long_name));
+    }
+
+  cr_assert(log_msg_is_handle_sdata(log_msg_get_value_handle(".SDATA.origin.ip")));
+  cr_assert_eq(log_msg_get_value_handle("MSG"), LM_V_MESSAGE);
+  cr_assert_eq(log_msg_get_value_handle("MESSAGE"), LM_V_MESSAGE);
+}
+
 Test(log_message, test_local_logmsg_created_with_the_right_flags_and_timestamps)
 {
   LogMessage *msg = log_msg_new_local();
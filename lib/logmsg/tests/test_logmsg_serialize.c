@@ -176,6 +176,24 @@ Test(logmsg_serialize, serialize)
   g_string_free(stream, TRUE);
 }
 
+Test(logmsg_serialize, serialize_and_deserialize_with_the_same_registry)
+{
+  GString *stream = g_string_new("");
+  SerializeArchive *sa = serialize_string_archive_new(stream);
+
+  LogMessage *msg = _create_message_to_be_serialized(RAW_MSG, strlen(RAW_MSG));
+  cr_assert(log_msg_serialize(msg, sa, LMSF_COMPACTION));
+  log_msg_unref(msg);
+
+  msg = log_msg_new_empty();
+  cr_assert(log_msg_deserialize(msg, sa), ERROR_MSG);
+  _check_deserialized_message_all_fields(msg);
+
+  log_msg_unref(msg);
+  serialize_archive_free(sa);
+  g_string_free(stream, TRUE);
+}
+
 static LogMessage *
 _create_message_to_be_serialized_with_ts_processed(const gchar *raw_msg, const int raw_msg_len, UnixTime *processed)
 {
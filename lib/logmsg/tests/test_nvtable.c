@@ -884,6 +884,27 @@ Test(nvtable, test_nvtable_clone_grows_the_cloned_structure)
   nv_table_unref(tab);
 }
 
+Test(nvtable, test_nvtable_clone_of_a_full_nvtable_has_room_for_the_additional_space)
+{
+  NVTable *tab, *tab_clone;
+  gchar value[32];
+
+  memset(value, 'x', sizeof(value));
+  tab = nv_table_new(STATIC_VALUES, STATIC_VALUES, 256);
+
+  NVHandle handle = DYN_HANDLE;
+  while (nv_table_add_value(tab, handle, DYN_NAME, strlen(DYN_NAME), value, sizeof(value), 0, NULL))
+    handle++;
+
+  tab_clone = nv_table_clone(tab, NV_ENTRY_DIRECT_SIZE(strlen(DYN_NAME), sizeof(value)) + sizeof(NVIndexEntry));
+  cr_assert(nv_table_add_value(tab_clone, handle, DYN_NAME, strlen(DYN_NAME), value, sizeof(value), 0, NULL),
+            "the cloned NVTable should have room for the value it was cloned for");
+  assert_nvtable(tab_clone, handle, value, sizeof(value));
+
+  nv_table_unref(tab_clone);
+  nv_table_unref(tab);
+}
+
 Test(nvtable, test_nvtable_clone_cannot_grow_nvtable_larger_than_nvtable_max_bytes)
 {
   NVTable *tab, *tab_clone;
@@ -37,7 +37,9 @@ log_pipe_forward_msg(LogPipe *self, LogMessage *msg, const LogPathOptions *path_
     }
   else
     {
-      log_msg_drop(msg, path_options, AT_PROCESSED);
+      /* end of the pipeline, not accounted as a drop */
+      log_msg_ack(msg, path_options, AT_PROCESSED);
+      log_msg_unref(msg);
     }
 }
 
@@ -84,6 +86,20 @@ _is_fastpath(LogPipe *self)
   return TRUE;
 }
 
+/* no tail call here, the profiler needs to regain control after queue() returns */
+static void
+log_pipe_queue_profiled(LogPipe *self, LogMessage *msg, const LogPathOptions *path_options)
+{
+  PipeProfilerFrame frame;
+
+  pipe_profiler_enter(self, &frame);
+  if (_is_fastpath(self))
+    self->queue(self, msg, path_options);
+  else
+    log_pipe_queue_slow_path(self, msg, path_options);
+  pipe_profiler_leave(&frame);
+}
+
 void
 log_pipe_queue(LogPipe *self, LogMessage *msg, const LogPathOptions *path_options)
 {
@@ -98,6 +114,12 @@ log_pipe_queue(LogPipe *self, LogMessage *msg, const LogPathOptions *path_option
         }
     }
 
+  if (G_UNLIKELY(self->flags & PIF_PROFILED))
+    {
+      log_pipe_queue_profiled(self, msg, path_options);
+      return;
+    }
+
   /* on the fastpath we can use tail call optimization, so we won't have a
    * series of log_pipe_queue() calls on the stack, it improves perf traces
    * if nothing else, but I believe it also helps locality by using a lot
@@ -31,6 +31,7 @@
 #include "cfg.h"
 #include "atomic.h"
 #include "messages.h"
+#include "profiler/pipe-profiler.h"
 
 /* notify code values */
 #define NC_CLOSE       1
@@ -74,6 +75,9 @@
 /* sync filterx state to message in right before calling queue() */
 #define PIF_SYNC_FILTERX_TO_MSG      0x0200
 
+/* invocations are counted and timed by the pipe profiler */
+#define PIF_PROFILED          0x0400
+
 /* private flags range, to be used by other LogPipe instances for their own purposes */
 
 #define PIF_PRIVATE(x)       ((x) << 16)
@@ -332,6 +336,7 @@ struct _LogPipe
   void (*free_fn)(LogPipe *self);
   void (*notify)(LogPipe *self, gint notify_code, gpointer user_data);
   GList *info;
+  LogPipeProfile *profile;
 };
 
 /*
@@ -385,6 +390,9 @@ log_pipe_init(LogPipe *s)
       if (!s->init || s->init(s))
         {
           s->flags |= PIF_INITIALIZED;
+          if ((s->flags & PIF_CONFIG_RELATED) && s->cfg &&
+              (s->cfg->stats_options.profile_sample_rate > 0 || s->cfg->stats_options.stack_sample_frequency > 0))
+            pipe_profiler_attach(s, s->cfg->stats_options.profile_sample_rate);
           return TRUE;
         }
       return FALSE;
@@ -400,6 +408,7 @@ log_pipe_deinit(LogPipe *s)
       if (!s->deinit || s->deinit(s))
         {
           s->flags &= ~PIF_INITIALIZED;
+          pipe_profiler_detach(s);
 
           if (s->post_deinit)
             s->post_deinit(s);
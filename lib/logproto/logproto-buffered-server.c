@@ -26,6 +26,7 @@
 #include "messages.h"
 #include "serialize.h"
 #include "compat/string.h"
+#include "memory-reservation.h"
 
 #include <errno.h>
 #include <unistd.h>
@@ -131,7 +132,7 @@ log_proto_buffered_server_convert_from_raw(LogProtoBufferedServer *self, const g
                   if (state->buffer_size > self->super.options->max_buffer_size)
                     state->buffer_size = self->super.options->max_buffer_size;
 
-                  self->buffer = g_realloc(self->buffer, state->buffer_size);
+                  self->buffer = reserved_realloc(self->buffer, state->buffer_size);
                 }
               else
                 {
@@ -193,7 +194,7 @@ log_proto_buffered_server_apply_state(LogProtoBufferedServer *self, PersistEntry
   if (!self->buffer)
     {
       gssize buffer_size = MAX(state->buffer_size, self->super.options->init_buffer_size);
-      self->buffer = g_malloc(buffer_size);
+      self->buffer = reserved_malloc(buffer_size);
       state->buffer_size = buffer_size;
     }
   state->pending_buffer_end = 0;
@@ -414,7 +415,7 @@ log_proto_buffered_server_convert_state(LogProtoBufferedServer *self, guint8 per
       if (!self->buffer || state->buffer_size < buffer_len)
         {
           gsize buffer_size = MAX(self->super.options->init_buffer_size, buffer_len);
-          self->buffer = g_realloc(self->buffer, buffer_size);
+          self->buffer = reserved_realloc(self->buffer, buffer_size);
         }
       serialize_archive_free(archive);
 
@@ -764,7 +765,7 @@ static inline void
 log_proto_buffered_server_allocate_buffer(LogProtoBufferedServer *self, LogProtoBufferedServerState *state)
 {
   state->buffer_size = self->super.options->init_buffer_size;
-  self->buffer = g_malloc(state->buffer_size);
+  self->buffer = reserved_malloc(state->buffer_size);
 }
 
 static inline gint
@@ -1066,7 +1067,7 @@ log_proto_buffered_server_free_method(LogProtoServer *s)
 
   log_transport_aux_data_destroy(&self->buffer_aux);
 
-  g_free(self->buffer);
+  reserved_free(self->buffer);
   if (self->state1)
     {
       g_free(self->state1);
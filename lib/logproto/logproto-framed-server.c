@@ -24,6 +24,7 @@
 #include "logproto-framed-server.h"
 #include "logproto.h"
 #include "messages.h"
+#include "memory-reservation.h"
 
 #include <errno.h>
 #include <ctype.h>
@@ -225,7 +226,7 @@ _ensure_buffer(LogProtoFramedServer *self)
     return;
 
   self->buffer_size = self->super.options->init_buffer_size;
-  self->buffer = g_malloc(self->buffer_size);
+  self->buffer = reserved_malloc(self->buffer_size);
 }
 
 static LogProtoFramedServerStateControl
@@ -418,7 +419,7 @@ static void
 log_proto_framed_server_free(LogProtoServer *s)
 {
   LogProtoFramedServer *self = (LogProtoFramedServer *) s;
-  g_free(self->buffer);
+  reserved_free(self->buffer);
 
   log_transport_aux_data_destroy(&self->buffer_aux);
   log_proto_server_free_method(s);
@@ -99,6 +99,8 @@ typedef struct _LogQueueFifo
   OverflowQueue backlog_queue; /* entries that were sent but not acked yet */
 
   gint log_fifo_size;
+  /* 0 means no byte based limit */
+  gsize log_fifo_size_bytes;
 
   struct
   {
@@ -122,12 +124,11 @@ typedef struct _LogQueueFifo
 static void
 iv_list_update_msg_size(LogQueueFifo *self, struct iv_list_head *head)
 {
-  LogMessage *msg;
   struct iv_list_head *ilh, *ilh2;
   iv_list_for_each_safe(ilh, ilh2, head)
   {
-    msg = iv_list_entry(ilh, LogMessageQueueNode, list)->msg;
-    log_queue_memory_usage_add(&self->super, log_msg_get_size(msg));
+    LogMessageQueueNode *node = iv_list_entry(ilh, LogMessageQueueNode, list);
+    log_queue_memory_usage_add(&self->super, log_msg_queue_node_get_size(node));
   }
 }
 
@@ -176,10 +177,26 @@ log_queue_fifo_keep_on_reload(LogQueue *s)
 }
 
 static inline void
-log_queue_fifo_drop_messages_from_input_queue(LogQueueFifo *self, InputQueue *input_queue, gint num_of_messages_to_drop)
+_drop_node_from_input_queue(LogQueueFifo *self, InputQueue *input_queue, LogMessageQueueNode *node)
 {
   LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+  LogMessage *msg = node->msg;
+
+  path_options.ack_needed = node->ack_needed;
+  path_options.flow_control_requested = node->flow_control_requested;
+
+  iv_list_del(&node->list);
+  input_queue->len--;
+  input_queue->non_flow_controlled_len--;
+  log_queue_dropped_messages_inc(&self->super);
+  log_msg_free_queue_node(node);
+
+  log_msg_drop(msg, &path_options, AT_PROCESSED);
+}
 
+static inline void
+log_queue_fifo_drop_messages_from_input_queue(LogQueueFifo *self, InputQueue *input_queue, gint num_of_messages_to_drop)
+{
   struct iv_list_head *item = input_queue->items.next;
   for (gint dropped = 0; dropped < num_of_messages_to_drop;)
     {
@@ -187,22 +204,10 @@ log_queue_fifo_drop_messages_from_input_queue(LogQueueFifo *self, InputQueue *in
 
       item = item->next;
 
-      path_options.ack_needed = node->ack_needed;
-      path_options.flow_control_requested = node->flow_control_requested;
-
-      if (path_options.flow_control_requested)
+      if (node->flow_control_requested)
         continue;
 
-      iv_list_del(&node->list);
-      input_queue->len--;
-      log_queue_dropped_messages_inc(&self->super);
-      log_msg_free_queue_node(node);
-
-      LogMessage *msg = node->msg;
-
-      input_queue->non_flow_controlled_len--;
-      log_msg_drop(msg, &path_options, AT_PROCESSED);
-
+      _drop_node_from_input_queue(self, input_queue, node);
       dropped++;
     }
 
@@ -212,6 +217,53 @@ log_queue_fifo_drop_messages_from_input_queue(LogQueueFifo *self, InputQueue *in
             evt_tag_str("persist_name", self->super.persist_name));
 }
 
+static inline gboolean
+_memory_limit_in_effect(LogQueueFifo *self)
+{
+  return self->log_fifo_size_bytes || log_queue_global_memory_limit_reached();
+}
+
+/* racy the same way as the length based check below, which is fine */
+static inline gboolean
+_memory_limit_reached(LogQueueFifo *self, gssize memory_usage, gsize msg_size)
+{
+  if (log_queue_global_memory_limit_reached())
+    return TRUE;
+
+  return self->log_fifo_size_bytes && (gsize) memory_usage + msg_size > self->log_fifo_size_bytes;
+}
+
+/* drops the non-flow-controlled messages that would not fit into the byte
+ * limits, flow-controlled ones are kept and throttle their sources instead */
+static void
+log_queue_fifo_drop_messages_over_memory_limit(LogQueueFifo *self, InputQueue *input_queue)
+{
+  struct iv_list_head *item, *next;
+  gssize memory_usage = log_queue_get_memory_usage(&self->super);
+  gint dropped = 0;
+
+  iv_list_for_each_safe(item, next, &input_queue->items)
+  {
+    LogMessageQueueNode *node = iv_list_entry(item, LogMessageQueueNode, list);
+    gsize msg_size = log_msg_queue_node_get_size(node);
+
+    if (!node->flow_control_requested && _memory_limit_reached(self, memory_usage, msg_size))
+      {
+        _drop_node_from_input_queue(self, input_queue, node);
+        dropped++;
+        continue;
+      }
+    memory_usage += msg_size;
+  }
+
+  if (dropped)
+    msg_debug("Destination queue memory limit reached, dropping messages",
+              evt_tag_long("log_fifo_size_bytes", self->log_fifo_size_bytes),
+              evt_tag_long("memory_usage", log_queue_get_memory_usage(&self->super)),
+              evt_tag_int("number_of_dropped_messages", dropped),
+              evt_tag_str("persist_name", self->super.persist_name));
+}
+
 static inline gboolean
 log_queue_fifo_calculate_num_of_messages_to_drop(LogQueueFifo *self, InputQueue *input_queue,
                                                  gint *num_of_messages_to_drop)
@@ -257,6 +309,9 @@ log_queue_fifo_move_input_unlocked(LogQueueFifo *self, gint thread_index)
       log_queue_fifo_drop_messages_from_input_queue(self, &self->input_queues[thread_index], num_of_messages_to_drop);
     }
 
+  if (_memory_limit_in_effect(self))
+    log_queue_fifo_drop_messages_over_memory_limit(self, &self->input_queues[thread_index]);
+
   log_queue_queued_messages_add(&self->super, self->input_queues[thread_index].len);
   iv_list_update_msg_size(self, &self->input_queues[thread_index].items);
 
@@ -292,10 +347,16 @@ log_queue_fifo_move_input(gpointer user_data)
 
 /* lock must be held */
 static inline gboolean
-_message_has_to_be_dropped(LogQueueFifo *self, const LogPathOptions *path_options)
+_message_has_to_be_dropped(LogQueueFifo *self, LogMessage *msg, const LogPathOptions *path_options)
 {
-  return !path_options->flow_control_requested
-         && log_queue_fifo_get_non_flow_controlled_length(self) >= self->log_fifo_size;
+  if (path_options->flow_control_requested)
+    return FALSE;
+
+  if (log_queue_fifo_get_non_flow_controlled_length(self) >= self->log_fifo_size)
+    return TRUE;
+
+  return _memory_limit_in_effect(self)
+         && _memory_limit_reached(self, log_queue_get_memory_usage(&self->super), log_msg_get_size(msg));
 }
 
 /**
@@ -368,7 +429,7 @@ log_queue_fifo_push_tail(LogQueue *s, LogMessage *msg, const LogPathOptions *pat
 
   g_mutex_lock(&self->super.lock);
 
-  if (_message_has_to_be_dropped(self, path_options))
+  if (_message_has_to_be_dropped(self, msg, path_options))
     {
       log_queue_dropped_messages_inc(&self->super);
       g_mutex_unlock(&self->super.lock);
@@ -394,7 +455,7 @@ log_queue_fifo_push_tail(LogQueue *s, LogMessage *msg, const LogPathOptions *pat
   log_queue_push_notify(&self->super);
   log_queue_queued_messages_inc(&self->super);
 
-  log_queue_memory_usage_add(&self->super, log_msg_get_size(msg));
+  log_queue_memory_usage_add(&self->super, log_msg_queue_node_get_size(node));
   g_mutex_unlock(&self->super.lock);
 
   log_msg_unref(msg);
@@ -479,7 +540,7 @@ log_queue_fifo_pop_head(LogQueue *s, LogPathOptions *path_options)
       return NULL;
     }
   log_queue_queued_messages_dec(&self->super);
-  log_queue_memory_usage_sub(&self->super, log_msg_get_size(msg));
+  log_queue_memory_usage_sub(&self->super, log_msg_queue_node_get_size(node));
 
   /* push to backlog */
   log_msg_ref(msg);
@@ -578,7 +639,7 @@ log_queue_fifo_rewind_backlog(LogQueue *s, guint rewind_count)
         }
 
       log_queue_queued_messages_inc(&self->super);
-      log_queue_memory_usage_add(&self->super, log_msg_get_size(node->msg));
+      log_queue_memory_usage_add(&self->super, log_msg_queue_node_get_size(node));
     }
 }
 
@@ -715,6 +776,14 @@ log_queue_fifo_new(gint log_fifo_size, const gchar *persist_name, gint stats_lev
   return &self->super;
 }
 
+void
+log_queue_fifo_set_memory_limit(LogQueue *s, gsize log_fifo_size_bytes)
+{
+  LogQueueFifo *self = (LogQueueFifo *) s;
+
+  self->log_fifo_size_bytes = log_fifo_size_bytes;
+}
+
 QueueType
 log_queue_fifo_get_type(void)
 {
@@ -31,6 +31,8 @@ LogQueue *log_queue_fifo_new(gint log_fifo_size, const gchar *persist_name, gint
                              StatsClusterKeyBuilder *driver_sck_builder,
                              StatsClusterKeyBuilder *queue_sck_builder);
 
+void log_queue_fifo_set_memory_limit(LogQueue *s, gsize log_fifo_size_bytes);
+
 QueueType log_queue_fifo_get_type(void);
 
 #endif
@@ -28,11 +28,19 @@
 #include "messages.h"
 #include "timeutils/misc.h"
 
+/* bytes held by all queues of the process, and the limit above which
+ * sources are paused and non-flow-controlled messages are dropped (0 is
+ * unlimited) */
+static atomic_gssize log_queue_global_memory_usage;
+static gsize log_queue_global_memory_limit;
+
 void
 log_queue_memory_usage_add(LogQueue *self, gsize value)
 {
   stats_counter_add(self->metrics.shared.memory_usage, value);
   stats_counter_add(self->metrics.owned.memory_usage, value);
+  atomic_gssize_add(&self->memory_usage, value);
+  atomic_gssize_add(&log_queue_global_memory_usage, value);
 }
 
 void
@@ -40,6 +48,27 @@ log_queue_memory_usage_sub(LogQueue *self, gsize value)
 {
   stats_counter_sub(self->metrics.shared.memory_usage, value);
   stats_counter_sub(self->metrics.owned.memory_usage, value);
+  atomic_gssize_sub(&self->memory_usage, value);
+  atomic_gssize_sub(&log_queue_global_memory_usage, value);
+}
+
+void
+log_queue_set_global_memory_limit(gsize limit)
+{
+  log_queue_global_memory_limit = limit;
+}
+
+gboolean
+log_queue_global_memory_limit_reached(void)
+{
+  return log_queue_global_memory_limit &&
+         atomic_gssize_get(&log_queue_global_memory_usage) >= (gssize) log_queue_global_memory_limit;
+}
+
+gssize
+log_queue_get_global_memory_usage(void)
+{
+  return atomic_gssize_get(&log_queue_global_memory_usage);
 }
 
 void
@@ -317,7 +346,10 @@ _unregister_shared_counters(LogQueue *self)
 
     if (self->metrics.shared.memory_usage_sc_key)
       {
-        log_queue_memory_usage_sub(self, stats_counter_get(self->metrics.owned.memory_usage));
+        /* not via log_queue_memory_usage_sub(), the global usage is released when the queue is freed */
+        gsize owned_memory_usage = stats_counter_get(self->metrics.owned.memory_usage);
+        stats_counter_sub(self->metrics.shared.memory_usage, owned_memory_usage);
+        stats_counter_sub(self->metrics.owned.memory_usage, owned_memory_usage);
         stats_unregister_counter(self->metrics.shared.memory_usage_sc_key, SC_TYPE_SINGLE_VALUE,
                                  &self->metrics.shared.memory_usage);
 
@@ -374,6 +406,7 @@ log_queue_init_instance(LogQueue *self, const gchar *persist_name, gint stats_le
 void
 log_queue_free_method(LogQueue *self)
 {
+  atomic_gssize_sub(&log_queue_global_memory_usage, log_queue_get_memory_usage(self));
   _unregister_counters(self);
   g_mutex_clear(&self->lock);
   g_free(self->persist_name);
@@ -69,6 +69,8 @@ struct _LogQueue
   gchar *persist_name;
 
   LogQueueMetrics metrics;
+  /* bytes of messages held by the queue, maintained regardless of stats-level() */
+  atomic_gssize memory_usage;
 
   GMutex lock;
   LogQueuePushNotifyFunc parallel_push_notify;
@@ -201,9 +203,19 @@ log_queue_has_type(LogQueue *self, QueueType type)
   return g_strcmp0(self->type, type) == 0;
 }
 
+static inline gssize
+log_queue_get_memory_usage(LogQueue *self)
+{
+  return atomic_gssize_get(&self->memory_usage);
+}
+
 void log_queue_memory_usage_add(LogQueue *self, gsize value);
 void log_queue_memory_usage_sub(LogQueue *self, gsize value);
 
+void log_queue_set_global_memory_limit(gsize limit);
+gboolean log_queue_global_memory_limit_reached(void);
+gssize log_queue_get_global_memory_usage(void);
+
 void log_queue_queued_messages_add(LogQueue *self, gsize value);
 void log_queue_queued_messages_sub(LogQueue *self, gsize value);
 void log_queue_queued_messages_inc(LogQueue *self);
@@ -34,6 +34,7 @@
 #include "timeutils/misc.h"
 #include "compat/time.h"
 #include "scratch-buffers.h"
+#include "logqueue.h"
 
 #include <string.h>
 #include <unistd.h>
@@ -552,11 +553,10 @@ log_source_deinit(LogPipe *s)
   return TRUE;
 }
 
-void
-log_source_post(LogSource *self, LogMessage *msg)
+static void
+_queue_reserved_message(LogSource *self, LogMessage *msg)
 {
   LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
-  gint old_window_size;
 
   ack_tracker_track_msg(self->ack_tracker, msg);
 
@@ -566,10 +566,21 @@ log_source_post(LogSource *self, LogMessage *msg)
   log_msg_add_ack(msg, &path_options);
   msg->ack_func = log_source_msg_ack;
 
-  old_window_size = window_size_counter_sub(&self->window_size, 1, NULL);
-  stats_counter_sub(self->metrics.stat_window_size, 1);
+  ScratchBuffersMarker mark;
+  scratch_buffers_mark(&mark);
+  log_pipe_queue(&self->super, msg, &path_options);
+  scratch_buffers_reclaim_marked(mark);
+}
 
-  if (G_UNLIKELY(old_window_size == 1))
+static void
+_reserve_window(LogSource *self, gsize num_msgs)
+{
+  gsize old_window_size;
+
+  old_window_size = window_size_counter_sub(&self->window_size, num_msgs, NULL);
+  stats_counter_sub(self->metrics.stat_window_size, num_msgs);
+
+  if (G_UNLIKELY(old_window_size == num_msgs))
     {
       msg_debug("Source has been suspended",
                 log_pipe_location_tag(&self->super),
@@ -580,16 +591,40 @@ log_source_post(LogSource *self, LogMessage *msg)
    * NOTE: this assertion validates that the source is not overflowing its
    * own flow-control window size, decreased above, by the atomic statement.
    *
-   * If the _old_ value is zero, that means that the decrement operation
-   * above has decreased the value to -1.
+   * If the _old_ value is smaller than the batch, that means that the
+   * decrement operation above has decreased the value below zero.
    */
 
-  g_assert(old_window_size > 0);
+  g_assert(old_window_size >= num_msgs);
 
-  ScratchBuffersMarker mark;
-  scratch_buffers_mark(&mark);
-  log_pipe_queue(&self->super, msg, &path_options);
-  scratch_buffers_reclaim_marked(mark);
+  /* byte based backpressure: the queues of the process hold more than
+   * queue-memory-limit(), pause reading until the next acknowledgement,
+   * which at the latest arrives for this message */
+  if (G_UNLIKELY(log_queue_global_memory_limit_reached()))
+    log_source_flow_control_suspend(self);
+}
+
+void
+log_source_post(LogSource *self, LogMessage *msg)
+{
+  _reserve_window(self, 1);
+  _queue_reserved_message(self, msg);
+}
+
+/*
+ * Post num_msgs messages, taking their window space in one go. The caller
+ * must make sure that the window can hold the whole batch, see
+ * log_source_get_free_window_size().
+ */
+void
+log_source_post_batch(LogSource *self, LogMessage **msgs, gsize num_msgs)
+{
+  if (num_msgs == 0)
+    return;
+
+  _reserve_window(self, num_msgs);
+  for (gsize i = 0; i < num_msgs; i++)
+    _queue_reserved_message(self, msgs[i]);
 }
 
 static void
@@ -114,6 +114,16 @@ log_source_free_to_send(LogSource *self)
   return !window_size_counter_suspended(&self->window_size);
 }
 
+/* the number of messages that can be posted without overflowing the window */
+static inline gsize
+log_source_get_free_window_size(LogSource *self)
+{
+  gboolean suspended;
+  gsize window_size = window_size_counter_get(&self->window_size, &suspended);
+
+  return suspended ? 0 : window_size;
+}
+
 static inline gsize
 log_source_get_init_window_size(LogSource *self)
 {
@@ -132,6 +142,7 @@ gboolean log_source_init(LogPipe *s);
 gboolean log_source_deinit(LogPipe *s);
 
 void log_source_post(LogSource *self, LogMessage *msg);
+void log_source_post_batch(LogSource *self, LogMessage **msgs, gsize num_msgs);
 
 void log_source_set_options(LogSource *self, LogSourceOptions *options, const gchar *stats_id,
                             StatsClusterKeyBuilder *kb, gboolean threaded, LogExprNode *expr_node);
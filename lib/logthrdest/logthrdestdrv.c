@@ -809,6 +809,7 @@ log_threaded_dest_worker_start(LogThreadedDestWorker *self)
             evt_tag_str("driver", self->owner->super.super.id),
             log_expr_node_location_tag(self->owner->super.super.super.expr_node));
 
+  main_loop_threaded_worker_set_cpu_affinity(&self->thread, self->owner->worker_cpu_affinity);
   return main_loop_threaded_worker_start(&self->thread);
 }
 
@@ -1025,6 +1026,21 @@ log_threaded_dest_driver_set_num_workers(LogDriver *s, gint num_workers)
   self->num_workers = num_workers;
 }
 
+gboolean
+log_threaded_dest_driver_set_worker_cpus(LogDriver *s, const gchar *cpu_list, GError **error)
+{
+  LogThreadedDestDriver *self = (LogThreadedDestDriver *) s;
+  CpuAffinity *cpu_affinity = cpu_affinity_new(cpu_list, error);
+
+  if (!cpu_affinity)
+    return FALSE;
+
+  if (self->worker_cpu_affinity)
+    cpu_affinity_free(self->worker_cpu_affinity);
+  self->worker_cpu_affinity = cpu_affinity;
+  return TRUE;
+}
+
 void
 log_threaded_dest_driver_set_worker_partition_key_ref(LogDriver *s, LogTemplate *key)
 {
@@ -1483,6 +1499,8 @@ log_threaded_dest_driver_free(LogPipe *s)
 
   g_free(self->workers);
   log_template_unref(self->worker_partition_key);
+  if (self->worker_cpu_affinity)
+    cpu_affinity_free(self->worker_cpu_affinity);
   log_dest_driver_free((LogPipe *)self);
 }
 
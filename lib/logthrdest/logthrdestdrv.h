@@ -185,6 +185,7 @@ struct _LogThreadedDestDriver
 
   gboolean flush_on_key_change;
   LogTemplate *worker_partition_key;
+  CpuAffinity *worker_cpu_affinity;
   gint stats_source;
 
   /* this counter is not thread safe if there are multiple worker threads,
@@ -316,6 +317,7 @@ void log_threaded_dest_driver_free(LogPipe *s);
 
 void log_threaded_dest_driver_set_max_retries_on_error(LogDriver *s, gint max_retries);
 void log_threaded_dest_driver_set_num_workers(LogDriver *s, gint num_workers);
+gboolean log_threaded_dest_driver_set_worker_cpus(LogDriver *s, const gchar *cpu_list, GError **error);
 void log_threaded_dest_driver_set_worker_partition_key_ref(LogDriver *s, LogTemplate *key);
 void log_threaded_dest_driver_set_flush_on_worker_key_change(LogDriver *s, gboolean f);
 void log_threaded_dest_driver_set_batch_lines(LogDriver *s, gint batch_lines);
@@ -347,17 +347,37 @@ log_threaded_source_driver_free_method(LogPipe *s)
 
   g_free(self->transport_name);
   log_threaded_source_worker_options_destroy(&self->worker_options);
+  if (self->worker_cpu_affinity)
+    cpu_affinity_free(self->worker_cpu_affinity);
 
   log_src_driver_free(s);
 }
 
+gboolean
+log_threaded_source_driver_set_worker_cpus(LogDriver *s, const gchar *cpu_list, GError **error)
+{
+  LogThreadedSourceDriver *self = (LogThreadedSourceDriver *) s;
+  CpuAffinity *cpu_affinity = cpu_affinity_new(cpu_list, error);
+
+  if (!cpu_affinity)
+    return FALSE;
+
+  if (self->worker_cpu_affinity)
+    cpu_affinity_free(self->worker_cpu_affinity);
+  self->worker_cpu_affinity = cpu_affinity;
+  return TRUE;
+}
+
 gboolean
 log_threaded_source_driver_start_workers(LogPipe *s)
 {
   LogThreadedSourceDriver *self = (LogThreadedSourceDriver *) s;
 
   for (size_t i = 0; i < self->num_workers; i++)
-    g_assert(main_loop_threaded_worker_start(&self->workers[i]->thread));
+    {
+      main_loop_threaded_worker_set_cpu_affinity(&self->workers[i]->thread, self->worker_cpu_affinity);
+      g_assert(main_loop_threaded_worker_start(&self->workers[i]->thread));
+    }
 
   return TRUE;
 }
@@ -451,6 +471,76 @@ log_threaded_source_worker_blocking_post(LogThreadedSourceWorker *self, LogMessa
   wakeup_cond_unlock(&self->wakeup_cond);
 }
 
+static gsize
+_post_batch_chunk(LogThreadedSourceWorker *self, LogMessage **msgs, gsize num_msgs)
+{
+  gsize chunk_size = MIN(num_msgs, log_source_get_free_window_size(&self->super));
+
+  for (gsize i = 0; i < chunk_size; i++)
+    {
+      msg_debug("Incoming log message",
+                evt_tag_str("input", log_msg_get_value(msgs[i], LM_V_MESSAGE, NULL)),
+                evt_tag_str("driver", self->control->super.super.id),
+                evt_tag_int("worker_index", self->worker_index),
+                evt_tag_msg_reference(msgs[i]));
+      _apply_message_attributes(self->control, msgs[i]);
+    }
+
+  log_source_post_batch(&self->super, msgs, chunk_size);
+  return chunk_size;
+}
+
+/*
+ * Posts as many messages of the batch as the window allows and returns their
+ * number, the rest remain owned by the caller. With auto_close_batches, the
+ * batch is closed once, after the last message.
+ */
+gsize
+log_threaded_source_worker_post_batch(LogThreadedSourceWorker *self, LogMessage **msgs, gsize num_msgs)
+{
+  gsize posted = _post_batch_chunk(self, msgs, num_msgs);
+
+  if (self->control->auto_close_batches && posted > 0)
+    log_threaded_source_worker_close_batch(self);
+
+  return posted;
+}
+
+/*
+ * Posts the whole batch, suspending whenever the window is exhausted.  It
+ * only returns early when the worker is being terminated, in that case the
+ * messages not posted remain owned by the caller.
+ */
+gsize
+log_threaded_source_worker_blocking_post_batch(LogThreadedSourceWorker *self, LogMessage **msgs, gsize num_msgs)
+{
+  gsize posted = 0;
+
+  while (TRUE)
+    {
+      posted += _post_batch_chunk(self, &msgs[posted], num_msgs - posted);
+
+      if (posted == num_msgs && log_threaded_source_worker_free_to_send(self))
+        break;
+
+      log_threaded_source_worker_close_batch(self);
+
+      /* see log_threaded_source_worker_blocking_post() about the locking */
+      wakeup_cond_lock(&self->wakeup_cond);
+      if (!log_threaded_source_worker_free_to_send(self))
+        _worker_suspend(self);
+      wakeup_cond_unlock(&self->wakeup_cond);
+
+      if (posted == num_msgs || self->under_termination)
+        return posted;
+    }
+
+  if (self->control->auto_close_batches)
+    log_threaded_source_worker_close_batch(self);
+
+  return posted;
+}
+
 void
 log_threaded_source_driver_set_transport_name(LogThreadedSourceDriver *self, const gchar *transport_name)
 {
@@ -74,6 +74,7 @@ struct _LogThreadedSourceDriver
   LogThreadedSourceWorkerOptions worker_options;
   LogThreadedSourceWorker **workers;
   gint num_workers;
+  CpuAffinity *worker_cpu_affinity;
   gboolean auto_close_batches;
   gchar *transport_name;
   gsize transport_name_len;
@@ -92,6 +93,7 @@ void log_threaded_source_driver_init_instance(LogThreadedSourceDriver *self, Glo
 gboolean log_threaded_source_driver_init_method(LogPipe *s);
 gboolean log_threaded_source_driver_deinit_method(LogPipe *s);
 void log_threaded_source_driver_free_method(LogPipe *s);
+gboolean log_threaded_source_driver_set_worker_cpus(LogDriver *s, const gchar *cpu_list, GError **error);
 
 static inline void
 log_threaded_source_driver_set_num_workers(LogDriver *s, gint num_workers)
@@ -126,9 +128,11 @@ void log_threaded_source_worker_close_batch(LogThreadedSourceWorker *self);
 
 /* blocking API */
 void log_threaded_source_worker_blocking_post(LogThreadedSourceWorker *self, LogMessage *msg);
+gsize log_threaded_source_worker_blocking_post_batch(LogThreadedSourceWorker *self, LogMessage **msgs, gsize num_msgs);
 
 /* non-blocking API, use it wisely (thread boundaries); call close_batch() at least before suspending */
 void log_threaded_source_worker_post(LogThreadedSourceWorker *self, LogMessage *msg);
+gsize log_threaded_source_worker_post_batch(LogThreadedSourceWorker *self, LogMessage **msgs, gsize num_msgs);
 gboolean log_threaded_source_worker_free_to_send(LogThreadedSourceWorker *self);
 
 #endif
@@ -40,6 +40,8 @@ typedef struct _TestThreadedSourceDriver
   gboolean suspended;
   gboolean exit_requested;
   gboolean blocking_post;
+  gboolean batch_post;
+  gsize num_of_messages_posted;
 } TestThreadedSourceDriver;
 
 MainLoopOptions main_loop_options = {0};
@@ -48,6 +50,7 @@ MainLoop *main_loop;
 static void _worker_request_exit(LogThreadedSourceWorker *s);
 static void _worker_run_simple(LogThreadedSourceWorker *s);
 static void _worker_run_using_blocking_posts(LogThreadedSourceWorker *s);
+static void _worker_run_using_batch_posts(LogThreadedSourceWorker *s);
 
 static const gchar *
 _generate_persist_name(const LogPipe *s)
@@ -101,7 +104,9 @@ _construct_worker(LogThreadedSourceDriver *s, gint worker_index)
   log_threaded_source_worker_init_instance(worker, s, worker_index);
 
   worker->request_exit = _worker_request_exit;
-  if (self->blocking_post)
+  if (self->batch_post)
+    worker->run = _worker_run_using_batch_posts;
+  else if (self->blocking_post)
     worker->run = _worker_run_using_blocking_posts;
   else
     worker->run = _worker_run_simple;
@@ -203,6 +208,28 @@ _worker_run_simple(LogThreadedSourceWorker *s)
     }
 }
 
+static void
+_worker_run_using_batch_posts(LogThreadedSourceWorker *s)
+{
+  TestThreadedSourceDriver *driver = (TestThreadedSourceDriver *) s->control;
+  LogMessage **msgs = g_new(LogMessage *, driver->num_of_messages_to_generate);
+
+  for (gint i = 0; i < driver->num_of_messages_to_generate; ++i)
+    msgs[i] = create_sample_message();
+
+  if (driver->blocking_post)
+    driver->num_of_messages_posted = log_threaded_source_worker_blocking_post_batch(s, msgs,
+                                     driver->num_of_messages_to_generate);
+  else
+    driver->num_of_messages_posted = log_threaded_source_worker_post_batch(s, msgs,
+                                     driver->num_of_messages_to_generate);
+
+  driver->suspended = !log_threaded_source_worker_free_to_send(s);
+  for (gint i = driver->num_of_messages_posted; i < driver->num_of_messages_to_generate; ++i)
+    log_msg_unref(msgs[i]);
+  g_free(msgs);
+}
+
 static void
 _worker_request_exit(LogThreadedSourceWorker *s)
 {
@@ -252,3 +279,42 @@ Test(logthrsourcedrv, test_threaded_source_suspend)
 
   destroy_test_threaded_source(s);
 }
+
+Test(logthrsourcedrv, test_threaded_source_blocking_post_batch_larger_than_window)
+{
+  TestThreadedSourceDriver *s = create_threaded_source_blocking();
+
+  s->batch_post = TRUE;
+  s->num_of_messages_to_generate = 12;
+  s->super.worker_options.super.init_window_size = 5;
+
+  start_test_threaded_source(s);
+  request_exit_and_wait_for_stop(s);
+
+  StatsCounterItem *recvd_messages = _get_source(s)->metrics.recvd_messages;
+  cr_assert(stats_counter_get(recvd_messages) == 12);
+  cr_assert(s->num_of_messages_posted == 12);
+  cr_assert_not(s->suspended);
+
+  destroy_test_threaded_source(s);
+}
+
+Test(logthrsourcedrv, test_threaded_source_post_batch_stops_at_window)
+{
+  TestThreadedSourceDriver *s = create_threaded_source();
+
+  s->batch_post = TRUE;
+  s->num_of_messages_to_generate = 8;
+  s->super.worker_options.super.init_window_size = 5;
+  s->super.super.super.super.queue = _do_not_ack_messages;
+
+  start_test_threaded_source(s);
+  request_exit_and_wait_for_stop(s);
+
+  StatsCounterItem *recvd_messages = _get_source(s)->metrics.recvd_messages;
+  cr_assert(stats_counter_get(recvd_messages) == 5);
+  cr_assert(s->num_of_messages_posted == 5);
+  cr_assert(s->suspended);
+
+  destroy_test_threaded_source(s);
+}
@@ -0,0 +1,1044 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "lookup-table.h"
+#include "resolved-configurable-paths.h"
+#include "timeutils/misc.h"
+#include "messages.h"
+
+#include <iv.h>
+#include <iv_event.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#define LOOKUP_TABLE_MAGIC "SNGLKUP"
+#define LOOKUP_TABLE_VERSION 1
+#define LOOKUP_TABLE_BYTE_ORDER_MARK 0x01020304
+#define LOOKUP_TABLE_MAX_ENTRIES (G_MAXUINT32 / 2)
+#define LOOKUP_TABLE_POLL_FREQ 60
+
+typedef struct _LookupTableStamp
+{
+  gint64 mtime;
+  gint64 ctime;
+  gint64 size;
+  guint64 ino;
+  guint64 dev;
+} LookupTableStamp;
+
+/*
+ * The compiled image is used in place, it is only valid on hosts with the
+ * same byte order and type sizes, which the header checks on load.
+ */
+typedef struct _LookupTableHeader
+{
+  gchar magic[8];
+  guint32 version;
+  guint32 format;
+  guint32 byte_order;
+  guint32 header_size;
+  LookupTableStamp source;
+  guint64 num_entries;
+  guint64 num_slots;
+  guint64 entries_offset;
+  guint64 slots_offset;
+  guint64 strings_offset;
+  guint64 image_size;
+} LookupTableHeader;
+
+typedef struct _LookupTableEntry
+{
+  /* relative to the string area, the value immediately follows the key */
+  guint64 offset;
+  guint32 key_len;
+  guint32 value_len;
+} LookupTableEntry;
+
+typedef struct _LookupTableSlot
+{
+  /* index of the entry + 1, 0 marks an empty slot */
+  guint32 entry;
+  /* upper half of the hash, so that collisions rarely touch the strings */
+  guint32 tag;
+} LookupTableSlot;
+
+struct _LookupTable
+{
+  GAtomicCounter ref_cnt;
+  gchar *image;
+  gsize image_size;
+  gboolean mapped;
+
+  const LookupTableHeader *header;
+  const LookupTableEntry *entries;
+  const LookupTableSlot *slots;
+  const gchar *strings;
+};
+
+GQuark
+lookup_table_error_quark(void)
+{
+  return g_quark_from_static_string("lookup-table-error-quark");
+}
+
+/* the hash is part of the compiled format, it must not change without bumping the version */
+static guint64
+_hash_key(const gchar *key, gsize key_len)
+{
+  guint64 hash = 0xcbf29ce484222325ULL;
+
+  for (gsize i = 0; i < key_len; i++)
+    {
+      hash ^= (guchar) key[i];
+      hash *= 0x100000001b3ULL;
+    }
+
+  /* FNV-1a mixes the low bits poorly, which are the ones selecting the slot */
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+static guint64
+_calculate_num_slots(guint64 num_entries)
+{
+  guint64 num_slots = 1;
+
+  /* keep the load factor below 2/3, so that probe sequences stay short */
+  while (num_slots < num_entries + num_entries / 2 + 1)
+    num_slots <<= 1;
+  return num_slots;
+}
+
+static gboolean
+_stat_source(const gchar *filename, LookupTableStamp *stamp, GError **error)
+{
+  struct stat st;
+
+  if (stat(filename, &st) < 0)
+    {
+      g_set_error(error, LOOKUP_TABLE_ERROR, LOOKUP_TABLE_ERROR_FAILED,
+                  "Error opening lookup table file: %s (%s)", filename, g_strerror(errno));
+      return FALSE;
+    }
+
+  memset(stamp, 0, sizeof(*stamp));
+  stamp->mtime = st.st_mtime;
+  stamp->ctime = st.st_ctime;
+  stamp->size = st.st_size;
+  stamp->ino = st.st_ino;
+  stamp->dev = st.st_dev;
+  return TRUE;
+}
+
+static const LookupTableEntry *
+_find_entry(LookupTable *self, const gchar *key, gsize key_len)
+{
+  guint64 hash = _hash_key(key, key_len);
+  guint64 mask = self->header->num_slots - 1;
+  guint32 tag = hash >> 32;
+
+  /* there is always at least one empty slot, so the probe terminates */
+  for (guint64 i = hash & mask; self->slots[i].entry; i = (i + 1) & mask)
+    {
+      const LookupTableSlot *slot = &self->slots[i];
+
+      if (slot->tag != tag)
+        continue;
+
+      const LookupTableEntry *entry = &self->entries[slot->entry - 1];
+      if (entry->key_len == key_len && memcmp(self->strings + entry->offset, key, key_len) == 0)
+        return entry;
+    }
+  return NULL;
+}
+
+gboolean
+lookup_table_lookup(LookupTable *self, const gchar *key, gsize key_len, const gchar **value, gsize *value_len)
+{
+  const LookupTableEntry *entry = _find_entry(self, key, key_len);
+
+  if (!entry)
+    return FALSE;
+
+  if (value)
+    *value = self->strings + entry->offset + entry->key_len;
+  if (value_len)
+    *value_len = entry->value_len;
+  return TRUE;
+}
+
+gsize
+lookup_table_get_size(LookupTable *self)
+{
+  return self->header->num_entries;
+}
+
+gboolean
+lookup_table_is_mapped(LookupTable *self)
+{
+  return self->mapped;
+}
+
+static gboolean
+_header_is_valid(const LookupTableHeader *header, gsize image_size)
+{
+  if (image_size < sizeof(*header))
+    return FALSE;
+
+  if (memcmp(header->magic, LOOKUP_TABLE_MAGIC, sizeof(header->magic)) != 0
+      || header->version != LOOKUP_TABLE_VERSION
+      || header->byte_order != LOOKUP_TABLE_BYTE_ORDER_MARK
+      || header->header_size != sizeof(*header)
+      || header->image_size != image_size)
+    return FALSE;
+
+  if (header->num_entries > LOOKUP_TABLE_MAX_ENTRIES
+      || header->num_slots <= header->num_entries
+      || header->num_slots > 2 * (guint64) LOOKUP_TABLE_MAX_ENTRIES + 2
+      || (header->num_slots & (header->num_slots - 1)) != 0)
+    return FALSE;
+
+  return header->entries_offset == sizeof(*header)
+         && header->slots_offset == header->entries_offset + header->num_entries * sizeof(LookupTableEntry)
+         && header->strings_offset == header->slots_offset + header->num_slots * sizeof(LookupTableSlot)
+         && header->strings_offset <= image_size;
+}
+
+/* compiled files are read back from disk, make sure a damaged one cannot cause out of bounds reads */
+static gboolean
+_image_is_consistent(LookupTable *self)
+{
+  guint64 strings_len = self->header->image_size - self->header->strings_offset;
+
+  for (guint64 i = 0; i < self->header->num_entries; i++)
+    {
+      const LookupTableEntry *entry = &self->entries[i];
+      if (entry->offset > strings_len || (guint64) entry->key_len + entry->value_len > strings_len - entry->offset)
+        return FALSE;
+    }
+
+  guint64 used_slots = 0;
+  for (guint64 i = 0; i < self->header->num_slots; i++)
+    {
+      if (!self->slots[i].entry)
+        continue;
+      if (self->slots[i].entry > self->header->num_entries)
+        return FALSE;
+      used_slots++;
+    }
+  return used_slots == self->header->num_entries;
+}
+
+static LookupTable *
+_table_new(gchar *image, gsize image_size, gboolean mapped)
+{
+  LookupTable *self = g_new0(LookupTable, 1);
+
+  g_atomic_counter_set(&self->ref_cnt, 1);
+  self->image = image;
+  self->image_size = image_size;
+  self->mapped = mapped;
+
+  self->header = (const LookupTableHeader *) image;
+  self->entries = (const LookupTableEntry *) (image + self->header->entries_offset);
+  self->slots = (const LookupTableSlot *) (image + self->header->slots_offset);
+  self->strings = image + self->header->strings_offset;
+  return self;
+}
+
+static void
+_table_free(LookupTable *self)
+{
+  if (self->mapped)
+    munmap(self->image, self->image_size);
+  else
+    g_free(self->image);
+  g_free(self);
+}
+
+LookupTable *
+lookup_table_ref(LookupTable *self)
+{
+  g_atomic_counter_inc(&self->ref_cnt);
+  return self;
+}
+
+void
+lookup_table_unref(LookupTable *self)
+{
+  if (self && g_atomic_counter_dec_and_test(&self->ref_cnt))
+    _table_free(self);
+}
+
+static LookupTable *
+_map_compiled_file(const gchar *compiled_filename, LookupTableFormat format, const LookupTableStamp *source)
+{
+  gint fd = open(compiled_filename, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (gsize) st.st_size < sizeof(LookupTableHeader))
+    {
+      close(fd);
+      return NULL;
+    }
+
+  gchar *image = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED)
+    return NULL;
+
+  const LookupTableHeader *header = (const LookupTableHeader *) image;
+  if (!_header_is_valid(header, st.st_size)
+      || header->format != format
+      || memcmp(&header->source, source, sizeof(*source)) != 0)
+    {
+      munmap(image, st.st_size);
+      return NULL;
+    }
+
+  LookupTable *self = _table_new(image, st.st_size, TRUE);
+  if (!_image_is_consistent(self))
+    {
+      msg_warning("Compiled lookup table is damaged, recompiling",
+                  evt_tag_str("compiled_file", compiled_filename));
+      _table_free(self);
+      return NULL;
+    }
+  return self;
+}
+
+typedef struct _LookupTableBuilder
+{
+  const gchar *source;
+  LookupTableFormat format;
+  /* offsets point into the source text while building */
+  GArray *entries;
+  LookupTableSlot *slots;
+  guint64 num_slots;
+  guint64 strings_len;
+} LookupTableBuilder;
+
+static guint64
+_count_lines(const gchar *text, gsize text_len)
+{
+  guint64 lines = 0;
+  const gchar *end = text + text_len;
+
+  for (const gchar *p = text; p < end; lines++)
+    {
+      const gchar *eol = memchr(p, '\n', end - p);
+      p = eol ? eol + 1 : end;
+    }
+  return lines;
+}
+
+static gboolean
+_builder_add_line(LookupTableBuilder *self, const gchar *line, gsize line_len)
+{
+  if (line_len > G_MAXUINT32)
+    return FALSE;
+
+  gsize key_len = line_len;
+  gsize value_len = 0;
+
+  if (self->format == LOOKUP_TABLE_FORMAT_TSV)
+    {
+      const gchar *tab = memchr(line, '\t', line_len);
+      if (tab)
+        {
+          key_len = tab - line;
+          value_len = line_len - key_len - 1;
+        }
+    }
+
+  guint64 hash = _hash_key(line, key_len);
+  guint64 mask = self->num_slots - 1;
+  guint64 i;
+
+  for (i = hash & mask; self->slots[i].entry; i = (i + 1) & mask)
+    {
+      const LookupTableEntry *entry = &g_array_index(self->entries, LookupTableEntry, self->slots[i].entry - 1);
+
+      if (self->slots[i].tag == (guint32) (hash >> 32)
+          && entry->key_len == key_len && memcmp(self->source + entry->offset, line, key_len) == 0)
+        return TRUE;
+    }
+
+  LookupTableEntry entry =
+  {
+    .offset = line - self->source,
+    .key_len = key_len,
+    .value_len = value_len,
+  };
+  g_array_append_val(self->entries, entry);
+
+  self->slots[i].entry = self->entries->len;
+  self->slots[i].tag = hash >> 32;
+  self->strings_len += key_len + value_len;
+  return TRUE;
+}
+
+static gboolean
+_builder_parse(LookupTableBuilder *self, const gchar *filename, gsize source_len, GError **error)
+{
+  const gchar *end = self->source + source_len;
+
+  for (const gchar *line = self->source; line < end; )
+    {
+      const gchar *eol = memchr(line, '\n', end - line);
+      gsize line_len = eol ? eol - line : end - line;
+
+      if (line_len > 0 && !_builder_add_line(self, line, line_len))
+        {
+          g_set_error(error, LOOKUP_TABLE_ERROR, LOOKUP_TABLE_ERROR_FAILED,
+                      "Error compiling lookup table, line too long: %s", filename);
+          return FALSE;
+        }
+      line = eol ? eol + 1 : end;
+    }
+  return TRUE;
+}
+
+static gchar *
+_builder_build_image(LookupTableBuilder *self, LookupTableFormat format, const LookupTableStamp *source,
+                     gsize *image_size)
+{
+  LookupTableHeader header =
+  {
+    .version = LOOKUP_TABLE_VERSION,
+    .format = format,
+    .byte_order = LOOKUP_TABLE_BYTE_ORDER_MARK,
+    .header_size = sizeof(LookupTableHeader),
+    .source = *source,
+    .num_entries = self->entries->len,
+    .num_slots = self->num_slots,
+  };
+  memcpy(header.magic, LOOKUP_TABLE_MAGIC, sizeof(header.magic));
+  header.entries_offset = sizeof(header);
+  header.slots_offset = header.entries_offset + header.num_entries * sizeof(LookupTableEntry);
+  header.strings_offset = header.slots_offset + header.num_slots * sizeof(LookupTableSlot);
+  header.image_size = header.strings_offset + self->strings_len;
+
+  gchar *image = g_malloc(header.image_size);
+  memcpy(image, &header, sizeof(header));
+  memcpy(image + header.slots_offset, self->slots, header.num_slots * sizeof(LookupTableSlot));
+
+  LookupTableEntry *entries = (LookupTableEntry *) (image + header.entries_offset);
+  gchar *strings = image + header.strings_offset;
+  guint64 offset = 0;
+  for (guint64 i = 0; i < header.num_entries; i++)
+    {
+      const LookupTableEntry *src = &g_array_index(self->entries, LookupTableEntry, i);
+      const gchar *key = self->source + src->offset;
+
+      entries[i] = *src;
+      entries[i].offset = offset;
+
+      memcpy(strings + offset, key, src->key_len);
+      offset += src->key_len;
+      if (src->value_len)
+        {
+          /* the value is separated from the key by a TAB in the source */
+          memcpy(strings + offset, key + src->key_len + 1, src->value_len);
+          offset += src->value_len;
+        }
+    }
+
+  *image_size = header.image_size;
+  return image;
+}
+
+static gboolean
+_write_compiled_file(const gchar *compiled_filename, const gchar *image, gsize image_size)
+{
+  /* unique, a cancelled background compilation may still be writing the same file */
+  gchar *tmp_filename = g_strdup_printf("%s.XXXXXX", compiled_filename);
+  gboolean success = FALSE;
+
+  gint fd = g_mkstemp_full(tmp_filename, O_WRONLY, 0600);
+  if (fd < 0)
+    goto exit;
+
+  const gchar *p = image;
+  gsize remaining = image_size;
+  while (remaining > 0)
+    {
+      gssize written = write(fd, p, remaining);
+      if (written < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          gint saved_errno = errno;
+          close(fd);
+          unlink(tmp_filename);
+          errno = saved_errno;
+          goto exit;
+        }
+      p += written;
+      remaining -= written;
+    }
+  if (close(fd) < 0 || rename(tmp_filename, compiled_filename) < 0)
+    {
+      gint saved_errno = errno;
+      unlink(tmp_filename);
+      errno = saved_errno;
+      goto exit;
+    }
+  success = TRUE;
+
+exit:
+  g_free(tmp_filename);
+  return success;
+}
+
+/* switch to the mapped version of a freshly compiled table, so that its pages can be shared and evicted */
+static LookupTable *
+_store_compiled_file(LookupTable *self, const gchar *filename, LookupTableFormat format,
+                     const LookupTableStamp *stamp, const gchar *compiled_filename)
+{
+  if (!_write_compiled_file(compiled_filename, self->image, self->image_size))
+    {
+      msg_debug("Error writing compiled lookup table, using it from memory",
+                evt_tag_str("file", filename),
+                evt_tag_str("compiled_file", compiled_filename),
+                evt_tag_error("error"));
+      return self;
+    }
+
+  LookupTable *mapped = _map_compiled_file(compiled_filename, format, stamp);
+  if (!mapped)
+    return self;
+
+  _table_free(self);
+  return mapped;
+}
+
+static LookupTable *
+_compile(const gchar *filename, LookupTableFormat format, const LookupTableStamp *stamp,
+         const gchar *compiled_filename, GError **error)
+{
+  gchar *source;
+  gsize source_len;
+
+  if (!g_file_get_contents(filename, &source, &source_len, error))
+    return NULL;
+
+  guint64 num_lines = _count_lines(source, source_len);
+  if (num_lines > LOOKUP_TABLE_MAX_ENTRIES)
+    {
+      g_set_error(error, LOOKUP_TABLE_ERROR, LOOKUP_TABLE_ERROR_FAILED,
+                  "Error compiling lookup table, too many entries: %s", filename);
+      g_free(source);
+      return NULL;
+    }
+
+  LookupTableBuilder builder =
+  {
+    .source = source,
+    .format = format,
+    .entries = g_array_sized_new(FALSE, FALSE, sizeof(LookupTableEntry), num_lines),
+    .num_slots = _calculate_num_slots(num_lines),
+  };
+  builder.slots = g_new0(LookupTableSlot, builder.num_slots);
+
+  LookupTable *self = NULL;
+  if (_builder_parse(&builder, filename, source_len, error))
+    {
+      gsize image_size;
+      gchar *image = _builder_build_image(&builder, format, stamp, &image_size);
+      self = _table_new(image, image_size, FALSE);
+    }
+
+  g_free(builder.slots);
+  g_array_free(builder.entries, TRUE);
+  g_free(source);
+
+  /* a file modified within the current second may change again without its stamp changing */
+  if (self && compiled_filename && stamp->mtime < time(NULL) - 1)
+    self = _store_compiled_file(self, filename, format, stamp, compiled_filename);
+
+  return self;
+}
+
+LookupTable *
+lookup_table_load(const gchar *filename, LookupTableFormat format, const gchar *compiled_filename, GError **error)
+{
+  LookupTableStamp stamp;
+
+  if (!_stat_source(filename, &stamp, error))
+    return NULL;
+
+  if (compiled_filename)
+    {
+      LookupTable *self = _map_compiled_file(compiled_filename, format, &stamp);
+      if (self)
+        {
+          msg_debug("Using compiled lookup table",
+                    evt_tag_str("file", filename),
+                    evt_tag_str("compiled_file", compiled_filename),
+                    evt_tag_long("entries", lookup_table_get_size(self)));
+          return self;
+        }
+    }
+
+  LookupTable *self = _compile(filename, format, &stamp, compiled_filename, error);
+  if (self)
+    msg_debug("Lookup table compiled",
+              evt_tag_str("file", filename),
+              evt_tag_long("entries", lookup_table_get_size(self)),
+              evt_tag_int("mapped", self->mapped));
+  return self;
+}
+
+typedef struct _LookupTableReload LookupTableReload;
+
+struct _LookupTableHandle
+{
+  gint ref_cnt;
+  gchar *key;
+  gchar *filename;
+  LookupTableFormat format;
+  gchar *compiled_filename;
+
+  /*
+   * Lookups take no lock: they register in the reader counter of the
+   * current epoch and use the table published at that point.  Publishing
+   * a new table flips the epoch, the replaced table is retired and freed
+   * as soon as the readers of the previous epoch are gone.  The rest of
+   * the fields are only used in the main thread.
+   */
+  LookupTable *table;
+  gint epoch;
+  gint readers[2];
+  LookupTable *retired;
+  /* compiled, but waiting for the retired table to be freed before it can be published */
+  LookupTable *pending;
+
+  LookupTableReload *reload;
+};
+
+/*
+ * A background compilation of a changed source file.  The thread only
+ * uses its own copy of the parameters, so when the handle is released in
+ * the meantime the reload is merely cancelled by clearing @handle, and it
+ * is freed once the thread has posted its completion.
+ */
+struct _LookupTableReload
+{
+  LookupTableHandle *handle;
+  gchar *filename;
+  LookupTableFormat format;
+  gchar *compiled_filename;
+
+  GThread *thread;
+  struct iv_event completed;
+  LookupTable *table;
+  GError *error;
+};
+
+/* handles are created, refreshed and released in the main thread only */
+static GHashTable *lookup_table_handles;
+static struct iv_timer lookup_table_poll_timer;
+static gint lookup_table_running_reloads;
+
+static gchar *
+_format_compiled_filename(const gchar *key)
+{
+  const gchar *persist_file = resolved_configurable_paths.persist_file;
+
+  if (!persist_file)
+    return NULL;
+
+  return g_strdup_printf("%s.lookup-%016" G_GINT64_MODIFIER "x", persist_file, _hash_key(key, strlen(key)));
+}
+
+static LookupTable *
+_handle_enter(LookupTableHandle *self, gint *epoch)
+{
+  while (TRUE)
+    {
+      gint current_epoch = g_atomic_int_get(&self->epoch);
+
+      g_atomic_int_inc(&self->readers[current_epoch]);
+      if (g_atomic_int_get(&self->epoch) == current_epoch)
+        {
+          *epoch = current_epoch;
+          return g_atomic_pointer_get(&self->table);
+        }
+      /* raced with a publish, the table we would see may already be retired */
+      g_atomic_int_add(&self->readers[current_epoch], -1);
+    }
+}
+
+static void
+_handle_leave(LookupTableHandle *self, gint epoch)
+{
+  g_atomic_int_add(&self->readers[epoch], -1);
+}
+
+static gboolean
+_handle_free_retired(LookupTableHandle *self)
+{
+  if (!self->retired)
+    return TRUE;
+
+  if (g_atomic_int_get(&self->readers[!self->epoch]) > 0)
+    return FALSE;
+
+  lookup_table_unref(self->retired);
+  self->retired = NULL;
+  return TRUE;
+}
+
+static void
+_handle_publish(LookupTableHandle *self, LookupTable *table)
+{
+  if (!_handle_free_retired(self))
+    {
+      lookup_table_unref(self->pending);
+      self->pending = table;
+      return;
+    }
+
+  lookup_table_unref(self->pending);
+  self->pending = NULL;
+
+  self->retired = self->table;
+  g_atomic_pointer_set(&self->table, table);
+  g_atomic_int_set(&self->epoch, !self->epoch);
+  _handle_free_retired(self);
+}
+
+static void
+_handle_publish_pending(LookupTableHandle *self)
+{
+  if (!self->pending || !_handle_free_retired(self))
+    return;
+
+  LookupTable *table = self->pending;
+  self->pending = NULL;
+  _handle_publish(self, table);
+}
+
+static LookupTable *
+_handle_get_latest_table(LookupTableHandle *self)
+{
+  return self->pending ? self->pending : self->table;
+}
+
+static gboolean
+_handle_source_changed(LookupTableHandle *self, gboolean *changed, GError **error)
+{
+  LookupTableStamp stamp;
+
+  if (!_stat_source(self->filename, &stamp, error))
+    return FALSE;
+
+  *changed = memcmp(&stamp, &_handle_get_latest_table(self)->header->source, sizeof(stamp)) != 0;
+  return TRUE;
+}
+
+static void
+_handle_reloaded(LookupTableHandle *self, LookupTable *table)
+{
+  _handle_publish(self, table);
+
+  msg_info("Lookup table file changed, reloaded",
+           evt_tag_str("file", self->filename),
+           evt_tag_long("entries", lookup_table_get_size(table)));
+}
+
+static gpointer
+_reload_thread(gpointer user_data)
+{
+  LookupTableReload *reload = (LookupTableReload *) user_data;
+
+  reload->table = lookup_table_load(reload->filename, reload->format, reload->compiled_filename, &reload->error);
+  iv_event_post(&reload->completed);
+  return NULL;
+}
+
+/* only called once the completion was posted, the thread is exiting */
+static void
+_reload_free(LookupTableReload *reload)
+{
+  g_thread_join(reload->thread);
+  iv_event_unregister(&reload->completed);
+  lookup_table_running_reloads--;
+
+  lookup_table_unref(reload->table);
+  g_clear_error(&reload->error);
+  g_free(reload->compiled_filename);
+  g_free(reload->filename);
+  g_free(reload);
+}
+
+static void
+_reload_completed(gpointer user_data)
+{
+  LookupTableReload *reload = (LookupTableReload *) user_data;
+  LookupTableHandle *handle = reload->handle;
+
+  if (!handle)
+    {
+      msg_debug("Background compilation of lookup table finished after its last user was gone, discarding it",
+                evt_tag_str("file", reload->filename));
+    }
+  else if (reload->table)
+    {
+      _handle_reloaded(handle, reload->table);
+      reload->table = NULL;
+    }
+  else
+    {
+      msg_error("Error reloading lookup table, keeping the current version",
+                evt_tag_str("file", handle->filename),
+                evt_tag_str("error", reload->error->message));
+    }
+
+  if (handle)
+    handle->reload = NULL;
+  _reload_free(reload);
+}
+
+static void
+_handle_start_reload(LookupTableHandle *self)
+{
+  if (self->reload)
+    return;
+
+  LookupTableReload *reload = g_new0(LookupTableReload, 1);
+  reload->handle = self;
+  reload->filename = g_strdup(self->filename);
+  reload->format = self->format;
+  reload->compiled_filename = g_strdup(self->compiled_filename);
+
+  IV_EVENT_INIT(&reload->completed);
+  reload->completed.cookie = reload;
+  reload->completed.handler = _reload_completed;
+  iv_event_register(&reload->completed);
+
+  msg_debug("Lookup table file changed, compiling it in the background",
+            evt_tag_str("file", self->filename));
+
+  self->reload = reload;
+  lookup_table_running_reloads++;
+  reload->thread = g_thread_new("lookup-table", _reload_thread, reload);
+}
+
+/*
+ * Compiles a changed source file in the calling thread, while lookups
+ * keep using the current version.
+ */
+gboolean
+lookup_table_handle_refresh(LookupTableHandle *self)
+{
+  GError *error = NULL;
+  gboolean changed;
+  LookupTable *table = NULL;
+
+  if (_handle_source_changed(self, &changed, &error))
+    {
+      if (!changed)
+        return TRUE;
+      table = lookup_table_load(self->filename, self->format, self->compiled_filename, &error);
+    }
+
+  if (!table)
+    {
+      msg_error("Error reloading lookup table, keeping the current version",
+                evt_tag_str("file", self->filename),
+                evt_tag_str("error", error->message));
+      g_clear_error(&error);
+      return FALSE;
+    }
+
+  _handle_reloaded(self, table);
+  return TRUE;
+}
+
+static void
+_poll_timer_start(void)
+{
+  if (!iv_inited() || iv_timer_registered(&lookup_table_poll_timer))
+    return;
+
+  iv_validate_now();
+  lookup_table_poll_timer.expires = iv_now;
+  timespec_add_msec(&lookup_table_poll_timer.expires, LOOKUP_TABLE_POLL_FREQ * 1000);
+  iv_timer_register(&lookup_table_poll_timer);
+}
+
+static void
+_poll_timer_stop(void)
+{
+  if (iv_inited() && iv_timer_registered(&lookup_table_poll_timer))
+    iv_timer_unregister(&lookup_table_poll_timer);
+}
+
+static void
+_poll_handle(gpointer key, gpointer value, gpointer user_data)
+{
+  LookupTableHandle *self = (LookupTableHandle *) value;
+  GError *error = NULL;
+  gboolean changed;
+
+  _handle_publish_pending(self);
+  _handle_free_retired(self);
+
+  if (self->reload)
+    return;
+
+  if (!_handle_source_changed(self, &changed, &error))
+    {
+      msg_error("Error reloading lookup table, keeping the current version",
+                evt_tag_str("file", self->filename),
+                evt_tag_str("error", error->message));
+      g_clear_error(&error);
+      return;
+    }
+
+  if (changed)
+    _handle_start_reload(self);
+}
+
+static void
+_poll_timer_tick(gpointer cookie)
+{
+  g_hash_table_foreach(lookup_table_handles, _poll_handle, NULL);
+  _poll_timer_start();
+}
+
+LookupTableHandle *
+lookup_table_handle_get(const gchar *filename, LookupTableFormat format, GError **error)
+{
+  gchar *key = g_strdup_printf("%d:%s", format, filename);
+
+  LookupTableHandle *self = lookup_table_handles ? g_hash_table_lookup(lookup_table_handles, key) : NULL;
+  if (self)
+    {
+      gboolean changed;
+
+      g_free(key);
+      if (!_handle_source_changed(self, &changed, error))
+        return NULL;
+      if (changed)
+        _handle_start_reload(self);
+      self->ref_cnt++;
+      return self;
+    }
+
+  gchar *compiled_filename = _format_compiled_filename(key);
+  LookupTable *table = lookup_table_load(filename, format, compiled_filename, error);
+  if (!table)
+    {
+      g_free(compiled_filename);
+      g_free(key);
+      return NULL;
+    }
+
+  self = g_new0(LookupTableHandle, 1);
+  self->ref_cnt = 1;
+  self->key = key;
+  self->filename = g_strdup(filename);
+  self->format = format;
+  self->compiled_filename = compiled_filename;
+  self->table = table;
+
+  if (!lookup_table_handles)
+    {
+      lookup_table_handles = g_hash_table_new(g_str_hash, g_str_equal);
+      IV_TIMER_INIT(&lookup_table_poll_timer);
+      lookup_table_poll_timer.handler = _poll_timer_tick;
+    }
+  g_hash_table_insert(lookup_table_handles, self->key, self);
+  _poll_timer_start();
+  return self;
+}
+
+void
+lookup_table_handle_unref(LookupTableHandle *self)
+{
+  if (!self || --self->ref_cnt > 0)
+    return;
+
+  g_hash_table_remove(lookup_table_handles, self->key);
+  if (g_hash_table_size(lookup_table_handles) == 0)
+    {
+      _poll_timer_stop();
+      g_hash_table_unref(lookup_table_handles);
+      lookup_table_handles = NULL;
+    }
+
+  /* the result of a compilation still running is not needed any more,
+   * it is discarded when it completes, without blocking the main loop */
+  if (self->reload)
+    self->reload->handle = NULL;
+
+  lookup_table_unref(self->pending);
+  lookup_table_unref(self->retired);
+  lookup_table_unref(self->table);
+  g_free(self->compiled_filename);
+  g_free(self->filename);
+  g_free(self->key);
+  g_free(self);
+}
+
+gboolean
+lookup_table_handle_lookup(LookupTableHandle *self, const gchar *key, gsize key_len, GString *value)
+{
+  const gchar *found_value;
+  gsize found_value_len;
+  gint epoch;
+
+  LookupTable *table = _handle_enter(self, &epoch);
+  gboolean found = lookup_table_lookup(table, key, key_len, &found_value, &found_value_len);
+  if (found && value)
+    g_string_append_len(value, found_value, found_value_len);
+  _handle_leave(self, epoch);
+
+  return found;
+}
+
+gboolean
+lookup_table_handle_contains(LookupTableHandle *self, const gchar *key, gsize key_len)
+{
+  return lookup_table_handle_lookup(self, key, key_len, NULL);
+}
+
+/* background compilations that have not completed yet, including the
+ * cancelled ones */
+gint
+lookup_table_get_running_reloads(void)
+{
+  return lookup_table_running_reloads;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef LOOKUP_TABLE_H_INCLUDED
+#define LOOKUP_TABLE_H_INCLUDED 1
+
+#include "syslog-ng.h"
+
+/*
+ * LookupTable is an immutable string set/map compiled from a text file
+ * into a flat image: a header, an open addressing hash index and the
+ * key/value strings.  The image is built once and then used in place,
+ * either from memory or mmap()-ed from a compiled file that is reused as
+ * long as the source file is unchanged.
+ *
+ * Source formats:
+ *   - LOOKUP_TABLE_FORMAT_LIST: one key per line, empty lines are ignored
+ *   - LOOKUP_TABLE_FORMAT_TSV: "key<TAB>value" lines, lines without a TAB
+ *     map the whole line to an empty value
+ *
+ * If a key appears multiple times, the first occurrence wins.
+ */
+typedef struct _LookupTable LookupTable;
+
+typedef enum
+{
+  LOOKUP_TABLE_FORMAT_LIST,
+  LOOKUP_TABLE_FORMAT_TSV,
+} LookupTableFormat;
+
+#define LOOKUP_TABLE_ERROR lookup_table_error_quark()
+
+GQuark lookup_table_error_quark(void);
+
+enum LookupTableError
+{
+  LOOKUP_TABLE_ERROR_FAILED,
+};
+
+LookupTable *lookup_table_load(const gchar *filename, LookupTableFormat format, const gchar *compiled_filename,
+                               GError **error);
+LookupTable *lookup_table_ref(LookupTable *self);
+void lookup_table_unref(LookupTable *self);
+
+gboolean lookup_table_lookup(LookupTable *self, const gchar *key, gsize key_len,
+                             const gchar **value, gsize *value_len);
+gsize lookup_table_get_size(LookupTable *self);
+gboolean lookup_table_is_mapped(LookupTable *self);
+
+/*
+ * LookupTableHandle is a shared reference to the most recent version of a
+ * source file.  Handles are shared between all users of the same file,
+ * including the old and the new configuration during reload, so a table
+ * is compiled only once.  When the source file changes, the new version
+ * is compiled in a background thread and swapped in atomically once it is
+ * ready, lookups that are already running finish on the old version.
+ * lookup_table_handle_refresh() compiles in the calling thread instead.
+ *
+ * Handles are created and released in the main thread, lookups may run in
+ * any thread and take no locks.
+ */
+typedef struct _LookupTableHandle LookupTableHandle;
+
+LookupTableHandle *lookup_table_handle_get(const gchar *filename, LookupTableFormat format, GError **error);
+void lookup_table_handle_unref(LookupTableHandle *self);
+gboolean lookup_table_handle_refresh(LookupTableHandle *self);
+
+gboolean lookup_table_handle_contains(LookupTableHandle *self, const gchar *key, gsize key_len);
+gboolean lookup_table_handle_lookup(LookupTableHandle *self, const gchar *key, gsize key_len, GString *value);
+
+gint lookup_table_get_running_reloads(void);
+
+#endif
@@ -26,12 +26,14 @@
 #include "mainloop-call.h"
 #include "logqueue.h"
 #include "apphook.h"
+#include "cpu-affinity.h"
 
 /************************************************************************************
  * I/O worker threads
  ************************************************************************************/
 
 static struct iv_work_pool main_loop_io_workers;
+static CpuAffinity *main_loop_io_worker_cpu_affinity;
 
 static void
 _release(MainLoopIOWorkerJob *self)
@@ -124,6 +126,8 @@ static void
 main_loop_io_worker_thread_start(void *cookie)
 {
   main_loop_worker_thread_start(MLW_ASYNC_WORKER);
+  if (main_loop_io_worker_cpu_affinity)
+    cpu_affinity_apply_to_current_thread(main_loop_io_worker_cpu_affinity);
 }
 
 static void
@@ -157,11 +161,32 @@ void
 main_loop_io_worker_deinit(void)
 {
   iv_work_pool_put(&main_loop_io_workers);
+  if (main_loop_io_worker_cpu_affinity)
+    cpu_affinity_free(main_loop_io_worker_cpu_affinity);
+  main_loop_io_worker_cpu_affinity = NULL;
+}
+
+/* parsed right away, so that an invalid CPU list fails the command line
+ * parsing and with that the startup, instead of silently running unbound */
+static gboolean
+_process_worker_cpus(const gchar *option_name G_GNUC_UNUSED, const gchar *value, gpointer data G_GNUC_UNUSED,
+                     GError **error)
+{
+  CpuAffinity *cpu_affinity = cpu_affinity_new(value, error);
+
+  if (!cpu_affinity)
+    return FALSE;
+
+  if (main_loop_io_worker_cpu_affinity)
+    cpu_affinity_free(main_loop_io_worker_cpu_affinity);
+  main_loop_io_worker_cpu_affinity = cpu_affinity;
+  return TRUE;
 }
 
 static GOptionEntry main_loop_io_worker_options[] =
 {
   { "worker-threads",      0,         0, G_OPTION_ARG_INT, &main_loop_io_workers.max_threads, "Set the number of I/O worker threads", "<max>" },
+  { "worker-cpus",         0,         0, G_OPTION_ARG_CALLBACK, _process_worker_cpus, "Bind I/O worker threads to the listed CPUs, e.g. 0-3,8", "<cpulist>" },
   { NULL },
 };
 
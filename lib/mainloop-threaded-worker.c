@@ -44,6 +44,9 @@ _thread_init(MainLoopThreadedWorker *self)
 
   main_loop_worker_thread_start(self->worker_type);
 
+  if (self->cpu_affinity)
+    cpu_affinity_apply_to_current_thread(self->cpu_affinity);
+
   if (self->thread_init)
     result = self->thread_init(self);
 
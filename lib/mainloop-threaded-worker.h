@@ -27,6 +27,7 @@
 #define MAINLOOP_THREADED_WORKER_H_INCLUDED
 
 #include "mainloop-worker.h"
+#include "cpu-affinity.h"
 
 typedef void (*MainLoopThreadedWorkerFunc)(gpointer user_data);
 typedef struct _MainLoopThreadedWorker MainLoopThreadedWorker;
@@ -35,6 +36,8 @@ struct _MainLoopThreadedWorker
   gpointer data;
   MainLoopWorkerType worker_type;
   GThread *thread;
+  /* not owned, applied when the thread starts */
+  const CpuAffinity *cpu_affinity;
   GMutex lock;
   struct
   {
@@ -54,4 +57,10 @@ void main_loop_threaded_worker_init(MainLoopThreadedWorker *self,
                                     MainLoopWorkerType worker_type, gpointer data);
 void main_loop_threaded_worker_clear(MainLoopThreadedWorker *self);
 
+static inline void
+main_loop_threaded_worker_set_cpu_affinity(MainLoopThreadedWorker *self, const CpuAffinity *cpu_affinity)
+{
+  self->cpu_affinity = cpu_affinity;
+}
+
 #endif
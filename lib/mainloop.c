@@ -43,9 +43,11 @@
 #include "plugin.h"
 #include "resolved-configurable-paths.h"
 #include "scratch-buffers.h"
+#include "memory-reservation.h"
 #include "timeutils/misc.h"
 #include "stats/stats-control.h"
 #include "healthcheck/healthcheck-control.h"
+#include "profiler/profiler-control.h"
 #include "signal-handler.h"
 #include "cfg-monitor.h"
 
@@ -168,6 +170,7 @@ struct _MainLoop
   MainLoopOptions *options;
   ControlServer *control_server;
   CfgMonitor *cfg_monitor;
+  CfgCache *config_cache;
 
   struct
   {
@@ -335,7 +338,7 @@ main_loop_reload_config_prepare(MainLoop *self, GError **error)
 
   self->old_config = self->current_configuration;
   self->new_config = cfg_new(0);
-  if (!cfg_read_config(self->new_config, resolved_configurable_paths.cfgfilename, NULL))
+  if (!cfg_read_config_with_cache(self->new_config, resolved_configurable_paths.cfgfilename, self->config_cache, NULL))
     {
       cfg_free(self->new_config);
       self->new_config = NULL;
@@ -643,6 +646,7 @@ main_loop_init(MainLoop *self, MainLoopOptions *options)
   g_mutex_init(&workers_running_lock);
   self->options = options;
   scratch_buffers_automatic_gc_init();
+  memory_reservation_global_init();
   main_loop_worker_init();
   main_loop_io_worker_init();
   main_loop_call_init();
@@ -655,6 +659,9 @@ main_loop_init(MainLoop *self, MainLoopOptions *options)
   if (self->options->disable_module_discovery)
     self->current_configuration->use_plugin_discovery = FALSE;
 
+  if (self->options->config_cache)
+    self->config_cache = cfg_cache_new(self->options->config_cache);
+
   _register_metrics(self);
 }
 
@@ -676,7 +683,8 @@ main_loop_read_and_init_config(MainLoop *self)
 
   _init_reload_metrics(self);
 
-  if (!cfg_read_config(self->current_configuration, resolved_configurable_paths.cfgfilename, options->preprocess_into))
+  if (!cfg_read_config_with_cache(self->current_configuration, resolved_configurable_paths.cfgfilename,
+                                  self->config_cache, options->preprocess_into))
     {
       return 1;
     }
@@ -710,6 +718,7 @@ main_loop_read_and_init_config(MainLoop *self)
   main_loop_register_control_commands(self);
   stats_register_control_commands();
   healthcheck_register_control_commands();
+  profiler_register_control_commands();
   return 0;
 }
 
@@ -731,6 +740,9 @@ main_loop_deinit(MainLoop *self)
       cfg_monitor_free(self->cfg_monitor);
     }
 
+  if (self->config_cache)
+    cfg_cache_free(self->config_cache);
+
   control_deinit(self->control_server);
 
   iv_event_unregister(&self->exit_requested);
@@ -739,6 +751,7 @@ main_loop_deinit(MainLoop *self)
   main_loop_worker_deinit();
   block_till_workers_exit();
   scratch_buffers_automatic_gc_deinit();
+  memory_reservation_global_deinit();
   g_mutex_clear(&workers_running_lock);
 
   _unregister_metrics(self);
@@ -767,6 +780,7 @@ void
 main_loop_add_options(GOptionContext *ctx)
 {
   main_loop_io_worker_add_options(ctx);
+  memory_reservation_add_options(ctx);
 }
 
 void
@@ -34,6 +34,7 @@ typedef struct _MainLoop MainLoop;
 typedef struct _MainLoopOptions
 {
   gchar *preprocess_into;
+  gchar *config_cache;
   gboolean syntax_only;
   gboolean check_startup;
   gboolean config_id;
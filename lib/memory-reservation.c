@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "memory-reservation.h"
+#include "parse-number.h"
+#include "stats/stats-registry.h"
+#include "stats/stats-cluster-single.h"
+#include "messages.h"
+
+#include <sys/mman.h>
+#include <string.h>
+
+/*
+ * Memory reservation
+ *
+ * When enabled with --reserved-memory, a single region of the configured
+ * size is mapped (and prefaulted) at startup.  Allocations are served from
+ * power-of-two size classes: a chunk is carved from the region on first
+ * use and is put on the free list of its class when released, so the
+ * region is never returned to the OS and RSS stays predictable during
+ * bursts.  The region can be backed by explicit huge pages (MAP_HUGETLB),
+ * otherwise transparent huge pages are requested via madvise().
+ *
+ * Once the region is exhausted, or for requests larger than the largest
+ * size class, callers fall back to the heap.  As objects allocated from
+ * the region may outlive the main loop, the region is kept until the
+ * process exits.
+ *
+ * Scratch buffers are not served from the region: they are GStrings, which
+ * GLib grows with g_realloc(), so their storage cannot be substituted.
+ */
+
+#define MEMORY_RESERVATION_MIN_SHIFT    6
+#define MEMORY_RESERVATION_MAX_SHIFT    20
+#define MEMORY_RESERVATION_CLASSES      (MEMORY_RESERVATION_MAX_SHIFT - MEMORY_RESERVATION_MIN_SHIFT + 1)
+
+/* keeps the payload 16-byte aligned */
+typedef union _MemoryReservationHeader
+{
+  gint size_class;
+  guint8 __align[16];
+} MemoryReservationHeader;
+
+typedef struct _MemoryReservationChunk MemoryReservationChunk;
+struct _MemoryReservationChunk
+{
+  MemoryReservationHeader header;
+  MemoryReservationChunk *next;
+};
+
+typedef struct _MemoryReservationClass
+{
+  GMutex lock;
+  MemoryReservationChunk *free_list;
+} MemoryReservationClass;
+
+static struct
+{
+  guint8 *base;
+  gsize size;
+  gsize top;
+  MemoryReservationClass classes[MEMORY_RESERVATION_CLASSES];
+
+  StatsCounterItem *reserved_bytes;
+  StatsCounterItem *used_bytes;
+} memory_reservation;
+
+static gchar *reserved_memory_size;
+static gboolean reserved_memory_hugetlb;
+
+static inline gsize
+_class_chunk_size(gint size_class)
+{
+  return ((gsize) 1) << (size_class + MEMORY_RESERVATION_MIN_SHIFT);
+}
+
+static inline gint
+_size_to_class(gsize size)
+{
+  gsize chunk_size = size + sizeof(MemoryReservationHeader);
+  gint size_class = 0;
+
+  while (_class_chunk_size(size_class) < chunk_size)
+    {
+      size_class++;
+      if (size_class >= MEMORY_RESERVATION_CLASSES)
+        return -1;
+    }
+  return size_class;
+}
+
+gboolean
+memory_reservation_owns(gconstpointer p)
+{
+  return (const guint8 *) p >= memory_reservation.base &&
+         (const guint8 *) p < memory_reservation.base + memory_reservation.size;
+}
+
+static gpointer
+_map_region(gsize size, gboolean use_hugetlb)
+{
+  gint flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  gpointer region;
+
+#ifdef MAP_POPULATE
+  flags |= MAP_POPULATE;
+#endif
+
+#ifdef MAP_HUGETLB
+  if (use_hugetlb)
+    {
+      region = mmap(NULL, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+      if (region != MAP_FAILED)
+        return region;
+
+      msg_warning("Error mapping reserved memory using explicit huge pages, falling back to regular pages",
+                  evt_tag_long("size", size),
+                  evt_tag_error("error"));
+    }
+#endif
+
+  region = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (region == MAP_FAILED)
+    return NULL;
+
+#ifdef MADV_HUGEPAGE
+  madvise(region, size, MADV_HUGEPAGE);
+#endif
+  return region;
+}
+
+gboolean
+memory_reservation_reserve(gsize size, gboolean use_hugetlb)
+{
+  g_assert(!memory_reservation.base);
+
+  gpointer region = _map_region(size, use_hugetlb);
+  if (!region)
+    {
+      msg_error("Error reserving memory, continuing without a memory reservation",
+                evt_tag_long("size", size),
+                evt_tag_error("error"));
+      return FALSE;
+    }
+
+  for (gint i = 0; i < MEMORY_RESERVATION_CLASSES; i++)
+    g_mutex_init(&memory_reservation.classes[i].lock);
+  memory_reservation.top = 0;
+  memory_reservation.size = size;
+  memory_reservation.base = region;
+  stats_counter_set(memory_reservation.reserved_bytes, size);
+  return TRUE;
+}
+
+static MemoryReservationChunk *
+_carve_chunk(gint size_class)
+{
+  gsize chunk_size = _class_chunk_size(size_class);
+  gsize offset = (gsize) g_atomic_pointer_add(&memory_reservation.top, chunk_size);
+
+  /* top keeps growing past the end once exhausted, that's fine */
+  if (offset + chunk_size > memory_reservation.size)
+    return NULL;
+  return (MemoryReservationChunk *) (memory_reservation.base + offset);
+}
+
+/* returns NULL if there's no reservation, or it is exhausted */
+gpointer
+memory_reservation_alloc(gsize size)
+{
+  if (!memory_reservation.base)
+    return NULL;
+
+  gint size_class = _size_to_class(size);
+  if (size_class < 0)
+    return NULL;
+
+  MemoryReservationClass *klass = &memory_reservation.classes[size_class];
+
+  g_mutex_lock(&klass->lock);
+  MemoryReservationChunk *chunk = klass->free_list;
+  if (chunk)
+    klass->free_list = chunk->next;
+  g_mutex_unlock(&klass->lock);
+
+  if (!chunk)
+    {
+      chunk = _carve_chunk(size_class);
+      if (!chunk)
+        return NULL;
+    }
+
+  chunk->header.size_class = size_class;
+  stats_counter_add(memory_reservation.used_bytes, _class_chunk_size(size_class));
+  return ((guint8 *) chunk) + sizeof(MemoryReservationHeader);
+}
+
+/* the footprint of an allocation in the reservation, including its header */
+gsize
+memory_reservation_get_chunk_size(gconstpointer p)
+{
+  const guint8 *chunk = ((const guint8 *) p) - sizeof(MemoryReservationHeader);
+  const MemoryReservationHeader *header = (const MemoryReservationHeader *) chunk;
+
+  g_assert(memory_reservation_owns(chunk));
+  return _class_chunk_size(header->size_class);
+}
+
+void
+memory_reservation_free(gpointer p)
+{
+  MemoryReservationChunk *chunk = (MemoryReservationChunk *) (((guint8 *) p) - sizeof(MemoryReservationHeader));
+  gint size_class = chunk->header.size_class;
+  MemoryReservationClass *klass = &memory_reservation.classes[size_class];
+
+  g_assert(memory_reservation_owns(chunk));
+
+  stats_counter_sub(memory_reservation.used_bytes, _class_chunk_size(size_class));
+  g_mutex_lock(&klass->lock);
+  chunk->next = klass->free_list;
+  klass->free_list = chunk;
+  g_mutex_unlock(&klass->lock);
+}
+
+gpointer
+reserved_malloc(gsize size)
+{
+  gpointer p = memory_reservation_alloc(size);
+
+  return p ? : g_malloc(size);
+}
+
+gpointer
+reserved_realloc(gpointer p, gsize size)
+{
+  if (!p)
+    return reserved_malloc(size);
+
+  if (!memory_reservation_owns(p))
+    return g_realloc(p, size);
+
+  MemoryReservationHeader *header = (MemoryReservationHeader *) (((guint8 *) p) - sizeof(MemoryReservationHeader));
+  gsize capacity = _class_chunk_size(header->size_class) - sizeof(MemoryReservationHeader);
+
+  if (size <= capacity)
+    return p;
+
+  gpointer new_p = reserved_malloc(size);
+  memcpy(new_p, p, capacity);
+  memory_reservation_free(p);
+  return new_p;
+}
+
+void
+reserved_free(gpointer p)
+{
+  if (memory_reservation_owns(p))
+    memory_reservation_free(p);
+  else
+    g_free(p);
+}
+
+static void
+_register_stats(void)
+{
+  StatsClusterKey sc_key;
+
+  stats_lock();
+  stats_cluster_single_key_set(&sc_key, "reserved_memory_bytes", NULL, 0);
+  stats_register_counter(0, &sc_key, SC_TYPE_SINGLE_VALUE, &memory_reservation.reserved_bytes);
+  stats_cluster_single_key_set(&sc_key, "reserved_memory_used_bytes", NULL, 0);
+  stats_register_counter(0, &sc_key, SC_TYPE_SINGLE_VALUE, &memory_reservation.used_bytes);
+  stats_unlock();
+}
+
+static void
+_unregister_stats(void)
+{
+  StatsClusterKey sc_key;
+
+  stats_lock();
+  stats_cluster_single_key_set(&sc_key, "reserved_memory_bytes", NULL, 0);
+  stats_unregister_counter(&sc_key, SC_TYPE_SINGLE_VALUE, &memory_reservation.reserved_bytes);
+  stats_cluster_single_key_set(&sc_key, "reserved_memory_used_bytes", NULL, 0);
+  stats_unregister_counter(&sc_key, SC_TYPE_SINGLE_VALUE, &memory_reservation.used_bytes);
+  stats_unlock();
+}
+
+void
+memory_reservation_global_init(void)
+{
+  gint64 size;
+
+  if (!reserved_memory_size || memory_reservation.base)
+    return;
+
+  if (!parse_int64_with_suffix(reserved_memory_size, &size) || size <= 0)
+    {
+      msg_error("Invalid --reserved-memory value, continuing without a memory reservation",
+                evt_tag_str("value", reserved_memory_size));
+      return;
+    }
+
+  _register_stats();
+  if (memory_reservation_reserve((gsize) size, reserved_memory_hugetlb))
+    msg_verbose("Memory reserved for queues and buffers",
+                evt_tag_long("size", size),
+                evt_tag_int("hugetlb", reserved_memory_hugetlb));
+}
+
+void
+memory_reservation_global_deinit(void)
+{
+  if (memory_reservation.reserved_bytes || memory_reservation.used_bytes)
+    _unregister_stats();
+}
+
+static GOptionEntry memory_reservation_options[] =
+{
+  { "reserved-memory",     0,         0, G_OPTION_ARG_STRING, &reserved_memory_size, "Reserve memory for queues and read buffers at startup, e.g. 256M", "<size>" },
+  { "reserved-memory-hugetlb", 0,     0, G_OPTION_ARG_NONE, &reserved_memory_hugetlb, "Back the reserved memory with explicit huge pages (MAP_HUGETLB)", NULL },
+  { NULL },
+};
+
+void
+memory_reservation_add_options(GOptionContext *ctx)
+{
+  g_option_context_add_main_entries(ctx, memory_reservation_options, NULL);
+}
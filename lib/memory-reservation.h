@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef MEMORY_RESERVATION_H_INCLUDED
+#define MEMORY_RESERVATION_H_INCLUDED 1
+
+#include "syslog-ng.h"
+
+/*
+ * An opt-in, preallocated memory region that hot-path buffers (queue
+ * nodes, read buffers) are carved from, see memory-reservation.c for
+ * details.
+ */
+
+gboolean memory_reservation_reserve(gsize size, gboolean use_hugetlb);
+
+gpointer memory_reservation_alloc(gsize size);
+void memory_reservation_free(gpointer p);
+gboolean memory_reservation_owns(gconstpointer p);
+gsize memory_reservation_get_chunk_size(gconstpointer p);
+
+/* g_malloc()/g_realloc()/g_free() replacements, that use the reservation
+ * if possible and fall back to the heap otherwise */
+gpointer reserved_malloc(gsize size);
+gpointer reserved_realloc(gpointer p, gsize size);
+void reserved_free(gpointer p);
+
+void memory_reservation_global_init(void);
+void memory_reservation_global_deinit(void);
+void memory_reservation_add_options(GOptionContext *ctx);
+
+#endif
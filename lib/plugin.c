@@ -30,6 +30,7 @@
 
 #include <gmodule.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #ifdef _AIX
 #undef G_MODULE_SUFFIX
@@ -454,12 +455,193 @@ plugin_has_discovery_run(PluginContext *context)
   return context->candidate_plugins != NULL;
 }
 
+static gchar *
+_format_module_name_from_filename(const gchar *fname)
+{
+  const gchar *so_basename = fname;
+
+  if (g_str_has_prefix(fname, "lib"))
+    so_basename = fname + 3;
+  return g_strndup(so_basename, (gint) (strlen(so_basename) - strlen(G_MODULE_SUFFIX) - 1));
+}
+
+static void
+_register_candidate_plugin(PluginContext *context, gint plugin_type, const gchar *plugin_name,
+                           const gchar *module_name)
+{
+  PluginCandidate *candidate_plugin;
+
+  candidate_plugin = (PluginCandidate *) _find_plugin_in_list(context->candidate_plugins, plugin_type, plugin_name);
+
+  msg_debug("Registering candidate plugin",
+            evt_tag_str("module", module_name),
+            evt_tag_str("context", cfg_lexer_lookup_context_name_by_type(plugin_type)),
+            evt_tag_str("name", plugin_name));
+  if (candidate_plugin)
+    {
+      msg_debug("Duplicate plugin candidate, overriding previous registration with the new one",
+                evt_tag_str("old-module", candidate_plugin->module_name),
+                evt_tag_str("new-module", module_name),
+                evt_tag_str("context", cfg_lexer_lookup_context_name_by_type(plugin_type)),
+                evt_tag_str("name", plugin_name));
+      plugin_candidate_set_module_name(candidate_plugin, module_name);
+    }
+  else
+    {
+      context->candidate_plugins = g_list_prepend(context->candidate_plugins,
+                                                  plugin_candidate_new(plugin_type, plugin_name, module_name));
+    }
+}
+
+/************************************************************
+ * Module manifest
+ *
+ * Discovery has to dlopen() every module to read its ModuleInfo, which
+ * also pulls in all the libraries the module depends on.  To avoid that,
+ * each module directory may contain a manifest listing the plugins of each
+ * module.  It is either generated at build time by "syslog-ng
+ * --generate-module-manifest" and installed along the modules, or by
+ * "syslog-ng --update-module-manifest" in place.  The latter also records
+ * the size and mtime of the module files, and such an entry is only
+ * trusted if those still match.  Modules without an entry are discovered
+ * by dlopen(), as well as every module if the manifest was generated by a
+ * different syslog-ng version.
+ ************************************************************/
+
+#define PLUGIN_MANIFEST_FILENAME "plugin-manifest"
+#define PLUGIN_MANIFEST_GROUP "Manifest"
+
+static gboolean
+_stat_module_file(const gchar *module_dir_name, const gchar *module_file_name, struct stat *st)
+{
+  gchar *path = g_build_path(G_DIR_SEPARATOR_S, module_dir_name, module_file_name, NULL);
+  gboolean result = stat(path, st) == 0;
+
+  g_free(path);
+  return result;
+}
+
+static GKeyFile *
+_manifest_load(const gchar *module_dir_name)
+{
+  GKeyFile *manifest = g_key_file_new();
+  gchar *path = g_build_path(G_DIR_SEPARATOR_S, module_dir_name, PLUGIN_MANIFEST_FILENAME, NULL);
+  gchar *core_revision = NULL;
+
+  if (!g_key_file_load_from_file(manifest, path, G_KEY_FILE_NONE, NULL))
+    goto error;
+
+  core_revision = g_key_file_get_string(manifest, PLUGIN_MANIFEST_GROUP, "core-revision", NULL);
+  if (!core_revision || strcmp(core_revision, SYSLOG_NG_SOURCE_REVISION) != 0)
+    {
+      msg_debug("Ignoring module manifest generated by a different syslog-ng version",
+                evt_tag_str("filename", path),
+                evt_tag_str("core-revision", core_revision ? : "unknown"));
+      goto error;
+    }
+
+  msg_debug("Using module manifest",
+            evt_tag_str("filename", path));
+  g_free(core_revision);
+  g_free(path);
+  return manifest;
+
+error:
+  g_free(core_revision);
+  g_free(path);
+  g_key_file_free(manifest);
+  return NULL;
+}
+
+static gboolean
+_manifest_entry_is_up_to_date(GKeyFile *manifest, const gchar *module_dir_name, const gchar *module_file_name)
+{
+  struct stat st;
+
+  if (!_stat_module_file(module_dir_name, module_file_name, &st))
+    return FALSE;
+
+  /* generated at build time, before the module files got their final stamps */
+  if (!g_key_file_has_key(manifest, module_file_name, "size", NULL))
+    return TRUE;
+
+  GError *error = NULL;
+  gint64 size = g_key_file_get_int64(manifest, module_file_name, "size", &error);
+  gint64 mtime = error ? 0 : g_key_file_get_int64(manifest, module_file_name, "mtime", &error);
+
+  if (error || size != (gint64) st.st_size || mtime != (gint64) st.st_mtime)
+    {
+      msg_debug("Module manifest entry is out of date, loading module to discover its plugins",
+                evt_tag_str("path", module_dir_name),
+                evt_tag_str("fname", module_file_name));
+      g_clear_error(&error);
+      return FALSE;
+    }
+  return TRUE;
+}
+
+/* returns the plugins of the module if its manifest entry is up-to-date */
+static gchar **
+_manifest_lookup_plugins(GKeyFile *manifest, const gchar *module_dir_name, const gchar *module_file_name)
+{
+  if (!manifest || !g_key_file_has_group(manifest, module_file_name))
+    return NULL;
+
+  if (!_manifest_entry_is_up_to_date(manifest, module_dir_name, module_file_name))
+    return NULL;
+
+  gchar **plugins = g_key_file_get_string_list(manifest, module_file_name, "plugins", NULL, NULL);
+  return plugins ? : g_new0(gchar *, 1);
+}
+
+/* plugins are stored as "<type>:<name>" */
+static void
+_register_candidate_plugins_from_manifest(PluginContext *context, gchar **plugins, const gchar *module_name)
+{
+  for (gint i = 0; plugins[i]; i++)
+    {
+      gchar *end;
+      gint64 plugin_type = g_ascii_strtoll(plugins[i], &end, 10);
+
+      if (*end != ':' || !end[1])
+        {
+          msg_warning("Invalid plugin entry in module manifest",
+                      evt_tag_str("module", module_name),
+                      evt_tag_str("entry", plugins[i]));
+          continue;
+        }
+      _register_candidate_plugin(context, (gint) plugin_type, end + 1, module_name);
+    }
+}
+
+static void
+_discover_candidate_plugins_by_dlopen(PluginContext *context, const gchar *module_dir_name,
+                                      const gchar *module_file_name, const gchar *module_name)
+{
+  GModule *mod;
+  ModuleInfo *module_info;
+
+  mod = _dlopen_module_as_dir_and_filename(module_dir_name, module_file_name, module_name);
+  module_info = _get_module_info(mod);
+
+  if (module_info)
+    {
+      for (gint j = 0; j < module_info->plugins_len; j++)
+        {
+          Plugin *plugin = &module_info->plugins[j];
+
+          _register_candidate_plugin(context, plugin->type, plugin->name, module_name);
+        }
+    }
+  if (mod)
+    g_module_close(mod);
+}
+
 void
 plugin_discover_candidate_modules(PluginContext *context)
 {
-  GModule *mod;
   gchar **mod_paths;
-  gint i, j;
+  gint i;
 
   _free_candidate_plugins(context);
 
@@ -467,6 +649,7 @@ plugin_discover_candidate_modules(PluginContext *context)
   for (i = 0; mod_paths[i]; i++)
     {
       GDir *dir;
+      GKeyFile *manifest;
       const gchar *fname;
 
       msg_debug("Reading path for candidate modules",
@@ -474,67 +657,183 @@ plugin_discover_candidate_modules(PluginContext *context)
       dir = g_dir_open(mod_paths[i], 0, NULL);
       if (!dir)
         continue;
+
+      manifest = _manifest_load(mod_paths[i]);
       while ((fname = g_dir_read_name(dir)))
         {
           if (g_str_has_suffix(fname, G_MODULE_SUFFIX))
             {
-              gchar *module_name;
-              ModuleInfo *module_info;
-              const gchar *so_basename = fname;
-
-              if (g_str_has_prefix(fname, "lib"))
-                so_basename = fname + 3;
-              module_name = g_strndup(so_basename, (gint) (strlen(so_basename) - strlen(G_MODULE_SUFFIX) - 1));
+              gchar *module_name = _format_module_name_from_filename(fname);
+              gchar **plugins = _manifest_lookup_plugins(manifest, mod_paths[i], fname);
 
-              msg_debug("Reading shared object for a candidate module",
-                        evt_tag_str("path", mod_paths[i]),
-                        evt_tag_str("fname", fname),
-                        evt_tag_str("module", module_name));
-              mod = _dlopen_module_as_dir_and_filename(mod_paths[i], fname, module_name);
-              module_info = _get_module_info(mod);
-
-              if (module_info)
+              if (plugins)
                 {
-                  for (j = 0; j < module_info->plugins_len; j++)
-                    {
-                      Plugin *plugin = &module_info->plugins[j];
-                      PluginCandidate *candidate_plugin;
-
-                      candidate_plugin = (PluginCandidate *) _find_plugin_in_list(context->candidate_plugins, plugin->type, plugin->name);
-
-                      msg_debug("Registering candidate plugin",
-                                evt_tag_str("module", module_name),
-                                evt_tag_str("context", cfg_lexer_lookup_context_name_by_type(plugin->type)),
-                                evt_tag_str("name", plugin->name));
-                      if (candidate_plugin)
-                        {
-                          msg_debug("Duplicate plugin candidate, overriding previous registration with the new one",
-                                    evt_tag_str("old-module", candidate_plugin->module_name),
-                                    evt_tag_str("new-module", module_name),
-                                    evt_tag_str("context", cfg_lexer_lookup_context_name_by_type(plugin->type)),
-                                    evt_tag_str("name", plugin->name));
-                          plugin_candidate_set_module_name(candidate_plugin, module_name);
-                        }
-                      else
-                        {
-                          context->candidate_plugins = g_list_prepend(context->candidate_plugins,
-                                                                      plugin_candidate_new(plugin->type, plugin->name,
-                                                                          module_name));
-                        }
-                    }
+                  _register_candidate_plugins_from_manifest(context, plugins, module_name);
+                  g_strfreev(plugins);
                 }
-              g_free(module_name);
-              if (mod)
-                g_module_close(mod);
               else
-                mod = NULL;
+                {
+                  msg_debug("Reading shared object for a candidate module",
+                            evt_tag_str("path", mod_paths[i]),
+                            evt_tag_str("fname", fname),
+                            evt_tag_str("module", module_name));
+                  _discover_candidate_plugins_by_dlopen(context, mod_paths[i], fname, module_name);
+                }
+              g_free(module_name);
             }
         }
+      if (manifest)
+        g_key_file_free(manifest);
       g_dir_close(dir);
     }
   g_strfreev(mod_paths);
 }
 
+static GKeyFile *
+_manifest_new(void)
+{
+  GKeyFile *manifest = g_key_file_new();
+
+  g_key_file_set_string(manifest, PLUGIN_MANIFEST_GROUP, "core-revision", SYSLOG_NG_SOURCE_REVISION);
+  return manifest;
+}
+
+static gboolean
+_manifest_add_modules_in_dir(GKeyFile *manifest, const gchar *module_dir_name, gboolean record_stamps)
+{
+  GDir *dir;
+  const gchar *fname;
+
+  dir = g_dir_open(module_dir_name, 0, NULL);
+  if (!dir)
+    return FALSE;
+
+  while ((fname = g_dir_read_name(dir)))
+    {
+      struct stat st;
+
+      /* the first module of the same name wins, the same way as when loading modules */
+      if (!g_str_has_suffix(fname, G_MODULE_SUFFIX) || g_key_file_has_group(manifest, fname)
+          || !_stat_module_file(module_dir_name, fname, &st))
+        continue;
+
+      gchar *module_name = _format_module_name_from_filename(fname);
+      GModule *mod = _dlopen_module_as_dir_and_filename(module_dir_name, fname, module_name);
+      if (!mod)
+        {
+          /* left out, so that it is discovered by dlopen() once it can be loaded */
+          msg_warning("Error loading module, not adding it to the module manifest",
+                      evt_tag_str("path", module_dir_name),
+                      evt_tag_str("fname", fname));
+          g_free(module_name);
+          continue;
+        }
+
+      /* non-modules are recorded with an empty list, so they are not dlopen()-ed at startup either */
+      ModuleInfo *module_info = _get_module_info(mod);
+      GPtrArray *plugins = g_ptr_array_new_with_free_func(g_free);
+      for (gint j = 0; module_info && j < module_info->plugins_len; j++)
+        {
+          Plugin *plugin = &module_info->plugins[j];
+
+          g_ptr_array_add(plugins, g_strdup_printf("%d:%s", plugin->type, plugin->name));
+        }
+
+      if (record_stamps)
+        {
+          g_key_file_set_int64(manifest, fname, "size", (gint64) st.st_size);
+          g_key_file_set_int64(manifest, fname, "mtime", (gint64) st.st_mtime);
+        }
+      g_key_file_set_string_list(manifest, fname, "plugins", (const gchar *const *) plugins->pdata, plugins->len);
+
+      g_ptr_array_free(plugins, TRUE);
+      g_free(module_name);
+      g_module_close(mod);
+    }
+  g_dir_close(dir);
+  return TRUE;
+}
+
+static gboolean
+_manifest_write(GKeyFile *manifest, const gchar *filename)
+{
+  GError *error = NULL;
+  gsize length;
+  gchar *data = g_key_file_to_data(manifest, &length, NULL);
+  gboolean result = g_file_set_contents(filename, data, length, &error);
+
+  if (!result)
+    {
+      msg_error("Error writing module manifest",
+                evt_tag_str("filename", filename),
+                evt_tag_str("error", error->message));
+      g_clear_error(&error);
+    }
+  g_free(data);
+  return result;
+}
+
+static gboolean
+_update_module_manifest_in_dir(const gchar *module_dir_name)
+{
+  GKeyFile *manifest = _manifest_new();
+  gboolean result = TRUE;
+
+  if (_manifest_add_modules_in_dir(manifest, module_dir_name, TRUE))
+    {
+      gchar *path = g_build_path(G_DIR_SEPARATOR_S, module_dir_name, PLUGIN_MANIFEST_FILENAME, NULL);
+      result = _manifest_write(manifest, path);
+      g_free(path);
+    }
+  g_key_file_free(manifest);
+  return result;
+}
+
+/* updates the manifest of each module directory in place */
+gboolean
+plugin_update_module_manifests(const gchar *module_path)
+{
+  gchar **mod_paths;
+  gboolean result = TRUE;
+
+  mod_paths = g_strsplit(module_path ? : "", G_SEARCHPATH_SEPARATOR_S, 0);
+  for (gint i = 0; mod_paths[i]; i++)
+    result &= _update_module_manifest_in_dir(mod_paths[i]);
+  g_strfreev(mod_paths);
+  return result;
+}
+
+/*
+ * Writes a single manifest to @filename, covering the modules of all the
+ * directories in @module_path.  Used at build time, where the modules are
+ * spread over the build tree and are not yet at their final location, so
+ * the entries are not stamped.
+ */
+gboolean
+plugin_generate_module_manifest(const gchar *module_path, const gchar *filename)
+{
+  GKeyFile *manifest = _manifest_new();
+  gchar **mod_paths;
+  gboolean result = TRUE;
+
+  mod_paths = g_strsplit(module_path ? : "", G_SEARCHPATH_SEPARATOR_S, 0);
+  for (gint i = 0; mod_paths[i]; i++)
+    {
+      if (!mod_paths[i][0] || _manifest_add_modules_in_dir(manifest, mod_paths[i], FALSE))
+        continue;
+
+      msg_error("Error reading module directory",
+                evt_tag_str("path", mod_paths[i]),
+                evt_tag_error("error"));
+      result = FALSE;
+    }
+  g_strfreev(mod_paths);
+
+  if (result)
+    result = _manifest_write(manifest, filename);
+  g_key_file_free(manifest);
+  return result;
+}
 
 static void
 _free_plugins(PluginContext *context)
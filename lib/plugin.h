@@ -106,6 +106,8 @@ void plugin_list_modules(FILE *out, gboolean verbose);
 
 gboolean plugin_has_discovery_run(PluginContext *context);
 void plugin_discover_candidate_modules(PluginContext *context);
+gboolean plugin_update_module_manifests(const gchar *module_path);
+gboolean plugin_generate_module_manifest(const gchar *module_path, const gchar *filename);
 
 void plugin_context_copy_candidates(PluginContext *context, PluginContext *src_context);
 void plugin_context_set_module_path(PluginContext *context, const gchar *module_path);
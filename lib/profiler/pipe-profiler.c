@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "profiler/pipe-profiler.h"
+#include "logpipe.h"
+#include "cfg-tree.h"
+#include "tls-support.h"
+#include "stats/stats-registry.h"
+#include "stats/stats-cluster-single.h"
+
+#include <string.h>
+
+struct _LogPipeProfile
+{
+  gint ref_cnt;
+  gchar *location;
+  gchar *kind;
+  /* "kind@location", interned so it outlives the profile */
+  const gchar *label;
+  gint sample_rate;
+
+  StatsCounterItem *time_nsec;
+  StatsCounterItem *invocations;
+  StatsCounterItem *dropped;
+  StatsCounterItem *errors;
+};
+
+TLS_BLOCK_START
+{
+  PipeProfilerFrame *current_frame;
+  guint64 child_nsec;
+  gboolean sampling;
+  gint sample_countdown;
+}
+TLS_BLOCK_END;
+
+#define current_frame     __tls_deref(current_frame)
+#define child_nsec        __tls_deref(child_nsec)
+#define sampling          __tls_deref(sampling)
+#define sample_countdown  __tls_deref(sample_countdown)
+
+/* location -> LogPipeProfile, protected by profiles_lock */
+static GHashTable *profiles;
+static GMutex profiles_lock;
+
+static void
+_format_key(StatsClusterKey *sc_key, const gchar *name, LogPipeProfile *self, StatsClusterLabel *labels)
+{
+  labels[0] = stats_cluster_label("location", self->location);
+  labels[1] = stats_cluster_label("kind", self->kind);
+  stats_cluster_single_key_set(sc_key, name, labels, 2);
+}
+
+static void
+_register_counters(LogPipeProfile *self)
+{
+  StatsClusterLabel labels[2];
+  StatsClusterKey sc_key;
+
+  stats_lock();
+  _format_key(&sc_key, "pipe_profile_time_nanoseconds_total", self, labels);
+  stats_cluster_single_key_add_unit(&sc_key, SCU_NANOSECONDS);
+  stats_register_counter(STATS_LEVEL0, &sc_key, SC_TYPE_SINGLE_VALUE, &self->time_nsec);
+
+  _format_key(&sc_key, "pipe_profile_invocations_total", self, labels);
+  stats_register_counter(STATS_LEVEL0, &sc_key, SC_TYPE_SINGLE_VALUE, &self->invocations);
+
+  _format_key(&sc_key, "pipe_profile_dropped_total", self, labels);
+  stats_register_counter(STATS_LEVEL0, &sc_key, SC_TYPE_SINGLE_VALUE, &self->dropped);
+
+  _format_key(&sc_key, "pipe_profile_errors_total", self, labels);
+  stats_register_counter(STATS_LEVEL0, &sc_key, SC_TYPE_SINGLE_VALUE, &self->errors);
+  stats_unlock();
+}
+
+static void
+_unregister_counters(LogPipeProfile *self)
+{
+  StatsClusterLabel labels[2];
+  StatsClusterKey sc_key;
+
+  stats_lock();
+  _format_key(&sc_key, "pipe_profile_time_nanoseconds_total", self, labels);
+  stats_cluster_single_key_add_unit(&sc_key, SCU_NANOSECONDS);
+  stats_unregister_counter(&sc_key, SC_TYPE_SINGLE_VALUE, &self->time_nsec);
+
+  _format_key(&sc_key, "pipe_profile_invocations_total", self, labels);
+  stats_unregister_counter(&sc_key, SC_TYPE_SINGLE_VALUE, &self->invocations);
+
+  _format_key(&sc_key, "pipe_profile_dropped_total", self, labels);
+  stats_unregister_counter(&sc_key, SC_TYPE_SINGLE_VALUE, &self->dropped);
+
+  _format_key(&sc_key, "pipe_profile_errors_total", self, labels);
+  stats_unregister_counter(&sc_key, SC_TYPE_SINGLE_VALUE, &self->errors);
+  stats_unlock();
+}
+
+static const gchar *
+_get_kind(LogPipe *pipe)
+{
+  if (pipe->plugin_name)
+    return pipe->plugin_name;
+
+  for (LogExprNode *node = pipe->expr_node; node; node = node->parent)
+    {
+      if (node->content < ENC_MAX)
+        return log_expr_node_get_content_name(node->content);
+    }
+  return "pipe";
+}
+
+static LogPipeProfile *
+_profile_new(const gchar *location, const gchar *kind, gint sample_rate)
+{
+  LogPipeProfile *self = g_new0(LogPipeProfile, 1);
+
+  self->ref_cnt = 1;
+  self->location = g_strdup(location);
+  self->kind = g_strdup(kind);
+  self->sample_rate = sample_rate;
+
+  /* used as a frame of folded stacks, where ';' and ' ' are separators */
+  gchar *label = g_strdup_printf("%s@%s", kind, location);
+  g_strdelimit(label, "; ", '_');
+  self->label = g_intern_string(label);
+  g_free(label);
+
+  _register_counters(self);
+  return self;
+}
+
+static void
+_profile_free(LogPipeProfile *self)
+{
+  _unregister_counters(self);
+  g_free(self->location);
+  g_free(self->kind);
+  g_free(self);
+}
+
+void
+pipe_profiler_attach(LogPipe *pipe, gint sample_rate)
+{
+  gchar location[256];
+
+  if (pipe->profile)
+    return;
+
+  log_expr_node_format_location(pipe->expr_node, location, sizeof(location));
+
+  g_mutex_lock(&profiles_lock);
+  if (!profiles)
+    profiles = g_hash_table_new(g_str_hash, g_str_equal);
+
+  LogPipeProfile *profile = g_hash_table_lookup(profiles, location);
+  if (profile)
+    {
+      profile->ref_cnt++;
+    }
+  else
+    {
+      profile = _profile_new(location, _get_kind(pipe), sample_rate);
+      g_hash_table_insert(profiles, profile->location, profile);
+    }
+  g_mutex_unlock(&profiles_lock);
+
+  pipe->profile = profile;
+  pipe->flags |= PIF_PROFILED;
+}
+
+void
+pipe_profiler_detach(LogPipe *pipe)
+{
+  LogPipeProfile *profile = pipe->profile;
+
+  if (!profile)
+    return;
+
+  pipe->flags &= ~PIF_PROFILED;
+  pipe->profile = NULL;
+
+  g_mutex_lock(&profiles_lock);
+  if (--profile->ref_cnt == 0)
+    {
+      g_hash_table_remove(profiles, profile->location);
+      _profile_free(profile);
+
+      if (g_hash_table_size(profiles) == 0)
+        g_clear_pointer(&profiles, g_hash_table_unref);
+    }
+  g_mutex_unlock(&profiles_lock);
+}
+
+void
+pipe_profiler_enter(LogPipe *pipe, PipeProfilerFrame *frame)
+{
+  LogPipeProfile *profile = pipe->profile;
+
+  stats_counter_inc(profile->invocations);
+
+  frame->profile = profile;
+  frame->outer = current_frame;
+  frame->sample_root = FALSE;
+
+  /* the stack sampler walks the chain from a signal handler on this thread */
+  __atomic_signal_fence(__ATOMIC_SEQ_CST);
+  current_frame = frame;
+
+  if (!sampling)
+    {
+      if (profile->sample_rate == 0 || --sample_countdown > 0)
+        {
+          frame->timed = FALSE;
+          return;
+        }
+
+      /* this message is timed on every profiled pipe it passes through */
+      sample_countdown = profile->sample_rate;
+      sampling = TRUE;
+      frame->sample_root = TRUE;
+    }
+
+  frame->timed = TRUE;
+  frame->outer_child_nsec = child_nsec;
+  child_nsec = 0;
+  stopwatch_start(&frame->stopwatch);
+}
+
+void
+pipe_profiler_leave(PipeProfilerFrame *frame)
+{
+  if (frame->timed)
+    {
+      guint64 elapsed = stopwatch_get_elapsed_nsec(&frame->stopwatch);
+      guint64 own = elapsed > child_nsec ? elapsed - child_nsec : 0;
+
+      stats_counter_add(frame->profile->time_nsec, (gssize) (own * frame->profile->sample_rate));
+      child_nsec = frame->outer_child_nsec + elapsed;
+
+      if (frame->sample_root)
+        sampling = FALSE;
+    }
+
+  current_frame = frame->outer;
+}
+
+/* called from log_msg_drop(), attributed to the innermost profiled pipe */
+void
+pipe_profiler_record_drop(AckType ack_type)
+{
+  PipeProfilerFrame *frame = current_frame;
+
+  if (G_LIKELY(!frame))
+    return;
+
+  LogPipeProfile *profile = frame->profile;
+  if (ack_type == AT_PROCESSED)
+    stats_counter_inc(profile->dropped);
+  else
+    stats_counter_inc(profile->errors);
+}
+
+/*
+ * Returns the labels of the profiled pipes the current thread is in,
+ * outermost first.  Async-signal-safe.
+ */
+gint
+pipe_profiler_get_current_chain(const gchar **labels, gint max_labels)
+{
+  gint depth = 0;
+
+  for (PipeProfilerFrame *frame = current_frame; frame; frame = frame->outer)
+    depth++;
+
+  gint num_labels = MIN(depth, max_labels);
+  gint i = depth;
+  for (PipeProfilerFrame *frame = current_frame; frame; frame = frame->outer)
+    {
+      i--;
+      if (i < num_labels)
+        labels[i] = frame->profile->label;
+    }
+  return num_labels;
+}
+
+static struct
+{
+  const gchar *name;
+  PipeProfilerSortKey key;
+} sort_keys[] =
+{
+  { "time", PPS_TIME },
+  { "invocations", PPS_INVOCATIONS },
+  { "dropped", PPS_DROPPED },
+};
+
+gboolean
+pipe_profiler_lookup_sort_key(const gchar *name, PipeProfilerSortKey *key)
+{
+  for (gint i = 0; i < G_N_ELEMENTS(sort_keys); i++)
+    {
+      if (g_ascii_strcasecmp(sort_keys[i].name, name) == 0)
+        {
+          *key = sort_keys[i].key;
+          return TRUE;
+        }
+    }
+  return FALSE;
+}
+
+typedef struct _ProfileSnapshot
+{
+  const gchar *location;
+  const gchar *kind;
+  gsize time_nsec;
+  gsize invocations;
+  gsize dropped;
+  gsize errors;
+} ProfileSnapshot;
+
+static gsize
+_get_sort_value(const ProfileSnapshot *snapshot, PipeProfilerSortKey sort_key)
+{
+  switch (sort_key)
+    {
+    case PPS_INVOCATIONS:
+      return snapshot->invocations;
+    case PPS_DROPPED:
+      return snapshot->dropped + snapshot->errors;
+    case PPS_TIME:
+    default:
+      return snapshot->time_nsec;
+    }
+}
+
+static gint
+_compare_snapshots(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  PipeProfilerSortKey sort_key = GPOINTER_TO_INT(user_data);
+  gsize va = _get_sort_value(a, sort_key);
+  gsize vb = _get_sort_value(b, sort_key);
+
+  if (va != vb)
+    return va > vb ? -1 : 1;
+  return strcmp(((const ProfileSnapshot *) a)->location, ((const ProfileSnapshot *) b)->location);
+}
+
+static void
+_append_report_line(GString *report, const ProfileSnapshot *snapshot, gsize total_nsec)
+{
+  gdouble share = total_nsec ? 100.0 * snapshot->time_nsec / total_nsec : 0;
+  gsize nsec_per_msg = snapshot->invocations ? snapshot->time_nsec / snapshot->invocations : 0;
+
+  g_string_append_printf(report, "%6.2f%% %15" G_GSIZE_FORMAT " %12" G_GSIZE_FORMAT " %10" G_GSIZE_FORMAT
+                         " %10" G_GSIZE_FORMAT " %10" G_GSIZE_FORMAT "  %-16s %s\n",
+                         share, snapshot->time_nsec, snapshot->invocations, nsec_per_msg,
+                         snapshot->dropped, snapshot->errors, snapshot->kind, snapshot->location);
+}
+
+GString *
+pipe_profiler_format_report(gint top_n, PipeProfilerSortKey sort_key)
+{
+  GString *report = g_string_new("");
+  GArray *snapshots = g_array_new(FALSE, FALSE, sizeof(ProfileSnapshot));
+  gsize total_nsec = 0;
+
+  g_mutex_lock(&profiles_lock);
+  if (profiles)
+    {
+      GHashTableIter iter;
+      LogPipeProfile *profile;
+
+      g_hash_table_iter_init(&iter, profiles);
+      while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &profile))
+        {
+          ProfileSnapshot snapshot =
+          {
+            .location = profile->location,
+            .kind = profile->kind,
+            .time_nsec = stats_counter_get(profile->time_nsec),
+            .invocations = stats_counter_get(profile->invocations),
+            .dropped = stats_counter_get(profile->dropped),
+            .errors = stats_counter_get(profile->errors),
+          };
+          total_nsec += snapshot.time_nsec;
+          g_array_append_val(snapshots, snapshot);
+        }
+    }
+
+  g_array_sort_with_data(snapshots, _compare_snapshots, GINT_TO_POINTER(sort_key));
+
+  g_string_append_printf(report, "%7s %15s %12s %10s %10s %10s  %-16s %s\n",
+                         "time%", "time_nsec", "invocations", "nsec/msg", "dropped", "errors", "kind", "location");
+  for (guint i = 0; i < snapshots->len && (top_n <= 0 || i < top_n); i++)
+    _append_report_line(report, &g_array_index(snapshots, ProfileSnapshot, i), total_nsec);
+  g_mutex_unlock(&profiles_lock);
+
+  g_array_free(snapshots, TRUE);
+  return report;
+}
+
+void
+pipe_profiler_reset(void)
+{
+  g_mutex_lock(&profiles_lock);
+  if (profiles)
+    {
+      GHashTableIter iter;
+      LogPipeProfile *profile;
+
+      g_hash_table_iter_init(&iter, profiles);
+      while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &profile))
+        {
+          stats_counter_set(profile->time_nsec, 0);
+          stats_counter_set(profile->invocations, 0);
+          stats_counter_set(profile->dropped, 0);
+          stats_counter_set(profile->errors, 0);
+        }
+    }
+  g_mutex_unlock(&profiles_lock);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef PIPE_PROFILER_H_INCLUDED
+#define PIPE_PROFILER_H_INCLUDED
+
+#include "syslog-ng.h"
+#include "logmsg/logmsg.h"
+#include "healthcheck/stopwatch.h"
+
+/*
+ * Sampled per-LogPipe profiling.
+ *
+ * Config related pipes (drivers, filters, parsers, rewrite rules, filterx
+ * blocks) get a LogPipeProfile when stats(profile-sample-rate()) or
+ * stats(stack-sample-frequency()) is non-zero.  Every invocation is
+ * counted, and every Nth message that enters a profiled pipe on a thread
+ * is timed along its whole synchronous path.  The time of a pipe excludes the time spent in the
+ * profiled pipes it forwards to, and is scaled up by the sample rate, so
+ * the counters estimate the total time spent in the object.
+ *
+ * Profiles are keyed by the config location of the pipe, clones of the
+ * same object share a profile.
+ */
+typedef struct _LogPipeProfile LogPipeProfile;
+
+typedef struct _PipeProfilerFrame PipeProfilerFrame;
+struct _PipeProfilerFrame
+{
+  LogPipeProfile *profile;
+  PipeProfilerFrame *outer;
+  guint64 outer_child_nsec;
+  Stopwatch stopwatch;
+  gboolean timed;
+  gboolean sample_root;
+};
+
+typedef enum
+{
+  PPS_TIME,
+  PPS_INVOCATIONS,
+  PPS_DROPPED,
+} PipeProfilerSortKey;
+
+void pipe_profiler_attach(LogPipe *pipe, gint sample_rate);
+void pipe_profiler_detach(LogPipe *pipe);
+
+void pipe_profiler_enter(LogPipe *pipe, PipeProfilerFrame *frame);
+void pipe_profiler_leave(PipeProfilerFrame *frame);
+void pipe_profiler_record_drop(AckType ack_type);
+gint pipe_profiler_get_current_chain(const gchar **labels, gint max_labels);
+
+gboolean pipe_profiler_lookup_sort_key(const gchar *name, PipeProfilerSortKey *key);
+GString *pipe_profiler_format_report(gint top_n, PipeProfilerSortKey sort_key);
+void pipe_profiler_reset(void);
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "profiler/profiler-control.h"
+#include "profiler/pipe-profiler.h"
+#include "profiler/stack-sampler.h"
+#include "control/control-commands.h"
+#include "control/control-connection.h"
+
+#include <stdlib.h>
+
+#define DEFAULT_TOP_N 20
+
+/*
+ * PROFILE [TOP <n>] [SORT <time|invocations|dropped>]
+ * PROFILE RESET
+ */
+static void
+control_connection_profile(ControlConnection *cc, GString *command, gpointer user_data, gboolean *cancelled)
+{
+  gchar **cmds = g_strsplit(command->str, " ", -1);
+  gint top_n = DEFAULT_TOP_N;
+  PipeProfilerSortKey sort_key = PPS_TIME;
+  GString *result;
+
+  g_assert(g_str_equal(cmds[0], "PROFILE"));
+
+  if (g_strcmp0(cmds[1], "RESET") == 0)
+    {
+      pipe_profiler_reset();
+      result = g_string_new("OK The profile counters have been reset to 0.");
+      goto exit;
+    }
+
+  for (gint i = 1; cmds[i]; i++)
+    {
+      if (g_str_equal(cmds[i], "TOP") && cmds[i + 1])
+        {
+          top_n = atoi(cmds[++i]);
+        }
+      else if (g_str_equal(cmds[i], "SORT") && cmds[i + 1])
+        {
+          if (!pipe_profiler_lookup_sort_key(cmds[++i], &sort_key))
+            {
+              result = g_string_new("FAIL Unknown sort key, expected one of: time, invocations, dropped");
+              goto exit;
+            }
+        }
+      else if (cmds[i][0])
+        {
+          result = g_string_new("FAIL Invalid arguments received");
+          goto exit;
+        }
+    }
+
+  result = pipe_profiler_format_report(top_n, sort_key);
+  g_string_prepend(result, "OK ");
+
+exit:
+  g_strfreev(cmds);
+  control_connection_send_reply(cc, result);
+}
+
+static void
+_send_folded_stack(const gchar *stack, guint64 count, gpointer user_data)
+{
+  static const gsize BATCH_LEN = 2048;
+
+  gpointer *args = (gpointer *) user_data;
+  ControlConnection *cc = (ControlConnection *) args[0];
+  GString **batch = (GString **) args[1];
+
+  if (!*batch)
+    *batch = g_string_sized_new(BATCH_LEN + 512);
+  g_string_append_printf(*batch, "%s %" G_GUINT64_FORMAT "\n", stack, count);
+
+  if ((*batch)->len > BATCH_LEN)
+    {
+      control_connection_send_batched_reply(cc, *batch);
+      *batch = NULL;
+    }
+}
+
+/*
+ * PROFILE_STACKS
+ * PROFILE_STACKS RESET
+ *
+ * The samples are returned as folded stacks, one per line.
+ */
+static void
+control_connection_profile_stacks(ControlConnection *cc, GString *command, gpointer user_data, gboolean *cancelled)
+{
+  if (g_str_equal(command->str, "PROFILE_STACKS RESET"))
+    {
+      stack_sampler_reset();
+      control_connection_send_reply(cc, g_string_new("OK The stack samples have been cleared."));
+      return;
+    }
+
+  if (!stack_sampler_is_supported())
+    {
+      control_connection_send_reply(cc, g_string_new("FAIL Stack sampling is not supported on this platform"));
+      return;
+    }
+
+  GString *batch = NULL;
+  gpointer args[] = { cc, &batch };
+
+  stack_sampler_foreach_folded_stack(_send_folded_stack, args);
+
+  if (batch)
+    control_connection_send_batched_reply(cc, batch);
+  control_connection_send_close_batch(cc);
+}
+
+void
+profiler_register_control_commands(void)
+{
+  control_register_command("PROFILE", control_connection_profile, NULL, FALSE);
+  control_register_command("PROFILE_STACKS", control_connection_profile_stacks, NULL, TRUE);
+}
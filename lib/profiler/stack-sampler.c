@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "profiler/stack-sampler.h"
+#include "profiler/pipe-profiler.h"
+#include "apphook.h"
+#include "messages.h"
+#include "tls-support.h"
+#include "timeutils/misc.h"
+
+#include <iv.h>
+#include <string.h>
+#include <errno.h>
+
+#if SYSLOG_NG_HAVE_EXECINFO_H && SYSLOG_NG_HAVE_SIGEV_THREAD_ID
+#define STACK_SAMPLER_SUPPORTED 1
+#endif
+
+#if STACK_SAMPLER_SUPPORTED
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif
+
+#define STACK_SAMPLER_SIGNAL        SIGPROF
+#define STACK_SAMPLER_RING_SIZE     1024
+#define STACK_SAMPLER_MAX_FRAMES    48
+#define STACK_SAMPLER_MAX_PIPES     16
+#define STACK_SAMPLER_DRAIN_FREQ    1000
+
+/* the signal handler and the trampoline that called it */
+#define STACK_SAMPLER_SKIPPED_FRAMES 2
+
+typedef struct _StackSample
+{
+  gint num_frames;
+  gint num_pipes;
+  gpointer frames[STACK_SAMPLER_MAX_FRAMES];
+  const gchar *pipes[STACK_SAMPLER_MAX_PIPES];
+} StackSample;
+
+/*
+ * Single producer (the signal handler of the thread), single consumer
+ * (the drain, under sampler_lock) ring buffer.  head is only written by
+ * the producer, tail only by the consumer.
+ *
+ * Every thread is registered, but the ring and the timer are only set up
+ * once sampling is enabled, possibly from the main thread, so the
+ * identity of the thread is stored to create the timer on its behalf.
+ */
+typedef struct _StackSamplerThread
+{
+#if STACK_SAMPLER_SUPPORTED
+  pid_t tid;
+  clockid_t cpu_clock;
+  timer_t timer;
+#endif
+  gboolean timer_created;
+  gint head;
+  gint tail;
+  gint lost;
+  StackSample *ring;
+} StackSamplerThread;
+
+TLS_BLOCK_START
+{
+  StackSamplerThread *sampler_thread;
+}
+TLS_BLOCK_END;
+
+#define sampler_thread __tls_deref(sampler_thread)
+
+static GMutex sampler_lock;
+static GList *sampler_threads;
+static gint sampler_frequency;
+static gboolean signal_handler_installed;
+static GHashTable *folded_stacks;
+static GHashTable *symbol_cache;
+static guint64 lost_samples;
+static struct iv_timer drain_timer;
+
+#if STACK_SAMPLER_SUPPORTED
+
+static void
+_signal_handler(int signo, siginfo_t *info, void *ucontext)
+{
+  StackSamplerThread *self = sampler_thread;
+  gint saved_errno = errno;
+
+  if (!self)
+    goto exit;
+
+  StackSample *ring = g_atomic_pointer_get(&self->ring);
+  if (!ring)
+    goto exit;
+
+  gint head = self->head;
+  if (head - g_atomic_int_get(&self->tail) >= STACK_SAMPLER_RING_SIZE)
+    {
+      g_atomic_int_inc(&self->lost);
+      goto exit;
+    }
+
+  StackSample *sample = &ring[head % STACK_SAMPLER_RING_SIZE];
+  sample->num_frames = backtrace(sample->frames, STACK_SAMPLER_MAX_FRAMES);
+  sample->num_pipes = pipe_profiler_get_current_chain(sample->pipes, STACK_SAMPLER_MAX_PIPES);
+  g_atomic_int_set(&self->head, head + 1);
+
+exit:
+  errno = saved_errno;
+}
+
+static void
+_arm_timer(StackSamplerThread *self, gint frequency)
+{
+  struct itimerspec spec = { 0 };
+
+  if (!self->timer_created)
+    return;
+
+  if (frequency > 0)
+    {
+      glong interval_nsec = 1000000000L / frequency;
+
+      spec.it_interval.tv_sec = interval_nsec / 1000000000L;
+      spec.it_interval.tv_nsec = interval_nsec % 1000000000L;
+      spec.it_value = spec.it_interval;
+    }
+  timer_settime(self->timer, 0, &spec, NULL);
+}
+
+/* runs in the sampled thread itself */
+static gboolean
+_identify_thread(StackSamplerThread *self)
+{
+  sigset_t mask;
+
+  if (pthread_getcpuclockid(pthread_self(), &self->cpu_clock) != 0)
+    return FALSE;
+  self->tid = syscall(SYS_gettid);
+
+  /* the signal is only ever sent to this thread once its timer is created */
+  sigemptyset(&mask);
+  sigaddset(&mask, STACK_SAMPLER_SIGNAL);
+  pthread_sigmask(SIG_UNBLOCK, &mask, NULL);
+  return TRUE;
+}
+
+/* may run in any thread, the timer measures and signals the sampled one */
+static gboolean
+_create_timer(StackSamplerThread *self)
+{
+  struct sigevent sev = { 0 };
+
+  if (self->timer_created)
+    return TRUE;
+
+  sev.sigev_notify = SIGEV_THREAD_ID;
+  sev.sigev_signo = STACK_SAMPLER_SIGNAL;
+  sev.sigev_notify_thread_id = self->tid;
+
+  if (timer_create(self->cpu_clock, &sev, &self->timer) < 0)
+    {
+      msg_error("stack-sampler: error creating the sampling timer of a worker thread",
+                evt_tag_error("error"));
+      return FALSE;
+    }
+  self->timer_created = TRUE;
+  return TRUE;
+}
+
+static void
+_delete_timer(StackSamplerThread *self)
+{
+  if (self->timer_created)
+    timer_delete(self->timer);
+  self->timer_created = FALSE;
+}
+
+static void
+_install_signal_handler(void)
+{
+  struct sigaction sa;
+  gpointer dummy[1];
+
+  if (signal_handler_installed)
+    return;
+  signal_handler_installed = TRUE;
+
+  /* the first call of backtrace() loads libgcc, which is not async-signal-safe */
+  backtrace(dummy, 1);
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = _signal_handler;
+  sa.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  sigaction(STACK_SAMPLER_SIGNAL, &sa, NULL);
+}
+
+/* "/path/libfoo.so(function+0x1f) [0x7f...]" -> "function" */
+static gchar *
+_format_symbol(gpointer address)
+{
+  gchar **symbols = backtrace_symbols(&address, 1);
+  gchar *result = NULL;
+
+  if (symbols)
+    {
+      gchar *start = strchr(symbols[0], '(');
+      gchar *end = start ? strpbrk(start, "+)") : NULL;
+
+      if (start && end && end > start + 1)
+        result = g_strndup(start + 1, end - start - 1);
+      else if (start)
+        result = g_strdup_printf("%.*s", (gint) (start - symbols[0]), symbols[0]);
+      free(symbols);
+    }
+
+  if (!result)
+    result = g_strdup_printf("%p", address);
+  g_strdelimit(result, "; ", '_');
+  return result;
+}
+
+#else
+
+static void
+_arm_timer(StackSamplerThread *self, gint frequency)
+{
+}
+
+static gboolean
+_identify_thread(StackSamplerThread *self)
+{
+  return FALSE;
+}
+
+static gboolean
+_create_timer(StackSamplerThread *self)
+{
+  return FALSE;
+}
+
+static void
+_delete_timer(StackSamplerThread *self)
+{
+}
+
+static void
+_install_signal_handler(void)
+{
+}
+
+static gchar *
+_format_symbol(gpointer address)
+{
+  return g_strdup_printf("%p", address);
+}
+
+#endif
+
+gboolean
+stack_sampler_is_supported(void)
+{
+#if STACK_SAMPLER_SUPPORTED
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+static const gchar *
+_lookup_symbol(gpointer address)
+{
+  const gchar *symbol = g_hash_table_lookup(symbol_cache, address);
+
+  if (!symbol)
+    {
+      gchar *formatted = _format_symbol(address);
+      symbol = g_intern_string(formatted);
+      g_free(formatted);
+      g_hash_table_insert(symbol_cache, address, (gpointer) symbol);
+    }
+  return symbol;
+}
+
+/* root first: config objects, then the C stack, outermost frame first */
+static gchar *
+_fold_sample(StackSample *sample)
+{
+  GString *folded = g_string_sized_new(256);
+
+  g_string_append(folded, "syslog-ng");
+  for (gint i = 0; i < sample->num_pipes; i++)
+    g_string_append_printf(folded, ";[%s]", sample->pipes[i]);
+
+  for (gint i = sample->num_frames - 1; i >= STACK_SAMPLER_SKIPPED_FRAMES; i--)
+    {
+      g_string_append_c(folded, ';');
+      g_string_append(folded, _lookup_symbol(sample->frames[i]));
+    }
+  return g_string_free(folded, FALSE);
+}
+
+static void
+_add_folded_stack(gchar *folded)
+{
+  guint64 *count = g_hash_table_lookup(folded_stacks, folded);
+
+  if (count)
+    {
+      (*count)++;
+      g_free(folded);
+      return;
+    }
+
+  count = g_new(guint64, 1);
+  *count = 1;
+  g_hash_table_insert(folded_stacks, folded, count);
+}
+
+static void
+_drain_thread(StackSamplerThread *self)
+{
+  if (!self->ring)
+    return;
+
+  gint head = g_atomic_int_get(&self->head);
+
+  for (gint tail = self->tail; tail != head; tail++)
+    _add_folded_stack(_fold_sample(&self->ring[tail % STACK_SAMPLER_RING_SIZE]));
+
+  g_atomic_int_set(&self->tail, head);
+
+  gint lost = g_atomic_int_get(&self->lost);
+  if (lost)
+    {
+      g_atomic_int_add(&self->lost, -lost);
+      lost_samples += lost;
+    }
+}
+
+/* must be called with sampler_lock held */
+static void
+_drain(void)
+{
+  for (GList *l = sampler_threads; l; l = l->next)
+    _drain_thread((StackSamplerThread *) l->data);
+}
+
+static void
+_drain_timer_elapsed(gpointer user_data)
+{
+  g_mutex_lock(&sampler_lock);
+  _drain();
+  g_mutex_unlock(&sampler_lock);
+
+  iv_validate_now();
+  drain_timer.expires = iv_now;
+  timespec_add_msec(&drain_timer.expires, STACK_SAMPLER_DRAIN_FREQ);
+  iv_timer_register(&drain_timer);
+}
+
+void
+stack_sampler_foreach_folded_stack(StackSamplerFoldedStackFunc func, gpointer user_data)
+{
+  GHashTableIter iter;
+  gchar *folded;
+  guint64 *count;
+
+  g_mutex_lock(&sampler_lock);
+  _drain();
+
+  g_hash_table_iter_init(&iter, folded_stacks);
+  while (g_hash_table_iter_next(&iter, (gpointer *) &folded, (gpointer *) &count))
+    func(folded, *count, user_data);
+
+  if (lost_samples)
+    func("syslog-ng;[lost-samples]", lost_samples, user_data);
+  g_mutex_unlock(&sampler_lock);
+}
+
+void
+stack_sampler_reset(void)
+{
+  g_mutex_lock(&sampler_lock);
+  _drain();
+  g_hash_table_remove_all(folded_stacks);
+  lost_samples = 0;
+  g_mutex_unlock(&sampler_lock);
+}
+
+/*
+ * Sets up the ring and the timer of a thread when sampling is enabled
+ * for the first time. They are kept until the thread exits, as the
+ * signal handler of the thread may still be using them.
+ *
+ * must be called with sampler_lock held
+ */
+static void
+_apply_frequency(StackSamplerThread *self, gint frequency)
+{
+  if (frequency > 0)
+    {
+      if (!self->ring)
+        g_atomic_pointer_set(&self->ring, g_new0(StackSample, STACK_SAMPLER_RING_SIZE));
+
+      if (!_create_timer(self))
+        return;
+    }
+  _arm_timer(self, frequency);
+}
+
+void
+stack_sampler_set_frequency(gint frequency)
+{
+  if (frequency > 0 && !stack_sampler_is_supported())
+    {
+      msg_warning("WARNING: stack-sample-frequency() is not supported on this platform, ignoring");
+      frequency = 0;
+    }
+
+  if (frequency > 0)
+    _install_signal_handler();
+
+  g_mutex_lock(&sampler_lock);
+  if (frequency != sampler_frequency)
+    {
+      sampler_frequency = frequency;
+      for (GList *l = sampler_threads; l; l = l->next)
+        _apply_frequency((StackSamplerThread *) l->data, frequency);
+    }
+  g_mutex_unlock(&sampler_lock);
+
+  if (frequency > 0 && !iv_timer_registered(&drain_timer))
+    _drain_timer_elapsed(NULL);
+  else if (frequency == 0 && iv_timer_registered(&drain_timer))
+    iv_timer_unregister(&drain_timer);
+}
+
+static void
+_thread_init(gpointer user_data)
+{
+  if (!stack_sampler_is_supported())
+    return;
+
+  StackSamplerThread *self = g_new0(StackSamplerThread, 1);
+  if (!_identify_thread(self))
+    {
+      g_free(self);
+      return;
+    }
+
+  g_mutex_lock(&sampler_lock);
+  sampler_threads = g_list_prepend(sampler_threads, self);
+  sampler_thread = self;
+  _apply_frequency(self, sampler_frequency);
+  g_mutex_unlock(&sampler_lock);
+}
+
+static void
+_thread_deinit(gpointer user_data)
+{
+  StackSamplerThread *self = sampler_thread;
+
+  if (!self)
+    return;
+
+  /* under the lock, so that enabling the sampler does not create a timer
+   * for this thread in the meantime */
+  g_mutex_lock(&sampler_lock);
+  sampler_threads = g_list_remove(sampler_threads, self);
+  _delete_timer(self);
+  sampler_thread = NULL;
+  _drain_thread(self);
+  g_mutex_unlock(&sampler_lock);
+
+  g_free(self->ring);
+  g_free(self);
+}
+
+void
+stack_sampler_global_init(void)
+{
+  folded_stacks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  symbol_cache = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+  IV_TIMER_INIT(&drain_timer);
+  drain_timer.handler = _drain_timer_elapsed;
+
+  /* the signal handler is only installed once sampling is enabled */
+  register_application_thread_init_hook(_thread_init, NULL);
+  register_application_thread_deinit_hook(_thread_deinit, NULL);
+
+  /* the main thread also runs the pipelines of non-threaded sources */
+  _thread_init(NULL);
+}
+
+void
+stack_sampler_global_deinit(void)
+{
+  if (iv_timer_registered(&drain_timer))
+    iv_timer_unregister(&drain_timer);
+
+  _thread_deinit(NULL);
+  g_hash_table_unref(folded_stacks);
+  g_hash_table_unref(symbol_cache);
+  folded_stacks = NULL;
+  symbol_cache = NULL;
+  lost_samples = 0;
+  sampler_frequency = 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef STACK_SAMPLER_H_INCLUDED
+#define STACK_SAMPLER_H_INCLUDED
+
+#include "syslog-ng.h"
+
+/*
+ * Statistical profiler for worker threads.
+ *
+ * With stats(stack-sample-frequency(N)), every worker thread gets a timer
+ * that fires N times per second of CPU time the thread uses.  The signal
+ * handler records the C stack and the chain of config objects the thread
+ * is processing into a per-thread ring buffer, without locking.  The
+ * buffers are drained periodically and aggregated into folded stacks,
+ * the input format of flamegraph.pl and similar tools.  Until sampling is
+ * enabled, neither the buffers, the timers nor the signal handler are set
+ * up.
+ */
+
+gboolean stack_sampler_is_supported(void);
+void stack_sampler_set_frequency(gint frequency);
+
+typedef void (*StackSamplerFoldedStackFunc)(const gchar *stack, guint64 count, gpointer user_data);
+void stack_sampler_foreach_folded_stack(StackSamplerFoldedStackFunc func, gpointer user_data);
+void stack_sampler_reset(void);
+
+void stack_sampler_global_init(void);
+void stack_sampler_global_deinit(void);
+
+#endif
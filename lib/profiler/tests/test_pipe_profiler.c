@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "profiler/pipe-profiler.h"
+#include "logpipe.h"
+#include "cfg-tree.h"
+#include "apphook.h"
+#include "stats/stats-counter.h"
+
+#include <string.h>
+
+static GlobalConfig *cfg;
+
+static void
+_forward(LogPipe *s, LogMessage *msg, const LogPathOptions *path_options)
+{
+  log_pipe_forward_msg(s, msg, path_options);
+}
+
+static void
+_drop(LogPipe *s, LogMessage *msg, const LogPathOptions *path_options)
+{
+  log_msg_drop(msg, path_options, AT_PROCESSED);
+}
+
+static LogPipe *
+_create_config_pipe(gint line, void (*queue)(LogPipe *, LogMessage *, const LogPathOptions *))
+{
+  CFG_LTYPE loc = { .first_line = line, .first_column = 1, .name = "test.conf" };
+  LogPipe *pipe = log_pipe_new(cfg);
+
+  pipe->queue = queue;
+  pipe->flags |= PIF_CONFIG_RELATED;
+  pipe->expr_node = log_expr_node_new(ENL_SINGLE, ENC_PARSER, NULL, NULL, 0, &loc);
+  return pipe;
+}
+
+static void
+_free_config_pipe(LogPipe *pipe)
+{
+  log_pipe_deinit(pipe);
+  log_expr_node_unref(pipe->expr_node);
+  pipe->expr_node = NULL;
+  log_pipe_unref(pipe);
+}
+
+static void
+_send_messages(LogPipe *pipe, gint num)
+{
+  for (gint i = 0; i < num; i++)
+    {
+      LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+      log_pipe_queue(pipe, log_msg_new_empty(), &path_options);
+    }
+}
+
+static gboolean
+_report_contains_line(GString *report, const gchar *location, gsize invocations, gsize dropped)
+{
+  gchar **lines = g_strsplit(report->str, "\n", -1);
+  gboolean found = FALSE;
+
+  for (gint i = 0; lines[i] && !found; i++)
+    {
+      gchar **fields = g_strsplit_set(g_strstrip(lines[i]), " ", -1);
+      GPtrArray *non_empty = g_ptr_array_new();
+
+      for (gint j = 0; fields[j]; j++)
+        if (fields[j][0])
+          g_ptr_array_add(non_empty, fields[j]);
+
+      /* time% time_nsec invocations nsec/msg dropped errors kind location */
+      if (non_empty->len == 8 && strcmp(g_ptr_array_index(non_empty, 7), location) == 0)
+        {
+          found = g_ascii_strtoull(g_ptr_array_index(non_empty, 2), NULL, 10) == invocations
+                  && g_ascii_strtoull(g_ptr_array_index(non_empty, 4), NULL, 10) == dropped;
+        }
+      g_ptr_array_free(non_empty, TRUE);
+      g_strfreev(fields);
+    }
+  g_strfreev(lines);
+  return found;
+}
+
+Test(pipe_profiler, pipes_are_not_profiled_by_default)
+{
+  LogPipe *pipe = _create_config_pipe(1, _drop);
+
+  cr_assert(log_pipe_init(pipe));
+  cr_assert_null(pipe->profile);
+  cr_assert_not(pipe->flags & PIF_PROFILED);
+
+  _free_config_pipe(pipe);
+}
+
+Test(pipe_profiler, invocations_and_drops_are_attributed_to_the_dropping_pipe)
+{
+  cfg->stats_options.profile_sample_rate = 3;
+
+  LogPipe *head = _create_config_pipe(1, _forward);
+  LogPipe *tail = _create_config_pipe(2, _drop);
+
+  log_pipe_append(head, tail);
+  cr_assert(log_pipe_init(head));
+  cr_assert(log_pipe_init(tail));
+  cr_assert(head->flags & PIF_PROFILED);
+
+  _send_messages(head, 10);
+
+  GString *report = pipe_profiler_format_report(0, PPS_INVOCATIONS);
+  cr_assert(_report_contains_line(report, "test.conf:1:1", 10, 0), "%s", report->str);
+  cr_assert(_report_contains_line(report, "test.conf:2:1", 10, 10), "%s", report->str);
+  g_string_free(report, TRUE);
+
+  pipe_profiler_reset();
+  report = pipe_profiler_format_report(0, PPS_INVOCATIONS);
+  cr_assert(_report_contains_line(report, "test.conf:2:1", 0, 0), "%s", report->str);
+  g_string_free(report, TRUE);
+
+  _free_config_pipe(head);
+  _free_config_pipe(tail);
+}
+
+Test(pipe_profiler, end_of_pipeline_is_not_a_drop)
+{
+  cfg->stats_options.profile_sample_rate = 1;
+
+  LogPipe *pipe = _create_config_pipe(1, _forward);
+  cr_assert(log_pipe_init(pipe));
+
+  _send_messages(pipe, 5);
+
+  GString *report = pipe_profiler_format_report(0, PPS_TIME);
+  cr_assert(_report_contains_line(report, "test.conf:1:1", 5, 0), "%s", report->str);
+  g_string_free(report, TRUE);
+
+  _free_config_pipe(pipe);
+}
+
+Test(pipe_profiler, clones_share_the_profile_of_their_location)
+{
+  cfg->stats_options.profile_sample_rate = 1;
+
+  LogPipe *pipe = _create_config_pipe(1, _drop);
+  LogPipe *clone = _create_config_pipe(1, _drop);
+
+  cr_assert(log_pipe_init(pipe));
+  cr_assert(log_pipe_init(clone));
+  cr_assert_eq(pipe->profile, clone->profile);
+
+  _send_messages(pipe, 2);
+  _send_messages(clone, 3);
+
+  GString *report = pipe_profiler_format_report(0, PPS_TIME);
+  cr_assert(_report_contains_line(report, "test.conf:1:1", 5, 5), "%s", report->str);
+  g_string_free(report, TRUE);
+
+  _free_config_pipe(pipe);
+  _free_config_pipe(clone);
+}
+
+Test(pipe_profiler, report_is_limited_to_top_n)
+{
+  cfg->stats_options.profile_sample_rate = 1;
+
+  LogPipe *busy = _create_config_pipe(1, _drop);
+  LogPipe *idle = _create_config_pipe(2, _drop);
+
+  cr_assert(log_pipe_init(busy));
+  cr_assert(log_pipe_init(idle));
+  _send_messages(busy, 4);
+  _send_messages(idle, 1);
+
+  GString *report = pipe_profiler_format_report(1, PPS_INVOCATIONS);
+  cr_assert(_report_contains_line(report, "test.conf:1:1", 4, 4), "%s", report->str);
+  cr_assert_null(strstr(report->str, "test.conf:2:1"), "%s", report->str);
+  g_string_free(report, TRUE);
+
+  _free_config_pipe(busy);
+  _free_config_pipe(idle);
+}
+
+static void
+setup(void)
+{
+  app_startup();
+  cfg = cfg_new_snippet();
+}
+
+static void
+teardown(void)
+{
+  cfg_free(cfg);
+  app_shutdown();
+}
+
+TestSuite(pipe_profiler, .init = setup, .fini = teardown);
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "profiler/stack-sampler.h"
+#include "profiler/pipe-profiler.h"
+#include "logpipe.h"
+#include "cfg-tree.h"
+#include "apphook.h"
+
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+static GlobalConfig *cfg;
+
+static void
+_burn_cpu(gint msec)
+{
+  struct timespec start, now;
+  volatile guint64 sum = 0;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+  do
+    {
+      for (gint i = 0; i < 100000; i++)
+        sum += i;
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    }
+  while ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 < msec);
+}
+
+static void
+_busy_queue(LogPipe *s, LogMessage *msg, const LogPathOptions *path_options)
+{
+  _burn_cpu(200);
+  log_msg_drop(msg, path_options, AT_PROCESSED);
+}
+
+typedef struct
+{
+  guint64 samples;
+  guint64 samples_in_pipe;
+} SampleCounts;
+
+static void
+_count_samples(const gchar *stack, guint64 count, gpointer user_data)
+{
+  SampleCounts *counts = (SampleCounts *) user_data;
+
+  cr_assert(g_str_has_prefix(stack, "syslog-ng"), "%s", stack);
+  cr_assert_null(strchr(stack, ' '), "%s", stack);
+
+  counts->samples += count;
+  if (strstr(stack, ";[parser@test.conf:7:1]"))
+    counts->samples_in_pipe += count;
+}
+
+Test(stack_sampler, samples_are_folded_with_the_pipe_chain)
+{
+  if (!stack_sampler_is_supported())
+    cr_skip_test("stack sampling is not supported on this platform");
+
+  CFG_LTYPE loc = { .first_line = 7, .first_column = 1, .name = "test.conf" };
+  LogPipe *pipe = log_pipe_new(cfg);
+  pipe->queue = _busy_queue;
+  pipe->flags |= PIF_CONFIG_RELATED;
+  pipe->expr_node = log_expr_node_new(ENL_SINGLE, ENC_PARSER, NULL, NULL, 0, &loc);
+
+  cfg->stats_options.stack_sample_frequency = 1000;
+  cr_assert(log_pipe_init(pipe));
+  cr_assert(pipe->flags & PIF_PROFILED);
+
+  stack_sampler_set_frequency(1000);
+  LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+  log_pipe_queue(pipe, log_msg_new_empty(), &path_options);
+  stack_sampler_set_frequency(0);
+
+  SampleCounts counts = { 0 };
+  stack_sampler_foreach_folded_stack(_count_samples, &counts);
+  cr_assert_gt(counts.samples_in_pipe, 0);
+  cr_assert_geq(counts.samples, counts.samples_in_pipe);
+
+  stack_sampler_reset();
+  counts = (SampleCounts) { 0 };
+  stack_sampler_foreach_folded_stack(_count_samples, &counts);
+  cr_assert_eq(counts.samples, 0);
+
+  log_pipe_deinit(pipe);
+  log_expr_node_unref(pipe->expr_node);
+  pipe->expr_node = NULL;
+  log_pipe_unref(pipe);
+}
+
+Test(stack_sampler, no_samples_when_disabled)
+{
+  SampleCounts counts = { 0 };
+
+  _burn_cpu(50);
+  stack_sampler_foreach_folded_stack(_count_samples, &counts);
+  cr_assert_eq(counts.samples, 0);
+}
+
+static gboolean
+_is_signal_handler_installed(void)
+{
+  struct sigaction sa;
+
+  cr_assert_eq(sigaction(SIGPROF, NULL, &sa), 0);
+  return sa.sa_handler != SIG_DFL;
+}
+
+Test(stack_sampler, signal_handler_is_only_installed_when_enabled)
+{
+  if (!stack_sampler_is_supported())
+    cr_skip_test("stack sampling is not supported on this platform");
+
+  cr_assert_not(_is_signal_handler_installed());
+  stack_sampler_set_frequency(0);
+  cr_assert_not(_is_signal_handler_installed());
+
+  stack_sampler_set_frequency(1000);
+  cr_assert(_is_signal_handler_installed());
+  _burn_cpu(50);
+  stack_sampler_set_frequency(0);
+
+  SampleCounts counts = { 0 };
+  stack_sampler_foreach_folded_stack(_count_samples, &counts);
+  cr_assert_gt(counts.samples, 0, "the thread registered while disabled is expected to be sampled once enabled");
+}
+
+static void
+setup(void)
+{
+  app_startup();
+  cfg = cfg_new_snippet();
+}
+
+static void
+teardown(void)
+{
+  cfg_free(cfg);
+  app_shutdown();
+}
+
+TestSuite(stack_sampler, .init = setup, .fini = teardown);
@@ -25,14 +25,41 @@
 #include "rcptid.h"
 #include "messages.h"
 #include "str-format.h"
+#include "tls-support.h"
+
+/* number of IDs a thread reserves at once, unless strict ordering is
+ * requested.  The persisted value is advanced by a whole block, so a
+ * restart may leave a gap of at most this many IDs per thread. */
+#define RCPTID_BLOCK_SIZE 4096
 
 static struct _RcptidService
 {
   PersistState *persist_state;
   PersistEntryHandle persist_handle;
   GMutex lock;
+  gboolean strict_order;
+
+  /* bumped whenever the persisted counter is (re)initialized or set
+   * explicitly, invalidating the blocks reserved by the threads */
+  gint generation;
+  /* the persisted value right after the last reservation, the blocks
+   * handed out so far are all below it */
+  guint64 reserved_until;
 } rcptid_service;
 
+TLS_BLOCK_START
+{
+  struct
+  {
+    gint generation;
+    guint64 next;
+    guint64 left;
+  } rcptid_block;
+}
+TLS_BLOCK_END;
+
+#define rcptid_block __tls_deref(rcptid_block)
+
 /* NOTE: RcptIdInstance is a singleton, so we don't pass self around as an argument */
 
 #define self (&rcpt_instance)
@@ -75,6 +102,11 @@ rcptid_restore_entry(void)
       data->g_rcptid = GUINT64_SWAP_LE_BE(data->g_rcptid);
     }
 
+  /* a reload restores the very counter we have been reserving from, the
+   * blocks of the threads remain valid unless the state was replaced */
+  if (data->g_rcptid != rcptid_service.reserved_until)
+    g_atomic_int_inc(&rcptid_service.generation);
+
   rcptid_unmap_state();
   return TRUE;
 }
@@ -97,6 +129,8 @@ rcptid_create_new_entry(void)
   data->header.big_endian = (G_BYTE_ORDER == G_BIG_ENDIAN);
   data->g_rcptid = 1;
   rcptid_unmap_state();
+
+  g_atomic_int_inc(&rcptid_service.generation);
   return TRUE;
 }
 
@@ -121,40 +155,76 @@ rcptid_set_id(guint64 id)
 
   data = rcptid_map_state();
   data->g_rcptid = id;
+  rcptid_service.reserved_until = id;
 
   rcptid_unmap_state();
 
+  g_atomic_int_inc(&rcptid_service.generation);
   g_mutex_unlock(&rcptid_service.lock);
 }
 
-guint64
-rcptid_generate_id(void)
+/* reserves at most @count IDs, returns the first one in @first and the
+ * number of reserved IDs, which is less than @count when the counter wraps
+ * around.  Must be called with the lock held. */
+static guint64
+rcptid_reserve_ids(guint64 count, guint64 *first)
 {
-  RcptidState *data;
-  guint64 new_id;
-
-  if (!rcptid_is_initialized())
-    return 0;
+  RcptidState *data = rcptid_map_state();
 
-  g_mutex_lock(&rcptid_service.lock);
+  *first = data->g_rcptid;
 
-  data = rcptid_map_state();
+  /* IDs up to G_MAXUINT64 are valid, 0 is skipped when wrapping around */
+  guint64 available = G_MAXUINT64 - *first + 1;
+  if (count > available)
+    count = available;
 
-  new_id = data->g_rcptid++;
+  data->g_rcptid += count;
   if (data->g_rcptid == 0)
     data->g_rcptid = 1;
+  rcptid_service.reserved_until = data->g_rcptid;
 
   rcptid_unmap_state();
+  return count;
+}
 
+static guint64
+rcptid_generate_id_strict(void)
+{
+  guint64 new_id;
+
+  g_mutex_lock(&rcptid_service.lock);
+  rcptid_reserve_ids(1, &new_id);
   g_mutex_unlock(&rcptid_service.lock);
 
   return new_id;
 }
 
+guint64
+rcptid_generate_id(void)
+{
+  if (!rcptid_is_initialized())
+    return 0;
+
+  if (rcptid_service.strict_order)
+    return rcptid_generate_id_strict();
+
+  gint generation = g_atomic_int_get(&rcptid_service.generation);
+  if (rcptid_block.left == 0 || rcptid_block.generation != generation)
+    {
+      g_mutex_lock(&rcptid_service.lock);
+      rcptid_block.left = rcptid_reserve_ids(RCPTID_BLOCK_SIZE, &rcptid_block.next);
+      rcptid_block.generation = g_atomic_int_get(&rcptid_service.generation);
+      g_mutex_unlock(&rcptid_service.lock);
+    }
+
+  rcptid_block.left--;
+  return rcptid_block.next++;
+}
+
 /*restore RCTPID from persist file, if possible, else
   create new entry point with "next.rcptid" name*/
 gboolean
-rcptid_init(PersistState *state, gboolean use_rcptid)
+rcptid_init(PersistState *state, gboolean use_rcptid, gboolean strict_order)
 {
   gsize size;
   guint8 version;
@@ -164,6 +234,7 @@ rcptid_init(PersistState *state, gboolean use_rcptid)
     return TRUE;
 
   rcptid_service.persist_state = state;
+  rcptid_service.strict_order = strict_order;
   rcptid_service.persist_handle = persist_state_lookup_entry(state, "next.rcptid", &size, &version);
 
   if (rcptid_service.persist_handle && size == sizeof(RcptidState))
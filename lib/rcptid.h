@@ -39,7 +39,7 @@ void rcptid_set_id(guint64 id);
 guint64 rcptid_generate_id(void);
 void rcptid_append_formatted_id(GString *result, guint64 rcptid);
 
-gboolean rcptid_init(PersistState *state, gboolean use_rcptid);
+gboolean rcptid_init(PersistState *state, gboolean use_rcptid, gboolean strict_order);
 void rcptid_deinit(void);
 
 #endif
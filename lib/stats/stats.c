@@ -261,6 +261,8 @@ stats_options_defaults(StatsOptions *options)
   options->lifetime = 600;
   options->max_dynamic = -1;
   options->syslog_stats = CYNA_AUTO;
+  options->profile_sample_rate = 0;
+  options->stack_sample_frequency = 0;
 }
 
 gboolean
@@ -36,6 +36,8 @@ typedef struct _StatsOptions
   gint lifetime;
   gint max_dynamic;
   CfgYesNoAuto syslog_stats;
+  gint profile_sample_rate;
+  gint stack_sample_frequency;
 } StatsOptions;
 
 enum
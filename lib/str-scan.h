@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef STR_SCAN_H_INCLUDED
+#define STR_SCAN_H_INCLUDED 1
+
+#include "syslog-ng.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * Scanning primitives for escaping routines (format-json, format-welf,
+ * format-cef-extension, format_csv(), format_kv() and friends).
+ *
+ * Escapers spend most of their time on runs of characters that are copied
+ * verbatim: printable ASCII other than the backslash and a few
+ * format-specific characters.  str_scan_plain_ascii() finds the end of such
+ * a run a block at a time (32 bytes with AVX2, two 16-byte vectors with
+ * SSE2), so that the run can be copied in bulk and only the character that
+ * ends it needs to go through the per-character escaping logic.
+ *
+ * Everything that is not plain (control characters, non-ASCII bytes,
+ * backslash and the extra specials) is reported, the caller decides what to
+ * do with it, so the output of an escaper using this is the same as if it
+ * looked at each character one by one.
+ */
+
+#define STR_SCAN_MAX_EXTRA_SPECIALS 4
+
+typedef struct _StrScanSpecials
+{
+  gint count;
+  gchar chars[STR_SCAN_MAX_EXTRA_SPECIALS];
+} StrScanSpecials;
+
+/* extra specials are ASCII characters that need escaping on top of the
+ * backslash, at most STR_SCAN_MAX_EXTRA_SPECIALS of them are considered,
+ * returns FALSE if there are more */
+static inline gboolean
+str_scan_specials_init(StrScanSpecials *self, const gchar *extra_specials)
+{
+  self->count = 0;
+  for (const gchar *c = extra_specials; c && *c; c++)
+    {
+      if (self->count == STR_SCAN_MAX_EXTRA_SPECIALS)
+        return FALSE;
+      self->chars[self->count++] = *c;
+    }
+  return TRUE;
+}
+
+static inline gboolean
+str_scan_is_plain_ascii(const StrScanSpecials *specials, gchar c)
+{
+  if ((guchar) c < 0x20 || (guchar) c >= 0x80 || c == '\\')
+    return FALSE;
+
+  for (gint i = 0; i < specials->count; i++)
+    {
+      if (c == specials->chars[i])
+        return FALSE;
+    }
+  return TRUE;
+}
+
+#if defined(__AVX2__)
+
+static inline guint32
+_str_scan_block_special_mask(const StrScanSpecials *specials, const gchar *block)
+{
+  __m256i v = _mm256_loadu_si256((const __m256i *) block);
+
+  /* signed comparison: bytes >= 0x80 are negative, so this is 0x20..0x7f */
+  __m256i plain = _mm256_cmpgt_epi8(v, _mm256_set1_epi8(0x1f));
+  __m256i special = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+  for (gint i = 0; i < specials->count; i++)
+    special = _mm256_or_si256(special, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(specials->chars[i])));
+
+  return ~(guint32) _mm256_movemask_epi8(_mm256_andnot_si256(special, plain));
+}
+
+#elif defined(__SSE2__)
+
+static inline guint32
+_str_scan_half_block_special_mask(const StrScanSpecials *specials, const gchar *half_block)
+{
+  __m128i v = _mm_loadu_si128((const __m128i *) half_block);
+
+  /* signed comparison: bytes >= 0x80 are negative, so this is 0x20..0x7f */
+  __m128i plain = _mm_cmpgt_epi8(v, _mm_set1_epi8(0x1f));
+  __m128i special = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+  for (gint i = 0; i < specials->count; i++)
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(v, _mm_set1_epi8(specials->chars[i])));
+
+  return (~(guint32) _mm_movemask_epi8(_mm_andnot_si128(special, plain))) & 0xffff;
+}
+
+static inline guint32
+_str_scan_block_special_mask(const StrScanSpecials *specials, const gchar *block)
+{
+  return _str_scan_half_block_special_mask(specials, block) |
+         (_str_scan_half_block_special_mask(specials, block + 16) << 16);
+}
+
+#endif
+
+/*
+ * Returns the length of the plain ASCII run at the start of @str, e.g. the
+ * offset of the first character that needs attention, or @len if there is
+ * none.  DEL (0x7f) counts as plain.
+ */
+static inline gsize
+str_scan_plain_ascii(const StrScanSpecials *specials, const gchar *str, gsize len)
+{
+  gsize pos = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+  for (; pos + 32 <= len; pos += 32)
+    {
+      guint32 mask = _str_scan_block_special_mask(specials, str + pos);
+      if (mask)
+        return pos + __builtin_ctz(mask);
+    }
+#endif
+
+  for (; pos < len; pos++)
+    {
+      if (!str_scan_is_plain_ascii(specials, str[pos]))
+        return pos;
+    }
+  return len;
+}
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "cfg-cache.h"
+#include "cfg.h"
+#include "apphook.h"
+
+#include <glib/gstdio.h>
+#include <utime.h>
+#include <stdlib.h>
+#include <string.h>
+
+static gchar *test_dir;
+static gchar *cache_file;
+static gchar *config_file;
+
+static void
+_write_file_in_the_past(const gchar *filename, const gchar *content)
+{
+  struct utimbuf times = { .actime = time(NULL) - 60, .modtime = time(NULL) - 60 };
+
+  cr_assert(g_file_set_contents(filename, content, -1, NULL));
+  cr_assert(utime(filename, &times) == 0);
+}
+
+static CfgCache *
+_store_cache_with_config(const gchar *content)
+{
+  CfgCache *cache = cfg_cache_new(cache_file);
+  GString *preprocessed = g_string_new(content);
+
+  cfg_cache_start_recording(cache);
+  cfg_cache_record_file(config_file);
+  cfg_cache_record_env("CFG_CACHE_TEST_VAR", g_getenv("CFG_CACHE_TEST_VAR"));
+  cfg_cache_stop_recording(cache);
+
+  cr_assert(cfg_cache_store(cache, config_file, preprocessed));
+  g_string_free(preprocessed, TRUE);
+  return cache;
+}
+
+static void
+_assert_cache_hit(CfgCache *cache, const gchar *expected)
+{
+  GString *loaded = cfg_cache_load(cache, config_file);
+
+  cr_assert_not_null(loaded);
+  cr_assert_str_eq(loaded->str, expected);
+  g_string_free(loaded, TRUE);
+}
+
+static void
+_assert_cache_miss(CfgCache *cache)
+{
+  GString *loaded = cfg_cache_load(cache, config_file);
+
+  cr_assert_null(loaded);
+}
+
+Test(cfg_cache, unchanged_dependencies_return_the_cached_config)
+{
+  CfgCache *cache = _store_cache_with_config("log { source { internal(); }; };\n");
+
+  _assert_cache_hit(cache, "log { source { internal(); }; };\n");
+  cfg_cache_free(cache);
+}
+
+Test(cfg_cache, modified_file_invalidates_the_cache)
+{
+  CfgCache *cache = _store_cache_with_config("expanded\n");
+
+  _write_file_in_the_past(config_file, "@version: current\n# a longer configuration\n");
+  _assert_cache_miss(cache);
+  cfg_cache_free(cache);
+}
+
+Test(cfg_cache, changed_environment_variable_invalidates_the_cache)
+{
+  CfgCache *cache = _store_cache_with_config("expanded\n");
+
+  setenv("CFG_CACHE_TEST_VAR", "changed", TRUE);
+  _assert_cache_miss(cache);
+  cfg_cache_free(cache);
+}
+
+Test(cfg_cache, cache_of_another_configuration_is_ignored)
+{
+  CfgCache *cache = _store_cache_with_config("expanded\n");
+  GString *loaded = cfg_cache_load(cache, "/nonexistent/syslog-ng.conf");
+
+  cr_assert_null(loaded);
+  cfg_cache_free(cache);
+}
+
+Test(cfg_cache, truncated_cache_is_ignored)
+{
+  CfgCache *cache = _store_cache_with_config("expanded configuration\n");
+  gchar *contents;
+  gsize length;
+
+  cr_assert(g_file_get_contents(cache_file, &contents, &length, NULL));
+  cr_assert(g_file_set_contents(cache_file, contents, length - 5, NULL));
+  g_free(contents);
+
+  _assert_cache_miss(cache);
+  cfg_cache_free(cache);
+}
+
+Test(cfg_cache, recently_modified_dependency_is_not_cached)
+{
+  CfgCache *cache = cfg_cache_new(cache_file);
+  GString *preprocessed = g_string_new("expanded\n");
+
+  cr_assert(g_file_set_contents(config_file, "@version: current\n", -1, NULL));
+  cfg_cache_start_recording(cache);
+  cfg_cache_record_file(config_file);
+  cfg_cache_stop_recording(cache);
+
+  cr_assert_not(cfg_cache_store(cache, config_file, preprocessed));
+  _assert_cache_miss(cache);
+
+  g_string_free(preprocessed, TRUE);
+  cfg_cache_free(cache);
+}
+
+Test(cfg_cache, recording_is_inactive_outside_of_start_and_stop)
+{
+  CfgCache *cache = cfg_cache_new(cache_file);
+  GString *preprocessed = g_string_new("expanded\n");
+
+  cfg_cache_start_recording(cache);
+  cfg_cache_stop_recording(cache);
+  cfg_cache_record_env("CFG_CACHE_TEST_VAR", "value-not-seen-by-the-cache");
+
+  cr_assert(cfg_cache_store(cache, config_file, preprocessed));
+  setenv("CFG_CACHE_TEST_VAR", "changed", TRUE);
+  _assert_cache_hit(cache, "expanded\n");
+
+  g_string_free(preprocessed, TRUE);
+  cfg_cache_free(cache);
+}
+
+Test(cfg_cache, invalidated_cache_is_removed)
+{
+  CfgCache *cache = _store_cache_with_config("log { };\n");
+
+  cfg_cache_invalidate(cache);
+  cr_assert_not(g_file_test(cache_file, G_FILE_TEST_EXISTS));
+  _assert_cache_miss(cache);
+
+  /* invalidating a missing cache is not an error */
+  cfg_cache_invalidate(cache);
+  cfg_cache_free(cache);
+}
+
+Test(cfg_cache, unparsable_cached_config_falls_back_to_the_configuration_file)
+{
+  CfgCache *cache = _store_cache_with_config("this is not a valid configuration;\n");
+  GlobalConfig *cfg = cfg_new_snippet();
+
+  cr_assert(cfg_read_config_with_cache(cfg, config_file, cache, NULL));
+  cr_assert_not(cfg->use_plugin_discovery);
+  cr_assert_str_eq(cfg_get_filename(cfg), config_file);
+
+  /* the cache is rebuilt from the configuration file */
+  GString *loaded = cfg_cache_load(cache, config_file);
+  cr_assert_not_null(loaded);
+  cr_assert_null(strstr(loaded->str, "not a valid configuration"));
+  g_string_free(loaded, TRUE);
+
+  cfg_free(cfg);
+  cfg_cache_free(cache);
+}
+
+static void
+setup(void)
+{
+  app_startup();
+  test_dir = g_dir_make_tmp("test_cfg_cache_XXXXXX", NULL);
+  cr_assert_not_null(test_dir);
+  cache_file = g_build_filename(test_dir, "syslog-ng.conf.cache", NULL);
+  config_file = g_build_filename(test_dir, "syslog-ng.conf", NULL);
+  _write_file_in_the_past(config_file, "@version: current\n");
+  setenv("CFG_CACHE_TEST_VAR", "value", TRUE);
+}
+
+static void
+teardown(void)
+{
+  g_unlink(cache_file);
+  g_unlink(config_file);
+  g_rmdir(test_dir);
+  g_free(cache_file);
+  g_free(config_file);
+  g_free(test_dir);
+  unsetenv("CFG_CACHE_TEST_VAR");
+  app_shutdown();
+}
+
+TestSuite(cfg_cache, .init = setup, .fini = teardown);
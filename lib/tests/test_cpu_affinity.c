@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "cpu-affinity.h"
+#include "apphook.h"
+#include "stats/stats-registry.h"
+#include "stats/stats-cluster-single.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+static void
+assert_cpu_list(const gchar *cpu_list, const gint *expected, gint expected_len)
+{
+  GError *error = NULL;
+  CpuAffinity *cpu_affinity = cpu_affinity_new(cpu_list, &error);
+
+  cr_assert_not_null(cpu_affinity, "Error parsing CPU list %s: %s", cpu_list, error ? error->message : "");
+  cr_assert_str_eq(cpu_affinity_get_cpu_list(cpu_affinity), cpu_list);
+  cr_assert_eq(cpu_affinity_get_cpu_count(cpu_affinity), expected_len);
+  for (gint i = 0; i < expected_len; i++)
+    cr_assert_eq(cpu_affinity_get_cpu(cpu_affinity, i), expected[i], "CPU mismatch at index %d", i);
+
+  cpu_affinity_free(cpu_affinity);
+}
+
+static void
+assert_cpu_list_invalid(const gchar *cpu_list)
+{
+  GError *error = NULL;
+  CpuAffinity *cpu_affinity = cpu_affinity_new(cpu_list, &error);
+
+  cr_assert_null(cpu_affinity, "Parsing CPU list should have failed: %s", cpu_list);
+  cr_assert_not_null(error);
+  g_clear_error(&error);
+}
+
+Test(cpu_affinity, test_valid_cpu_lists)
+{
+  assert_cpu_list("0", (gint[]) { 0 }, 1);
+  assert_cpu_list("3,1", (gint[]) { 3, 1 }, 2);
+  assert_cpu_list("0-3", (gint[]) { 0, 1, 2, 3 }, 4);
+  assert_cpu_list("0-1, 8 ,10-11", (gint[]) { 0, 1, 8, 10, 11 }, 5);
+}
+
+Test(cpu_affinity, test_invalid_cpu_lists)
+{
+  assert_cpu_list_invalid("");
+  assert_cpu_list_invalid("a");
+  assert_cpu_list_invalid("1-");
+  assert_cpu_list_invalid("-1");
+  assert_cpu_list_invalid("3-1");
+  assert_cpu_list_invalid("0,,1");
+  assert_cpu_list_invalid("100000");
+}
+
+#ifdef __linux__
+Test(cpu_affinity, test_cpus_beyond_the_affinity_mask_are_rejected)
+{
+  gchar *cpu_list = g_strdup_printf("%d", CPU_SETSIZE - 1);
+  assert_cpu_list(cpu_list, (gint[]) { CPU_SETSIZE - 1 }, 1);
+  g_free(cpu_list);
+
+  cpu_list = g_strdup_printf("%d", CPU_SETSIZE);
+  assert_cpu_list_invalid(cpu_list);
+  g_free(cpu_list);
+
+  cpu_list = g_strdup_printf("0-%d", CPU_SETSIZE);
+  assert_cpu_list_invalid(cpu_list);
+  g_free(cpu_list);
+}
+
+static gsize
+_get_counter(const gchar *name)
+{
+  StatsClusterKey sc_key;
+
+  stats_cluster_single_key_set(&sc_key, name, NULL, 0);
+  StatsCounterItem *counter = stats_get_counter(&sc_key, SC_TYPE_SINGLE_VALUE);
+  cr_assert_not_null(counter, "counter %s is not registered", name);
+  return stats_counter_get(counter);
+}
+
+Test(cpu_affinity, test_bound_threads_are_counted)
+{
+  app_startup();
+
+  CpuAffinity *cpu_affinity = cpu_affinity_new("0", NULL);
+  gsize bound_threads = _get_counter("cpu_affinity_bound_threads_total");
+  gsize errors = _get_counter("cpu_affinity_errors_total");
+
+  if (cpu_affinity_apply_to_current_thread(cpu_affinity))
+    cr_assert_eq(_get_counter("cpu_affinity_bound_threads_total"), bound_threads + 1);
+  else
+    cr_assert_eq(_get_counter("cpu_affinity_errors_total"), errors + 1);
+
+  cpu_affinity_free(cpu_affinity);
+  app_shutdown();
+}
+#endif
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "host-resolve-async.h"
+#include "apphook.h"
+
+#include <string.h>
+
+static gint resolver_calls;
+static gboolean resolver_released;
+static GMutex resolver_lock;
+static GCond resolver_cond;
+
+static void
+_release_resolvers(void)
+{
+  g_mutex_lock(&resolver_lock);
+  resolver_released = TRUE;
+  g_cond_broadcast(&resolver_cond);
+  g_mutex_unlock(&resolver_lock);
+}
+
+static const gchar *
+_fake_resolve(GSockAddr *saddr, gchar *buf, gsize buf_len)
+{
+  g_atomic_int_inc(&resolver_calls);
+
+  g_mutex_lock(&resolver_lock);
+  while (!resolver_released)
+    g_cond_wait(&resolver_cond, &resolver_lock);
+  g_mutex_unlock(&resolver_lock);
+
+  g_strlcpy(buf, "fake.host", buf_len);
+  return buf;
+}
+
+static const gchar *
+_failing_resolve(GSockAddr *saddr, gchar *buf, gsize buf_len)
+{
+  g_atomic_int_inc(&resolver_calls);
+  return NULL;
+}
+
+static const gchar *
+_lookup_until_resolved(GSockAddr *saddr, HostResolveAsyncFunc resolve, gchar *buf, gsize buf_len,
+                       gboolean *positive)
+{
+  const gchar *result = host_resolve_async_lookup(saddr, resolve, buf, buf_len, positive);
+
+  if (result)
+    return result;
+
+  host_resolve_async_wait_idle();
+  return host_resolve_async_lookup(saddr, resolve, buf, buf_len, positive);
+}
+
+Test(host_resolve_async, test_pending_lookups_are_coalesced)
+{
+  GSockAddr *saddr = g_sockaddr_inet_new("192.0.2.1", 514);
+  gchar buf[256];
+  gboolean positive;
+
+  for (gint i = 0; i < 10; i++)
+    {
+      cr_assert_null(host_resolve_async_lookup(saddr, _fake_resolve, buf, sizeof(buf), &positive));
+      cr_assert_not(positive);
+    }
+
+  _release_resolvers();
+  const gchar *hostname = _lookup_until_resolved(saddr, _fake_resolve, buf, sizeof(buf), &positive);
+
+  cr_assert_str_eq(hostname, "fake.host");
+  cr_assert(positive);
+  cr_assert_eq(g_atomic_int_get(&resolver_calls), 1);
+
+  g_sockaddr_unref(saddr);
+}
+
+Test(host_resolve_async, test_negative_answer_is_cached)
+{
+  GSockAddr *saddr = g_sockaddr_inet_new("192.0.2.2", 514);
+  gchar buf[256];
+  gboolean positive;
+
+  cr_assert_null(host_resolve_async_lookup(saddr, _failing_resolve, buf, sizeof(buf), &positive));
+  host_resolve_async_wait_idle();
+
+  for (gint i = 0; i < 10; i++)
+    {
+      cr_assert_null(host_resolve_async_lookup(saddr, _failing_resolve, buf, sizeof(buf), &positive));
+      cr_assert_not(positive);
+    }
+  cr_assert_eq(g_atomic_int_get(&resolver_calls), 1);
+
+  g_sockaddr_unref(saddr);
+}
+
+Test(host_resolve_async, test_queued_lookups_are_dropped_on_shutdown)
+{
+  GSockAddr *saddrs[16];
+  gchar buf[256];
+  gboolean positive;
+
+  for (gint i = 0; i < G_N_ELEMENTS(saddrs); i++)
+    {
+      gchar address[32];
+
+      g_snprintf(address, sizeof(address), "10.1.0.%d", i);
+      saddrs[i] = g_sockaddr_inet_new(address, 514);
+      cr_assert_null(host_resolve_async_lookup(saddrs[i], _fake_resolve, buf, sizeof(buf), &positive));
+    }
+
+  /* the running lookups finish, the queued ones are freed without being
+   * resolved, which leak checkers would catch otherwise */
+  _release_resolvers();
+  host_resolve_async_global_deinit();
+  cr_assert_leq(g_atomic_int_get(&resolver_calls), G_N_ELEMENTS(saddrs));
+
+  for (gint i = 0; i < G_N_ELEMENTS(saddrs); i++)
+    g_sockaddr_unref(saddrs[i]);
+
+  host_resolve_async_global_init();
+}
+
+Test(host_resolve_async, test_outstanding_lookups_are_capped)
+{
+  GSockAddr *saddrs[HOST_RESOLVE_ASYNC_MAX_QUEUED + 10];
+  gchar buf[256];
+  gboolean positive;
+
+  for (gint i = 0; i < G_N_ELEMENTS(saddrs); i++)
+    {
+      gchar address[32];
+
+      g_snprintf(address, sizeof(address), "10.0.%d.%d", i / 256, i % 256);
+      saddrs[i] = g_sockaddr_inet_new(address, 514);
+      cr_assert_null(host_resolve_async_lookup(saddrs[i], _fake_resolve, buf, sizeof(buf), &positive));
+      cr_assert_not(positive);
+    }
+
+  _release_resolvers();
+  host_resolve_async_wait_idle();
+
+  /* the addresses over the limit fell back to the IP address without being queued */
+  cr_assert_eq(g_atomic_int_get(&resolver_calls), HOST_RESOLVE_ASYNC_MAX_QUEUED);
+  cr_assert_str_eq(_lookup_until_resolved(saddrs[0], _fake_resolve, buf, sizeof(buf), &positive), "fake.host");
+
+  /* and are resolved once there is room again */
+  cr_assert_str_eq(_lookup_until_resolved(saddrs[HOST_RESOLVE_ASYNC_MAX_QUEUED], _fake_resolve, buf, sizeof(buf),
+                                          &positive), "fake.host");
+  cr_assert_eq(g_atomic_int_get(&resolver_calls), HOST_RESOLVE_ASYNC_MAX_QUEUED + 1);
+
+  for (gint i = 0; i < G_N_ELEMENTS(saddrs); i++)
+    g_sockaddr_unref(saddrs[i]);
+}
+
+static void
+setup(void)
+{
+  app_startup();
+  resolver_calls = 0;
+  resolver_released = FALSE;
+}
+
+static void
+teardown(void)
+{
+  app_shutdown();
+}
+
+TestSuite(host_resolve_async, .init = setup, .fini = teardown);
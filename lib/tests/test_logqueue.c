@@ -322,6 +322,142 @@ Test(logqueue, log_queue_fifo_should_drop_only_non_flow_controlled_messages,
   log_queue_unref(q);
 }
 
+Test(logqueue, log_queue_fifo_should_drop_non_flow_controlled_messages_over_memory_limit)
+{
+  LogPathOptions flow_controlled_path = LOG_PATH_OPTIONS_INIT;
+  flow_controlled_path.flow_control_requested = TRUE;
+
+  LogPathOptions non_flow_controlled_path = LOG_PATH_OPTIONS_INIT;
+  non_flow_controlled_path.flow_control_requested = FALSE;
+
+  StatsClusterKeyBuilder *driver_sck_builder = stats_cluster_key_builder_new();
+  StatsClusterKeyBuilder *queue_sck_builder = stats_cluster_key_builder_new();
+  LogQueue *q = log_queue_fifo_new(OVERFLOW_SIZE, NULL, STATS_LEVEL0, driver_sck_builder, queue_sck_builder);
+  stats_cluster_key_builder_free(driver_sck_builder);
+  stats_cluster_key_builder_free(queue_sck_builder);
+
+  fed_messages = 0;
+  acked_messages = 0;
+  feed_empty_messages(q, &non_flow_controlled_path, 1);
+  gssize size_when_single_msg = log_queue_get_memory_usage(q);
+  cr_assert_gt(size_when_single_msg, 0);
+
+  log_queue_fifo_set_memory_limit(q, 3 * size_when_single_msg);
+
+  feed_empty_messages(q, &non_flow_controlled_path, 5);
+  cr_assert_eq(log_queue_get_length(q), 3);
+  cr_assert_eq(log_queue_get_memory_usage(q), 3 * size_when_single_msg);
+  cr_assert_eq(stats_counter_get(q->metrics.shared.dropped_messages), 3);
+
+  feed_empty_messages(q, &flow_controlled_path, 2);
+  cr_assert_eq(log_queue_get_length(q), 5);
+  cr_assert_eq(stats_counter_get(q->metrics.shared.dropped_messages), 3);
+
+  gint queued_messages = stats_counter_get(q->metrics.shared.queued_messages);
+  send_some_messages(q, queued_messages, TRUE);
+  cr_assert_eq(log_queue_get_memory_usage(q), 0);
+
+  cr_assert_eq(fed_messages, acked_messages,
+               "did not receive enough acknowledgements: fed_messages=%d, acked_messages=%d",
+               fed_messages, acked_messages);
+
+  log_queue_unref(q);
+}
+
+Test(logqueue, log_queue_fifo_accounts_separately_allocated_queue_nodes)
+{
+  LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+  path_options.ack_needed = TRUE;
+  path_options.flow_control_requested = TRUE;
+
+  StatsClusterKeyBuilder *driver_sck_builder = stats_cluster_key_builder_new();
+  StatsClusterKeyBuilder *queue_sck_builder = stats_cluster_key_builder_new();
+  LogQueue *q = log_queue_fifo_new(OVERFLOW_SIZE, NULL, STATS_LEVEL0, driver_sck_builder, queue_sck_builder);
+  stats_cluster_key_builder_free(driver_sck_builder);
+  stats_cluster_key_builder_free(queue_sck_builder);
+
+  fed_messages = 0;
+  acked_messages = 0;
+
+  LogMessage *msg = log_msg_new_empty();
+  /* the embedded nodes are taken, as if the message was already queued elsewhere */
+  msg->cur_node = msg->num_nodes;
+  log_msg_add_ack(msg, &path_options);
+  msg->ack_func = test_ack;
+  gssize msg_size = log_msg_get_size(msg);
+  log_queue_push_tail(q, msg, &path_options);
+  fed_messages++;
+
+  cr_assert_eq(log_queue_get_memory_usage(q), msg_size + sizeof(LogMessageQueueNode));
+
+  send_some_messages(q, 1, TRUE);
+  cr_assert_eq(log_queue_get_memory_usage(q), 0);
+
+  cr_assert_eq(fed_messages, acked_messages,
+               "did not receive enough acknowledgements: fed_messages=%d, acked_messages=%d",
+               fed_messages, acked_messages);
+
+  log_queue_unref(q);
+}
+
+Test(logqueue, log_queue_fifo_should_enforce_the_global_memory_limit_across_queues)
+{
+  LogPathOptions flow_controlled_path = LOG_PATH_OPTIONS_INIT;
+  flow_controlled_path.flow_control_requested = TRUE;
+
+  LogPathOptions non_flow_controlled_path = LOG_PATH_OPTIONS_INIT;
+  non_flow_controlled_path.flow_control_requested = FALSE;
+
+  StatsClusterKeyBuilder *driver_sck_builder = stats_cluster_key_builder_new();
+  StatsClusterKeyBuilder *queue_sck_builder = stats_cluster_key_builder_new();
+  LogQueue *q1 = log_queue_fifo_new(OVERFLOW_SIZE, NULL, STATS_LEVEL0, driver_sck_builder, queue_sck_builder);
+  LogQueue *q2 = log_queue_fifo_new(OVERFLOW_SIZE, NULL, STATS_LEVEL0, driver_sck_builder, queue_sck_builder);
+  stats_cluster_key_builder_free(driver_sck_builder);
+  stats_cluster_key_builder_free(queue_sck_builder);
+
+  fed_messages = 0;
+  acked_messages = 0;
+  cr_assert_eq(log_queue_get_global_memory_usage(), 0);
+  feed_empty_messages(q1, &non_flow_controlled_path, 1);
+  gssize size_when_single_msg = log_queue_get_memory_usage(q1);
+  cr_assert_gt(size_when_single_msg, 0);
+  cr_assert_eq(log_queue_get_global_memory_usage(), size_when_single_msg);
+
+  log_queue_set_global_memory_limit(3 * size_when_single_msg);
+
+  /* neither queue is over the limit on its own, only their sum */
+  feed_empty_messages(q1, &non_flow_controlled_path, 1);
+  feed_empty_messages(q2, &non_flow_controlled_path, 3);
+  cr_assert_eq(log_queue_get_length(q1), 2);
+  cr_assert_eq(log_queue_get_length(q2), 1);
+  cr_assert_eq(stats_counter_get(q2->metrics.shared.dropped_messages), 2);
+  cr_assert_eq(log_queue_get_global_memory_usage(), 3 * size_when_single_msg);
+  cr_assert(log_queue_global_memory_limit_reached());
+
+  feed_empty_messages(q2, &flow_controlled_path, 1);
+  cr_assert_eq(log_queue_get_length(q2), 2, "flow-controlled messages should not be dropped over the global limit");
+
+  /* draining one queue releases the memory for the other one */
+  send_some_messages(q1, 2, TRUE);
+  cr_assert_eq(log_queue_get_global_memory_usage(), 2 * size_when_single_msg);
+  cr_assert_not(log_queue_global_memory_limit_reached());
+
+  feed_empty_messages(q2, &non_flow_controlled_path, 1);
+  cr_assert_eq(log_queue_get_length(q2), 3);
+  cr_assert_eq(stats_counter_get(q2->metrics.shared.dropped_messages), 2);
+
+  send_some_messages(q2, 3, TRUE);
+  cr_assert_eq(log_queue_get_global_memory_usage(), 0);
+
+  cr_assert_eq(fed_messages, acked_messages,
+               "did not receive enough acknowledgements: fed_messages=%d, acked_messages=%d",
+               fed_messages, acked_messages);
+
+  log_queue_set_global_memory_limit(0);
+  log_queue_unref(q1);
+  log_queue_unref(q2);
+}
+
 static gpointer
 _flow_control_feed_thread(gpointer args)
 {
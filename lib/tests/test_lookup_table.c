@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "lookup-table.h"
+#include "apphook.h"
+#include "timeutils/misc.h"
+
+#include <iv.h>
+#include <glib/gstdio.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+static gchar *test_dir;
+static gchar *source_file;
+static gchar *compiled_file;
+
+static void
+_write_source(const gchar *content, time_t age)
+{
+  struct utimbuf times = { .actime = time(NULL) - age, .modtime = time(NULL) - age };
+
+  cr_assert(g_file_set_contents(source_file, content, -1, NULL));
+  cr_assert(utime(source_file, &times) == 0);
+}
+
+static gboolean
+_contains(LookupTable *table, const gchar *key)
+{
+  return lookup_table_lookup(table, key, strlen(key), NULL, NULL);
+}
+
+static void
+_assert_value(LookupTable *table, const gchar *key, const gchar *expected)
+{
+  const gchar *value;
+  gsize value_len;
+
+  cr_assert(lookup_table_lookup(table, key, strlen(key), &value, &value_len), "key not found: %s", key);
+  cr_assert_eq(value_len, strlen(expected));
+  cr_assert(memcmp(value, expected, value_len) == 0, "unexpected value for key: %s", key);
+}
+
+Test(lookup_table, list_entries_are_whole_lines)
+{
+  _write_source("foo\n\nbar baz\nfoo\n192.168.1.1\tx\nlast-line-without-newline", 60);
+
+  LookupTable *table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL, NULL);
+  cr_assert_not_null(table);
+
+  cr_assert_eq(lookup_table_get_size(table), 4);
+  cr_assert(_contains(table, "foo"));
+  cr_assert(_contains(table, "bar baz"));
+  cr_assert(_contains(table, "192.168.1.1\tx"));
+  cr_assert(_contains(table, "last-line-without-newline"));
+  cr_assert_not(_contains(table, ""));
+  cr_assert_not(_contains(table, "bar"));
+  cr_assert_not(_contains(table, "192.168.1.1"));
+  lookup_table_unref(table);
+}
+
+Test(lookup_table, tsv_maps_keys_to_values_and_the_first_occurrence_wins)
+{
+  _write_source("alpha\t1\nbeta\tvalue\twith tab\nalpha\t2\nno-value\n", 60);
+
+  LookupTable *table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_TSV, NULL, NULL);
+  cr_assert_not_null(table);
+
+  cr_assert_eq(lookup_table_get_size(table), 3);
+  _assert_value(table, "alpha", "1");
+  _assert_value(table, "beta", "value\twith tab");
+  _assert_value(table, "no-value", "");
+  cr_assert_not(_contains(table, "gamma"));
+  lookup_table_unref(table);
+}
+
+Test(lookup_table, many_entries_are_all_found)
+{
+  GString *content = g_string_new(NULL);
+  for (gint i = 0; i < 10000; i++)
+    g_string_append_printf(content, "10.%d.%d.%d\n", i / 65536, (i / 256) % 256, i % 256);
+  _write_source(content->str, 60);
+  g_string_free(content, TRUE);
+
+  LookupTable *table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL, NULL);
+  cr_assert_not_null(table);
+  cr_assert_eq(lookup_table_get_size(table), 10000);
+
+  gchar key[32];
+  for (gint i = 0; i < 10000; i++)
+    {
+      g_snprintf(key, sizeof(key), "10.%d.%d.%d", i / 65536, (i / 256) % 256, i % 256);
+      cr_assert(_contains(table, key), "key not found: %s", key);
+      g_snprintf(key, sizeof(key), "11.%d.%d.%d", i / 65536, (i / 256) % 256, i % 256);
+      cr_assert_not(_contains(table, key), "unexpected key found: %s", key);
+    }
+  lookup_table_unref(table);
+}
+
+static ino_t
+_get_compiled_file_inode(void)
+{
+  struct stat st;
+
+  cr_assert(stat(compiled_file, &st) == 0);
+  return st.st_ino;
+}
+
+Test(lookup_table, compiled_file_is_reused_while_the_source_is_unchanged)
+{
+  _write_source("foo\nbar\n", 60);
+
+  LookupTable *table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_LIST, compiled_file, NULL);
+  cr_assert_not_null(table);
+  cr_assert(lookup_table_is_mapped(table));
+  lookup_table_unref(table);
+  ino_t compiled_inode = _get_compiled_file_inode();
+
+  table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_LIST, compiled_file, NULL);
+  cr_assert(lookup_table_is_mapped(table));
+  cr_assert(_contains(table, "foo"));
+  lookup_table_unref(table);
+  cr_assert_eq(_get_compiled_file_inode(), compiled_inode, "compiled file should have been reused");
+
+  _write_source("baz\nbar\n", 30);
+  table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_LIST, compiled_file, NULL);
+  cr_assert(_contains(table, "baz"));
+  cr_assert_not(_contains(table, "foo"));
+  lookup_table_unref(table);
+  cr_assert_neq(_get_compiled_file_inode(), compiled_inode, "compiled file should have been rebuilt");
+}
+
+Test(lookup_table, recently_modified_source_is_not_compiled_to_file)
+{
+  _write_source("foo\n", 0);
+
+  LookupTable *table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_LIST, compiled_file, NULL);
+  cr_assert_not_null(table);
+  cr_assert_not(lookup_table_is_mapped(table));
+  cr_assert(_contains(table, "foo"));
+  lookup_table_unref(table);
+  cr_assert_not(g_file_test(compiled_file, G_FILE_TEST_EXISTS));
+}
+
+Test(lookup_table, compiled_file_of_another_format_is_not_reused)
+{
+  _write_source("key\tvalue\n", 60);
+
+  LookupTable *table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_LIST, compiled_file, NULL);
+  cr_assert(_contains(table, "key\tvalue"));
+  lookup_table_unref(table);
+
+  table = lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_TSV, compiled_file, NULL);
+  _assert_value(table, "key", "value");
+  lookup_table_unref(table);
+}
+
+Test(lookup_table, missing_source_file_is_reported)
+{
+  GError *error = NULL;
+
+  cr_assert_null(lookup_table_load(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL, &error));
+  cr_assert_not_null(error);
+  g_clear_error(&error);
+}
+
+Test(lookup_table, handles_are_shared_and_follow_source_changes)
+{
+  _write_source("foo\n", 60);
+
+  LookupTableHandle *handle = lookup_table_handle_get(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL);
+  LookupTableHandle *same_handle = lookup_table_handle_get(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL);
+  LookupTableHandle *tsv_handle = lookup_table_handle_get(source_file, LOOKUP_TABLE_FORMAT_TSV, NULL);
+  cr_assert_not_null(handle);
+  cr_assert_eq(handle, same_handle);
+  cr_assert_neq(handle, tsv_handle);
+
+  cr_assert(lookup_table_handle_contains(handle, "foo", 3));
+  cr_assert_not(lookup_table_handle_contains(handle, "bar", 3));
+
+  _write_source("bar\n", 30);
+  cr_assert(lookup_table_handle_refresh(handle));
+  cr_assert_not(lookup_table_handle_contains(same_handle, "foo", 3));
+  cr_assert(lookup_table_handle_contains(same_handle, "bar", 3));
+
+  GString *value = g_string_new(NULL);
+  cr_assert(lookup_table_handle_lookup(tsv_handle, "foo", 3, value));
+  cr_assert_str_eq(value->str, "");
+  g_string_free(value, TRUE);
+
+  /* the last good version is kept if the source disappears */
+  g_unlink(source_file);
+  cr_assert_not(lookup_table_handle_refresh(handle));
+  cr_assert(lookup_table_handle_contains(handle, "bar", 3));
+
+  lookup_table_handle_unref(tsv_handle);
+  lookup_table_handle_unref(same_handle);
+  lookup_table_handle_unref(handle);
+}
+
+typedef struct _ReloadWaiter
+{
+  LookupTableHandle *handle;
+  struct iv_timer timer;
+  gint ticks;
+} ReloadWaiter;
+
+static void
+_wait_for_reload(gpointer cookie)
+{
+  ReloadWaiter *waiter = (ReloadWaiter *) cookie;
+
+  if (lookup_table_handle_contains(waiter->handle, "bar", 3) || ++waiter->ticks > 500)
+    {
+      iv_quit();
+      return;
+    }
+
+  iv_validate_now();
+  waiter->timer.expires = iv_now;
+  timespec_add_msec(&waiter->timer.expires, 10);
+  iv_timer_register(&waiter->timer);
+}
+
+Test(lookup_table, changed_files_are_compiled_in_the_background_when_the_handle_is_taken)
+{
+  _write_source("foo\n", 60);
+
+  LookupTableHandle *handle = lookup_table_handle_get(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL);
+  cr_assert_not_null(handle);
+
+  _write_source("bar\n", 30);
+  LookupTableHandle *same_handle = lookup_table_handle_get(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL);
+  cr_assert_eq(handle, same_handle);
+
+  ReloadWaiter waiter = { .handle = handle };
+  IV_TIMER_INIT(&waiter.timer);
+  waiter.timer.cookie = &waiter;
+  waiter.timer.handler = _wait_for_reload;
+  _wait_for_reload(&waiter);
+  iv_main();
+
+  cr_assert(lookup_table_handle_contains(handle, "bar", 3));
+  cr_assert_not(lookup_table_handle_contains(handle, "foo", 3));
+
+  lookup_table_handle_unref(same_handle);
+  lookup_table_handle_unref(handle);
+}
+
+static void
+_wait_for_running_reloads(gpointer cookie)
+{
+  ReloadWaiter *waiter = (ReloadWaiter *) cookie;
+
+  if (lookup_table_get_running_reloads() == 0 || ++waiter->ticks > 500)
+    {
+      iv_quit();
+      return;
+    }
+
+  iv_validate_now();
+  waiter->timer.expires = iv_now;
+  timespec_add_msec(&waiter->timer.expires, 10);
+  iv_timer_register(&waiter->timer);
+}
+
+Test(lookup_table, handles_can_be_released_while_compiling_in_the_background)
+{
+  _write_source("foo\n", 60);
+
+  LookupTableHandle *handle = lookup_table_handle_get(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL);
+  cr_assert_not_null(handle);
+
+  _write_source("bar\n", 30);
+  LookupTableHandle *same_handle = lookup_table_handle_get(source_file, LOOKUP_TABLE_FORMAT_LIST, NULL);
+  cr_assert_eq(handle, same_handle);
+
+  /* the completion of the reload is delivered by the main loop, which is not running yet */
+  lookup_table_handle_unref(same_handle);
+  lookup_table_handle_unref(handle);
+  cr_assert_eq(lookup_table_get_running_reloads(), 1);
+
+  ReloadWaiter waiter = { 0 };
+  IV_TIMER_INIT(&waiter.timer);
+  waiter.timer.cookie = &waiter;
+  waiter.timer.handler = _wait_for_running_reloads;
+  _wait_for_running_reloads(&waiter);
+  iv_main();
+
+  cr_assert_eq(lookup_table_get_running_reloads(), 0);
+}
+
+typedef struct _LookupThreadData
+{
+  LookupTableHandle *handle;
+  gint stop;
+  gint failures;
+} LookupThreadData;
+
+static gpointer
+_lookup_thread(gpointer user_data)
+{
+  LookupThreadData *data = (LookupThreadData *) user_data;
+  GString *value = g_string_new(NULL);
+
+  while (!g_atomic_int_get(&data->stop))
+    {
+      g_string_truncate(value, 0);
+      if (!lookup_table_handle_lookup(data->handle, "foo", 3, value) || strcmp(value->str, "1") != 0)
+        g_atomic_int_inc(&data->failures);
+    }
+
+  g_string_free(value, TRUE);
+  return NULL;
+}
+
+Test(lookup_table, lookups_are_not_disturbed_by_reloads)
+{
+  _write_source("foo\t1\n", 60);
+
+  LookupThreadData data = { 0 };
+  data.handle = lookup_table_handle_get(source_file, LOOKUP_TABLE_FORMAT_TSV, NULL);
+  cr_assert_not_null(data.handle);
+
+  GThread *threads[4];
+  for (gint i = 0; i < G_N_ELEMENTS(threads); i++)
+    threads[i] = g_thread_new(NULL, _lookup_thread, &data);
+
+  for (gint i = 0; i < 200; i++)
+    {
+      _write_source(i % 2 ? "foo\t1\n" : "foo\t1\nbar\t2\n", 60 + i);
+      cr_assert(lookup_table_handle_refresh(data.handle));
+    }
+
+  g_atomic_int_set(&data.stop, TRUE);
+  for (gint i = 0; i < G_N_ELEMENTS(threads); i++)
+    g_thread_join(threads[i]);
+
+  cr_assert_eq(data.failures, 0);
+  lookup_table_handle_unref(data.handle);
+}
+
+static void
+setup(void)
+{
+  app_startup();
+  test_dir = g_dir_make_tmp("test_lookup_table_XXXXXX", NULL);
+  cr_assert_not_null(test_dir);
+  source_file = g_build_filename(test_dir, "table.list", NULL);
+  compiled_file = g_build_filename(test_dir, "table.lookup", NULL);
+}
+
+static void
+teardown(void)
+{
+  g_unlink(source_file);
+  g_unlink(compiled_file);
+  g_rmdir(test_dir);
+  g_free(source_file);
+  g_free(compiled_file);
+  g_free(test_dir);
+  app_shutdown();
+}
+
+TestSuite(lookup_table, .init = setup, .fini = teardown);
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "memory-reservation.h"
+
+#include <string.h>
+
+Test(memory_reservation, test_no_reservation_falls_back_to_heap)
+{
+  cr_assert_null(memory_reservation_alloc(64));
+
+  gpointer p = reserved_malloc(64);
+  cr_assert_not_null(p);
+  cr_assert_not(memory_reservation_owns(p));
+  reserved_free(p);
+}
+
+Test(memory_reservation, test_released_chunks_are_reused)
+{
+  cr_assert(memory_reservation_reserve(1024 * 1024, FALSE));
+
+  gpointer p = memory_reservation_alloc(100);
+  cr_assert_not_null(p);
+  cr_assert(memory_reservation_owns(p));
+  cr_assert_eq(GPOINTER_TO_SIZE(p) % 16, 0);
+  memory_reservation_free(p);
+
+  gpointer q = memory_reservation_alloc(120);
+  cr_assert_eq(q, p, "a chunk of the same size class should have been reused");
+  memory_reservation_free(q);
+}
+
+Test(memory_reservation, test_chunk_size_covers_the_whole_size_class)
+{
+  cr_assert(memory_reservation_reserve(1024 * 1024, FALSE));
+
+  gpointer p = memory_reservation_alloc(100);
+  cr_assert_eq(memory_reservation_get_chunk_size(p), 128);
+  memory_reservation_free(p);
+
+  p = memory_reservation_alloc(128);
+  cr_assert_eq(memory_reservation_get_chunk_size(p), 256, "the header is part of the chunk");
+  memory_reservation_free(p);
+}
+
+Test(memory_reservation, test_exhausted_reservation_falls_back_to_heap)
+{
+  cr_assert(memory_reservation_reserve(64 * 1024, FALSE));
+
+  GPtrArray *allocations = g_ptr_array_new();
+  gpointer p;
+
+  while ((p = memory_reservation_alloc(1000)))
+    g_ptr_array_add(allocations, p);
+  cr_assert_eq(allocations->len, 64);
+
+  p = reserved_malloc(1000);
+  cr_assert_not(memory_reservation_owns(p));
+  reserved_free(p);
+
+  for (gint i = 0; i < allocations->len; i++)
+    memory_reservation_free(g_ptr_array_index(allocations, i));
+  g_ptr_array_free(allocations, TRUE);
+}
+
+Test(memory_reservation, test_too_large_allocations_are_not_served)
+{
+  cr_assert(memory_reservation_reserve(4 * 1024 * 1024, FALSE));
+
+  cr_assert_null(memory_reservation_alloc(2 * 1024 * 1024));
+}
+
+Test(memory_reservation, test_realloc_preserves_contents)
+{
+  cr_assert(memory_reservation_reserve(1024 * 1024, FALSE));
+
+  gchar *p = reserved_malloc(32);
+  cr_assert(memory_reservation_owns(p));
+  strcpy(p, "preserved");
+
+  p = reserved_realloc(p, 40);
+  cr_assert(memory_reservation_owns(p));
+  cr_assert_str_eq(p, "preserved");
+
+  p = reserved_realloc(p, 8192);
+  cr_assert(memory_reservation_owns(p));
+  cr_assert_str_eq(p, "preserved");
+
+  reserved_free(p);
+}
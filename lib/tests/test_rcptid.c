@@ -31,12 +31,12 @@
 #include <unistd.h>
 
 static PersistState *
-setup_persist_id_test(const gchar *persist_file)
+setup_persist_id_test(const gchar *persist_file, gboolean strict_order)
 {
   PersistState *state;
 
   state = clean_and_create_persist_state_for_test(persist_file);
-  rcptid_init(state, TRUE);
+  rcptid_init(state, TRUE, strict_order);
   return state;
 }
 
@@ -65,7 +65,7 @@ Test(rcptid, test_rcptid_is_persistent_across_persist_backend_reinits)
 {
   guint64 rcptid;
 
-  PersistState *state = setup_persist_id_test("test_values.backend_reinits");
+  PersistState *state = setup_persist_id_test("test_values.backend_reinits", TRUE);
   rcptid_set_id(0xFFFFFFFFFFFFFFFE);
   rcptid = rcptid_generate_id();
   cr_assert_eq(rcptid, 0xFFFFFFFFFFFFFFFE, "Rcptid initialization to specific value failed!");
@@ -73,7 +73,7 @@ Test(rcptid, test_rcptid_is_persistent_across_persist_backend_reinits)
   state = restart_persist_state(state);
 
   rcptid_deinit();
-  rcptid_init(state, TRUE);
+  rcptid_init(state, TRUE, TRUE);
 
   rcptid = rcptid_generate_id();
   cr_assert_eq(rcptid, 0xFFFFFFFFFFFFFFFF, "Rcptid did not persisted across persist backend reinit!");
@@ -84,7 +84,7 @@ Test(rcptid, test_rcptid_overflows_at_64bits_and_is_reset_to_one)
 {
   guint64 rcptid;
 
-  PersistState *state = setup_persist_id_test("test_values.reset_to_one");
+  PersistState *state = setup_persist_id_test("test_values.reset_to_one", TRUE);
   rcptid_set_id(0xFFFFFFFFFFFFFFFF);
   rcptid = rcptid_generate_id();
   rcptid = rcptid_generate_id();
@@ -92,6 +92,70 @@ Test(rcptid, test_rcptid_overflows_at_64bits_and_is_reset_to_one)
   teardown_persist_id_test(state);
 }
 
+Test(rcptid, test_rcptid_overflows_at_64bits_and_is_reset_to_one_with_reserved_blocks)
+{
+  guint64 rcptid;
+
+  PersistState *state = setup_persist_id_test("test_values.reset_to_one_blocks", FALSE);
+  rcptid_set_id(0xFFFFFFFFFFFFFFFE);
+  rcptid = rcptid_generate_id();
+  cr_assert_eq(rcptid, 0xFFFFFFFFFFFFFFFE);
+  rcptid = rcptid_generate_id();
+  cr_assert_eq(rcptid, 0xFFFFFFFFFFFFFFFF);
+  rcptid = rcptid_generate_id();
+  cr_assert_eq(rcptid, (guint64) 1, "Rcptid counter overflow handling did not work!");
+  teardown_persist_id_test(state);
+}
+
+Test(rcptid, test_rcptid_reserved_blocks_stay_unique_across_persist_backend_reinits)
+{
+  guint64 rcptid, last_rcptid = 0;
+
+  PersistState *state = setup_persist_id_test("test_values.blocks_backend_reinits", FALSE);
+  rcptid_set_id(1000);
+  for (gint i = 0; i < 10; i++)
+    {
+      rcptid = rcptid_generate_id();
+      cr_assert_eq(rcptid, 1000 + i, "Rcptids should be consecutive within a reserved block");
+      last_rcptid = rcptid;
+    }
+
+  state = restart_persist_state(state);
+
+  rcptid_deinit();
+  rcptid_init(state, TRUE, FALSE);
+
+  rcptid = rcptid_generate_id();
+  cr_assert_gt(rcptid, last_rcptid, "Rcptid was reused after persist backend reinit!");
+  cr_assert_leq(rcptid, 1000 + 4096, "More than one block of rcptids were skipped after persist backend reinit");
+  teardown_persist_id_test(state);
+}
+
+Test(rcptid, test_reserved_blocks_are_kept_across_reloads)
+{
+  PersistState *state = setup_persist_id_test("test_values.blocks_reload", FALSE);
+  rcptid_set_id(1000);
+  cr_assert_eq(rcptid_generate_id(), 1000);
+
+  rcptid_deinit();
+  rcptid_init(state, TRUE, FALSE);
+
+  cr_assert_eq(rcptid_generate_id(), 1001, "Reserved block was dropped on reload");
+  teardown_persist_id_test(state);
+}
+
+Test(rcptid, test_reserved_blocks_are_dropped_when_the_persisted_state_is_reinitialized)
+{
+  PersistState *state = setup_persist_id_test("test_values.blocks_reinit", FALSE);
+  rcptid_set_id(1000);
+  cr_assert_eq(rcptid_generate_id(), 1000);
+  teardown_persist_id_test(state);
+
+  state = setup_persist_id_test("test_values.blocks_reinit", FALSE);
+  cr_assert_eq(rcptid_generate_id(), 1, "Reserved block survived the reinitialization of the persisted state");
+  teardown_persist_id_test(state);
+}
+
 Test(rcptid, test_rcptid_is_formatted_as_a_number_when_nonzero)
 {
   PersistState *state = setup_persist_id_test("test_values.nonzero");
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "str-scan.h"
+
+static void
+_assert_special_found_at_every_offset(const StrScanSpecials *specials, gchar special)
+{
+  gchar buffer[100];
+
+  for (gsize offset = 0; offset < sizeof(buffer); offset++)
+    {
+      memset(buffer, 'a', sizeof(buffer));
+      buffer[offset] = special;
+
+      cr_assert_eq(str_scan_plain_ascii(specials, buffer, sizeof(buffer)), offset,
+                   "special character 0x%02x not found at offset %" G_GSIZE_FORMAT, (guchar) special, offset);
+      cr_assert_eq(str_scan_plain_ascii(specials, buffer, offset), offset);
+    }
+}
+
+Test(str_scan, plain_ascii_is_skipped)
+{
+  StrScanSpecials specials;
+  const gchar *plain = "The quick brown fox jumps over the lazy dog, 0123456789 ~!@#$%^&*()_+{}|:<>?\x7f";
+
+  cr_assert(str_scan_specials_init(&specials, NULL));
+  cr_assert_eq(str_scan_plain_ascii(&specials, plain, strlen(plain)), strlen(plain));
+  cr_assert_eq(str_scan_plain_ascii(&specials, plain, 0), 0);
+}
+
+Test(str_scan, specials_are_found_in_every_position_of_the_block)
+{
+  StrScanSpecials specials;
+
+  cr_assert(str_scan_specials_init(&specials, "\"="));
+  _assert_special_found_at_every_offset(&specials, '\\');
+  _assert_special_found_at_every_offset(&specials, '"');
+  _assert_special_found_at_every_offset(&specials, '=');
+  _assert_special_found_at_every_offset(&specials, '\n');
+  _assert_special_found_at_every_offset(&specials, '\0');
+  _assert_special_found_at_every_offset(&specials, '\x1f');
+  _assert_special_found_at_every_offset(&specials, '\x80');
+  _assert_special_found_at_every_offset(&specials, '\xc3');
+  _assert_special_found_at_every_offset(&specials, '\xff');
+}
+
+Test(str_scan, too_many_extra_specials_are_reported)
+{
+  StrScanSpecials specials;
+
+  cr_assert(str_scan_specials_init(&specials, "\"=,;"));
+  cr_assert_not(str_scan_specials_init(&specials, "\"=,; "));
+}
@@ -55,6 +55,21 @@ ParameterizedTestParameters(test_utf8utils, test_escaped_binary)
     {"\"text\"", "\\\"te\\xt\\\"", "\"x", -1},
     {"\xc3""\xa1 non zero terminated", "\\xc3", NULL, 1},
     {"\xc3""\xa1 non zero terminated", "á", NULL, 2},
+    /* special characters around the boundaries of the 32 byte scanning blocks */
+    {
+      "0123456789abcdefghijklmnopqrstu\"v\nwxyz0123456789abcdefghijklmnopqrstuvwxyz\\",
+      "0123456789abcdefghijklmnopqrstu\\\"v\\nwxyz0123456789abcdefghijklmnopqrstuvwxyz\\\\", "\"", -1
+    },
+    {
+      "0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz\x01",
+      "0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz\\x01", NULL, -1
+    },
+    {
+      "0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz\xc3""\xa1\xc3",
+      "0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyzá\\xc3", NULL, -1
+    },
+    /* more unsafe characters than the vectorized scan handles */
+    {"a=b, c;d \"e\"", "a\\=b\\,\\ c\\;d\\ \\\"e\\\"", "\"=,; ", -1},
   };
 
   return cr_make_param_array(StringValueList, string_value_list,
@@ -23,6 +23,7 @@
  */
 #include "utf8utils.h"
 #include "str-utils.h"
+#include "str-scan.h"
 
 static inline gboolean
 _is_character_unsafe(gunichar uchar, const gchar *unsafe_chars)
@@ -57,58 +58,109 @@ _is_character_unsafe(gunichar uchar, const gchar *unsafe_chars)
  *   - any additional characters (only ASCII is supported) as \<char>
  *   - invalid utf8 sequences are converted as per invalid_format
  *   - utf8 characters are reproduced as is
+ *
+ * The escaped form of the character is written to @dst, which must have
+ * room for it, the number of bytes written is returned.
  */
 static gsize
-_append_escaped_utf8_character(GString *escaped_output, const gchar **raw,
-                               gssize raw_len, const gchar *unsafe_chars,
-                               const gchar *control_format,
-                               const gchar *invalid_format)
+_write_escaped_utf8_character(gchar *dst, gsize dst_size, const gchar **raw,
+                              gssize raw_len, const gchar *unsafe_chars,
+                              const gchar *control_format,
+                              const gchar *invalid_format)
 {
   const gchar *char_ptr = *raw;
   gunichar uchar = g_utf8_get_char_validated(char_ptr, raw_len);
 
   if (G_UNLIKELY(uchar == (gunichar) -1 || uchar == (gunichar) -2))
     {
-      g_string_append_printf(escaped_output, invalid_format, *(guint8 *) char_ptr);
       (*raw)++;
-      return 1;
+      return g_snprintf(dst, dst_size, invalid_format, *(guint8 *) char_ptr);
     }
-  else if (G_UNLIKELY(uchar < 32 || uchar == '\\'))
+
+  *raw = g_utf8_next_char(char_ptr);
+
+  if (G_UNLIKELY(uchar < 32 || uchar == '\\'))
     {
       switch (uchar)
         {
         case '\b':
-          g_string_append(escaped_output, "\\b");
-          break;
+          memcpy(dst, "\\b", 2);
+          return 2;
         case '\f':
-          g_string_append(escaped_output, "\\f");
-          break;
+          memcpy(dst, "\\f", 2);
+          return 2;
         case '\n':
-          g_string_append(escaped_output, "\\n");
-          break;
+          memcpy(dst, "\\n", 2);
+          return 2;
         case '\r':
-          g_string_append(escaped_output, "\\r");
-          break;
+          memcpy(dst, "\\r", 2);
+          return 2;
         case '\t':
-          g_string_append(escaped_output, "\\t");
-          break;
+          memcpy(dst, "\\t", 2);
+          return 2;
         case '\\':
-          g_string_append(escaped_output, "\\\\");
-          break;
+          memcpy(dst, "\\\\", 2);
+          return 2;
         default:
-          g_string_append_printf(escaped_output, control_format, uchar);
-          break;
+          return g_snprintf(dst, dst_size, control_format, uchar);
         }
     }
   else if (G_UNLIKELY(_is_character_unsafe(uchar, unsafe_chars)))
-    g_string_append_printf(escaped_output, "\\%c", (gchar) uchar);
-  else
-    g_string_append_unichar_optimized(escaped_output, uchar);
+    {
+      dst[0] = '\\';
+      dst[1] = (gchar) uchar;
+      return 2;
+    }
 
-  *raw = g_utf8_next_char(char_ptr);
+  /* valid utf8 sequences are validated to be in their shortest form, so
+   * re-encoding uchar would produce the very same bytes */
+  memcpy(dst, char_ptr, *raw - char_ptr);
   return *raw - char_ptr;
 }
 
+/* the longest escape sequence a single input byte may turn into */
+static gsize
+_get_max_escaped_length_per_byte(const gchar *control_format, const gchar *invalid_format)
+{
+  gchar buf[64];
+  gsize max_length = 2;
+
+  max_length = MAX(max_length, g_snprintf(buf, sizeof(buf), control_format, 0x1f));
+  max_length = MAX(max_length, g_snprintf(buf, sizeof(buf), invalid_format, 0xff));
+  return max_length;
+}
+
+/* @unsafe_chars is only consulted if it did not fit into @specials */
+static inline gboolean
+_is_plain_ascii(const StrScanSpecials *specials, const gchar *unsafe_chars, gchar c)
+{
+  return str_scan_is_plain_ascii(specials, c) && (G_LIKELY(!unsafe_chars) || !strchr(unsafe_chars, c));
+}
+
+static inline gsize
+_scan_plain_ascii(const StrScanSpecials *specials, const gchar *unsafe_chars, const gchar *raw, gsize raw_len)
+{
+  /* escapes tend to come in runs (e.g. non-ASCII text), don't start a
+   * block scan unless there is something to skip */
+  if (raw_len == 0 || !_is_plain_ascii(specials, unsafe_chars, raw[0]))
+    return 0;
+
+  if (G_LIKELY(!unsafe_chars))
+    return str_scan_plain_ascii(specials, raw, raw_len);
+
+  gsize pos = 1;
+  while (pos < raw_len && _is_plain_ascii(specials, unsafe_chars, raw[pos]))
+    pos++;
+  return pos;
+}
+
+/*
+ * The output is produced in two passes: the first one measures the plain
+ * runs of the input (they are copied as is) and counts the bytes that need
+ * a closer look, so that the output can be reserved in one go.  The second
+ * pass bulk-copies the plain runs and escapes the rest directly into the
+ * reserved space.
+ */
 static void
 _append_unsafe_utf8_as_escaped_with_specific_length(GString *escaped_output, const gchar *raw,
                                                     gsize raw_len,
@@ -116,11 +168,44 @@ _append_unsafe_utf8_as_escaped_with_specific_length(GString *escaped_output, con
                                                     const gchar *control_format,
                                                     const gchar *invalid_format)
 {
-  const gchar *raw_end = raw + raw_len;
+  StrScanSpecials specials;
+  const gchar *scalar_unsafe_chars = str_scan_specials_init(&specials, unsafe_chars) ? NULL : unsafe_chars;
+
+  gsize special_count = 0;
+  gsize pos = _scan_plain_ascii(&specials, scalar_unsafe_chars, raw, raw_len);
+  while (pos < raw_len)
+    {
+      for (; pos < raw_len && !_is_plain_ascii(&specials, scalar_unsafe_chars, raw[pos]); pos++)
+        special_count++;
+      pos += _scan_plain_ascii(&specials, scalar_unsafe_chars, raw + pos, raw_len - pos);
+    }
+
+  if (G_LIKELY(special_count == 0))
+    {
+      g_string_append_len(escaped_output, raw, raw_len);
+      return;
+    }
 
+  gsize max_escaped_length = _get_max_escaped_length_per_byte(control_format, invalid_format);
+  gsize start = escaped_output->len;
+  g_string_set_size(escaped_output, start + (raw_len - special_count) + special_count * max_escaped_length);
+
+  gchar *dst = escaped_output->str + start;
+  gchar *dst_end = escaped_output->str + escaped_output->len;
+  const gchar *raw_end = raw + raw_len;
   while (raw < raw_end)
-    _append_escaped_utf8_character(escaped_output, &raw, raw_end - raw, unsafe_chars,
-                                   control_format, invalid_format);
+    {
+      gsize plain_len = _scan_plain_ascii(&specials, scalar_unsafe_chars, raw, raw_end - raw);
+      memcpy(dst, raw, plain_len);
+      dst += plain_len;
+      raw += plain_len;
+
+      /* dst_end is followed by the room of the NUL terminator */
+      if (raw < raw_end)
+        dst += _write_escaped_utf8_character(dst, dst_end - dst + 1, &raw, raw_end - raw, unsafe_chars,
+                                             control_format, invalid_format);
+    }
+  g_string_truncate(escaped_output, dst - escaped_output->str);
 }
 
 static void
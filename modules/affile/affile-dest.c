@@ -57,7 +57,7 @@
  *
  *   - queue runs in the thread of the source thread that generated the message
  *   - if the message is to be written to a not-yet-opened file, a new gets
- *     opened and stored in the writer_hash hashtable (initiated from queue,
+ *     opened and stored in one of the writer shards (initiated from queue,
  *     but performed in the main thread, but more on that later)
  *   - currently opened destination files are checked regularly and closed
  *     if they are idle for a given amount of time (time_reap) (this is done
@@ -74,15 +74,25 @@
  * syslog-ng is running.
  *
  * AFFileDestWriter instances are created dynamically when a new file is
- * opened. A reference is stored in the writer_hash hashtable. This is then:
+ * opened. A reference is stored in the hashtable of the writer shard
+ * selected by the hash of the filename. This is then:
  *    - looked up in _queue() (in the source thread)
  *    - cleaned up in reap callback (in the main thread)
  *
- * writer_hash is locked (currently a simple mutex) using
+ * Each shard is locked using its own mutex, so that source threads
+ * delivering to different files do not contend on a single lock, and
+ * reaping an idle file only blocks the lookups of its own shard.  The
+ * single_writer of non-templated destinations is protected by
  * AFFileDestDriver->lock.  The "queue" method cannot hold the lock while
  * forwarding it to the next pipe, thus a reference is taken under the
  * protection of the lock, keeping a the next pipe alive, even if that would
  * go away in a parallel reaper process.
+ *
+ * If max-files() is set, the number of writers is limited over all the
+ * shards: when opening a new file exceeds the limit, the least recently
+ * used idle writers are closed, regardless of the shard they are in.  This
+ * happens in the main thread, with all the shards locked, as the shard
+ * hashtables are only written there.
  */
 
 static GList *affile_dest_drivers = NULL;
@@ -97,6 +107,7 @@ struct _AFFileDestWriter
   time_t last_msg_stamp;
   time_t last_open_stamp;
   gboolean reopen_pending, queue_pending;
+  WriterShardEntry shard_entry;
 };
 
 static gchar *
@@ -111,23 +122,31 @@ affile_dw_format_persist_name(AFFileDestWriter *self)
 }
 
 static void affile_dd_reap_writer(AFFileDestDriver *self, AFFileDestWriter *dw);
+static GMutex *affile_dd_get_writer_lock(AFFileDestDriver *self, AFFileDestWriter *dw);
+
+static gboolean
+affile_dw_is_idle(AFFileDestWriter *self)
+{
+  return !log_writer_has_pending_writes((LogWriter *) self->writer) && !self->queue_pending;
+}
 
 static void
 affile_dw_reap(AFFileDestWriter *self)
 {
   AFFileDestDriver *owner = self->owner;
+  GMutex *lock = affile_dd_get_writer_lock(owner, self);
 
   main_loop_assert_main_thread();
 
-  g_mutex_lock(&owner->lock);
-  if (!log_writer_has_pending_writes((LogWriter *) self->writer) && !self->queue_pending)
+  g_mutex_lock(lock);
+  if (affile_dw_is_idle(self))
     {
       msg_verbose("Destination timed out, reaping",
                   evt_tag_str("template", self->owner->filename_template->template_str),
                   evt_tag_str("filename", self->filename));
       affile_dd_reap_writer(self->owner, self);
     }
-  g_mutex_unlock(&owner->lock);
+  g_mutex_unlock(lock);
 }
 
 static gboolean
@@ -388,12 +407,13 @@ affile_dw_new(const gchar *filename, GlobalConfig *cfg)
   /* we have to take care about freeing filename later.
      This avoids a move of the filename. */
   self->filename = g_strdup(filename);
+  writer_shard_entry_init(&self->shard_entry, self->filename, self);
   g_mutex_init(&self->lock);
   return self;
 }
 
 static void
-affile_dw_reopen_writer(gpointer key, gpointer value, gpointer user_data)
+affile_dw_reopen_writer(gpointer value, gpointer user_data)
 {
   AFFileDestWriter *writer = (AFFileDestWriter *) value;
   affile_dw_reopen(writer);
@@ -404,9 +424,12 @@ affile_dd_reopen_all_writers(gpointer data, gpointer user_data)
 {
   AFFileDestDriver *driver = (AFFileDestDriver *) data;
   if (driver->single_writer)
-    affile_dw_reopen(driver->single_writer);
-  else if (driver->writer_hash)
-    g_hash_table_foreach(driver->writer_hash, affile_dw_reopen_writer, NULL);
+    {
+      affile_dw_reopen(driver->single_writer);
+      return;
+    }
+
+  writer_shards_foreach(&driver->writers, affile_dw_reopen_writer, NULL);
 }
 
 static void
@@ -456,6 +479,14 @@ affile_dd_set_time_reap(LogDriver *s, gint time_reap)
   log_proto_client_options_set_timeout(&self->writer_options.proto_options.super, time_reap);
 }
 
+void
+affile_dd_set_max_files(LogDriver *s, gint max_files)
+{
+  AFFileDestDriver *self = (AFFileDestDriver *) s;
+
+  self->max_files = max_files;
+}
+
 static gint
 affile_dd_get_time_reap(AFFileDestDriver *self)
 {
@@ -477,24 +508,36 @@ affile_dd_format_persist_name(const LogPipe *s)
   return persist_name;
 }
 
-/* DestDriver lock must be held before calling this function */
-static void
-affile_dd_reap_writer(AFFileDestDriver *self, AFFileDestWriter *dw)
+static GMutex *
+affile_dd_get_writer_lock(AFFileDestDriver *self, AFFileDestWriter *dw)
 {
-  LogWriter *writer = (LogWriter *)dw->writer;
+  if (!self->filename_is_a_template)
+    return &self->lock;
 
-  main_loop_assert_main_thread();
+  return &writer_shards_get_shard(&self->writers, dw->filename)->lock;
+}
 
+/* DestDriver lock (or the writer's shard lock) must be held before calling this function */
+static void
+affile_dd_detach_writer(AFFileDestDriver *self, AFFileDestWriter *dw)
+{
   if (self->filename_is_a_template)
     {
-      /* remove from hash table */
-      g_hash_table_remove(self->writer_hash, dw->filename);
+      writer_shards_remove(&self->writers, &dw->shard_entry);
     }
   else
     {
       g_assert(dw == self->single_writer);
       self->single_writer = NULL;
     }
+}
+
+static void
+affile_dd_release_writer(AFFileDestDriver *self, AFFileDestWriter *dw)
+{
+  LogWriter *writer = (LogWriter *)dw->writer;
+
+  main_loop_assert_main_thread();
 
   LogQueue *queue = log_writer_get_queue(writer);
   log_pipe_deinit(&dw->super);
@@ -502,29 +545,128 @@ affile_dd_reap_writer(AFFileDestDriver *self, AFFileDestWriter *dw)
   log_pipe_unref(&dw->super);
 }
 
+/* DestDriver lock (or the writer's shard lock) must be held before calling this function */
+static void
+affile_dd_reap_writer(AFFileDestDriver *self, AFFileDestWriter *dw)
+{
+  main_loop_assert_main_thread();
+
+  affile_dd_detach_writer(self, dw);
+  affile_dd_release_writer(self, dw);
+}
+
+static gboolean
+affile_dd_writer_is_evictable(WriterShardEntry *entry, gpointer user_data)
+{
+  AFFileDestWriter *dw = (AFFileDestWriter *) entry->writer;
+  AFFileDestWriter *opened_writer = (AFFileDestWriter *) user_data;
+
+  return dw != opened_writer && affile_dw_is_idle(dw);
+}
+
+/*
+ * Enforces max-files() over all the writer shards. The least recently used
+ * idle writers are removed with all the shards locked, but closing them is
+ * done after releasing the locks, so that source threads are not blocked
+ * while the files are flushed and closed.
+ */
+static void
+affile_dd_close_least_recently_used(AFFileDestDriver *self, AFFileDestWriter *opened_writer)
+{
+  GList *evicted = NULL;
+
+  main_loop_assert_main_thread();
+
+  if (self->max_files <= 0 || writer_shards_get_size(&self->writers) <= self->max_files)
+    return;
+
+  writer_shards_lock_all(&self->writers);
+  while (writer_shards_get_size(&self->writers) > self->max_files)
+    {
+      WriterShardEntry *entry = writer_shards_find_least_recently_used(&self->writers, affile_dd_writer_is_evictable,
+                                                                       opened_writer);
+      if (!entry)
+        break;
+
+      AFFileDestWriter *dw = (AFFileDestWriter *) entry->writer;
+
+      msg_verbose("Too many open destination files, closing the least recently used one",
+                  evt_tag_str("template", self->filename_template->template_str),
+                  evt_tag_str("filename", dw->filename),
+                  evt_tag_int("max_files", self->max_files));
+      affile_dd_detach_writer(self, dw);
+      evicted = g_list_prepend(evicted, dw);
+    }
+  writer_shards_unlock_all(&self->writers);
+
+  for (GList *l = evicted; l; l = l->next)
+    affile_dd_release_writer(self, (AFFileDestWriter *) l->data);
+  g_list_free(evicted);
+}
 
 /**
- * affile_dd_reuse_writer:
+ * affile_dd_reuse_writers:
  *
- * This function is called as a g_hash_table_foreach() callback to set the
- * owner of each writer, previously connected to an AFileDestDriver instance
- * in an earlier configuration. This way AFFileDestWriter instances are
+ * This function sets the owner of each writer, previously connected to an
+ * AFileDestDriver instance in an earlier configuration and moves them into
+ * the writer shards of @self. This way AFFileDestWriter instances are
  * remembered across reloads.
  *
  **/
 static void
-affile_dd_reuse_writer(gpointer key, gpointer value, gpointer user_data)
+affile_dd_reuse_writers(AFFileDestDriver *self, GHashTable *writer_hash)
 {
-  AFFileDestDriver *self = (AFFileDestDriver *) user_data;
-  AFFileDestWriter *writer = (AFFileDestWriter *) value;
+  GHashTableIter iter;
+  gpointer value;
 
-  affile_dw_set_owner(writer, self);
-  if (!log_pipe_init(&writer->super))
+  g_hash_table_iter_init(&iter, writer_hash);
+  while (g_hash_table_iter_next(&iter, NULL, &value))
     {
-      affile_dw_unset_owner(writer);
-      log_pipe_unref(&writer->super);
-      g_hash_table_remove(self->writer_hash, key);
+      AFFileDestWriter *writer = (AFFileDestWriter *) value;
+
+      g_hash_table_iter_steal(&iter);
+      affile_dw_set_owner(writer, self);
+      if (!log_pipe_init(&writer->super))
+        {
+          affile_dw_unset_owner(writer);
+          log_pipe_unref(&writer->super);
+          continue;
+        }
+
+      WriterShard *shard = writer_shards_get_shard(&self->writers, writer->filename);
+      g_mutex_lock(&shard->lock);
+      writer_shards_add(&self->writers, &writer->shard_entry);
+      g_mutex_unlock(&shard->lock);
     }
+  g_hash_table_destroy(writer_hash);
+
+  /* max-files() might have been lowered by the reload */
+  affile_dd_close_least_recently_used(self, NULL);
+}
+
+/*
+ * Collects the writers of all shards into a single hashtable, this is what
+ * we store in the persistent config across reloads.
+ */
+static void
+affile_dd_collect_writer(gpointer value, gpointer user_data)
+{
+  AFFileDestWriter *writer = (AFFileDestWriter *) value;
+  GHashTable **writer_hash = (GHashTable **) user_data;
+
+  if (!*writer_hash)
+    *writer_hash = g_hash_table_new(g_str_hash, g_str_equal);
+
+  g_hash_table_insert(*writer_hash, writer->filename, writer);
+}
+
+static GHashTable *
+affile_dd_collect_writers(AFFileDestDriver *self)
+{
+  GHashTable *writer_hash = NULL;
+
+  writer_shards_foreach_remove(&self->writers, affile_dd_collect_writer, &writer_hash);
+  return writer_hash;
 }
 
 
@@ -546,9 +688,9 @@ affile_dd_init(LogPipe *s)
 
   if (self->filename_is_a_template)
     {
-      self->writer_hash = cfg_persist_config_fetch(cfg, affile_dd_format_persist_name(s));
-      if (self->writer_hash)
-        g_hash_table_foreach(self->writer_hash, affile_dd_reuse_writer, self);
+      GHashTable *writer_hash = cfg_persist_config_fetch(cfg, affile_dd_format_persist_name(s));
+      if (writer_hash)
+        affile_dd_reuse_writers(self, writer_hash);
     }
   else
     {
@@ -623,21 +765,23 @@ affile_dd_deinit(LogPipe *s)
    * have circular references between AFFileDestDriver and file writers */
   if (self->single_writer)
     {
-      g_assert(self->writer_hash == NULL);
+      g_assert(self->filename_is_a_template == FALSE);
 
       log_pipe_deinit(&self->single_writer->super);
       cfg_persist_config_add(cfg, affile_dd_format_persist_name(s), self->single_writer,
                              affile_dd_destroy_writer);
       self->single_writer = NULL;
     }
-  else if (self->writer_hash)
+  else if (self->filename_is_a_template)
     {
-      g_assert(self->single_writer == NULL);
+      GHashTable *writer_hash = affile_dd_collect_writers(self);
 
-      g_hash_table_foreach(self->writer_hash, affile_dd_deinit_writer, NULL);
-      cfg_persist_config_add(cfg, affile_dd_format_persist_name(s), self->writer_hash,
-                             affile_dd_destroy_writer_hash);
-      self->writer_hash = NULL;
+      if (writer_hash)
+        {
+          g_hash_table_foreach(writer_hash, affile_dd_deinit_writer, NULL);
+          cfg_persist_config_add(cfg, affile_dd_format_persist_name(s), writer_hash,
+                                 affile_dd_destroy_writer_hash);
+        }
     }
 
   if (!log_dest_driver_deinit_method(s))
@@ -687,17 +831,15 @@ affile_dd_open_writer(gpointer args[])
   else
     {
       GString *filename = args[1];
+      WriterShard *shard = writer_shards_get_shard(&self->writers, filename->str);
 
-      /* hash table construction is serialized, as we only do that in the main thread. */
-      if (!self->writer_hash)
-        self->writer_hash = g_hash_table_new(g_str_hash, g_str_equal);
+      /* the shard hashtables are only written in the main thread, which
+       * we're running right now, but the lookup also updates the LRU
+       * order, which is shared with the lookups in other threads.  */
 
-      /* we don't need to lock the hashtable as it is only written in
-       * the main thread, which we're running right now.  lookups in
-       * other threads must be locked. writers must be locked even in
-       * this thread to exclude lookups in other threads.  */
-
-      next = g_hash_table_lookup(self->writer_hash, filename->str);
+      g_mutex_lock(&shard->lock);
+      next = writer_shards_lookup(&self->writers, filename->str);
+      g_mutex_unlock(&shard->lock);
       if (!next)
         {
           next = affile_dw_new(filename->str, log_pipe_get_config(&self->super.super.super));
@@ -710,9 +852,10 @@ affile_dd_open_writer(gpointer args[])
           else
             {
               log_pipe_ref(&next->super);
-              g_mutex_lock(&self->lock);
-              g_hash_table_insert(self->writer_hash, next->filename, next);
-              g_mutex_unlock(&self->lock);
+              g_mutex_lock(&shard->lock);
+              writer_shards_add(&self->writers, &next->shard_entry);
+              g_mutex_unlock(&shard->lock);
+              affile_dd_close_least_recently_used(self, next);
             }
         }
       else
@@ -765,21 +908,19 @@ affile_dd_queue(LogPipe *s, LogMessage *msg, const LogPathOptions *path_options)
       LogTemplateEvalOptions options = {&self->writer_options.template_options, LTZ_LOCAL, 0, NULL, LM_VT_STRING};
       log_template_format(self->filename_template, msg, &options, filename);
 
-      g_mutex_lock(&self->lock);
-      if (self->writer_hash)
-        next = g_hash_table_lookup(self->writer_hash, filename->str);
-      else
-        next = NULL;
+      WriterShard *shard = writer_shards_get_shard(&self->writers, filename->str);
 
+      g_mutex_lock(&shard->lock);
+      next = writer_shards_lookup(&self->writers, filename->str);
       if (next)
         {
           log_pipe_ref(&next->super);
           next->queue_pending = TRUE;
-          g_mutex_unlock(&self->lock);
+          g_mutex_unlock(&shard->lock);
         }
       else
         {
-          g_mutex_unlock(&self->lock);
+          g_mutex_unlock(&shard->lock);
           args[1] = filename;
           next = main_loop_call((void *(*)(void *)) affile_dd_open_writer, args, TRUE);
         }
@@ -804,8 +945,9 @@ affile_dd_free(LogPipe *s)
   g_mutex_clear(&self->lock);
   affile_dest_drivers = g_list_remove(affile_dest_drivers, self);
 
-  /* NOTE: this must be NULL as deinit has freed it, otherwise we'd have circular references */
-  g_assert(self->single_writer == NULL && self->writer_hash == NULL);
+  /* NOTE: this must be empty as deinit has freed it, otherwise we'd have circular references */
+  g_assert(self->single_writer == NULL);
+  writer_shards_deinit(&self->writers);
 
   log_template_unref(self->filename_template);
   log_writer_options_destroy(&self->writer_options);
@@ -840,6 +982,7 @@ affile_dd_new_instance(LogTemplate *filename_template, GlobalConfig *cfg)
 
   affile_dd_set_time_reap(&self->super.super, self->filename_is_a_template ? -1 : 0);
   g_mutex_init(&self->lock);
+  writer_shards_init(&self->writers);
 
   affile_dest_drivers = g_list_append(affile_dest_drivers, self);
 
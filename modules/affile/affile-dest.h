@@ -27,6 +27,7 @@
 #include "driver.h"
 #include "logwriter.h"
 #include "file-opener.h"
+#include "writer-shards.h"
 
 typedef struct _AFFileDestWriter AFFileDestWriter;
 
@@ -44,7 +45,8 @@ typedef struct _AFFileDestDriver
   TimeZoneInfo *local_time_zone_info;
   LogWriterOptions writer_options;
   guint32 writer_flags;
-  GHashTable *writer_hash;
+  WriterShards writers;
+  gint max_files;
 
   gint overwrite_if_older;
   gchar *symlink_as;
@@ -60,6 +62,7 @@ void affile_dd_set_overwrite_if_older(LogDriver *s, gint overwrite_if_older);
 void affile_dd_set_symlink_as(LogDriver *s, const gchar *symlink_as);
 void affile_dd_set_local_time_zone(LogDriver *s, const gchar *local_time_zone);
 void affile_dd_set_time_reap(LogDriver *s, gint time_reap);
+void affile_dd_set_max_files(LogDriver *s, gint max_files);
 void affile_dd_global_init(void);
 
 #endif
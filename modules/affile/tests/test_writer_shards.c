@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+#include "writer-shards.h"
+
+#define NUM_WRITERS 64
+
+typedef struct _TestWriter
+{
+  gchar *filename;
+  gboolean busy;
+  WriterShardEntry shard_entry;
+} TestWriter;
+
+static WriterShards shards;
+static TestWriter writers[NUM_WRITERS];
+
+/* entries are ordered by their timestamp, make sure two uses never share one */
+static void
+_wait_for_clock_tick(void)
+{
+  gint64 now = g_get_monotonic_time();
+
+  while (g_get_monotonic_time() == now)
+    ;
+}
+
+static void
+_add(TestWriter *writer)
+{
+  WriterShard *shard = writer_shards_get_shard(&shards, writer->filename);
+
+  _wait_for_clock_tick();
+  g_mutex_lock(&shard->lock);
+  writer_shards_add(&shards, &writer->shard_entry);
+  g_mutex_unlock(&shard->lock);
+}
+
+static TestWriter *
+_use(const gchar *filename)
+{
+  WriterShard *shard = writer_shards_get_shard(&shards, filename);
+
+  _wait_for_clock_tick();
+  g_mutex_lock(&shard->lock);
+  TestWriter *writer = writer_shards_lookup(&shards, filename);
+  g_mutex_unlock(&shard->lock);
+  return writer;
+}
+
+static gboolean
+_is_idle(WriterShardEntry *entry, gpointer user_data)
+{
+  TestWriter *writer = (TestWriter *) entry->writer;
+
+  return !writer->busy && writer != user_data;
+}
+
+/* the same loop as max-files() enforcement in the file destination */
+static GList *
+_close_least_recently_used(gint max_files, TestWriter *opened_writer)
+{
+  GList *closed = NULL;
+
+  writer_shards_lock_all(&shards);
+  while (writer_shards_get_size(&shards) > max_files)
+    {
+      WriterShardEntry *entry = writer_shards_find_least_recently_used(&shards, _is_idle, opened_writer);
+      if (!entry)
+        break;
+
+      writer_shards_remove(&shards, entry);
+      closed = g_list_append(closed, entry->writer);
+    }
+  writer_shards_unlock_all(&shards);
+  return closed;
+}
+
+static gboolean
+_is_open(TestWriter *writer)
+{
+  WriterShard *shard = writer_shards_get_shard(&shards, writer->filename);
+
+  return g_hash_table_lookup(shard->entries, writer->filename) == &writer->shard_entry;
+}
+
+static void
+_open_with_limit(TestWriter *writer, gint max_files)
+{
+  _add(writer);
+  g_list_free(_close_least_recently_used(max_files, writer));
+}
+
+static void
+_collect_writer(gpointer value, gpointer user_data)
+{
+  GList **collected = (GList **) user_data;
+
+  *collected = g_list_prepend(*collected, value);
+}
+
+static void
+setup(void)
+{
+  writer_shards_init(&shards);
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    {
+      writers[i].filename = g_strdup_printf("/var/log/hosts/host%02d.log", i);
+      writers[i].busy = FALSE;
+      writer_shard_entry_init(&writers[i].shard_entry, writers[i].filename, &writers[i]);
+    }
+}
+
+static void
+teardown(void)
+{
+  GList *removed = NULL;
+
+  writer_shards_foreach_remove(&shards, _collect_writer, &removed);
+  g_list_free(removed);
+  writer_shards_deinit(&shards);
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    g_free(writers[i].filename);
+}
+
+TestSuite(writer_shards, .init = setup, .fini = teardown);
+
+Test(writer_shards, writers_are_spread_over_the_shards_and_counted_globally)
+{
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    _add(&writers[i]);
+
+  cr_assert_eq(writer_shards_get_size(&shards), NUM_WRITERS);
+
+  gint used_shards = 0;
+  gint writers_in_shards = 0;
+  for (gint i = 0; i < WRITER_SHARDS_COUNT; i++)
+    {
+      gint shard_size = g_hash_table_size(shards.shards[i].entries);
+
+      cr_assert_eq(shard_size, g_queue_get_length(&shards.shards[i].lru));
+      writers_in_shards += shard_size;
+      used_shards += shard_size > 0;
+    }
+  cr_assert_eq(writers_in_shards, NUM_WRITERS);
+  cr_assert_gt(used_shards, 1, "writers are expected to be hashed into multiple shards");
+
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    cr_assert_eq(_use(writers[i].filename), &writers[i]);
+  cr_assert_null(_use("/var/log/hosts/unknown.log"));
+
+  writer_shards_remove(&shards, &writers[0].shard_entry);
+  cr_assert_eq(writer_shards_get_size(&shards), NUM_WRITERS - 1);
+  cr_assert_null(_use(writers[0].filename));
+}
+
+Test(writer_shards, least_recently_used_writer_is_found_across_shards)
+{
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    _add(&writers[i]);
+
+  writer_shards_lock_all(&shards);
+  cr_assert_eq(writer_shards_find_least_recently_used(&shards, NULL, NULL), &writers[0].shard_entry);
+  writer_shards_unlock_all(&shards);
+
+  /* use them in reverse order, the first one becomes the most recently used */
+  for (gint i = NUM_WRITERS - 1; i >= 0; i--)
+    _use(writers[i].filename);
+
+  writer_shards_lock_all(&shards);
+  cr_assert_eq(writer_shards_find_least_recently_used(&shards, NULL, NULL), &writers[NUM_WRITERS - 1].shard_entry);
+
+  writers[NUM_WRITERS - 1].busy = TRUE;
+  cr_assert_eq(writer_shards_find_least_recently_used(&shards, _is_idle, NULL),
+               &writers[NUM_WRITERS - 2].shard_entry, "busy writers are not evictable");
+  writer_shards_unlock_all(&shards);
+}
+
+Test(writer_shards, closing_least_recently_used_writers_keeps_max_files_open)
+{
+  const gint max_files = 4;
+
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    {
+      _open_with_limit(&writers[i], max_files);
+      cr_assert_leq(writer_shards_get_size(&shards), max_files);
+    }
+
+  cr_assert_eq(writer_shards_get_size(&shards), max_files);
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    cr_assert_eq(_is_open(&writers[i]), i >= NUM_WRITERS - max_files, "unexpected open state for writer %d", i);
+}
+
+Test(writer_shards, recently_used_writers_are_kept_open)
+{
+  const gint max_files = 4;
+
+  for (gint i = 0; i < max_files; i++)
+    _add(&writers[i]);
+
+  /* writers[0] keeps receiving messages, writers[1] becomes the oldest */
+  _use(writers[0].filename);
+  _open_with_limit(&writers[max_files], max_files);
+
+  cr_assert(_is_open(&writers[0]));
+  cr_assert_not(_is_open(&writers[1]));
+  cr_assert(_is_open(&writers[max_files]));
+  cr_assert_eq(writer_shards_get_size(&shards), max_files);
+}
+
+Test(writer_shards, busy_and_just_opened_writers_are_not_closed)
+{
+  const gint max_files = 2;
+
+  _add(&writers[0]);
+  _add(&writers[1]);
+  writers[0].busy = TRUE;
+  writers[1].busy = TRUE;
+
+  _open_with_limit(&writers[2], max_files);
+  cr_assert(_is_open(&writers[0]));
+  cr_assert(_is_open(&writers[1]));
+  cr_assert(_is_open(&writers[2]));
+  cr_assert_eq(writer_shards_get_size(&shards), 3, "the limit is exceeded while every other writer is busy");
+
+  writers[1].busy = FALSE;
+  _open_with_limit(&writers[3], max_files);
+  cr_assert(_is_open(&writers[0]));
+  cr_assert_not(_is_open(&writers[1]));
+  cr_assert_not(_is_open(&writers[2]));
+  cr_assert(_is_open(&writers[3]));
+  cr_assert_eq(writer_shards_get_size(&shards), max_files);
+}
+
+#define SAME_SHARD_MAX_FILES 4
+
+Test(writer_shards, the_limit_is_not_split_between_shards)
+{
+  TestWriter *same_shard[SAME_SHARD_MAX_FILES];
+  WriterShard *shard = NULL;
+  gint found = 0;
+
+  for (gint s = 0; s < WRITER_SHARDS_COUNT && found < SAME_SHARD_MAX_FILES; s++)
+    {
+      shard = &shards.shards[s];
+      found = 0;
+      for (gint i = 0; i < NUM_WRITERS && found < SAME_SHARD_MAX_FILES; i++)
+        {
+          if (writer_shards_get_shard(&shards, writers[i].filename) == shard)
+            same_shard[found++] = &writers[i];
+        }
+    }
+  cr_assert_eq(found, SAME_SHARD_MAX_FILES, "not enough writers hashed into the same shard");
+
+  for (gint i = 0; i < SAME_SHARD_MAX_FILES; i++)
+    _open_with_limit(same_shard[i], SAME_SHARD_MAX_FILES);
+
+  for (gint i = 0; i < SAME_SHARD_MAX_FILES; i++)
+    cr_assert(_is_open(same_shard[i]), "writer %d of a busy shard was closed below the limit", i);
+  cr_assert_eq(g_hash_table_size(shard->entries), SAME_SHARD_MAX_FILES);
+}
+
+Test(writer_shards, foreach_remove_empties_all_the_shards)
+{
+  GList *removed = NULL;
+
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    _add(&writers[i]);
+
+  writer_shards_foreach_remove(&shards, _collect_writer, &removed);
+  cr_assert_eq(g_list_length(removed), NUM_WRITERS);
+  cr_assert_eq(writer_shards_get_size(&shards), 0);
+  for (gint i = 0; i < NUM_WRITERS; i++)
+    cr_assert_not(_is_open(&writers[i]));
+  g_list_free(removed);
+}
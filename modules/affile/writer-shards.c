@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "writer-shards.h"
+
+void
+writer_shard_entry_init(WriterShardEntry *entry, const gchar *key, gpointer writer)
+{
+  entry->key = key;
+  entry->writer = writer;
+  entry->last_used = 0;
+  entry->lru_link.data = entry;
+  entry->lru_link.prev = entry->lru_link.next = NULL;
+}
+
+void
+writer_shards_init(WriterShards *self)
+{
+  for (gint i = 0; i < WRITER_SHARDS_COUNT; i++)
+    {
+      g_mutex_init(&self->shards[i].lock);
+      self->shards[i].entries = g_hash_table_new(g_str_hash, g_str_equal);
+      g_queue_init(&self->shards[i].lru);
+    }
+  self->size = 0;
+}
+
+void
+writer_shards_deinit(WriterShards *self)
+{
+  g_assert(self->size == 0);
+  for (gint i = 0; i < WRITER_SHARDS_COUNT; i++)
+    {
+      g_assert(g_hash_table_size(self->shards[i].entries) == 0);
+      g_hash_table_destroy(self->shards[i].entries);
+      g_mutex_clear(&self->shards[i].lock);
+    }
+}
+
+WriterShard *
+writer_shards_get_shard(WriterShards *self, const gchar *key)
+{
+  return &self->shards[g_str_hash(key) % WRITER_SHARDS_COUNT];
+}
+
+gint
+writer_shards_get_size(WriterShards *self)
+{
+  return g_atomic_int_get(&self->size);
+}
+
+void
+writer_shards_touch(WriterShards *self, WriterShardEntry *entry)
+{
+  WriterShard *shard = writer_shards_get_shard(self, entry->key);
+
+  /* compared across shards when looking for the least recently used entry */
+  entry->last_used = g_get_monotonic_time();
+  if (shard->lru.head == &entry->lru_link)
+    return;
+
+  g_queue_unlink(&shard->lru, &entry->lru_link);
+  g_queue_push_head_link(&shard->lru, &entry->lru_link);
+}
+
+gpointer
+writer_shards_lookup(WriterShards *self, const gchar *key)
+{
+  WriterShardEntry *entry = g_hash_table_lookup(writer_shards_get_shard(self, key)->entries, key);
+
+  if (!entry)
+    return NULL;
+
+  writer_shards_touch(self, entry);
+  return entry->writer;
+}
+
+void
+writer_shards_add(WriterShards *self, WriterShardEntry *entry)
+{
+  WriterShard *shard = writer_shards_get_shard(self, entry->key);
+
+  g_assert(!g_hash_table_contains(shard->entries, entry->key));
+
+  entry->last_used = g_get_monotonic_time();
+  g_hash_table_insert(shard->entries, (gpointer) entry->key, entry);
+  g_queue_push_head_link(&shard->lru, &entry->lru_link);
+  g_atomic_int_inc(&self->size);
+}
+
+void
+writer_shards_remove(WriterShards *self, WriterShardEntry *entry)
+{
+  WriterShard *shard = writer_shards_get_shard(self, entry->key);
+
+  if (!g_hash_table_remove(shard->entries, entry->key))
+    return;
+
+  g_queue_unlink(&shard->lru, &entry->lru_link);
+  g_atomic_int_add(&self->size, -1);
+}
+
+void
+writer_shards_lock_all(WriterShards *self)
+{
+  for (gint i = 0; i < WRITER_SHARDS_COUNT; i++)
+    g_mutex_lock(&self->shards[i].lock);
+}
+
+void
+writer_shards_unlock_all(WriterShards *self)
+{
+  for (gint i = WRITER_SHARDS_COUNT - 1; i >= 0; i--)
+    g_mutex_unlock(&self->shards[i].lock);
+}
+
+static WriterShardEntry *
+_find_least_recently_used_in_shard(WriterShard *shard, WriterShardsEvictableFunc evictable, gpointer user_data)
+{
+  for (GList *link = shard->lru.tail; link; link = link->prev)
+    {
+      WriterShardEntry *entry = (WriterShardEntry *) link->data;
+
+      if (!evictable || evictable(entry, user_data))
+        return entry;
+    }
+  return NULL;
+}
+
+WriterShardEntry *
+writer_shards_find_least_recently_used(WriterShards *self, WriterShardsEvictableFunc evictable, gpointer user_data)
+{
+  WriterShardEntry *oldest = NULL;
+
+  for (gint i = 0; i < WRITER_SHARDS_COUNT; i++)
+    {
+      WriterShardEntry *candidate = _find_least_recently_used_in_shard(&self->shards[i], evictable, user_data);
+
+      if (candidate && (!oldest || candidate->last_used < oldest->last_used))
+        oldest = candidate;
+    }
+  return oldest;
+}
+
+void
+writer_shards_foreach(WriterShards *self, GFunc func, gpointer user_data)
+{
+  for (gint i = 0; i < WRITER_SHARDS_COUNT; i++)
+    {
+      WriterShard *shard = &self->shards[i];
+
+      g_mutex_lock(&shard->lock);
+      for (GList *link = shard->lru.head; link; link = link->next)
+        func(((WriterShardEntry *) link->data)->writer, user_data);
+      g_mutex_unlock(&shard->lock);
+    }
+}
+
+void
+writer_shards_foreach_remove(WriterShards *self, GFunc func, gpointer user_data)
+{
+  GList *writers = NULL;
+
+  for (gint i = 0; i < WRITER_SHARDS_COUNT; i++)
+    {
+      WriterShard *shard = &self->shards[i];
+      GList *link;
+
+      g_mutex_lock(&shard->lock);
+      while ((link = g_queue_peek_head_link(&shard->lru)))
+        {
+          WriterShardEntry *entry = (WriterShardEntry *) link->data;
+
+          writers = g_list_prepend(writers, entry->writer);
+          writer_shards_remove(self, entry);
+        }
+      g_mutex_unlock(&shard->lock);
+    }
+
+  g_list_foreach(writers, func, user_data);
+  g_list_free(writers);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef MODULES_AFFILE_WRITER_SHARDS_H_
+#define MODULES_AFFILE_WRITER_SHARDS_H_
+
+#include <glib.h>
+
+#define WRITER_SHARDS_COUNT 16
+
+/*
+ * Embedded into the writer instance stored in WriterShards. @key must stay
+ * valid as long as the entry is part of a WriterShards instance.
+ */
+typedef struct _WriterShardEntry
+{
+  const gchar *key;
+  gpointer writer;
+  gint64 last_used;
+  GList lru_link;
+} WriterShardEntry;
+
+typedef struct _WriterShard
+{
+  GMutex lock;
+  GHashTable *entries;
+  /* WriterShardEntry instances, the most recently used one at the head */
+  GQueue lru;
+} WriterShard;
+
+/*
+ * Writers hashed into independently locked shards, so that threads using
+ * different writers do not contend on a single lock. The number of entries
+ * is tracked over all shards, so that a limit can be enforced globally.
+ */
+typedef struct _WriterShards
+{
+  WriterShard shards[WRITER_SHARDS_COUNT];
+  gint size;
+} WriterShards;
+
+typedef gboolean (*WriterShardsEvictableFunc)(WriterShardEntry *entry, gpointer user_data);
+
+void writer_shard_entry_init(WriterShardEntry *entry, const gchar *key, gpointer writer);
+
+void writer_shards_init(WriterShards *self);
+void writer_shards_deinit(WriterShards *self);
+
+WriterShard *writer_shards_get_shard(WriterShards *self, const gchar *key);
+gint writer_shards_get_size(WriterShards *self);
+
+/* the lock of the shard of @key (or @entry) must be held by the caller */
+gpointer writer_shards_lookup(WriterShards *self, const gchar *key);
+void writer_shards_touch(WriterShards *self, WriterShardEntry *entry);
+void writer_shards_add(WriterShards *self, WriterShardEntry *entry);
+void writer_shards_remove(WriterShards *self, WriterShardEntry *entry);
+
+/* locks all shards, always in the same order */
+void writer_shards_lock_all(WriterShards *self);
+void writer_shards_unlock_all(WriterShards *self);
+
+/* all shards must be locked by the caller */
+WriterShardEntry *writer_shards_find_least_recently_used(WriterShards *self, WriterShardsEvictableFunc evictable,
+                                                         gpointer user_data);
+
+/* calls @func with each writer, locking the shards one by one */
+void writer_shards_foreach(WriterShards *self, GFunc func, gpointer user_data);
+/* removes all entries, calling @func with each writer outside of the shard locks */
+void writer_shards_foreach_remove(WriterShards *self, GFunc func, gpointer user_data);
+
+#endif
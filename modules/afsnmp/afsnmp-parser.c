@@ -48,6 +48,7 @@ static CfgLexerKeyword afsnmp_keywords[] =
   { "snmptrapd_parser",  KW_SNMPTRAPD_PARSER },
   { "prefix",            KW_PREFIX },
   { "set_message_macro", KW_SET_MESSAGE_MACRO },
+  { "oid_map",           KW_OID_MAP },
   { NULL }
 };
 
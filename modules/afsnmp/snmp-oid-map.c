@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "snmp-oid-map.h"
+#include "messages.h"
+#include "atomic.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+/*
+ * Maps numeric OID prefixes to names, e.g. .1.3.6.1.2.1.2.2.1.8 to
+ * IF-MIB::ifOperStatus.  The map is loaded from a CSV file generated from
+ * MIBs (one "oid,name" pair per line) and stored as a trie of OID
+ * components, so a lookup is a single pass over the OID of a varbind,
+ * returning the longest known prefix and the remaining instance
+ * identifier.
+ */
+
+typedef struct _SnmpOidMapNode SnmpOidMapNode;
+struct _SnmpOidMapNode
+{
+  GHashTable *children;
+  SnmpOidMapEntry *entry;
+};
+
+struct _SnmpOidMap
+{
+  GAtomicCounter ref_cnt;
+  SnmpOidMapNode root;
+  guint size;
+};
+
+static void
+_node_destroy(SnmpOidMapNode *self)
+{
+  if (self->children)
+    g_hash_table_destroy(self->children);
+
+  if (self->entry)
+    {
+      g_free(self->entry->name);
+      g_free(self->entry);
+    }
+}
+
+static void
+_node_free(SnmpOidMapNode *self)
+{
+  _node_destroy(self);
+  g_free(self);
+}
+
+static SnmpOidMapNode *
+_node_lookup_child(SnmpOidMapNode *self, guint32 component)
+{
+  if (!self->children)
+    return NULL;
+
+  return g_hash_table_lookup(self->children, GUINT_TO_POINTER(component));
+}
+
+static SnmpOidMapNode *
+_node_lookup_or_insert_child(SnmpOidMapNode *self, guint32 component)
+{
+  SnmpOidMapNode *child = _node_lookup_child(self, component);
+
+  if (child)
+    return child;
+
+  if (!self->children)
+    self->children = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) _node_free);
+
+  child = g_new0(SnmpOidMapNode, 1);
+  g_hash_table_insert(self->children, GUINT_TO_POINTER(component), child);
+  return child;
+}
+
+/* snmptrapd prints OIDs either as ".1.3.6.1..." or as "iso.3.6.1...",
+ * depending on its output options. */
+static const gchar *
+_skip_oid_root(const gchar *oid, guint32 *first_component, gboolean *has_first_component)
+{
+  *has_first_component = FALSE;
+
+  if (oid[0] == '.')
+    return oid + 1;
+
+  if (strncmp(oid, "iso", 3) == 0 && (oid[3] == '.' || oid[3] == '\0'))
+    {
+      *first_component = 1;
+      *has_first_component = TRUE;
+      return oid[3] == '.' ? oid + 4 : oid + 3;
+    }
+
+  return oid;
+}
+
+/* parses a single numeric component, returns a pointer right after it
+ * (either at a '.' or at the terminating NUL) or NULL if the component is
+ * not numeric */
+static const gchar *
+_parse_component(const gchar *oid, guint32 *component)
+{
+  guint64 value = 0;
+  const gchar *cur = oid;
+
+  while (*cur >= '0' && *cur <= '9')
+    {
+      value = value * 10 + (*cur - '0');
+      if (value > G_MAXUINT32)
+        return NULL;
+      cur++;
+    }
+
+  if (cur == oid || (*cur != '.' && *cur != '\0'))
+    return NULL;
+
+  *component = (guint32) value;
+  return cur;
+}
+
+gboolean
+snmp_oid_map_add(SnmpOidMap *self, const gchar *oid, const gchar *name)
+{
+  SnmpOidMapNode *node = &self->root;
+  guint32 component;
+  gboolean has_first_component;
+
+  const gchar *cur = _skip_oid_root(oid, &component, &has_first_component);
+  if (has_first_component)
+    node = _node_lookup_or_insert_child(node, component);
+
+  while (*cur)
+    {
+      cur = _parse_component(cur, &component);
+      if (!cur)
+        return FALSE;
+
+      node = _node_lookup_or_insert_child(node, component);
+      if (*cur == '.')
+        cur++;
+    }
+
+  if (node == &self->root || name[0] == '\0')
+    return FALSE;
+
+  if (!node->entry)
+    {
+      node->entry = g_new0(SnmpOidMapEntry, 1);
+      self->size++;
+    }
+
+  g_free(node->entry->name);
+  node->entry->name = g_strdup(name);
+  return TRUE;
+}
+
+/* Returns the entry of the longest known prefix of @oid, @instance is set
+ * to the rest of the OID, without the separating dot. */
+SnmpOidMapEntry *
+snmp_oid_map_lookup(SnmpOidMap *self, const gchar *oid, const gchar **instance)
+{
+  SnmpOidMapNode *node = &self->root;
+  SnmpOidMapEntry *best_match = NULL;
+  const gchar *best_match_end = NULL;
+  guint32 component;
+  gboolean has_first_component;
+
+  const gchar *cur = _skip_oid_root(oid, &component, &has_first_component);
+  if (has_first_component)
+    node = _node_lookup_child(node, component);
+
+  while (node && *cur)
+    {
+      cur = _parse_component(cur, &component);
+      if (!cur)
+        break;
+
+      node = _node_lookup_child(node, component);
+      if (node && node->entry)
+        {
+          best_match = node->entry;
+          best_match_end = cur;
+        }
+
+      if (*cur == '.')
+        cur++;
+    }
+
+  if (!best_match)
+    return NULL;
+
+  *instance = (*best_match_end == '.') ? best_match_end + 1 : best_match_end;
+  return best_match;
+}
+
+static gchar *
+_strip_field(gchar *field)
+{
+  g_strstrip(field);
+
+  gsize len = strlen(field);
+  if (len >= 2 && field[0] == '"' && field[len - 1] == '"')
+    {
+      field[len - 1] = '\0';
+      field++;
+    }
+  return field;
+}
+
+static gboolean
+_load_line(SnmpOidMap *self, const gchar *line, gsize line_len, const gchar *filename, gint lineno)
+{
+  gchar *buf = g_strndup(line, line_len);
+  gboolean result = TRUE;
+  gchar *oid = _strip_field(buf);
+
+  if (oid[0] == '\0' || oid[0] == '#')
+    goto exit;
+
+  gchar *comma = strchr(oid, ',');
+  if (!comma)
+    {
+      msg_error("snmptrapd-parser: missing name in OID map",
+                evt_tag_str("filename", filename),
+                evt_tag_int("line", lineno));
+      result = FALSE;
+      goto exit;
+    }
+
+  *comma = '\0';
+  oid = _strip_field(oid);
+  const gchar *name = _strip_field(comma + 1);
+
+  if (!snmp_oid_map_add(self, oid, name))
+    {
+      msg_error("snmptrapd-parser: invalid entry in OID map, expecting a numeric OID and a name",
+                evt_tag_str("filename", filename),
+                evt_tag_int("line", lineno),
+                evt_tag_str("oid", oid),
+                evt_tag_str("name", name));
+      result = FALSE;
+    }
+
+exit:
+  g_free(buf);
+  return result;
+}
+
+gboolean
+snmp_oid_map_load(SnmpOidMap *self, const gchar *filename)
+{
+  GError *error = NULL;
+  GMappedFile *file = g_mapped_file_new(filename, FALSE, &error);
+
+  if (!file)
+    {
+      msg_error("snmptrapd-parser: error opening OID map",
+                evt_tag_str("filename", filename),
+                evt_tag_str("error", error->message));
+      g_clear_error(&error);
+      return FALSE;
+    }
+
+  const gchar *contents = g_mapped_file_get_contents(file);
+  const gchar *end = contents + g_mapped_file_get_length(file);
+  gboolean result = TRUE;
+  gint lineno = 0;
+
+  for (const gchar *line = contents; line && line < end && result;)
+    {
+      const gchar *eol = memchr(line, '\n', end - line);
+      const gchar *line_end = eol ? eol : end;
+
+      lineno++;
+      result = _load_line(self, line, line_end - line, filename, lineno);
+      line = eol ? eol + 1 : NULL;
+    }
+
+  g_mapped_file_unref(file);
+
+  if (result)
+    msg_debug("snmptrapd-parser: OID map loaded",
+              evt_tag_str("filename", filename),
+              evt_tag_int("entries", self->size));
+  return result;
+}
+
+guint
+snmp_oid_map_get_size(SnmpOidMap *self)
+{
+  return self->size;
+}
+
+SnmpOidMap *
+snmp_oid_map_new(void)
+{
+  SnmpOidMap *self = g_new0(SnmpOidMap, 1);
+
+  g_atomic_counter_set(&self->ref_cnt, 1);
+  return self;
+}
+
+SnmpOidMap *
+snmp_oid_map_ref(SnmpOidMap *self)
+{
+  g_assert(!self || g_atomic_counter_get(&self->ref_cnt) > 0);
+
+  if (self)
+    g_atomic_counter_inc(&self->ref_cnt);
+
+  return self;
+}
+
+void
+snmp_oid_map_unref(SnmpOidMap *self)
+{
+  g_assert(!self || g_atomic_counter_get(&self->ref_cnt));
+
+  if (self && (g_atomic_counter_dec_and_test(&self->ref_cnt)))
+    {
+      _node_destroy(&self->root);
+      g_free(self);
+    }
+}
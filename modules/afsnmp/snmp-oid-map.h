@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef SNMP_OID_MAP_H_INCLUDED
+#define SNMP_OID_MAP_H_INCLUDED
+
+#include "syslog-ng.h"
+#include "logmsg/nvtable.h"
+
+typedef struct _SnmpOidMapEntry
+{
+  gchar *name;
+
+  /* resolved lazily by the user of the map, only for the entries that
+   * actually matched, see snmptrapd-parser.c */
+  NVHandle value_handle;
+  NVHandle instance_handle;
+} SnmpOidMapEntry;
+
+typedef struct _SnmpOidMap SnmpOidMap;
+
+gboolean snmp_oid_map_add(SnmpOidMap *self, const gchar *oid, const gchar *name);
+gboolean snmp_oid_map_load(SnmpOidMap *self, const gchar *filename);
+SnmpOidMapEntry *snmp_oid_map_lookup(SnmpOidMap *self, const gchar *oid, const gchar **instance);
+guint snmp_oid_map_get_size(SnmpOidMap *self);
+
+SnmpOidMap *snmp_oid_map_new(void);
+SnmpOidMap *snmp_oid_map_ref(SnmpOidMap *self);
+void snmp_oid_map_unref(SnmpOidMap *self);
+
+#endif
@@ -23,6 +23,7 @@
 #include "snmptrapd-header-parser.h"
 #include "snmptrapd-nv-context.h"
 #include "varbindlist-scanner.h"
+#include "snmp-oid-map.h"
 #include "scratch-buffers.h"
 #include "utf8utils.h"
 #include "str-utils.h"
@@ -32,8 +33,25 @@ typedef struct _SnmpTrapdParser
   LogParser super;
   GString *prefix;
   gboolean set_message_macro;
+  gchar *oid_map_filename;
+  SnmpOidMap *oid_map;
+
+  /* handles of the name-value pairs extracted from the header, resolved
+   * in init() to avoid looking them up in the registry for each trap */
+  GHashTable *header_handles;
 } SnmpTrapdParser;
 
+typedef struct _SnmpTrapdParserNVContext
+{
+  SnmpTrapdNVContext super;
+  SnmpTrapdParser *parser;
+} SnmpTrapdParserNVContext;
+
+static const gchar *header_keys[] =
+{
+  "hostname", "transport_info", "enterprise_oid", "type", "subtype", "uptime", NULL
+};
+
 void
 snmptrapd_parser_set_prefix(LogParser *s, const gchar *prefix)
 {
@@ -53,6 +71,15 @@ snmptrapd_parser_set_set_message_macro(LogParser *s, gboolean set_message_macro)
   self->set_message_macro = set_message_macro;
 }
 
+void
+snmptrapd_parser_set_oid_map(LogParser *s, const gchar *filename)
+{
+  SnmpTrapdParser *self = (SnmpTrapdParser *) s;
+
+  g_free(self->oid_map_filename);
+  self->oid_map_filename = g_strdup(filename);
+}
+
 static inline gboolean
 _is_unwanted_key_char(gchar c)
 {
@@ -131,15 +158,26 @@ _append_name_value_to_generated_message(GString *generated_message, const gchar
   scratch_buffers_reclaim_marked(marker);
 }
 
+static NVHandle
+_get_handle(SnmpTrapdParser *self, const gchar *key, GString *formatted_key)
+{
+  gpointer handle = g_hash_table_lookup(self->header_handles, key);
+
+  if (handle)
+    return GPOINTER_TO_UINT(handle);
+
+  return log_msg_get_value_handle(_get_formatted_key(key, self->prefix, formatted_key));
+}
+
 static void
 _add_name_value(SnmpTrapdNVContext *nv_context, const gchar *key,
                 const gchar *value, gsize value_length)
 {
+  SnmpTrapdParser *self = ((SnmpTrapdParserNVContext *) nv_context)->parser;
   ScratchBuffersMarker marker;
   GString *formatted_key = scratch_buffers_alloc_and_mark(&marker);
 
-  const gchar *prefixed_key = _get_formatted_key(key, nv_context->key_prefix, formatted_key);
-  log_msg_set_value_by_name(nv_context->msg, prefixed_key, value, value_length);
+  log_msg_set_value(nv_context->msg, _get_handle(self, key, formatted_key), value, value_length);
 
   if (nv_context->generated_message)
     _append_name_value_to_generated_message(nv_context->generated_message, key, value, value_length);
@@ -147,11 +185,67 @@ _add_name_value(SnmpTrapdNVContext *nv_context, const gchar *key,
   scratch_buffers_reclaim_marked(marker);
 }
 
+/* Handles of the OID map entries are allocated on their first match, so
+ * the number of handles is bounded by the number of distinct names that
+ * actually occur, instead of growing with each new instance identifier. */
+static void
+_resolve_oid_map_entry_handles(SnmpTrapdParser *self, SnmpOidMapEntry *entry)
+{
+  if (g_atomic_int_get(&entry->value_handle))
+    return;
+
+  ScratchBuffersMarker marker;
+  GString *formatted_key = scratch_buffers_alloc_and_mark(&marker);
+
+  _get_formatted_key(entry->name, self->prefix, formatted_key);
+  g_string_append(formatted_key, "._instance");
+  g_atomic_int_set(&entry->instance_handle, log_msg_get_value_handle(formatted_key->str));
+
+  _get_formatted_key(entry->name, self->prefix, formatted_key);
+  g_atomic_int_set(&entry->value_handle, log_msg_get_value_handle(formatted_key->str));
+
+  scratch_buffers_reclaim_marked(marker);
+}
+
 static gboolean
-_parse_varbindlist(SnmpTrapdNVContext *nv_context, const gchar **input, gsize *input_len)
+_add_mapped_varbind(SnmpTrapdParser *self, SnmpTrapdNVContext *nv_context, const gchar *oid,
+                    const gchar *value, gsize value_length)
+{
+  const gchar *instance;
+  SnmpOidMapEntry *entry = snmp_oid_map_lookup(self->oid_map, oid, &instance);
+
+  if (!entry)
+    return FALSE;
+
+  _resolve_oid_map_entry_handles(self, entry);
+  log_msg_set_value(nv_context->msg, g_atomic_int_get(&entry->value_handle), value, value_length);
+  if (instance[0])
+    log_msg_set_value(nv_context->msg, g_atomic_int_get(&entry->instance_handle), instance, -1);
+
+  if (nv_context->generated_message)
+    {
+      ScratchBuffersMarker marker;
+      GString *name = scratch_buffers_alloc_and_mark(&marker);
+
+      g_string_assign(name, entry->name);
+      if (instance[0])
+        {
+          g_string_append_c(name, '.');
+          g_string_append(name, instance);
+        }
+      _append_name_value_to_generated_message(nv_context->generated_message, name->str, value, value_length);
+      scratch_buffers_reclaim_marked(marker);
+    }
+
+  return TRUE;
+}
+
+static gboolean
+_parse_varbindlist(SnmpTrapdParser *self, SnmpTrapdNVContext *nv_context, const gchar **input, gsize *input_len)
 {
   VarBindListScanner varbindlist_scanner;
   const gchar *key, *value;
+  gsize value_length;
 
   varbindlist_scanner_init(&varbindlist_scanner);
 
@@ -160,8 +254,12 @@ _parse_varbindlist(SnmpTrapdNVContext *nv_context, const gchar **input, gsize *i
     {
       key = varbindlist_scanner_get_current_key(&varbindlist_scanner);
       value = varbindlist_scanner_get_current_value(&varbindlist_scanner);
+      value_length = varbindlist_scanner_get_current_value_len(&varbindlist_scanner);
 
-      snmptrapd_nv_context_add_name_value(nv_context, key, value, -1);
+      if (self->oid_map && _add_mapped_varbind(self, nv_context, key, value, value_length))
+        continue;
+
+      snmptrapd_nv_context_add_name_value(nv_context, key, value, value_length);
     }
 
   varbindlist_scanner_deinit(&varbindlist_scanner);
@@ -188,17 +286,22 @@ snmptrapd_parser_process(LogParser *s, LogMessage **pmsg, const LogPathOptions *
     generated_message = scratch_buffers_alloc_and_mark(&marker);
 
 
-  SnmpTrapdNVContext nv_context =
+  SnmpTrapdParserNVContext parser_nv_context =
   {
-    .key_prefix = self->prefix,
-    .msg = *pmsg,
-    .generated_message = generated_message,
-    .add_name_value = _add_name_value
+    .super =
+    {
+      .key_prefix = self->prefix,
+      .msg = *pmsg,
+      .generated_message = generated_message,
+      .add_name_value = _add_name_value
+    },
+    .parser = self,
   };
+  SnmpTrapdNVContext *nv_context = &parser_nv_context.super;
 
-  log_msg_set_value(nv_context.msg, LM_V_PROGRAM, "snmptrapd", -1);
+  log_msg_set_value(nv_context->msg, LM_V_PROGRAM, "snmptrapd", -1);
 
-  if (!snmptrapd_header_parser_parse(&nv_context, &input, &input_len))
+  if (!snmptrapd_header_parser_parse(nv_context, &input, &input_len))
     {
       msg_debug("snmptrapd-parser failed",
                 evt_tag_str ("error", "cannot parse snmptrapd header"),
@@ -206,7 +309,7 @@ snmptrapd_parser_process(LogParser *s, LogMessage **pmsg, const LogPathOptions *
       return FALSE;
     };
 
-  if (!_parse_varbindlist(&nv_context, &input, &input_len))
+  if (!_parse_varbindlist(self, nv_context, &input, &input_len))
     {
       msg_debug("snmptrapd-parser failed",
                 evt_tag_str ("error", "can not parse name-value pairs in the input"),
@@ -217,12 +320,12 @@ snmptrapd_parser_process(LogParser *s, LogMessage **pmsg, const LogPathOptions *
 
   if (self->set_message_macro)
     {
-      log_msg_set_value(nv_context.msg, LM_V_MESSAGE, nv_context.generated_message->str, -1);
+      log_msg_set_value(nv_context->msg, LM_V_MESSAGE, nv_context->generated_message->str, -1);
       scratch_buffers_reclaim_marked(marker);
     }
   else
     {
-      log_msg_unset_value(nv_context.msg, LM_V_MESSAGE);
+      log_msg_unset_value(nv_context->msg, LM_V_MESSAGE);
     }
 
   return TRUE;
@@ -237,18 +340,59 @@ snmptrapd_parser_clone(LogPipe *s)
 
   snmptrapd_parser_set_prefix(&cloned->super, self->prefix->str);
   snmptrapd_parser_set_set_message_macro(&cloned->super, self->set_message_macro);
+  snmptrapd_parser_set_oid_map(&cloned->super, self->oid_map_filename);
+  cloned->oid_map = snmp_oid_map_ref(self->oid_map);
 
   log_parser_clone_settings(&self->super, &cloned->super);
 
   return &cloned->super.super;
 }
 
+static void
+_init_header_handles(SnmpTrapdParser *self)
+{
+  GString *formatted_key = g_string_new(NULL);
+
+  g_hash_table_remove_all(self->header_handles);
+  for (gint i = 0; header_keys[i]; i++)
+    {
+      NVHandle handle = log_msg_get_value_handle(_get_formatted_key(header_keys[i], self->prefix, formatted_key));
+      g_hash_table_insert(self->header_handles, (gpointer) header_keys[i], GUINT_TO_POINTER(handle));
+    }
+
+  g_string_free(formatted_key, TRUE);
+}
+
+static gboolean
+snmptrapd_parser_init(LogPipe *s)
+{
+  SnmpTrapdParser *self = (SnmpTrapdParser *) s;
+
+  _init_header_handles(self);
+
+  if (self->oid_map_filename && !self->oid_map)
+    {
+      self->oid_map = snmp_oid_map_new();
+      if (!snmp_oid_map_load(self->oid_map, self->oid_map_filename))
+        {
+          snmp_oid_map_unref(self->oid_map);
+          self->oid_map = NULL;
+          return FALSE;
+        }
+    }
+
+  return log_parser_init_method(s);
+}
+
 static void
 snmptrapd_parser_free(LogPipe *s)
 {
   SnmpTrapdParser *self = (SnmpTrapdParser *) s;
 
   g_string_free(self->prefix, TRUE);
+  g_free(self->oid_map_filename);
+  snmp_oid_map_unref(self->oid_map);
+  g_hash_table_destroy(self->header_handles);
 
   log_parser_free_method(s);
 }
@@ -259,12 +403,14 @@ snmptrapd_parser_new(GlobalConfig *cfg)
   SnmpTrapdParser *self = g_new0(SnmpTrapdParser, 1);
 
   log_parser_init_instance(&self->super, cfg);
+  self->super.super.init = snmptrapd_parser_init;
   self->super.super.free_fn = snmptrapd_parser_free;
   self->super.super.clone = snmptrapd_parser_clone;
   self->super.process = snmptrapd_parser_process;
 
   self->prefix = g_string_new(".snmp.");
   self->set_message_macro = TRUE;
+  self->header_handles = g_hash_table_new(g_str_hash, g_str_equal);
 
   return &self->super;
 }
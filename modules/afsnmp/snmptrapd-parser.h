@@ -27,5 +27,6 @@
 LogParser *snmptrapd_parser_new(GlobalConfig *cfg);
 void snmptrapd_parser_set_prefix(LogParser *s, const gchar *prefix);
 void snmptrapd_parser_set_set_message_macro(LogParser *s, gboolean set_message_macro);
+void snmptrapd_parser_set_oid_map(LogParser *s, const gchar *filename);
 
 #endif
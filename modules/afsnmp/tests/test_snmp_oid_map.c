@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "snmp-oid-map.h"
+#include "apphook.h"
+
+#include <glib/gstdio.h>
+#include <unistd.h>
+
+static void
+assert_lookup(SnmpOidMap *map, const gchar *oid, const gchar *expected_name, const gchar *expected_instance)
+{
+  const gchar *instance = NULL;
+  SnmpOidMapEntry *entry = snmp_oid_map_lookup(map, oid, &instance);
+
+  if (!expected_name)
+    {
+      cr_assert_null(entry, "unexpected match for OID: %s", oid);
+      return;
+    }
+
+  cr_assert_not_null(entry, "no match for OID: %s", oid);
+  cr_assert_str_eq(entry->name, expected_name);
+  cr_assert_str_eq(instance, expected_instance);
+}
+
+Test(snmp_oid_map, test_lookup_prefixes)
+{
+  SnmpOidMap *map = snmp_oid_map_new();
+
+  cr_assert(snmp_oid_map_add(map, ".1.3.6.1.2.1.1.3", "sysUpTime"));
+  cr_assert(snmp_oid_map_add(map, "1.3.6.1.2.1.2.2.1", "ifEntry"));
+  cr_assert(snmp_oid_map_add(map, "iso.3.6.1.2.1.2.2.1.2", "ifDescr"));
+  cr_assert_eq(snmp_oid_map_get_size(map), 3);
+
+  assert_lookup(map, ".1.3.6.1.2.1.1.3.0", "sysUpTime", "0");
+  assert_lookup(map, "iso.3.6.1.2.1.1.3", "sysUpTime", "");
+  assert_lookup(map, ".1.3.6.1.2.1.2.2.1.7.3", "ifEntry", "7.3");
+  assert_lookup(map, ".1.3.6.1.2.1.2.2.1.2.3", "ifDescr", "3");
+  assert_lookup(map, ".1.3.6.1.2.1.1.4.0", NULL, NULL);
+  assert_lookup(map, ".1.3.6.1.2.1", NULL, NULL);
+  assert_lookup(map, "SNMPv2-MIB::sysUpTime.0", NULL, NULL);
+
+  snmp_oid_map_unref(map);
+}
+
+Test(snmp_oid_map, test_invalid_entries_are_rejected)
+{
+  SnmpOidMap *map = snmp_oid_map_new();
+
+  cr_assert_not(snmp_oid_map_add(map, "SNMPv2-MIB::sysUpTime", "sysUpTime"));
+  cr_assert_not(snmp_oid_map_add(map, ".1.3.a.1", "foo"));
+  cr_assert_not(snmp_oid_map_add(map, ".1.3.6", ""));
+  cr_assert_not(snmp_oid_map_add(map, "", "foo"));
+  cr_assert_eq(snmp_oid_map_get_size(map), 0);
+
+  snmp_oid_map_unref(map);
+}
+
+Test(snmp_oid_map, test_add_overrides_existing_name)
+{
+  SnmpOidMap *map = snmp_oid_map_new();
+
+  cr_assert(snmp_oid_map_add(map, ".1.3.6.1.6.3.1.1.4.1", "snmpTrap"));
+  cr_assert(snmp_oid_map_add(map, ".1.3.6.1.6.3.1.1.4.1", "snmpTrapOID"));
+  cr_assert_eq(snmp_oid_map_get_size(map), 1);
+
+  assert_lookup(map, ".1.3.6.1.6.3.1.1.4.1.0", "snmpTrapOID", "0");
+
+  snmp_oid_map_unref(map);
+}
+
+static gchar *
+_write_map_file(const gchar *contents)
+{
+  gchar *filename = NULL;
+  gint fd = g_file_open_tmp("test_snmp_oid_map_XXXXXX.csv", &filename, NULL);
+
+  cr_assert(fd >= 0);
+  close(fd);
+  cr_assert(g_file_set_contents(filename, contents, -1, NULL));
+  return filename;
+}
+
+Test(snmp_oid_map, test_load_from_file)
+{
+  gchar *filename = _write_map_file("# oid,name\n"
+                                    ".1.3.6.1.2.1.1.3,sysUpTime\n"
+                                    "\n"
+                                    " \".1.3.6.1.6.3.1.1.4.1\" , \"snmpTrapOID\" \n"
+                                    "1.3.6.1.2.1.2.2.1.2,ifDescr");
+  SnmpOidMap *map = snmp_oid_map_new();
+
+  cr_assert(snmp_oid_map_load(map, filename));
+  cr_assert_eq(snmp_oid_map_get_size(map), 3);
+  assert_lookup(map, ".1.3.6.1.2.1.1.3.0", "sysUpTime", "0");
+  assert_lookup(map, ".1.3.6.1.6.3.1.1.4.1.0", "snmpTrapOID", "0");
+  assert_lookup(map, ".1.3.6.1.2.1.2.2.1.2.1", "ifDescr", "1");
+
+  snmp_oid_map_unref(map);
+  g_unlink(filename);
+  g_free(filename);
+}
+
+Test(snmp_oid_map, test_load_fails_on_invalid_lines)
+{
+  gchar *filename = _write_map_file(".1.3.6.1.2.1.1.3,sysUpTime\n"
+                                    ".1.3.6.1.2.1.1.4\n");
+  SnmpOidMap *map = snmp_oid_map_new();
+
+  cr_assert_not(snmp_oid_map_load(map, filename));
+  cr_assert_not(snmp_oid_map_load(map, "/nonexistent/oid-map.csv"));
+
+  snmp_oid_map_unref(map);
+  g_unlink(filename);
+  g_free(filename);
+}
+
+static void
+setup(void)
+{
+  app_startup();
+}
+
+static void
+teardown(void)
+{
+  app_shutdown();
+}
+
+TestSuite(snmp_oid_map, .init = setup, .fini = teardown);
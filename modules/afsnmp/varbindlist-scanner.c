@@ -22,6 +22,7 @@
 
 #include "varbindlist-scanner.h"
 #include "str-utils.h"
+#include "scratch-buffers.h"
 
 static inline gboolean
 _is_valid_key_character(gchar c)
@@ -77,13 +78,12 @@ varbindlist_scanner_init(VarBindListScanner *self)
   kv_scanner_set_valid_key_character_func(&self->super, _is_valid_key_character);
   kv_scanner_set_stop_character(&self->super, '\n');
 
-  self->varbind_type = g_string_sized_new(16);
+  self->varbind_type = scratch_buffers_alloc();
 }
 
 void
 varbindlist_scanner_deinit(VarBindListScanner *self)
 {
-  g_string_free(self->varbind_type, TRUE);
   kv_scanner_deinit(&self->super);
 }
 
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+
+#include "afinet-dest-sharding.h"
+#include "template/eval.h"
+#include "messages.h"
+
+#include <string.h>
+
+#define DEFAULT_SHARD_KEY "${HOST}"
+
+struct _AFInetDestDriverSharding
+{
+  GList *servers;
+  LogTemplate *shard_key;
+  GArray *shards;
+};
+
+static void
+_clear_shard(AFInetDestShard *shard)
+{
+  g_free(shard->hostname);
+}
+
+void
+afinet_dd_sharding_add_servers(AFInetDestDriverSharding *self, GList *servers)
+{
+  self->servers = g_list_concat(self->servers, servers);
+}
+
+void
+afinet_dd_sharding_set_shard_key_ref(AFInetDestDriverSharding *self, LogTemplate *shard_key)
+{
+  log_template_unref(self->shard_key);
+  self->shard_key = shard_key;
+}
+
+gint
+afinet_dd_sharding_get_num_shards(AFInetDestDriverSharding *self)
+{
+  return self->shards->len;
+}
+
+AFInetDestShard *
+afinet_dd_sharding_get_shard(AFInetDestDriverSharding *self, gint index)
+{
+  return &g_array_index(self->shards, AFInetDestShard, index);
+}
+
+static gboolean
+_is_shard_available(AFInetDestShard *shard)
+{
+  return shard->driver && shard->driver->writer && log_writer_opened(shard->driver->writer);
+}
+
+/*
+ * Shards that are not connected are skipped, so the share of a failed
+ * server is spread over the others until it comes back.  If none of them
+ * is connected, the message is queued to the shard that owns the key.
+ */
+AFInetDestShard *
+afinet_dd_sharding_choose(AFInetDestDriverSharding *self, LogMessage *msg, LogTemplateOptions *template_options)
+{
+  LogTemplateEvalOptions options = {template_options, LTZ_SEND, 0, NULL, LM_VT_STRING};
+  guint32 key_hash = log_template_hash(self->shard_key, msg, &options);
+  AFInetDestShard *best = NULL, *best_available = NULL;
+  guint64 best_score = 0, best_available_score = 0;
+
+  for (guint i = 0; i < self->shards->len; i++)
+    {
+      AFInetDestShard *shard = &g_array_index(self->shards, AFInetDestShard, i);
+      guint64 score = afinet_dd_shard_score(key_hash, shard->seed);
+
+      if (!best || score > best_score)
+        {
+          best = shard;
+          best_score = score;
+        }
+
+      if (_is_shard_available(shard) && (!best_available || score > best_available_score))
+        {
+          best_available = shard;
+          best_available_score = score;
+        }
+    }
+
+  return best_available ? best_available : best;
+}
+
+gboolean
+afinet_dd_sharding_init(AFInetDestDriverSharding *self, GlobalConfig *cfg)
+{
+  if (!self->shard_key)
+    {
+      self->shard_key = log_template_new(cfg, NULL);
+      log_template_compile(self->shard_key, DEFAULT_SHARD_KEY, NULL);
+    }
+
+  if (self->shards->len > 0)
+    return TRUE;
+
+  for (GList *l = self->servers; l; l = l->next)
+    {
+      const gchar *hostname = (const gchar *) l->data;
+
+      for (guint i = 0; i < self->shards->len; i++)
+        {
+          if (strcmp(afinet_dd_sharding_get_shard(self, i)->hostname, hostname) == 0)
+            {
+              msg_error("Error initializing sharding, the same server is listed multiple times",
+                        evt_tag_str("server", hostname));
+              g_array_set_size(self->shards, 0);
+              return FALSE;
+            }
+        }
+
+      AFInetDestShard shard =
+      {
+        .hostname = g_strdup(hostname),
+        .seed = g_str_hash(hostname),
+      };
+      g_array_append_val(self->shards, shard);
+    }
+
+  return TRUE;
+}
+
+AFInetDestDriverSharding *
+afinet_dd_sharding_new(const gchar *primary)
+{
+  AFInetDestDriverSharding *self = g_new0(AFInetDestDriverSharding, 1);
+
+  self->servers = g_list_append(NULL, g_strdup(primary));
+  self->shards = g_array_new(FALSE, TRUE, sizeof(AFInetDestShard));
+  g_array_set_clear_func(self->shards, (GDestroyNotify) _clear_shard);
+
+  return self;
+}
+
+void
+afinet_dd_sharding_free(AFInetDestDriverSharding *self)
+{
+  if (!self)
+    return;
+
+  g_list_free_full(self->servers, g_free);
+  log_template_unref(self->shard_key);
+  g_array_free(self->shards, TRUE);
+  g_free(self);
+}
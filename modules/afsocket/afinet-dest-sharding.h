@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+
+#ifndef AFINET_DEST_SHARDING_H_INCLUDED
+#define AFINET_DEST_SHARDING_H_INCLUDED
+
+#include "syslog-ng.h"
+#include "afsocket-dest.h"
+#include "template/templates.h"
+
+typedef struct _AFInetDestDriverSharding AFInetDestDriverSharding;
+
+typedef struct _AFInetDestShard
+{
+  gchar *hostname;
+  guint32 seed;
+  /* not referenced, the shards are owned by the sharded driver */
+  AFSocketDestDriver *driver;
+} AFInetDestShard;
+
+AFInetDestDriverSharding *afinet_dd_sharding_new(const gchar *primary);
+void afinet_dd_sharding_free(AFInetDestDriverSharding *self);
+
+void afinet_dd_sharding_add_servers(AFInetDestDriverSharding *self, GList *servers);
+void afinet_dd_sharding_set_shard_key_ref(AFInetDestDriverSharding *self, LogTemplate *shard_key);
+
+gboolean afinet_dd_sharding_init(AFInetDestDriverSharding *self, GlobalConfig *cfg);
+
+gint afinet_dd_sharding_get_num_shards(AFInetDestDriverSharding *self);
+AFInetDestShard *afinet_dd_sharding_get_shard(AFInetDestDriverSharding *self, gint index);
+AFInetDestShard *afinet_dd_sharding_choose(AFInetDestDriverSharding *self, LogMessage *msg,
+                                           LogTemplateOptions *template_options);
+
+/*
+ * Rendezvous (highest random weight) hashing: every shard scores the key
+ * and the highest score wins.  When a shard goes away, only the keys it
+ * has won move, and they spread evenly over the remaining shards.
+ */
+static inline guint64
+afinet_dd_shard_score(guint32 key_hash, guint32 shard_seed)
+{
+  guint64 x = ((guint64) key_hash << 32) | shard_seed;
+
+  /* splitmix64 finalizer */
+  x ^= x >> 30;
+  x *= G_GUINT64_CONSTANT(0xbf58476d1ce4e5b9);
+  x ^= x >> 27;
+  x *= G_GUINT64_CONSTANT(0x94d049bb133111eb);
+  x ^= x >> 31;
+  return x;
+}
+
+#endif
@@ -207,6 +207,21 @@ _is_failover_used(const AFInetDestDriver *self)
   return self->failover != NULL;
 }
 
+static gboolean
+_is_sharding_used(const AFInetDestDriver *self)
+{
+  return self->sharding != NULL;
+}
+
+static SignalSlotConnector *
+_get_signal_slot_connector(const AFInetDestDriver *self)
+{
+  if (self->shard_owner)
+    return self->shard_owner->super.super.super.signal_slot_connector;
+
+  return self->super.super.super.signal_slot_connector;
+}
+
 static const gchar *
 _afinet_dd_get_hostname(const AFInetDestDriver *self)
 {
@@ -230,7 +245,7 @@ afinet_dd_setup_tls_verifier(AFInetDestDriver *self)
 
   AFInetDestDriverTLSVerifyData *verify_data;
   verify_data = afinet_dd_tls_verify_data_new(transport_mapper_inet->tls_context, _afinet_dd_get_hostname(self),
-                                              self->super.super.super.signal_slot_connector);
+                                              _get_signal_slot_connector(self));
   TLSVerifier *verifier = tls_verifier_new(afinet_dd_verify_callback, verify_data, afinet_dd_tls_verify_data_free);
 
   transport_mapper_inet_set_tls_verifier(transport_mapper_inet, verifier);
@@ -292,6 +307,31 @@ afinet_dd_set_failback_successful_probes_required(LogDriver *s, gint successful_
   afinet_dd_failover_set_successful_probes_required(self->failover, successful_probes_required);
 }
 
+void
+afinet_dd_enable_sharding(LogDriver *s)
+{
+  AFInetDestDriver *self = (AFInetDestDriver *) s;
+  if (self->sharding)
+    return;
+  self->sharding = afinet_dd_sharding_new(self->primary);
+}
+
+void
+afinet_dd_add_shard_servers(LogDriver *s, GList *servers)
+{
+  AFInetDestDriver *self = (AFInetDestDriver *) s;
+  g_assert(self->sharding != NULL);
+  afinet_dd_sharding_add_servers(self->sharding, servers);
+}
+
+void
+afinet_dd_set_shard_key(LogDriver *s, LogTemplate *shard_key)
+{
+  AFInetDestDriver *self = (AFInetDestDriver *) s;
+  g_assert(self->sharding != NULL);
+  afinet_dd_sharding_set_shard_key_ref(self->sharding, shard_key);
+}
+
 static void
 _disable_connection_closure_on_input(LogWriter *writer)
 {
@@ -425,6 +465,120 @@ _libnet_destroy_when_spoof_source_enabled(AFInetDestDriver *self)
 #endif
 }
 
+static AFInetDestDriver *afinet_dd_new_instance(TransportMapper *transport_mapper, gchar *hostname,
+                                                GlobalConfig *cfg);
+
+static LogQueue *
+_shard_acquire_queue(LogDestDriver *s, const gchar *persist_name, gint stats_level,
+                     StatsClusterKeyBuilder *driver_sck_builder, StatsClusterKeyBuilder *queue_sck_builder)
+{
+  AFInetDestDriver *self = (AFInetDestDriver *) s;
+  LogDestDriver *owner = &self->shard_owner->super.super;
+
+  /* the owner may have a disk-buffer() attached */
+  return owner->acquire_queue(owner, persist_name, stats_level, driver_sck_builder, queue_sck_builder);
+}
+
+static void
+_shard_release_queue(LogDestDriver *s, LogQueue *q)
+{
+  AFInetDestDriver *self = (AFInetDestDriver *) s;
+  LogDestDriver *owner = &self->shard_owner->super.super;
+
+  owner->release_queue(owner, q);
+}
+
+static AFInetDestDriver *
+_new_shard(AFInetDestDriver *self, const gchar *hostname)
+{
+  LogPipe *owner_pipe = &self->super.super.super.super;
+  AFInetDestDriver *shard = afinet_dd_new_instance(transport_mapper_inet_clone(self->super.transport_mapper),
+                                                   (gchar *) hostname, log_pipe_get_config(owner_pipe));
+  LogPipe *shard_pipe = &shard->super.super.super.super;
+
+  shard->shard_owner = self;
+  shard->bind_ip = g_strdup(self->bind_ip);
+  shard->bind_port = g_strdup(self->bind_port);
+  shard->dest_port = g_strdup(self->dest_port);
+
+  socket_options_free(shard->super.socket_options);
+  shard->super.socket_options = socket_options_inet_clone(self->super.socket_options);
+  afsocket_dd_inherit_writer_options(&shard->super, &self->super);
+  shard->super.construct_writer = self->super.construct_writer;
+  shard->super.connections_kept_alive_across_reloads = self->super.connections_kept_alive_across_reloads;
+  shard->super.close_on_input = self->super.close_on_input;
+  shard->super.super.acquire_queue = _shard_acquire_queue;
+  shard->super.super.release_queue = _shard_release_queue;
+
+  log_pipe_clone_method(shard_pipe, owner_pipe);
+  if (owner_pipe->persist_name)
+    {
+      gchar *persist_name = g_strdup_printf("%s,%s", owner_pipe->persist_name, hostname);
+      log_pipe_set_persist_name(shard_pipe, persist_name);
+      g_free(persist_name);
+    }
+  shard_pipe->expr_node = owner_pipe->expr_node;
+  shard->super.super.super.group = g_strdup(self->super.super.super.group);
+  shard->super.super.super.id = g_strdup(self->super.super.super.id);
+
+  return shard;
+}
+
+/* the first shard is the primary server, which is served by the driver itself */
+static gboolean
+_init_shards(AFInetDestDriver *self)
+{
+  gint num_shards = afinet_dd_sharding_get_num_shards(self->sharding);
+
+  afinet_dd_sharding_get_shard(self->sharding, 0)->driver = &self->super;
+  for (gint i = 1; i < num_shards; i++)
+    {
+      AFInetDestShard *shard = afinet_dd_sharding_get_shard(self->sharding, i);
+
+      if (!shard->driver)
+        shard->driver = &_new_shard(self, shard->hostname)->super;
+
+      if (!log_pipe_init(&shard->driver->super.super.super))
+        {
+          msg_error("Error initializing shard of destination",
+                    evt_tag_str("server", shard->hostname),
+                    log_pipe_location_tag(&self->super.super.super.super));
+          return FALSE;
+        }
+    }
+
+  return TRUE;
+}
+
+static void
+_deinit_shards(AFInetDestDriver *self)
+{
+  gint num_shards = afinet_dd_sharding_get_num_shards(self->sharding);
+
+  for (gint i = 1; i < num_shards; i++)
+    {
+      AFInetDestShard *shard = afinet_dd_sharding_get_shard(self->sharding, i);
+
+      if (shard->driver)
+        log_pipe_deinit(&shard->driver->super.super.super);
+    }
+}
+
+static void
+_free_shards(AFInetDestDriver *self)
+{
+  gint num_shards = afinet_dd_sharding_get_num_shards(self->sharding);
+
+  for (gint i = 1; i < num_shards; i++)
+    {
+      AFInetDestShard *shard = afinet_dd_sharding_get_shard(self->sharding, i);
+
+      if (shard->driver)
+        log_pipe_unref(&shard->driver->super.super.super);
+      shard->driver = NULL;
+    }
+}
+
 static gboolean
 afinet_dd_deinit(LogPipe *s)
 {
@@ -433,6 +587,9 @@ afinet_dd_deinit(LogPipe *s)
   if (_is_failover_used(self))
     afinet_dd_failover_deinit(self->failover);
 
+  if (_is_sharding_used(self))
+    _deinit_shards(self);
+
   _libnet_destroy_when_spoof_source_enabled(self);
 
   return afsocket_dd_deinit(s);
@@ -448,6 +605,19 @@ afinet_dd_init(LogPipe *s)
     self->super.connections_kept_alive_across_reloads = TRUE;
 #endif
 
+  if (_is_sharding_used(self))
+    {
+      if (_is_failover_used(self))
+        {
+          msg_error("failover() and sharding() can not be used together",
+                    log_pipe_location_tag(s));
+          return FALSE;
+        }
+
+      if (!afinet_dd_sharding_init(self->sharding, log_pipe_get_config(s)))
+        return FALSE;
+    }
+
   if (!afsocket_dd_init(s))
     return FALSE;
 
@@ -494,6 +664,12 @@ afinet_dd_init(LogPipe *s)
       afinet_dd_failover_init(self->failover, s->expr_node, &ftm);
     }
 
+  if (_is_sharding_used(self) && !_init_shards(self))
+    {
+      _deinit_shards(self);
+      return FALSE;
+    }
+
   return TRUE;
 }
 
@@ -673,12 +849,33 @@ _is_spoof_source_enabled(AFInetDestDriver *self)
 
 #endif
 
+static void
+_queue_to_shard(AFInetDestDriver *self, LogMessage *msg, const LogPathOptions *path_options)
+{
+  AFInetDestShard *shard = afinet_dd_sharding_choose(self->sharding, msg, &self->super.writer_options.template_options);
+
+  /* the group and global counters of the shard drivers are the same
+   * counters as ours, they are only incremented once here.  The per-server
+   * throughput is counted by the writer and the queue of the shard, which
+   * are registered with the address of the server. */
+  stats_counter_inc(self->super.super.super.processed_group_messages);
+  stats_counter_inc(self->super.super.queued_global_messages);
+  log_pipe_queue((LogPipe *) shard->driver->writer, msg, path_options);
+}
+
 static void
 afinet_dd_queue(LogPipe *s, LogMessage *msg, const LogPathOptions *path_options)
 {
-#if SYSLOG_NG_ENABLE_SPOOF_SOURCE
   AFInetDestDriver *self = (AFInetDestDriver *) s;
 
+  if (_is_sharding_used(self))
+    {
+      _queue_to_shard(self, msg, path_options);
+      return;
+    }
+
+#if SYSLOG_NG_ENABLE_SPOOF_SOURCE
+
   /* NOTE: This code should probably be moved to the LogProto layer so that
    * spoofed packets are also going through the LogWriter queue */
 
@@ -698,6 +895,9 @@ afinet_dd_free(LogPipe *s)
 
   g_free(self->primary);
   afinet_dd_failover_free(self->failover);
+  if (_is_sharding_used(self))
+    _free_shards(self);
+  afinet_dd_sharding_free(self->sharding);
 
 
   g_free(self->bind_ip);
@@ -744,7 +944,7 @@ afinet_dd_restore_connection(AFSocketDestDriver *s, AFSocketDestKeptAliveConnect
     {
       TLSSession *session = log_tansport_tls_get_session(transport);
       AFInetDestDriverTLSVerifyData *verify_data = _get_tls_verify_data (session->verifier);
-      verify_data->signal_connector = self->super.super.super.signal_slot_connector;
+      verify_data->signal_connector = _get_signal_slot_connector(self);
     }
 
 exit:
@@ -27,6 +27,7 @@
 #include "afinet.h"
 #include "afsocket-dest.h"
 #include "afinet-dest-failover.h"
+#include "afinet-dest-sharding.h"
 #include "transport/tls-context.h"
 
 #if SYSLOG_NG_ENABLE_SPOOF_SOURCE
@@ -51,6 +52,9 @@ typedef struct _AFInetDestDriver
 #endif
   gchar *primary;
   AFInetDestDriverFailover *failover;
+  AFInetDestDriverSharding *sharding;
+  /* set on the per-server drivers of a sharded destination */
+  struct _AFInetDestDriver *shard_owner;
 
   /* character as it can contain a service name from /etc/services */
   gchar *bind_port;
@@ -77,6 +81,10 @@ void afinet_dd_enable_failback(LogDriver *s);
 void afinet_dd_set_failback_tcp_probe_interval(LogDriver *s, gint tcp_probe_interval);
 void afinet_dd_set_failback_successful_probes_required(LogDriver *s, gint successful_probes_required);
 
+void afinet_dd_enable_sharding(LogDriver *s);
+void afinet_dd_add_shard_servers(LogDriver *s, GList *servers);
+void afinet_dd_set_shard_key(LogDriver *s, LogTemplate *shard_key);
+
 const gchar *afinet_dd_get_hostname(const AFInetDestDriver *self);
 
 AFInetDestDriver *afinet_dd_new_tcp(gchar *host, GlobalConfig *cfg);
@@ -779,12 +779,28 @@ afsocket_dd_notify(LogPipe *s, gint notify_code, gpointer user_data)
     }
 }
 
+/*
+ * Drivers created by another driver (the per-server drivers of a sharded
+ * destination) use the options of their owner.  The copy is only valid
+ * while the owner is alive, so the owner has to free these drivers first.
+ */
+void
+afsocket_dd_inherit_writer_options(AFSocketDestDriver *self, AFSocketDestDriver *owner)
+{
+  g_assert(owner->writer_options.initialized);
+
+  self->writer_options = owner->writer_options;
+  self->writer_options_inherited = TRUE;
+  self->proto_factory = owner->proto_factory;
+}
+
 void
 afsocket_dd_free(LogPipe *s)
 {
   AFSocketDestDriver *self = (AFSocketDestDriver *) s;
 
-  log_writer_options_destroy(&self->writer_options);
+  if (!self->writer_options_inherited)
+    log_writer_options_destroy(&self->writer_options);
   g_sockaddr_unref(self->bind_addr);
   g_sockaddr_unref(self->dest_addr);
   log_pipe_unref((LogPipe *) self->writer);
@@ -45,6 +45,8 @@ struct _AFSocketDestDriver
   gint fd;
   LogWriter *writer;
   LogWriterOptions writer_options;
+  /* the writer options are a copy of the initialized options of another driver */
+  gboolean writer_options_inherited;
   LogProtoClientFactory *proto_factory;
 
   GSockAddr *bind_addr;
@@ -103,6 +105,7 @@ LogWriter *afsocket_dd_construct_writer_method(AFSocketDestDriver *self);
 gboolean afsocket_dd_setup_addresses_method(AFSocketDestDriver *self);
 void afsocket_dd_set_keep_alive(LogDriver *self, gint enable);
 void afsocket_dd_set_close_on_input(LogDriver *self, gboolean close_on_input);
+void afsocket_dd_inherit_writer_options(AFSocketDestDriver *self, AFSocketDestDriver *owner);
 void afsocket_dd_init_instance(AFSocketDestDriver *self, SocketOptions *socket_options,
                                TransportMapper *transport_mapper, GlobalConfig *cfg);
 void afsocket_dd_reconnect(AFSocketDestDriver *self);
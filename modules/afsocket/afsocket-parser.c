@@ -103,6 +103,8 @@ static CfgLexerKeyword afsocket_keywords[] =
   { "failover",           KW_FAILOVER },
   { "failback",           KW_FAILBACK },
   { "servers",            KW_SERVERS },
+  { "sharding",           KW_SHARDING },
+  { "shard_key",          KW_SHARD_KEY },
   { "tcp_probe_interval", KW_TCP_PROBE_INTERVAL },
   { "successful_probes_required", KW_SUCCESSFUL_PROBES_REQUIRED },
   { "dynamic_window_size", KW_DYNAMIC_WINDOW_SIZE },
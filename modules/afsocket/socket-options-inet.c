@@ -281,3 +281,14 @@ socket_options_inet_new(void)
 {
   return &socket_options_inet_new_instance()->super;
 }
+
+SocketOptions *
+socket_options_inet_clone(SocketOptions *s)
+{
+  SocketOptionsInet *self = (SocketOptionsInet *) s;
+  SocketOptionsInet *cloned = g_new0(SocketOptionsInet, 1);
+
+  *cloned = *self;
+  cloned->interface_name = g_strdup(self->interface_name);
+  return &cloned->super;
+}
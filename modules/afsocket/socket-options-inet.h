@@ -45,5 +45,6 @@ gboolean socket_options_inet_set_tcp_keepalive_probes(SocketOptionsInet *self, g
 
 SocketOptionsInet *socket_options_inet_new_instance(void);
 SocketOptions *socket_options_inet_new(void);
+SocketOptions *socket_options_inet_clone(SocketOptions *s);
 
 #endif
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "afinet-dest-sharding.h"
+#include "logqueue-fifo.h"
+#include "logproto/logproto-text-client.h"
+#include "transport/transport-file.h"
+#include "mainloop.h"
+#include "apphook.h"
+#include "cfg.h"
+
+#include <criterion/criterion.h>
+#include <unistd.h>
+
+#define NUM_KEYS 20000
+#define NUM_SERVERS 4
+
+static const gchar *servers[NUM_SERVERS] = { "10.0.0.1", "10.0.0.2", "10.0.0.3", "10.0.0.4" };
+
+static AFInetDestDriverSharding *sharding;
+static AFSocketDestDriver drivers[NUM_SERVERS];
+static LogWriterOptions writer_options;
+static LogMessage *msg;
+
+static LogWriter *
+_writer_new(void)
+{
+  LogWriter *writer = log_writer_new(LW_FORMAT_PROTO, configuration);
+
+  log_writer_set_options(writer, NULL, &writer_options, "sharding", stats_cluster_key_builder_new());
+  log_writer_set_queue(writer, log_queue_fifo_new(1000, NULL, STATS_LEVEL0, NULL, NULL));
+  cr_assert(log_pipe_init(&writer->super));
+  return writer;
+}
+
+/* the same as afsocket does when the connection of a server is established */
+static void
+_connect(gint server)
+{
+  gchar *filename;
+  gint fd = g_file_open_tmp("test-afinet-dest-sharding-XXXXXX", &filename, NULL);
+
+  cr_assert_geq(fd, 0);
+  unlink(filename);
+  g_free(filename);
+
+  LogProtoClient *proto = log_proto_text_client_new(log_transport_file_new(fd), &writer_options.proto_options.super);
+  log_writer_reopen(drivers[server].writer, proto);
+  cr_assert(log_writer_opened(drivers[server].writer));
+}
+
+/* ... and when it is lost */
+static void
+_disconnect(gint server)
+{
+  log_writer_reopen(drivers[server].writer, NULL);
+  cr_assert_not(log_writer_opened(drivers[server].writer));
+}
+
+static gint
+_choose(gint key)
+{
+  gchar host[32];
+
+  g_snprintf(host, sizeof(host), "host-%d", key);
+  log_msg_set_value(msg, LM_V_HOST, host, -1);
+
+  AFInetDestShard *shard = afinet_dd_sharding_choose(sharding, msg, &writer_options.template_options);
+  for (gint i = 0; i < NUM_SERVERS; i++)
+    {
+      if (shard->driver == &drivers[i])
+        return i;
+    }
+  cr_assert_fail("the chosen shard does not belong to any of the servers");
+  return -1;
+}
+
+static void
+setup(void)
+{
+  app_startup();
+  main_thread_handle = get_thread_id();
+  configuration = cfg_new_snippet();
+
+  log_writer_options_defaults(&writer_options);
+  log_writer_options_init(&writer_options, configuration, 0);
+
+  GList *other_servers = NULL;
+  for (gint i = 1; i < NUM_SERVERS; i++)
+    other_servers = g_list_append(other_servers, g_strdup(servers[i]));
+
+  sharding = afinet_dd_sharding_new(servers[0]);
+  afinet_dd_sharding_add_servers(sharding, other_servers);
+  cr_assert(afinet_dd_sharding_init(sharding, configuration));
+  cr_assert_eq(afinet_dd_sharding_get_num_shards(sharding), NUM_SERVERS);
+
+  for (gint i = 0; i < NUM_SERVERS; i++)
+    {
+      AFInetDestShard *shard = afinet_dd_sharding_get_shard(sharding, i);
+
+      cr_assert_str_eq(shard->hostname, servers[i]);
+      drivers[i].writer = _writer_new();
+      shard->driver = &drivers[i];
+      _connect(i);
+    }
+
+  msg = log_msg_new_empty();
+}
+
+static void
+teardown(void)
+{
+  log_msg_unref(msg);
+  for (gint i = 0; i < NUM_SERVERS; i++)
+    {
+      log_pipe_deinit(&drivers[i].writer->super);
+      log_pipe_unref(&drivers[i].writer->super);
+      drivers[i].writer = NULL;
+    }
+  afinet_dd_sharding_free(sharding);
+  log_writer_options_destroy(&writer_options);
+  cfg_free(configuration);
+  app_shutdown();
+}
+
+TestSuite(afinet_dest_sharding, .init = setup, .fini = teardown);
+
+Test(afinet_dest_sharding, keys_are_distributed_evenly)
+{
+  gint counts[NUM_SERVERS] = { 0 };
+
+  for (gint key = 0; key < NUM_KEYS; key++)
+    counts[_choose(key)]++;
+
+  for (gint i = 0; i < NUM_SERVERS; i++)
+    {
+      cr_assert_gt(counts[i], NUM_KEYS / NUM_SERVERS * 9 / 10, "shard %d got too few keys: %d", i, counts[i]);
+      cr_assert_lt(counts[i], NUM_KEYS / NUM_SERVERS * 11 / 10, "shard %d got too many keys: %d", i, counts[i]);
+    }
+}
+
+Test(afinet_dest_sharding, keys_of_a_disconnected_server_move_to_the_connected_ones)
+{
+  static gint before[NUM_KEYS];
+  const gint disconnected = 2;
+  gint moved = 0;
+
+  for (gint key = 0; key < NUM_KEYS; key++)
+    before[key] = _choose(key);
+
+  _disconnect(disconnected);
+  for (gint key = 0; key < NUM_KEYS; key++)
+    {
+      gint after = _choose(key);
+
+      cr_assert_neq(after, disconnected, "key %d was sent to a disconnected server", key);
+      if (before[key] != disconnected)
+        cr_assert_eq(before[key], after, "key %d moved from a server that is connected", key);
+      else
+        moved++;
+    }
+  cr_assert_lt(moved, NUM_KEYS / NUM_SERVERS * 11 / 10);
+
+  /* the keys go back once the server is reconnected */
+  _connect(disconnected);
+  for (gint key = 0; key < NUM_KEYS; key++)
+    cr_assert_eq(_choose(key), before[key], "key %d did not return to its server", key);
+}
+
+Test(afinet_dest_sharding, keys_stay_with_their_own_server_if_none_of_them_is_connected)
+{
+  static gint before[NUM_KEYS];
+
+  for (gint key = 0; key < NUM_KEYS; key++)
+    before[key] = _choose(key);
+
+  for (gint i = 0; i < NUM_SERVERS; i++)
+    _disconnect(i);
+
+  for (gint key = 0; key < NUM_KEYS; key++)
+    cr_assert_eq(_choose(key), before[key], "key %d was not queued to its own server", key);
+}
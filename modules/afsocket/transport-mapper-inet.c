@@ -295,6 +295,22 @@ transport_mapper_inet_new_instance(const gchar *transport)
   return self;
 }
 
+/* copies the user settings, the result is filled in by apply_transport() */
+TransportMapper *
+transport_mapper_inet_clone(TransportMapper *s)
+{
+  TransportMapperInet *self = (TransportMapperInet *) s;
+  TransportMapperInet *cloned = g_new0(TransportMapperInet, 1);
+
+  *cloned = *self;
+  cloned->super.transport = g_strdup(self->super.transport);
+  cloned->super.transport_name = NULL;
+  cloned->tls_context = self->tls_context ? tls_context_ref(self->tls_context) : NULL;
+  cloned->tls_verifier = NULL;
+  cloned->secret_store_cb_data = NULL;
+  return &cloned->super;
+}
+
 static gboolean
 transport_mapper_tcp_apply_transport(TransportMapper *s, GlobalConfig *cfg)
 {
@@ -93,4 +93,6 @@ TransportMapper *transport_mapper_udp6_new(void);
 TransportMapper *transport_mapper_network_new(void);
 TransportMapper *transport_mapper_syslog_new(void);
 
+TransportMapper *transport_mapper_inet_clone(TransportMapper *s);
+
 #endif
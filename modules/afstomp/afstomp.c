@@ -35,30 +35,6 @@
 
 #include <glib.h>
 #include <stomp.h>
-#include "logthrdest/logthrdestdrv.h"
-
-typedef struct
-{
-  LogThreadedDestDriver super;
-
-  gchar *destination;
-  LogTemplate *body_template;
-
-  gboolean persistent;
-  gboolean ack_needed;
-
-  gchar *host;
-  gint port;
-
-  gchar *user;
-  gchar *password;
-
-  LogTemplateOptions template_options;
-
-  ValuePairs *vp;
-
-  stomp_connection *conn;
-} STOMPDestDriver;
 
 /*
  * Configuration
@@ -221,6 +197,7 @@ afstomp_dd_connect(STOMPDestDriver *self, gboolean reconnect)
   if (!afstomp_send_frame(self, &frame))
     {
       msg_error("Sending CONNECT frame to STOMP server failed!");
+      stomp_disconnect(&self->conn);
       return FALSE;
     }
 
@@ -228,8 +205,12 @@ afstomp_dd_connect(STOMPDestDriver *self, gboolean reconnect)
   if (!frame_read || strcmp(frame.command, "CONNECTED") != 0)
     {
       msg_debug("Error connecting to STOMP server, stomp server did not accept CONNECT request");
-      stomp_frame_deinit(&frame);
+      if (frame_read)
+        stomp_frame_deinit(&frame);
 
+      /* do not keep the half-open connection around, it would be reused as
+       * if the handshake succeeded */
+      stomp_disconnect(&self->conn);
       return FALSE;
     }
   msg_debug("Connecting to STOMP succeeded",
@@ -240,6 +221,14 @@ afstomp_dd_connect(STOMPDestDriver *self, gboolean reconnect)
   return TRUE;
 }
 
+static gboolean
+afstomp_dd_connect_method(LogThreadedDestDriver *s)
+{
+  STOMPDestDriver *self = (STOMPDestDriver *)s;
+
+  return afstomp_dd_connect(self, TRUE);
+}
+
 static void
 afstomp_dd_disconnect(LogThreadedDestDriver *s)
 {
@@ -247,6 +236,7 @@ afstomp_dd_disconnect(LogThreadedDestDriver *s)
 
   stomp_disconnect(&self->conn);
   self->conn = NULL;
+  g_string_truncate(self->batch, 0);
 }
 
 /* TODO escape '\0' when passing down the value */
@@ -274,54 +264,78 @@ afstomp_set_frame_body(STOMPDestDriver *self, GString *body, stomp_frame *frame,
     }
 }
 
-static gboolean
-afstomp_worker_publish(STOMPDestDriver *self, LogMessage *msg)
+static void
+afstomp_worker_format_frame(STOMPDestDriver *self, LogMessage *msg)
 {
-  gboolean success = TRUE;
-  GString *body = NULL;
+  GString *body = scratch_buffers_alloc();
   stomp_frame frame;
-  stomp_frame recv_frame;
 
-  if (!self->conn)
-    {
-      msg_error("STOMP server is not connected, not sending message!");
-      return FALSE;
-    }
-
-  body = scratch_buffers_alloc();
   stomp_frame_init(&frame, "SEND", sizeof("SEND"));
 
   if (self->persistent)
     stomp_frame_add_header(&frame, "persistent", "true");
 
   stomp_frame_add_header(&frame, "destination", self->destination);
-  if (self->ack_needed)
-    {
-      /*
-       * We check the server's response before sending a new frame to it.
-       * Because of this, we do not need a unique receipt header.
-       *
-       * This changes if multiple workers and/or batching support is introduced.
-       * Make sure to use a unique receipt-id if one of the above gets implemented.
-       */
-      stomp_frame_add_header(&frame, "receipt", "0");
-    };
 
   LogTemplateEvalOptions options = {&self->template_options, LTZ_SEND, self->super.worker.instance.seq_num, NULL, LM_VT_STRING};
   value_pairs_foreach(self->vp, afstomp_vp_foreach, msg, &options, &frame);
 
   afstomp_set_frame_body(self, body, &frame, msg);
 
-  if (!afstomp_send_frame(self, &frame))
+  self->last_frame_offset = self->batch->len;
+  stomp_frame_format(&frame, self->batch);
+  stomp_frame_deinit(&frame);
+}
+
+/*
+ * The receipt is only requested for the last frame of the batch: the
+ * server processes the frames of a connection in order, so receiving it
+ * means that the whole batch was accepted. Headers are unordered in STOMP,
+ * so the header is simply inserted right after the command of the last
+ * frame.
+ */
+static void
+afstomp_worker_request_receipt(STOMPDestDriver *self, gchar *receipt_id, gsize receipt_id_size)
+{
+  gchar header[64];
+
+  g_snprintf(receipt_id, receipt_id_size, "%" G_GUINT64_FORMAT, ++self->receipt_id);
+  g_snprintf(header, sizeof(header), "receipt:%s\n", receipt_id);
+
+  g_string_insert(self->batch, self->last_frame_offset + sizeof("SEND\n") - 1, header);
+}
+
+static LogThreadedResult
+afstomp_worker_flush(LogThreadedDestDriver *s)
+{
+  STOMPDestDriver *self = (STOMPDestDriver *)s;
+  gchar receipt_id[32];
+  gboolean success = TRUE;
+
+  if (self->batch->len == 0)
+    return LTR_SUCCESS;
+
+  if (!self->conn)
+    {
+      msg_error("STOMP server is not connected, not sending message!");
+      g_string_truncate(self->batch, 0);
+      return LTR_NOT_CONNECTED;
+    }
+
+  if (self->ack_needed)
+    afstomp_worker_request_receipt(self, receipt_id, sizeof(receipt_id));
+
+  if (!stomp_write_data(self->conn, self->batch))
     {
       msg_error("Error while inserting into STOMP server");
       success = FALSE;
     }
 
   if (success && self->ack_needed)
-    success = stomp_receive_frame(self->conn, &recv_frame);
+    success = stomp_receive_receipt(self->conn, receipt_id);
 
-  return success;
+  g_string_truncate(self->batch, 0);
+  return success ? LTR_SUCCESS : LTR_ERROR;
 }
 
 static LogThreadedResult
@@ -332,10 +346,9 @@ afstomp_worker_insert(LogThreadedDestDriver *s, LogMessage *msg)
   if (!afstomp_dd_connect(self, TRUE))
     return LTR_NOT_CONNECTED;
 
-  if (!afstomp_worker_publish (self, msg))
-    return LTR_ERROR;
+  afstomp_worker_format_frame(self, msg);
 
-  return LTR_SUCCESS;
+  return LTR_QUEUED;
 }
 
 static void
@@ -380,6 +393,7 @@ afstomp_dd_free(LogPipe *d)
   g_free(self->password);
   g_free(self->host);
   value_pairs_unref(self->vp);
+  g_string_free(self->batch, TRUE);
   log_threaded_dest_driver_free(d);
 }
 
@@ -389,13 +403,16 @@ afstomp_dd_new(GlobalConfig *cfg)
   STOMPDestDriver *self = g_new0(STOMPDestDriver, 1);
 
   log_threaded_dest_driver_init_instance(&self->super, cfg);
+  self->batch = g_string_sized_new(4096);
   self->super.super.super.super.init = afstomp_dd_init;
   self->super.super.super.super.free_fn = afstomp_dd_free;
   self->super.super.super.super.generate_persist_name = afstomp_dd_format_persist_name;
 
   self->super.worker.thread_init = afstomp_worker_thread_init;
+  self->super.worker.connect = afstomp_dd_connect_method;
   self->super.worker.disconnect = afstomp_dd_disconnect;
   self->super.worker.insert = afstomp_worker_insert;
+  self->super.worker.flush = afstomp_worker_flush;
 
   self->super.format_stats_key = afstomp_dd_format_stats_key;
   self->super.stats_source = stats_register_type("stomp");
@@ -27,6 +27,37 @@
 
 #include "driver.h"
 #include "value-pairs/value-pairs.h"
+#include "logthrdest/logthrdestdrv.h"
+#include "stomp.h"
+
+typedef struct
+{
+  LogThreadedDestDriver super;
+
+  gchar *destination;
+  LogTemplate *body_template;
+
+  gboolean persistent;
+  gboolean ack_needed;
+
+  gchar *host;
+  gint port;
+
+  gchar *user;
+  gchar *password;
+
+  LogTemplateOptions template_options;
+
+  ValuePairs *vp;
+
+  stomp_connection *conn;
+
+  /* SEND frames formatted since the last flush, written with a single
+   * write() */
+  GString *batch;
+  gsize last_frame_offset;
+  guint64 receipt_id;
+} STOMPDestDriver;
 
 LogDriver *afstomp_dd_new(GlobalConfig *cfg);
 
@@ -323,11 +323,39 @@ stomp_check_for_frame(stomp_connection *connection)
   return TRUE;
 }
 
-GString *
-create_gstring_from_frame(stomp_frame *frame)
+int
+stomp_receive_receipt(stomp_connection *connection, const char *receipt_id)
 {
-  GString *data = g_string_new("");
+  stomp_frame frame;
+
+  if (!stomp_receive_frame(connection, &frame))
+    return FALSE;
+
+  int res = TRUE;
+  if (strcmp(frame.command, "RECEIPT") != 0)
+    {
+      msg_error("Unexpected frame received from STOMP server, expecting a RECEIPT",
+                evt_tag_str("command", frame.command),
+                evt_tag_str("message", g_hash_table_lookup(frame.headers, "message")));
+      res = FALSE;
+    }
+  else if (g_strcmp0(g_hash_table_lookup(frame.headers, "receipt-id"), receipt_id) != 0)
+    {
+      msg_error("RECEIPT frame received from STOMP server with an unexpected receipt-id",
+                evt_tag_str("receipt_id", g_hash_table_lookup(frame.headers, "receipt-id")),
+                evt_tag_str("expected", receipt_id));
+      res = FALSE;
+    }
+
+  stomp_frame_deinit(&frame);
+  return res;
+}
 
+/* appends the wire format of @frame to @data, so that multiple frames can
+ * be sent with a single write */
+void
+stomp_frame_format(stomp_frame *frame, GString *data)
+{
   g_string_append(data, frame->command);
   g_string_append_c(data, '\n');
   g_hash_table_foreach(frame->headers, write_header_into_gstring, data);
@@ -335,27 +363,39 @@ create_gstring_from_frame(stomp_frame *frame)
   if (frame->body)
     g_string_append_len(data, frame->body, frame->body_length);
   g_string_append_c(data, 0);
+}
+
+GString *
+create_gstring_from_frame(stomp_frame *frame)
+{
+  GString *data = g_string_new("");
+
+  stomp_frame_format(frame, data);
   return data;
 }
 
 int
-stomp_write(stomp_connection *connection, stomp_frame *frame)
+stomp_write_data(stomp_connection *connection, GString *data)
 {
-  GString *data;
-
   if (!stomp_check_for_frame(connection))
     return FALSE;
 
-  data = create_gstring_from_frame(frame);
   if (!write_gstring_to_socket(connection->socket, data))
     {
       msg_error("Write error, partial write");
-      stomp_frame_deinit(frame);
-      g_string_free(data, TRUE);
       return FALSE;
     }
 
+  return TRUE;
+}
+
+int
+stomp_write(stomp_connection *connection, stomp_frame *frame)
+{
+  GString *data = create_gstring_from_frame(frame);
+  int res = stomp_write_data(connection, data);
+
   g_string_free(data, TRUE);
   stomp_frame_deinit(frame);
-  return TRUE;
+  return res;
 }
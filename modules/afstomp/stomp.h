@@ -52,10 +52,13 @@ int stomp_connect(stomp_connection **connection_ref, char *hostname, int port);
 int stomp_disconnect(stomp_connection **connection_ref);
 
 int stomp_write(stomp_connection *connection, stomp_frame *frame);
+int stomp_write_data(stomp_connection *connection, GString *data);
 int stomp_read(stomp_connection *connection, stomp_frame **frame);
 int stomp_parse_frame(GString *data, stomp_frame *frame);
 int stomp_receive_frame(stomp_connection *connection, stomp_frame *frame);
+int stomp_receive_receipt(stomp_connection *connection, const char *receipt_id);
 
+void stomp_frame_format(stomp_frame *frame, GString *data);
 GString *create_gstring_from_frame(stomp_frame *frame);
 
 #endif
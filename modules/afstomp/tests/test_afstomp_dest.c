@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "apphook.h"
+#include "afstomp.h"
+#include "cfg.h"
+#include "logmsg/logmsg.h"
+
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* the server side of a socketpair, collecting the frames of a batch and
+ * answering with a RECEIPT frame, like a STOMP server would */
+typedef struct
+{
+  gint fd;
+  gint expected_frames;
+  const gchar *receipt_id;
+  GString *received;
+} FakeStompServer;
+
+static GlobalConfig *cfg;
+static STOMPDestDriver *stomp_driver;
+static FakeStompServer server;
+
+static gint
+_count_frames(GString *data)
+{
+  gint frames = 0;
+
+  for (gsize i = 0; i < data->len; i++)
+    {
+      if (data->str[i] == 0)
+        frames++;
+    }
+  return frames;
+}
+
+static gpointer
+_fake_server_run(gpointer user_data)
+{
+  FakeStompServer *self = (FakeStompServer *) user_data;
+  gchar buf[4096];
+
+  while (_count_frames(self->received) < self->expected_frames)
+    {
+      gssize res = read(self->fd, buf, sizeof(buf));
+
+      if (res <= 0)
+        return NULL;
+      g_string_append_len(self->received, buf, res);
+    }
+
+  GString *receipt = g_string_new("");
+  g_string_printf(receipt, "RECEIPT\nreceipt-id:%s\n\n", self->receipt_id);
+  g_string_append_c(receipt, 0);
+  gssize written = write(self->fd, receipt->str, receipt->len);
+  g_assert(written == receipt->len);
+  g_string_free(receipt, TRUE);
+  return NULL;
+}
+
+static GThread *
+_start_fake_server(gint expected_frames, const gchar *receipt_id)
+{
+  server.expected_frames = expected_frames;
+  server.receipt_id = receipt_id;
+  return g_thread_new("fake-stomp", _fake_server_run, &server);
+}
+
+static void
+_insert_message(const gchar *message)
+{
+  LogMessage *msg = log_msg_new_empty();
+
+  log_msg_set_value(msg, LM_V_MESSAGE, message, -1);
+  cr_assert_eq(stomp_driver->super.worker.insert(&stomp_driver->super, msg), LTR_QUEUED);
+  log_msg_unref(msg);
+}
+
+/* returns the frame following @frame in a buffer of NUL terminated frames */
+static const gchar *
+_next_frame(const gchar *frame)
+{
+  return frame + strlen(frame) + 1;
+}
+
+static void
+setup(void)
+{
+  gint fds[2];
+
+  app_startup();
+  cfg = cfg_new_snippet();
+
+  stomp_driver = (STOMPDestDriver *) afstomp_dd_new(cfg);
+  log_template_options_init(afstomp_dd_get_template_options(&stomp_driver->super.super.super), cfg);
+  afstomp_dd_set_value_pairs(&stomp_driver->super.super.super, value_pairs_new(cfg));
+
+  LogTemplate *body = log_template_new(cfg, NULL);
+  cr_assert(log_template_compile(body, "$MSG", NULL));
+  afstomp_dd_set_body(&stomp_driver->super.super.super, body);
+  afstomp_dd_set_ack(&stomp_driver->super.super.super, TRUE);
+
+  cr_assert_eq(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  stomp_driver->conn = g_new0(stomp_connection, 1);
+  stomp_driver->conn->socket = fds[0];
+
+  server.fd = fds[1];
+  server.received = g_string_new("");
+}
+
+static void
+teardown(void)
+{
+  stomp_disconnect(&stomp_driver->conn);
+  close(server.fd);
+  g_string_free(server.received, TRUE);
+
+  log_pipe_unref(&stomp_driver->super.super.super.super);
+  app_shutdown();
+  cfg_free(cfg);
+}
+
+TestSuite(afstomp_dest, .init = setup, .fini = teardown);
+
+Test(afstomp_dest, batch_is_written_at_once_and_acknowledged_by_a_single_receipt)
+{
+  GThread *server_thread = _start_fake_server(2, "1");
+
+  _insert_message("first");
+  _insert_message("second");
+  cr_assert_eq(stomp_driver->super.worker.flush(&stomp_driver->super), LTR_SUCCESS);
+  g_thread_join(server_thread);
+
+  cr_assert_eq(_count_frames(server.received), 2);
+
+  const gchar *first = server.received->str;
+  cr_assert(g_str_has_prefix(first, "SEND\n"));
+  cr_assert(strstr(first, "\ndestination:/topic/syslog\n"));
+  cr_assert(g_str_has_suffix(first, "\n\nfirst"));
+  cr_assert_null(strstr(first, "receipt:"), "only the last frame of the batch should request a receipt");
+
+  const gchar *second = _next_frame(first);
+  cr_assert(g_str_has_prefix(second, "SEND\nreceipt:1\n"));
+  cr_assert(g_str_has_suffix(second, "\n\nsecond"));
+
+  cr_assert_eq(stomp_driver->batch->len, 0);
+}
+
+Test(afstomp_dest, receipt_with_an_unexpected_id_fails_the_batch)
+{
+  GThread *server_thread = _start_fake_server(1, "42");
+
+  _insert_message("message");
+  cr_assert_eq(stomp_driver->super.worker.flush(&stomp_driver->super), LTR_ERROR);
+  g_thread_join(server_thread);
+
+  cr_assert_eq(stomp_driver->batch->len, 0);
+}
+
+Test(afstomp_dest, receipt_is_received_directly_with_the_expected_id)
+{
+  GThread *server_thread = _start_fake_server(0, "7");
+
+  g_thread_join(server_thread);
+  cr_assert(stomp_receive_receipt(stomp_driver->conn, "7"));
+}
+
+Test(afstomp_dest, receipt_with_a_different_id_is_rejected)
+{
+  GThread *server_thread = _start_fake_server(0, "8");
+
+  g_thread_join(server_thread);
+  cr_assert_not(stomp_receive_receipt(stomp_driver->conn, "7"));
+}
@@ -24,6 +24,8 @@
 #include <criterion/criterion.h>
 #include "stomp.h"
 
+#include <string.h>
+
 static void
 assert_stomp_header(stomp_frame *frame, char *key, char *value)
 {
@@ -97,6 +99,27 @@ Test(stomp_proto, test_generate_gstring_from_frame)
   stomp_frame_deinit(&frame);
 };
 
+Test(stomp_proto, test_format_multiple_frames_into_one_buffer)
+{
+  stomp_frame frame;
+  GString *actual = g_string_new("");
+
+  stomp_frame_init(&frame, "SEND", sizeof("SEND"));
+  stomp_frame_set_body(&frame, "first", strlen("first"));
+  stomp_frame_format(&frame, actual);
+  stomp_frame_deinit(&frame);
+
+  stomp_frame_init(&frame, "SEND", sizeof("SEND"));
+  stomp_frame_set_body(&frame, "second", strlen("second"));
+  stomp_frame_format(&frame, actual);
+  stomp_frame_deinit(&frame);
+
+  cr_assert_eq(actual->len, sizeof("SEND\n\nfirst") + sizeof("SEND\n\nsecond"));
+  cr_assert_str_eq(actual->str, "SEND\n\nfirst");
+  cr_assert_str_eq(actual->str + sizeof("SEND\n\nfirst"), "SEND\n\nsecond");
+  g_string_free(actual, TRUE);
+};
+
 Test(stomp_proto, test_invalid_command)
 {
   stomp_frame frame;
@@ -26,6 +26,7 @@
 #include "value-pairs/cmdline.h"
 #include "syslog-ng.h"
 #include "str-utils.h"
+#include "str-scan.h"
 #include "format-cef-extension.h"
 
 typedef struct _TFCefState
@@ -64,47 +65,96 @@ tf_cef_is_valid_key(const gchar *str)
   return str[end] == '\0';
 }
 
+/* the longest escape is \uXXXX for a single byte control character */
+#define TF_CEF_MAX_ESCAPED_LENGTH_PER_BYTE 6
+
+static inline gsize
+tf_cef_write_escaped_character(gchar *dst, gsize dst_size, const gchar **str, gsize str_len)
+{
+  const gchar *char_ptr = *str;
+  gunichar uchar = g_utf8_get_char_validated(char_ptr, str_len);
+
+  switch (uchar)
+    {
+    case (gunichar) -1:
+    case (gunichar) -2:
+      (*str)++;
+      return g_snprintf(dst, dst_size, "\\x%02x", *(guint8 *) char_ptr);
+    default:
+      break;
+    }
+
+  *str = g_utf8_next_char(char_ptr);
+  switch (uchar)
+    {
+    case '=':
+      memcpy(dst, "\\=", 2);
+      return 2;
+    case '\n':
+      memcpy(dst, "\\n", 2);
+      return 2;
+    case '\r':
+      memcpy(dst, "\\r", 2);
+      return 2;
+    case '\\':
+      memcpy(dst, "\\\\", 2);
+      return 2;
+    default:
+      if (uchar < 32)
+        return g_snprintf(dst, dst_size, "\\u%04x", uchar);
+
+      /* validated utf8 is in its shortest form, copying it is the same as
+       * re-encoding uchar */
+      memcpy(dst, char_ptr, *str - char_ptr);
+      return *str - char_ptr;
+    }
+}
+
+/*
+ * Two passes: measure the plain runs and count the bytes to be escaped so
+ * that the output is reserved once, then bulk-copy the plain runs and
+ * escape the rest in place.
+ */
 static inline void
 tf_cef_append_escaped(GString *escaped_string, const gchar *str, gsize str_len)
 {
-  const gchar *char_ptr;
-  gunichar uchar;
+  StrScanSpecials specials;
+  str_scan_specials_init(&specials, "=");
 
-  while (str_len)
+  gsize special_count = 0;
+  gsize pos = str_scan_plain_ascii(&specials, str, str_len);
+  while (pos < str_len)
     {
-      uchar = g_utf8_get_char_validated(str, str_len);
+      for (; pos < str_len && !str_scan_is_plain_ascii(&specials, str[pos]); pos++)
+        special_count++;
+      pos += str_scan_plain_ascii(&specials, str + pos, str_len - pos);
+    }
 
-      switch (uchar)
-        {
-        case (gunichar) -1:
-        case (gunichar) -2:
-          g_string_append_printf(escaped_string, "\\x%02x", *(guint8 *) str++);
-          str_len--;
-          continue;
-          break;
-        case '=':
-          g_string_append(escaped_string, "\\=");
-          break;
-        case '\n':
-          g_string_append(escaped_string, "\\n");
-          break;
-        case '\r':
-          g_string_append(escaped_string, "\\r");
-          break;
-        case '\\':
-          g_string_append(escaped_string, "\\\\");
-          break;
-        default:
-          if (uchar < 32)
-            g_string_append_printf(escaped_string, "\\u%04x", uchar);
-          else
-            g_string_append_unichar_optimized(escaped_string, uchar);
-          break;
-        }
-      char_ptr = g_utf8_next_char(str);
-      str_len -= char_ptr - str;
-      str = char_ptr;
+  if (G_LIKELY(special_count == 0))
+    {
+      g_string_append_len(escaped_string, str, str_len);
+      return;
+    }
+
+  gsize start = escaped_string->len;
+  g_string_set_size(escaped_string, start + (str_len - special_count) +
+                    special_count * TF_CEF_MAX_ESCAPED_LENGTH_PER_BYTE);
+
+  gchar *dst = escaped_string->str + start;
+  gchar *dst_end = escaped_string->str + escaped_string->len;
+  const gchar *str_end = str + str_len;
+  while (str < str_end)
+    {
+      gsize plain_len = str_scan_plain_ascii(&specials, str, str_end - str);
+      memcpy(dst, str, plain_len);
+      dst += plain_len;
+      str += plain_len;
+
+      /* dst_end is followed by the room of the NUL terminator */
+      if (str < str_end)
+        dst += tf_cef_write_escaped_character(dst, dst_end - dst + 1, &str, str_end - str);
     }
+  g_string_truncate(escaped_string, dst - escaped_string->str);
 }
 
 static gboolean
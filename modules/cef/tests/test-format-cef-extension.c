@@ -168,6 +168,14 @@ Test(format_cef, test_charset)
   _EXPECT_DROP_MESSAGE(".cef.k\xc3", "v");
 }
 
+Test(format_cef, test_escaping_long_values)
+{
+  _EXPECT_CEF_RESULT("act=0123456789abcdefghijklmnopqrstuvwxyz\\=0123456789abcdefghijklmnopqrstuvwxyz\\n\\u0001",
+                     ".cef.act", "0123456789abcdefghijklmnopqrstuvwxyz=0123456789abcdefghijklmnopqrstuvwxyz\n\x01");
+  _EXPECT_CEF_RESULT("act=0123456789abcdefghijklmnopqrstuvwxyz árvíztűrőtükörfúrógép 0123456789abcdefghijklmnopqrstuvwxyz",
+                     ".cef.act", "0123456789abcdefghijklmnopqrstuvwxyz árvíztűrőtükörfúrógép 0123456789abcdefghijklmnopqrstuvwxyz");
+}
+
 Test(format_cef, test_escaping)
 {
   _EXPECT_CEF_RESULT("act=\\\\", ".cef.act", "\\");
@@ -32,6 +32,18 @@ disk_queue_options_front_cache_size_set(DiskQueueOptions *self, gint front_cache
   self->front_cache_size = front_cache_size;
 }
 
+void
+disk_queue_options_front_cache_bytes_set(DiskQueueOptions *self, gint64 front_cache_bytes)
+{
+  self->front_cache_bytes = front_cache_bytes;
+}
+
+void
+disk_queue_options_prefetch_set(DiskQueueOptions *self, gboolean prefetch)
+{
+  self->prefetch = prefetch;
+}
+
 void
 disk_queue_options_capacity_bytes_set(DiskQueueOptions *self, gint64 capacity_bytes)
 {
@@ -91,6 +103,10 @@ disk_queue_options_check_plugin_settings(DiskQueueOptions *self)
         {
           msg_warning("WARNING: flow-control-window-size/mem-buf-length parameter was ignored as it is not compatible with reliable queue. Did you mean flow-control-window-bytes?");
         }
+      if (self->front_cache_bytes > 0)
+        {
+          msg_warning("WARNING: front-cache-bytes() parameter was ignored as it is only supported by the non-reliable queue");
+        }
     }
   else
     {
@@ -131,6 +147,8 @@ disk_queue_options_set_default_options(DiskQueueOptions *self)
   self->reliable = FALSE;
   self->flow_control_window_bytes = -1;
   self->front_cache_size = -1;
+  self->front_cache_bytes = -1;
+  self->prefetch = FALSE;
   self->dir = g_strdup(get_installation_path_for(SYSLOG_NG_PATH_LOCALSTATEDIR));
   self->truncate_size_ratio = -1;
   self->prealloc = -1;
@@ -33,6 +33,8 @@ typedef struct _DiskQueueOptions
 {
   gint64 capacity_bytes;
   gint front_cache_size;
+  gint64 front_cache_bytes;
+  gboolean prefetch;
   gboolean read_only;
   gboolean reliable;
   gboolean compaction;
@@ -44,6 +46,8 @@ typedef struct _DiskQueueOptions
 } DiskQueueOptions;
 
 void disk_queue_options_front_cache_size_set(DiskQueueOptions *self, gint front_cache_size);
+void disk_queue_options_front_cache_bytes_set(DiskQueueOptions *self, gint64 front_cache_bytes);
+void disk_queue_options_prefetch_set(DiskQueueOptions *self, gboolean prefetch);
 void disk_queue_options_capacity_bytes_set(DiskQueueOptions *self, gint64 capacity_bytes);
 void disk_queue_options_reliable_set(DiskQueueOptions *self, gboolean reliable);
 void disk_queue_options_compaction_set(DiskQueueOptions *self, gboolean compaction);
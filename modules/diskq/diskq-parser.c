@@ -41,6 +41,8 @@ static CfgLexerKeyword diskq_keywords[] =
   { "flow_control_window_bytes", KW_FLOW_CONTROL_WINDOW_BYTES },
   { "qout_size",         KW_FRONT_CACHE_SIZE },
   { "front_cache_size",  KW_FRONT_CACHE_SIZE },
+  { "front_cache_bytes", KW_FRONT_CACHE_BYTES },
+  { "prefetch",          KW_PREFETCH },
   { "dir",               KW_DIR },
   { "truncate_size_ratio", KW_TRUNCATE_SIZE_RATIO },
   { "prealloc",          KW_PREALLOC },
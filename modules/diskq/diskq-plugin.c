@@ -23,6 +23,7 @@
 
 #include "cfg-parser.h"
 #include "diskq-global-metrics.h"
+#include "logqueue-disk.h"
 #include "plugin.h"
 #include "plugin-types.h"
 
@@ -59,5 +60,6 @@ disk_buffer_module_init(PluginContext *context, CfgArgs *args)
 {
   plugin_register(context, diskq_plugins, G_N_ELEMENTS(diskq_plugins));
   diskq_global_metrics_init();
+  log_queue_disk_global_init();
   return TRUE;
 }
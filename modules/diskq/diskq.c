@@ -299,7 +299,7 @@ _attach(LogDriverPlugin *s, LogDriver *d)
   if (self->options.flow_control_window_size < 0)
     self->options.flow_control_window_size = cfg->log_fifo_size;
   if (self->options.front_cache_size < 0)
-    self->options.front_cache_size = 1000;
+    self->options.front_cache_size = self->options.front_cache_bytes > 0 ? G_MAXINT : 1000;
 
   if (!_set_truncate_size_ratio_and_prealloc(self, dd))
     return FALSE;
@@ -28,6 +28,7 @@
 #include "scratch-buffers.h"
 
 #define ITEM_NUMBER_PER_MESSAGE 2
+#define PREFETCH_BATCH_SIZE 64
 
 static void
 _update_memory_usage_during_load(LogQueueDiskNonReliable *s, GQueue *memory_queue, guint offset)
@@ -40,6 +41,9 @@ _update_memory_usage_during_load(LogQueueDiskNonReliable *s, GQueue *memory_queu
     {
       LogMessage *msg = (LogMessage *) msg_link->data;
       log_queue_memory_usage_add(&s->super.super, log_msg_get_size(msg));
+
+      if (memory_queue == s->front_cache)
+        s->front_cache_memory_usage += log_msg_get_size(msg);
     }
 }
 
@@ -48,6 +52,9 @@ _start(LogQueueDisk *s)
 {
   LogQueueDiskNonReliable *self = (LogQueueDiskNonReliable *) s;
 
+  /* a restarted queue prefetches again, _stop() has already waited for the last prefetch to finish */
+  self->prefetch.stopping = FALSE;
+
   guint front_cache_length_before_start = g_queue_get_length(self->front_cache);
   guint backlog_length_before_start = g_queue_get_length(self->backlog);
   guint flow_control_window_length_before_start = g_queue_get_length(self->flow_control_window);
@@ -82,10 +89,30 @@ _get_length(LogQueue *s)
          + _get_message_number_in_queue(self->flow_control_window);
 }
 
+/* with front-cache-bytes() set, the front cache is limited by its memory
+ * usage, so it can hold everything while the destination keeps up, and the
+ * queue only spills to disk when this budget is exhausted */
+static inline gboolean
+_front_cache_has_space(LogQueueDiskNonReliable *self)
+{
+  if (!HAS_SPACE_IN_QUEUE(self->front_cache))
+    return FALSE;
+
+  return self->front_cache_bytes <= 0 || self->front_cache_memory_usage < self->front_cache_bytes;
+}
+
 static inline gboolean
 _can_push_to_front_cache(LogQueueDiskNonReliable *self)
 {
-  return HAS_SPACE_IN_QUEUE(self->front_cache) && qdisk_get_length(self->super.qdisk) == 0;
+  return _front_cache_has_space(self) && qdisk_get_length(self->super.qdisk) == 0;
+}
+
+static inline void
+_front_cache_push_tail(LogQueueDiskNonReliable *self, LogMessage *msg, gpointer path_options)
+{
+  g_queue_push_tail(self->front_cache, msg);
+  g_queue_push_tail(self->front_cache, path_options);
+  self->front_cache_memory_usage += log_msg_get_size(msg);
 }
 
 static inline gboolean
@@ -126,8 +153,7 @@ _move_messages_from_overflow(LogQueueDiskNonReliable *self)
       if (_can_push_to_front_cache(self))
         {
           /* we can skip qdisk, go straight to front_cache */
-          g_queue_push_tail(self->front_cache, msg);
-          g_queue_push_tail(self->front_cache, LOG_PATH_OPTIONS_FOR_BACKLOG);
+          _front_cache_push_tail(self, msg, LOG_PATH_OPTIONS_FOR_BACKLOG);
           log_msg_ack(msg, &path_options, AT_PROCESSED);
         }
       else
@@ -153,6 +179,21 @@ _move_messages_from_overflow(LogQueueDiskNonReliable *self)
     }
 }
 
+static gboolean
+_move_message_from_disk_to_front_cache(LogQueueDiskNonReliable *self)
+{
+  LogPathOptions path_options;
+  LogMessage *msg = log_queue_disk_read_message(&self->super, &path_options);
+
+  if (!msg)
+    return FALSE;
+
+  _front_cache_push_tail(self, msg, LOG_PATH_OPTIONS_TO_POINTER(&path_options));
+  log_queue_memory_usage_add(&self->super.super, log_msg_get_size(msg));
+  log_queue_disk_update_disk_related_counters(&self->super);
+  return TRUE;
+}
+
 static gboolean
 _move_messages_from_disk_to_front_cache(LogQueueDiskNonReliable *self)
 {
@@ -161,22 +202,97 @@ _move_messages_from_disk_to_front_cache(LogQueueDiskNonReliable *self)
       if (qdisk_get_length(self->super.qdisk) <= 0)
         break;
 
-      LogPathOptions path_options;
-      LogMessage *msg = log_queue_disk_read_message(&self->super, &path_options);
+      if (!_move_message_from_disk_to_front_cache(self))
+        return FALSE;
+    }
+  while (_front_cache_has_space(self));
 
-      if (!msg)
+  return TRUE;
+}
+
+/*
+ * Prefetching: instead of deserializing a whole front cache worth of
+ * messages in the destination's thread once the front cache runs empty,
+ * the front cache is refilled in the background as soon as it drops below
+ * half of its size.  The refill happens in small batches, so producers and
+ * the consumer can grab the lock in between.
+ *
+ * Ordering is kept without any extra synchronization: the front cache
+ * always holds the messages preceding the ones on disk, so whether the
+ * consumer finds the next message in the front cache or reads it from the
+ * disk itself because prefetching did not catch up, it is the same message.
+ */
+static inline gboolean
+_front_cache_below_low_watermark(LogQueueDiskNonReliable *self)
+{
+  if (self->front_cache_bytes > 0)
+    return self->front_cache_memory_usage < self->front_cache_bytes / 2;
+
+  return _get_message_number_in_queue(self->front_cache) <= self->front_cache_size / 2;
+}
+
+static gboolean
+_prefetch_batch(LogQueueDiskNonReliable *self)
+{
+  for (gint i = 0; i < PREFETCH_BATCH_SIZE; i++)
+    {
+      if (self->prefetch.stopping || !qdisk_started(self->super.qdisk) || qdisk_is_read_only(self->super.qdisk))
         return FALSE;
 
-      g_queue_push_tail(self->front_cache, msg);
-      g_queue_push_tail(self->front_cache, LOG_PATH_OPTIONS_TO_POINTER(&path_options));
-      log_queue_memory_usage_add(&self->super.super, log_msg_get_size(msg));
-      log_queue_disk_update_disk_related_counters(&self->super);
+      if (qdisk_get_length(self->super.qdisk) <= 0 || !_front_cache_has_space(self))
+        return FALSE;
+
+      if (!_move_message_from_disk_to_front_cache(self))
+        return FALSE;
     }
-  while (HAS_SPACE_IN_QUEUE(self->front_cache));
 
   return TRUE;
 }
 
+static void
+_prefetch_worker(LogQueueDisk *s)
+{
+  LogQueueDiskNonReliable *self = (LogQueueDiskNonReliable *) s;
+  GMutex *lock = &self->super.super.lock;
+
+  gboolean more;
+  do
+    {
+      g_mutex_lock(lock);
+      more = _prefetch_batch(self);
+      g_mutex_unlock(lock);
+    }
+  while (more);
+
+  g_mutex_lock(lock);
+  self->prefetch.scheduled = FALSE;
+  g_cond_broadcast(&self->prefetch.finished);
+  g_mutex_unlock(lock);
+}
+
+/* must be called with the queue's lock held */
+static void
+_maybe_schedule_prefetch(LogQueueDiskNonReliable *self)
+{
+  if (self->prefetch.scheduled || self->prefetch.stopping)
+    return;
+
+  if (qdisk_get_length(self->super.qdisk) <= 0 || !_front_cache_below_low_watermark(self))
+    return;
+
+  self->prefetch.scheduled = TRUE;
+  log_queue_disk_run_in_helper_thread(&self->super, _prefetch_worker);
+}
+
+/* must be called with the queue's lock held */
+static void
+_wait_for_prefetch(LogQueueDiskNonReliable *self)
+{
+  self->prefetch.stopping = TRUE;
+  while (self->prefetch.scheduled)
+    g_cond_wait(&self->prefetch.finished, &self->super.super.lock);
+}
+
 static inline gboolean
 _maybe_move_messages_among_queue_segments(LogQueueDiskNonReliable *self)
 {
@@ -185,7 +301,9 @@ _maybe_move_messages_among_queue_segments(LogQueueDiskNonReliable *self)
   if (qdisk_is_read_only(self->super.qdisk))
     return TRUE;
 
-  if (self->front_cache->length == 0 && self->front_cache_size > 0)
+  if (self->prefetch.enabled && self->front_cache_size > 0)
+    _maybe_schedule_prefetch(self);
+  else if (self->front_cache->length == 0 && self->front_cache_size > 0)
     ret = _move_messages_from_disk_to_front_cache(self);
 
   if (self->flow_control_window->length > 0)
@@ -232,6 +350,7 @@ _rewind_backlog(LogQueue *s, guint rewind_count)
 
       g_queue_push_head(self->front_cache, ptr_opt);
       g_queue_push_head(self->front_cache, ptr_msg);
+      self->front_cache_memory_usage += log_msg_get_size((LogMessage *) ptr_msg);
 
       log_queue_queued_messages_inc(s);
     }
@@ -251,6 +370,7 @@ _pop_head_front_cache(LogQueueDiskNonReliable *self, LogPathOptions *path_option
   LogMessage *msg = g_queue_pop_head(self->front_cache);
   POINTER_TO_LOG_PATH_OPTIONS(g_queue_pop_head(self->front_cache), path_options);
   log_queue_memory_usage_sub(&self->super.super, log_msg_get_size(msg));
+  self->front_cache_memory_usage -= log_msg_get_size(msg);
 
   return msg;
 }
@@ -389,8 +509,7 @@ _push_tail_front_cache(LogQueueDiskNonReliable *self, LogMessage *msg, const Log
   /* simple push never generates flow-control enabled entries to front_cache, they only get there
    * when rewinding the backlog */
 
-  g_queue_push_tail(self->front_cache, msg);
-  g_queue_push_tail(self->front_cache, LOG_PATH_OPTIONS_FOR_BACKLOG);
+  _front_cache_push_tail(self, msg, LOG_PATH_OPTIONS_FOR_BACKLOG);
 
   log_queue_memory_usage_add(&self->super.super, log_msg_get_size(msg));
 
@@ -503,6 +622,9 @@ _empty_queue(LogQueueDiskNonReliable *self, GQueue *q)
       log_msg_ack(lm, &path_options, AT_PROCESSED);
       log_msg_unref(lm);
     }
+
+  if (q == self->front_cache)
+    self->front_cache_memory_usage = 0;
 }
 
 static void
@@ -532,6 +654,7 @@ _free(LogQueue *s)
       self->flow_control_window = NULL;
     }
 
+  g_cond_clear(&self->prefetch.finished);
   log_queue_disk_free_method(&self->super);
 }
 
@@ -542,6 +665,10 @@ _stop(LogQueueDisk *s, gboolean *persistent)
 
   gboolean result = FALSE;
 
+  g_mutex_lock(&self->super.super.lock);
+  _wait_for_prefetch(self);
+  g_mutex_unlock(&self->super.super.lock);
+
   if (qdisk_stop(s->qdisk, self->front_cache, self->backlog, self->flow_control_window))
     {
       *persistent = TRUE;
@@ -602,6 +729,9 @@ log_queue_disk_non_reliable_new(DiskQueueOptions *options, const gchar *filename
   self->front_cache = g_queue_new();
   self->flow_control_window = g_queue_new();
   self->front_cache_size = options->front_cache_size;
+  self->front_cache_bytes = options->front_cache_bytes;
+  self->prefetch.enabled = options->prefetch;
+  g_cond_init(&self->prefetch.finished);
   self->flow_control_window_size = options->flow_control_window_size;
   _set_virtual_functions(self);
   return &self->super.super;
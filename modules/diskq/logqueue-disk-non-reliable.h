@@ -34,6 +34,16 @@ typedef struct _LogQueueDiskNonReliable
   GQueue *backlog;
   gint flow_control_window_size;
   gint front_cache_size;
+  gint64 front_cache_bytes;
+  gsize front_cache_memory_usage;
+
+  struct
+  {
+    gboolean enabled;
+    gboolean scheduled;
+    gboolean stopping;
+    GCond finished;
+  } prefetch;
 } LogQueueDiskNonReliable;
 
 LogQueue *log_queue_disk_non_reliable_new(DiskQueueOptions *options, const gchar *filename, const gchar *persist_name,
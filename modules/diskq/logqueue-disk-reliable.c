@@ -68,15 +68,6 @@ _start(LogQueueDisk *s)
   return qdisk_start(s->qdisk, NULL, NULL, NULL);
 }
 
-static gboolean
-_skip_message(LogQueueDisk *self)
-{
-  if (!qdisk_started(self->qdisk))
-    return FALSE;
-
-  return qdisk_remove_head(self->qdisk);
-}
-
 static void
 _empty_queue(LogQueueDiskReliable *self, GQueue *queue)
 {
@@ -195,6 +186,7 @@ _rewind_backlog(LogQueue *s, guint rewind_count)
 
   rewind_count = MIN(rewind_count, qdisk_get_backlog_count(self->super.qdisk));
   qdisk_rewind_backlog(self->super.qdisk, rewind_count);
+  log_queue_disk_reset_readahead(&self->super);
   _rewind_from_backlog(self, qdisk_get_next_head_position(self->super.qdisk));
 
   log_queue_queued_messages_add(s, rewind_count);
@@ -268,7 +260,7 @@ _pop_head(LogQueue *s, LogPathOptions *path_options)
       _pop_from_memory_queue_head(self->flow_control_window, &position, &msg, path_options);
       log_queue_memory_usage_sub(s, log_msg_get_size(msg));
 
-      if (!_skip_message(&self->super))
+      if (!log_queue_disk_skip_message(&self->super))
         qdisk_corrupt = TRUE;
 
       /* push to backlog */
@@ -288,7 +280,7 @@ _pop_head(LogQueue *s, LogPathOptions *path_options)
       _pop_from_memory_queue_head(self->front_cache, &position, &msg, path_options);
       log_queue_memory_usage_sub(s, log_msg_get_size(msg));
 
-      if (!_skip_message(&self->super))
+      if (!log_queue_disk_skip_message(&self->super))
         qdisk_corrupt = TRUE;
 
       goto exit;
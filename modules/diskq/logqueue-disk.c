@@ -31,6 +31,7 @@
 #include "reloc.h"
 #include "qdisk.h"
 #include "scratch-buffers.h"
+#include "apphook.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -44,14 +45,91 @@
 
 #define B_TO_KiB(x) ((x) / 1024)
 
+#define READAHEAD_BATCH_SIZE 32
+#define READAHEAD_MAX_MESSAGES 256
+#define READAHEAD_POSITION_UNSET -1
+
+#define HELPER_MAX_THREADS 4
+
+typedef struct _HelperJob
+{
+  LogQueueDisk *queue;
+  LogQueueDiskHelperFunc func;
+} HelperJob;
+
+/* shared by the disk-buffers of the process, freed at shutdown */
+static GThreadPool *helper_pool;
+static GMutex helper_pool_lock;
+
 QueueType log_queue_disk_type = "DISK";
 
+static void _stop_readahead(LogQueueDisk *self);
+
+static void
+_helper_thread_run(gpointer data, gpointer user_data)
+{
+  HelperJob *job = (HelperJob *) data;
+
+  /* pool threads are not worker threads, set them up the same way for the
+   * duration of the job: reading messages needs scratch buffers, for one */
+  app_thread_start();
+  job->func(job->queue);
+  scratch_buffers_explicit_gc();
+  app_thread_stop();
+
+  log_queue_unref(&job->queue->super);
+  g_free(job);
+}
+
+void
+log_queue_disk_run_in_helper_thread(LogQueueDisk *self, LogQueueDiskHelperFunc func)
+{
+  HelperJob *job = g_new(HelperJob, 1);
+
+  job->queue = self;
+  job->func = func;
+  log_queue_ref(&self->super);
+
+  g_mutex_lock(&helper_pool_lock);
+  if (!helper_pool)
+    helper_pool = g_thread_pool_new(_helper_thread_run, NULL, HELPER_MAX_THREADS, FALSE, NULL);
+  g_thread_pool_push(helper_pool, job, NULL);
+  g_mutex_unlock(&helper_pool_lock);
+}
+
+/* the queues are stopped by now, which waits for their helper jobs */
+static void
+_free_helper_pool(gint type, gpointer user_data)
+{
+  g_mutex_lock(&helper_pool_lock);
+  GThreadPool *pool = helper_pool;
+  helper_pool = NULL;
+  g_mutex_unlock(&helper_pool_lock);
+
+  if (pool)
+    g_thread_pool_free(pool, FALSE, TRUE);
+}
+
+void
+log_queue_disk_global_init(void)
+{
+  static gboolean initialized = FALSE;
+
+  if (initialized)
+    return;
+
+  register_application_hook(AH_SHUTDOWN, _free_helper_pool, NULL, AHM_RUN_ONCE);
+  initialized = TRUE;
+}
+
 gboolean
 log_queue_disk_stop(LogQueue *s, gboolean *persistent)
 {
   LogQueueDisk *self = (LogQueueDisk *) s;
   g_assert(self->stop);
 
+  _stop_readahead(self);
+
   if (!qdisk_started(self->qdisk))
     {
       *persistent = FALSE;
@@ -71,6 +149,10 @@ log_queue_disk_start(LogQueue *s)
   g_assert(!qdisk_started(self->qdisk));
   g_assert(self->start);
 
+  /* a restarted queue reads ahead again, _stop_readahead() has waited for the helper thread */
+  g_assert(!self->readahead.scheduled);
+  self->readahead.stopping = FALSE;
+
   if (self->start(self))
     {
       log_queue_queued_messages_add(s, log_queue_get_length(s));
@@ -125,6 +207,12 @@ void
 log_queue_disk_free_method(LogQueueDisk *self)
 {
   g_assert(!qdisk_started(self->qdisk));
+  g_assert(!self->readahead.scheduled);
+
+  log_queue_disk_reset_readahead(self);
+  g_queue_free(self->readahead.ready);
+  g_cond_clear(&self->readahead.finished);
+
   qdisk_free(self->qdisk);
 
   _unregister_counters(self);
@@ -205,10 +293,257 @@ _peek_disk(LogQueueDisk *self, LogMessage **msg)
   return TRUE;
 }
 
+/*
+ * Readahead: while draining a backlog, a helper thread reads the records
+ * following the read head and deserializes them into a bounded ready
+ * queue, so the destination's thread only has to skip the record on disk.
+ *
+ * The ready queue holds position-message pairs, contiguous on disk.  It is
+ * only used while its head is the next record to be read; every move of
+ * the read head outside of _pop_readahead() either drops the matching head
+ * entry (see log_queue_disk_skip_message()) or the whole queue (rewinds,
+ * reading directly from disk), discarding the batches in flight by bumping
+ * the generation.  A stale entry must never survive, as its position may
+ * become valid again once the file has wrapped around.
+ */
+static inline gboolean
+_readahead_is_full(LogQueueDisk *self)
+{
+  return g_queue_get_length(self->readahead.ready) / 2 >= READAHEAD_MAX_MESSAGES;
+}
+
+void
+log_queue_disk_reset_readahead(LogQueueDisk *self)
+{
+  while (!g_queue_is_empty(self->readahead.ready))
+    {
+      g_free(g_queue_pop_head(self->readahead.ready));
+      log_msg_unref((LogMessage *) g_queue_pop_head(self->readahead.ready));
+    }
+
+  self->readahead.next_position = READAHEAD_POSITION_UNSET;
+  self->readahead.generation++;
+}
+
+typedef struct _ReadaheadRecord
+{
+  gint64 position;
+  GString *serialized;
+  LogMessage *msg;
+} ReadaheadRecord;
+
+/* runs under the queue's lock, returns FALSE if there is nothing to read */
+static gboolean
+_readahead_prepare(LogQueueDisk *self, gint64 *position, QDiskReadableRange *range)
+{
+  if (self->readahead.stopping || !qdisk_started(self->qdisk) || _readahead_is_full(self))
+    return FALSE;
+
+  /* the ready queue is contiguous with the read head, an empty one starts right at it */
+  *position = self->readahead.next_position;
+  if (*position == READAHEAD_POSITION_UNSET || g_queue_is_empty(self->readahead.ready))
+    *position = qdisk_get_next_head_position(self->qdisk);
+
+  qdisk_get_readable_range(self->qdisk, range);
+  return TRUE;
+}
+
+/*
+ * Runs without the queue's lock: the records of the range are only
+ * overwritten after the reader consumed them, which resets the readahead
+ * and with that discards what we read here.  The queue is not stopped
+ * either while a readahead is scheduled.
+ */
+static gint
+_readahead_read_records(LogQueueDisk *self, const QDiskReadableRange *range, gint64 position,
+                        ReadaheadRecord *records, gint64 *next_position)
+{
+  gint num_records = 0;
+  for (; num_records < READAHEAD_BATCH_SIZE; num_records++)
+    {
+      records[num_records].position = position;
+      if (!qdisk_read_record_at(self->qdisk, range, &position, records[num_records].serialized))
+        break;
+    }
+
+  *next_position = position;
+  return num_records;
+}
+
+static void
+_readahead_deserialize_records(LogQueueDisk *self, ReadaheadRecord *records, gint *num_records)
+{
+  for (gint i = 0; i < *num_records; i++)
+    {
+      /* leave the broken record to the reader, which handles the corruption */
+      if (!log_queue_disk_deserialize_msg(self, records[i].serialized, &records[i].msg))
+        {
+          *num_records = i;
+          return;
+        }
+    }
+}
+
+/* runs under the queue's lock */
+static void
+_readahead_publish_records(LogQueueDisk *self, ReadaheadRecord *records, gint num_records, gint64 next_position)
+{
+  for (gint i = 0; i < num_records; i++)
+    {
+      gint64 *allocated_position = g_new(gint64, 1);
+      *allocated_position = records[i].position;
+
+      g_queue_push_tail(self->readahead.ready, allocated_position);
+      g_queue_push_tail(self->readahead.ready, records[i].msg);
+      records[i].msg = NULL;
+    }
+
+  self->readahead.next_position = next_position;
+}
+
+static void
+_readahead_worker(LogQueueDisk *self)
+{
+  ReadaheadRecord records[READAHEAD_BATCH_SIZE];
+
+  for (gint i = 0; i < READAHEAD_BATCH_SIZE; i++)
+    {
+      records[i].serialized = g_string_sized_new(1024);
+      records[i].msg = NULL;
+    }
+
+  gint num_records;
+  do
+    {
+      QDiskReadableRange range;
+      gint64 position, next_position;
+
+      g_mutex_lock(&self->super.lock);
+      guint generation = self->readahead.generation;
+      gboolean readable = _readahead_prepare(self, &position, &range);
+      g_mutex_unlock(&self->super.lock);
+
+      num_records = readable ? _readahead_read_records(self, &range, position, records, &next_position) : 0;
+
+      gint num_read = num_records;
+      _readahead_deserialize_records(self, records, &num_records);
+      if (num_records < num_read)
+        next_position = records[num_records].position;
+
+      g_mutex_lock(&self->super.lock);
+      if (generation == self->readahead.generation && num_records > 0)
+        _readahead_publish_records(self, records, num_records, next_position);
+      else
+        num_records = 0;
+      g_mutex_unlock(&self->super.lock);
+
+      for (gint i = 0; i < num_read; i++)
+        {
+          if (records[i].msg)
+            log_msg_unref(records[i].msg);
+          records[i].msg = NULL;
+        }
+    }
+  while (num_records == READAHEAD_BATCH_SIZE);
+
+  for (gint i = 0; i < READAHEAD_BATCH_SIZE; i++)
+    g_string_free(records[i].serialized, TRUE);
+
+  g_mutex_lock(&self->super.lock);
+  self->readahead.scheduled = FALSE;
+  g_cond_broadcast(&self->readahead.finished);
+  g_mutex_unlock(&self->super.lock);
+}
+
+/* runs under the queue's lock */
+static void
+_maybe_schedule_readahead(LogQueueDisk *self)
+{
+  if (!self->readahead.enabled || self->readahead.scheduled || self->readahead.stopping)
+    return;
+
+  if (g_queue_get_length(self->readahead.ready) / 2 > READAHEAD_MAX_MESSAGES / 2)
+    return;
+
+  if (qdisk_get_length(self->qdisk) <= g_queue_get_length(self->readahead.ready) / 2)
+    return;
+
+  self->readahead.scheduled = TRUE;
+  log_queue_disk_run_in_helper_thread(self, _readahead_worker);
+}
+
+static void
+_stop_readahead(LogQueueDisk *self)
+{
+  g_mutex_lock(&self->super.lock);
+  self->readahead.stopping = TRUE;
+  while (self->readahead.scheduled)
+    g_cond_wait(&self->readahead.finished, &self->super.lock);
+  log_queue_disk_reset_readahead(self);
+  g_mutex_unlock(&self->super.lock);
+}
+
+/*
+ * Advances the read head past a record that has been consumed from one of
+ * the memory queues of the disk-buffer.  Its readahead copy is dropped too,
+ * any other entry (or batch in flight) would be stale from now on.
+ *
+ * Runs under the queue's lock.
+ */
+gboolean
+log_queue_disk_skip_message(LogQueueDisk *self)
+{
+  if (!qdisk_started(self->qdisk))
+    return FALSE;
+
+  gint64 position = qdisk_get_next_head_position(self->qdisk);
+  if (!qdisk_remove_head(self->qdisk))
+    return FALSE;
+
+  if (g_queue_is_empty(self->readahead.ready) || *(gint64 *) g_queue_peek_head(self->readahead.ready) != position)
+    {
+      log_queue_disk_reset_readahead(self);
+      return TRUE;
+    }
+
+  g_free(g_queue_pop_head(self->readahead.ready));
+  log_msg_unref((LogMessage *) g_queue_pop_head(self->readahead.ready));
+  return TRUE;
+}
+
+/* runs under the queue's lock */
+static LogMessage *
+_pop_readahead(LogQueueDisk *self)
+{
+  if (g_queue_is_empty(self->readahead.ready))
+    return NULL;
+
+  gint64 *position = g_queue_peek_head(self->readahead.ready);
+  if (*position != qdisk_get_next_head_position(self->qdisk))
+    return NULL;
+
+  if (!qdisk_remove_head(self->qdisk))
+    return NULL;
+
+  g_free(g_queue_pop_head(self->readahead.ready));
+  return g_queue_pop_head(self->readahead.ready);
+}
+
 LogMessage *
 log_queue_disk_read_message(LogQueueDisk *self, LogPathOptions *path_options)
 {
-  LogMessage *msg = NULL;
+  LogMessage *msg = _pop_readahead(self);
+
+  if (msg)
+    {
+      path_options->ack_needed = FALSE;
+      _maybe_schedule_readahead(self);
+      return msg;
+    }
+
+  if (self->readahead.enabled)
+    log_queue_disk_reset_readahead(self);
+
   do
     {
       if (qdisk_get_length(self->qdisk) == 0)
@@ -235,6 +570,7 @@ log_queue_disk_read_message(LogQueueDisk *self, LogPathOptions *path_options)
   if (msg)
     path_options->ack_needed = FALSE;
 
+  _maybe_schedule_readahead(self);
   return msg;
 }
 
@@ -346,6 +682,7 @@ _restart_diskq(LogQueueDisk *self)
 void
 log_queue_disk_restart_corrupted(LogQueueDisk *self)
 {
+  log_queue_disk_reset_readahead(self);
   _restart_diskq(self);
   log_queue_queued_messages_reset(&self->super);
   log_queue_disk_update_disk_related_counters(self);
@@ -406,6 +743,11 @@ log_queue_disk_init_instance(LogQueueDisk *self, DiskQueueOptions *options, cons
 
   self->compaction = options->compaction;
 
+  self->readahead.enabled = options->prefetch;
+  self->readahead.next_position = READAHEAD_POSITION_UNSET;
+  self->readahead.ready = g_queue_new();
+  g_cond_init(&self->readahead.finished);
+
   self->qdisk = qdisk_new(options, qdisk_file_id, filename);
   _register_counters(self, stats_level, queue_sck_builder);
 
@@ -30,6 +30,7 @@
 #include "logmsg/logmsg-serialize.h"
 
 typedef struct _LogQueueDisk LogQueueDisk;
+typedef void (*LogQueueDiskHelperFunc)(LogQueueDisk *self);
 
 struct _LogQueueDisk
 {
@@ -52,6 +53,18 @@ struct _LogQueueDisk
     StatsCounterItem *disk_allocated;
   } metrics;
 
+  /* messages read and deserialized ahead of the reader on a helper thread */
+  struct
+  {
+    gboolean enabled;
+    gboolean scheduled;
+    gboolean stopping;
+    guint generation;
+    gint64 next_position;
+    GQueue *ready;
+    GCond finished;
+  } readahead;
+
   gboolean compaction;
   gboolean (*start)(LogQueueDisk *s);
   gboolean (*stop)(LogQueueDisk *s, gboolean *persistent);
@@ -68,10 +81,14 @@ void log_queue_disk_init_instance(LogQueueDisk *self, DiskQueueOptions *options,
                                   StatsClusterKeyBuilder *driver_sck_builder,
                                   StatsClusterKeyBuilder *queue_sck_builder);
 void log_queue_disk_restart_corrupted(LogQueueDisk *self);
+void log_queue_disk_reset_readahead(LogQueueDisk *self);
 void log_queue_disk_free_method(LogQueueDisk *self);
+void log_queue_disk_run_in_helper_thread(LogQueueDisk *self, LogQueueDiskHelperFunc func);
+void log_queue_disk_global_init(void);
 
 void log_queue_disk_update_disk_related_counters(LogQueueDisk *self);
 LogMessage *log_queue_disk_read_message(LogQueueDisk *self, LogPathOptions *path_options);
+gboolean log_queue_disk_skip_message(LogQueueDisk *self);
 LogMessage *log_queue_disk_peek_message(LogQueueDisk *self);
 void log_queue_disk_drop_message(LogQueueDisk *self, LogMessage *msg, const LogPathOptions *path_options);
 gboolean log_queue_disk_serialize_msg(LogQueueDisk *self, LogMessage *msg, GString *serialized);
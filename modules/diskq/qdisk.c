@@ -48,6 +48,7 @@
 #endif
 
 #define MAX_RECORD_LENGTH 100 * 1024 * 1024
+#define QDISK_READAHEAD_SIZE (4 * 1024 * 1024)
 
 #define PATH_QDISK              PATH_LOCALSTATEDIR
 
@@ -102,6 +103,11 @@ struct _QDisk
   gint64 cached_file_size;
   QDiskFileHeader *hdr;
   DiskQueueOptions *options;
+  struct
+  {
+    gint64 start;
+    gint64 end;
+  } readahead;
 };
 
 #define QDISK_ERROR qdisk_error_quark()
@@ -830,12 +836,29 @@ _try_reading_record_length(QDisk *self, gint64 position, guint32 *record_length)
   return TRUE;
 }
 
+/* Draining a large backlog reads the file sequentially in small records,
+ * ask the kernel to read it ahead in big chunks instead, so the reader does
+ * not wait for the disk record by record.  Wrapping around simply starts a
+ * new window. */
+static inline void
+_maybe_read_ahead(QDisk *self, gint64 position)
+{
+#ifdef SYSLOG_NG_HAVE_POSIX_FADVISE
+  if (position >= self->readahead.start && position + QDISK_READAHEAD_SIZE / 2 < self->readahead.end)
+    return;
+
+  posix_fadvise(self->fd, position, QDISK_READAHEAD_SIZE, POSIX_FADV_WILLNEED);
+  self->readahead.start = position;
+  self->readahead.end = position + QDISK_READAHEAD_SIZE;
+#endif
+}
+
 static inline gboolean
-_read_record_from_disk(QDisk *self, GString *record, guint32 record_length)
+_pread_record(QDisk *self, gint64 position, GString *record, guint32 record_length)
 {
   g_string_set_size(record, record_length);
 
-  gssize bytes_read = pread(self->fd, record->str, record_length, self->hdr->read_head + sizeof(record_length));
+  gssize bytes_read = pread(self->fd, record->str, record_length, position + sizeof(record_length));
   if (bytes_read != record_length)
     {
       msg_error("Error reading disk-queue file",
@@ -849,6 +872,13 @@ _read_record_from_disk(QDisk *self, GString *record, guint32 record_length)
   return TRUE;
 }
 
+static inline gboolean
+_read_record_from_disk(QDisk *self, gint64 position, GString *record, guint32 record_length)
+{
+  _maybe_read_ahead(self, position);
+  return _pread_record(self, position, record, record_length);
+}
+
 static inline void
 _maybe_apply_non_reliable_corrections(QDisk *self)
 {
@@ -895,12 +925,48 @@ qdisk_peek_head(QDisk *self, GString *record)
   if (!_try_reading_record_length(self, self->hdr->read_head, &record_length))
     return FALSE;
 
-  if (!_read_record_from_disk(self, record, record_length))
+  if (!_read_record_from_disk(self, self->hdr->read_head, record, record_length))
     return FALSE;
 
   return TRUE;
 }
 
+void
+qdisk_get_readable_range(QDisk *self, QDiskReadableRange *range)
+{
+  range->write_head = self->hdr->write_head;
+  range->eof = self->hdr->use_v1_wrap_condition ? self->cached_file_size : G_MAXINT64;
+}
+
+/* Reads the record at @position without consuming it, and moves @position
+ * to the next record, wrapping it the same way the read head would be.
+ * Used to read ahead of the reader, so it must not change the queue: it
+ * only reads the file within @range, taken earlier under the queue's lock,
+ * and can run without the lock while the queue is started.  With legacy
+ * (v1) files it stops at the end of the file instead of wrapping. */
+gboolean
+qdisk_read_record_at(QDisk *self, const QDiskReadableRange *range, gint64 *position, GString *record)
+{
+  if (*position == range->write_head || *position >= range->eof)
+    return FALSE;
+
+  guint32 record_length;
+  if (!_try_reading_record_length(self, *position, &record_length))
+    return FALSE;
+
+  if (!_pread_record(self, *position, record, record_length))
+    return FALSE;
+
+  /* capacity_bytes does not change while the queue is started */
+  gint64 next_position = *position + record_length + sizeof(record_length);
+  gboolean wraps = range->eof == G_MAXINT64 && _has_position_reached_max_size(self, next_position);
+  if (next_position > range->write_head && wraps)
+    next_position = QDISK_RESERVED_SPACE;
+
+  *position = next_position;
+  return TRUE;
+}
+
 gboolean
 qdisk_pop_head(QDisk *self, GString *record)
 {
@@ -914,7 +980,7 @@ qdisk_pop_head(QDisk *self, GString *record)
   if (!_try_reading_record_length(self, self->hdr->read_head, &record_length))
     return FALSE;
 
-  if (!_read_record_from_disk(self, record, record_length))
+  if (!_read_record_from_disk(self, self->hdr->read_head, record, record_length))
     return FALSE;
 
   _update_position_after_read(self, record_length, &self->hdr->read_head);
@@ -1731,6 +1797,9 @@ qdisk_start(QDisk *self, GQueue *front_cache, GQueue *backlog, GQueue *flow_cont
   g_assert(!qdisk_started(self));
   g_assert(self->filename);
 
+  self->readahead.start = 0;
+  self->readahead.end = 0;
+
   struct stat st;
   gboolean file_exists = stat(self->filename, &st) != -1;
 
@@ -54,6 +54,14 @@ QDiskQueuePosition;
 
 typedef struct _QDisk QDisk;
 
+/* the records that can be read ahead of the reader, see qdisk_read_record_at() */
+typedef struct
+{
+  gint64 write_head;
+  /* legacy (v1) files are only read up to their end, G_MAXINT64 otherwise */
+  gint64 eof;
+} QDiskReadableRange;
+
 QDisk *qdisk_new(DiskQueueOptions *options, const gchar *file_id, const gchar *filename);
 
 gboolean qdisk_is_space_avail(QDisk *self, gint at_least);
@@ -63,6 +71,8 @@ gint64 qdisk_get_used_useful_space(QDisk *self);
 gboolean qdisk_push_tail(QDisk *self, GString *record);
 gboolean qdisk_pop_head(QDisk *self, GString *record);
 gboolean qdisk_peek_head(QDisk *self, GString *record);
+void qdisk_get_readable_range(QDisk *self, QDiskReadableRange *range);
+gboolean qdisk_read_record_at(QDisk *self, const QDiskReadableRange *range, gint64 *position, GString *record);
 gboolean qdisk_remove_head(QDisk *self);
 gboolean qdisk_ack_backlog(QDisk *self);
 gboolean qdisk_rewind_backlog(QDisk *self, guint rewind_count);
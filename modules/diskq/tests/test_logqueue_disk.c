@@ -414,6 +414,268 @@ Test(logqueue_disk, restart_corrupted_with_multiple_queues)
   stop_grabbing_messages();
 }
 
+static LogQueue *
+_create_non_reliable_queue_with_front_cache_bytes(const gchar *filename, DiskQueueOptions *options,
+                                                  gint64 front_cache_bytes, gboolean prefetch)
+{
+  disk_queue_options_set_default_options(options);
+  disk_queue_options_reliable_set(options, FALSE);
+  disk_queue_options_capacity_bytes_set(options, MIN_CAPACITY_BYTES);
+  disk_queue_options_flow_control_window_size_set(options, 100);
+  disk_queue_options_front_cache_size_set(options, G_MAXINT);
+  disk_queue_options_front_cache_bytes_set(options, front_cache_bytes);
+  disk_queue_options_prefetch_set(options, prefetch);
+
+  LogQueue *queue = log_queue_disk_non_reliable_new(options, filename, NULL, STATS_LEVEL0, NULL, NULL);
+  cr_assert(log_queue_disk_start(queue));
+  return queue;
+}
+
+static void
+_push_numbered_messages(LogQueue *queue, gint from, gint to)
+{
+  LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+
+  for (gint i = from; i < to; i++)
+    {
+      LogMessage *msg = log_msg_new_empty();
+      gchar value[16];
+
+      g_snprintf(value, sizeof(value), "%d", i);
+      log_msg_set_value(msg, LM_V_MESSAGE, value, -1);
+      log_queue_push_tail(queue, msg, &path_options);
+    }
+}
+
+static void
+_pop_and_assert_numbered_messages(LogQueue *queue, gint from, gint to)
+{
+  for (gint i = from; i < to; i++)
+    {
+      LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+      LogMessage *msg = log_queue_pop_head(queue, &path_options);
+      gchar expected[16];
+
+      cr_assert(msg, "Message is missing from the queue: %d", i);
+      g_snprintf(expected, sizeof(expected), "%d", i);
+      cr_assert_str_eq(log_msg_get_value(msg, LM_V_MESSAGE, NULL), expected);
+      log_msg_unref(msg);
+    }
+  log_queue_ack_backlog(queue, to - from);
+}
+
+Test(logqueue_disk, non_reliable_front_cache_bytes_spills_to_disk_over_budget)
+{
+  const gchar *filename = "non_reliable_front_cache_bytes.qf";
+  DiskQueueOptions options = {0};
+
+  LogMessage *msg = log_msg_new_empty();
+  log_msg_set_value(msg, LM_V_MESSAGE, "0", -1);
+  const gssize log_msg_size = log_msg_get_size(msg);
+  log_msg_unref(msg);
+
+  LogQueue *queue = _create_non_reliable_queue_with_front_cache_bytes(filename, &options, 10 * log_msg_size, FALSE);
+  LogQueueDiskNonReliable *queue_disk_non_reliable = (LogQueueDiskNonReliable *) queue;
+
+  _push_numbered_messages(queue, 0, 10);
+  cr_assert_eq(g_queue_get_length(queue_disk_non_reliable->front_cache), 10 * 2);
+  cr_assert_eq(qdisk_get_length(queue_disk_non_reliable->super.qdisk), 0);
+
+  _push_numbered_messages(queue, 10, 15);
+  cr_assert_eq(g_queue_get_length(queue_disk_non_reliable->front_cache), 10 * 2);
+  cr_assert_eq(qdisk_get_length(queue_disk_non_reliable->super.qdisk), 5);
+  cr_assert_eq(log_queue_get_length(queue), 15);
+
+  _pop_and_assert_numbered_messages(queue, 0, 15);
+  cr_assert_eq(log_queue_get_length(queue), 0);
+  cr_assert_eq(queue_disk_non_reliable->front_cache_memory_usage, 0);
+
+  gboolean persistent;
+  log_queue_disk_stop(queue, &persistent);
+  log_queue_unref(queue);
+  disk_queue_options_destroy(&options);
+  unlink(filename);
+}
+
+Test(logqueue_disk, non_reliable_prefetch_keeps_message_order)
+{
+  const gchar *filename = "non_reliable_prefetch.qf";
+  DiskQueueOptions options = {0};
+
+  LogMessage *msg = log_msg_new_empty();
+  log_msg_set_value(msg, LM_V_MESSAGE, "0", -1);
+  const gssize log_msg_size = log_msg_get_size(msg);
+  log_msg_unref(msg);
+
+  LogQueue *queue = _create_non_reliable_queue_with_front_cache_bytes(filename, &options, 16 * log_msg_size, TRUE);
+
+  _push_numbered_messages(queue, 0, 500);
+  cr_assert_eq(log_queue_get_length(queue), 500);
+
+  _pop_and_assert_numbered_messages(queue, 0, 250);
+  _push_numbered_messages(queue, 500, 600);
+  _pop_and_assert_numbered_messages(queue, 250, 600);
+  cr_assert_eq(log_queue_get_length(queue), 0);
+
+  gboolean persistent;
+  log_queue_disk_stop(queue, &persistent);
+  log_queue_unref(queue);
+  disk_queue_options_destroy(&options);
+  unlink(filename);
+}
+
+Test(logqueue_disk, non_reliable_prefetch_runs_again_after_restart)
+{
+  const gchar *filename = "non_reliable_prefetch_restart.qf";
+  DiskQueueOptions options = {0};
+
+  LogMessage *msg = log_msg_new_empty();
+  log_msg_set_value(msg, LM_V_MESSAGE, "0", -1);
+  const gssize log_msg_size = log_msg_get_size(msg);
+  log_msg_unref(msg);
+
+  LogQueue *queue = _create_non_reliable_queue_with_front_cache_bytes(filename, &options, 16 * log_msg_size, TRUE);
+  LogQueueDiskNonReliable *queue_disk_non_reliable = (LogQueueDiskNonReliable *) queue;
+
+  _push_numbered_messages(queue, 0, 500);
+
+  gboolean persistent;
+  cr_assert(log_queue_disk_stop(queue, &persistent));
+  cr_assert(persistent);
+  cr_assert(log_queue_disk_start(queue));
+  cr_assert_not(queue_disk_non_reliable->prefetch.stopping);
+
+  _pop_and_assert_numbered_messages(queue, 0, 100);
+
+  g_mutex_lock(&queue->lock);
+  while (queue_disk_non_reliable->prefetch.scheduled)
+    g_cond_wait(&queue_disk_non_reliable->prefetch.finished, &queue->lock);
+  cr_assert_gt(g_queue_get_length(queue_disk_non_reliable->front_cache), 0,
+               "The front cache is not refilled by prefetching after a restart");
+  g_mutex_unlock(&queue->lock);
+
+  _pop_and_assert_numbered_messages(queue, 100, 500);
+  cr_assert_eq(log_queue_get_length(queue), 0);
+
+  log_queue_disk_stop(queue, &persistent);
+  log_queue_unref(queue);
+  disk_queue_options_destroy(&options);
+  unlink(filename);
+}
+
+Test(logqueue_disk, reliable_readahead_keeps_message_order_across_rewinds)
+{
+  const gchar *filename = "reliable_readahead.rqf";
+  DiskQueueOptions options = {0};
+
+  disk_queue_options_set_default_options(&options);
+  disk_queue_options_reliable_set(&options, TRUE);
+  disk_queue_options_capacity_bytes_set(&options, MIN_CAPACITY_BYTES);
+  disk_queue_options_flow_control_window_bytes_set(&options, 4096);
+  disk_queue_options_front_cache_size_set(&options, 0);
+  disk_queue_options_prefetch_set(&options, TRUE);
+
+  LogQueue *queue = log_queue_disk_reliable_new(&options, filename, NULL, STATS_LEVEL0, NULL, NULL);
+  cr_assert(log_queue_disk_start(queue));
+
+  _push_numbered_messages(queue, 0, 1000);
+
+  for (gint i = 0; i < 100; i++)
+    {
+      LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+      LogMessage *msg = log_queue_pop_head(queue, &path_options);
+      cr_assert(msg);
+      log_msg_unref(msg);
+    }
+  log_queue_rewind_backlog_all(queue);
+
+  _pop_and_assert_numbered_messages(queue, 0, 1000);
+  cr_assert_eq(log_queue_get_length(queue), 0);
+
+  gboolean persistent;
+  log_queue_disk_stop(queue, &persistent);
+  log_queue_unref(queue);
+  disk_queue_options_destroy(&options);
+  unlink(filename);
+}
+
+static void
+_assert_readahead_follows_the_read_head(LogQueueDisk *queue)
+{
+  g_mutex_lock(&queue->super.lock);
+  while (queue->readahead.scheduled)
+    g_cond_wait(&queue->readahead.finished, &queue->super.lock);
+
+  if (!g_queue_is_empty(queue->readahead.ready))
+    cr_assert_eq(*(gint64 *) g_queue_peek_head(queue->readahead.ready), qdisk_get_next_head_position(queue->qdisk),
+                 "Stale readahead entry in front of the read head");
+  g_mutex_unlock(&queue->super.lock);
+}
+
+Test(logqueue_disk, reliable_readahead_is_dropped_when_the_head_moves_past_it)
+{
+  const gchar *filename = "reliable_readahead_skip.rqf";
+  DiskQueueOptions options = {0};
+
+  disk_queue_options_set_default_options(&options);
+  disk_queue_options_reliable_set(&options, TRUE);
+  disk_queue_options_capacity_bytes_set(&options, MIN_CAPACITY_BYTES);
+  disk_queue_options_flow_control_window_bytes_set(&options, 4096);
+  disk_queue_options_front_cache_size_set(&options, 0);
+  disk_queue_options_prefetch_set(&options, TRUE);
+
+  LogQueue *queue = log_queue_disk_reliable_new(&options, filename, NULL, STATS_LEVEL0, NULL, NULL);
+  LogQueueDisk *queue_disk = (LogQueueDisk *) queue;
+  cr_assert(log_queue_disk_start(queue));
+
+  _push_numbered_messages(queue, 0, 1000);
+
+  /* the records after the flow-control window are read from disk, with readahead */
+  for (gint i = 0; i < 300; i++)
+    {
+      LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+      LogMessage *msg = log_queue_pop_head(queue, &path_options);
+      cr_assert(msg);
+      log_msg_unref(msg);
+      _assert_readahead_follows_the_read_head(queue_disk);
+    }
+
+  /* the rewound records are consumed from memory, moving the read head past the readahead */
+  log_queue_rewind_backlog_all(queue);
+  for (gint i = 0; i < 1000; i++)
+    {
+      LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+      LogMessage *msg = log_queue_pop_head(queue, &path_options);
+      gchar expected[16];
+
+      cr_assert(msg, "Message is missing from the queue: %d", i);
+      g_snprintf(expected, sizeof(expected), "%d", i);
+      cr_assert_str_eq(log_msg_get_value(msg, LM_V_MESSAGE, NULL), expected);
+      log_msg_unref(msg);
+      _assert_readahead_follows_the_read_head(queue_disk);
+    }
+  log_queue_ack_backlog(queue, 1000);
+  cr_assert_eq(log_queue_get_length(queue), 0);
+  cr_assert(g_queue_is_empty(queue_disk->readahead.ready));
+
+  /* readahead is resumed after a restart */
+  gboolean persistent;
+  cr_assert(log_queue_disk_stop(queue, &persistent));
+  cr_assert(log_queue_disk_start(queue));
+  cr_assert_not(queue_disk->readahead.stopping);
+
+  _push_numbered_messages(queue, 0, 1000);
+  _pop_and_assert_numbered_messages(queue, 0, 500);
+  _assert_readahead_follows_the_read_head(queue_disk);
+  cr_assert_not(g_queue_is_empty(queue_disk->readahead.ready), "No readahead after a restart");
+  _pop_and_assert_numbered_messages(queue, 500, 1000);
+
+  log_queue_disk_stop(queue, &persistent);
+  log_queue_unref(queue);
+  disk_queue_options_destroy(&options);
+  unlink(filename);
+}
+
 static void
 setup(void)
 {
@@ -223,6 +223,36 @@ Test(qdisk, qdisk_remove_head)
   cleanup_qdisk(filename, qdisk);
 }
 
+Test(qdisk, qdisk_read_record_at_does_not_consume_records)
+{
+  const gchar *filename = "test_qdisk_read_record_at.rqf";
+  QDisk *qdisk = create_qdisk(TDISKQ_RELIABLE, filename, MiB(1));
+  qdisk_start(qdisk, NULL, NULL, NULL);
+
+  push_dummy_record(qdisk, 128);
+  push_dummy_record(qdisk, 256);
+
+  GString *record = g_string_new(NULL);
+  gint64 position = qdisk_get_next_head_position(qdisk);
+
+  cr_assert(qdisk_read_record_at(qdisk, &position, record));
+  assert_dummy_record(record, 128);
+  cr_assert(qdisk_read_record_at(qdisk, &position, record));
+  assert_dummy_record(record, 256);
+  cr_assert_not(qdisk_read_record_at(qdisk, &position, record));
+  cr_assert_eq(position, qdisk_get_writer_head(qdisk));
+  cr_assert_eq(qdisk_get_length(qdisk), 2);
+
+  cr_assert(qdisk_remove_head(qdisk));
+  position = qdisk_get_next_head_position(qdisk);
+  cr_assert(qdisk_read_record_at(qdisk, &position, record));
+  assert_dummy_record(record, 256);
+
+  g_string_free(record, TRUE);
+  qdisk_stop(qdisk, NULL, NULL, NULL);
+  cleanup_qdisk(filename, qdisk);
+}
+
 Test(qdisk, qdisk_basic_ack_rewind)
 {
   const gchar *filename = "test_qdisk_basic_ack_rewind.rqf";
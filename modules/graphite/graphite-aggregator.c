@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "graphite-aggregator.h"
+#include "logmsg/type-hinting.h"
+
+#include <string.h>
+
+/*
+ * Collects metric values per metric path between two flushes, so that a
+ * path that was updated N times within a flush interval is sent only once.
+ *
+ * Entries are kept in the order their path was first seen, so the output
+ * is deterministic.  Values are parsed as numbers in both modes and
+ * formatted by us, so a value can never inject extra protocol lines.
+ */
+typedef struct _GraphiteAggregatorEntry
+{
+  gchar *path;
+  gint64 timestamp;
+
+  /* the sum or the last value, depending on the aggregation mode */
+  gboolean is_integer;
+  gint64 int_value;
+  gdouble double_value;
+} GraphiteAggregatorEntry;
+
+struct _GraphiteAggregator
+{
+  GraphiteAggregationMode mode;
+  GHashTable *entries_by_path;
+  GPtrArray *entries;
+};
+
+gboolean
+graphite_aggregation_mode_from_str(const gchar *mode_str, GraphiteAggregationMode *mode)
+{
+  if (strcmp(mode_str, "last") == 0)
+    *mode = GRAPHITE_AGGREGATION_LAST;
+  else if (strcmp(mode_str, "sum") == 0)
+    *mode = GRAPHITE_AGGREGATION_SUM;
+  else
+    return FALSE;
+
+  return TRUE;
+}
+
+static GraphiteAggregatorEntry *
+_entry_new(const gchar *path)
+{
+  GraphiteAggregatorEntry *self = g_new0(GraphiteAggregatorEntry, 1);
+
+  self->path = g_strdup(path);
+  self->is_integer = TRUE;
+  return self;
+}
+
+static void
+_entry_free(GraphiteAggregatorEntry *self)
+{
+  g_free(self->path);
+  g_free(self);
+}
+
+static gboolean
+_parse_numeric_value(const gchar *value, gboolean *is_integer, gint64 *i, gdouble *d)
+{
+  if (type_cast_to_int64(value, -1, i, NULL))
+    {
+      *is_integer = TRUE;
+      *d = *i;
+      return TRUE;
+    }
+
+  *is_integer = FALSE;
+  return type_cast_to_double(value, -1, d, NULL);
+}
+
+/* the path is a single field of the plaintext protocol */
+static gboolean
+_is_valid_path(const gchar *path)
+{
+  if (!path[0])
+    return FALSE;
+
+  for (const gchar *p = path; *p; p++)
+    {
+      if (g_ascii_isspace(*p) || g_ascii_iscntrl(*p))
+        return FALSE;
+    }
+  return TRUE;
+}
+
+static void
+_entry_format(GraphiteAggregatorEntry *self, GString *output)
+{
+  g_string_append(output, self->path);
+  g_string_append_c(output, ' ');
+
+  if (self->is_integer)
+    {
+      g_string_append_printf(output, "%" G_GINT64_FORMAT, self->int_value);
+    }
+  else
+    {
+      gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+      g_string_append(output, g_ascii_dtostr(buf, sizeof(buf), self->double_value));
+    }
+
+  g_string_append_printf(output, " %" G_GINT64_FORMAT "\n", self->timestamp);
+}
+
+static GraphiteAggregatorEntry *
+_lookup_or_insert_entry(GraphiteAggregator *self, const gchar *path)
+{
+  GraphiteAggregatorEntry *entry = g_hash_table_lookup(self->entries_by_path, path);
+
+  if (entry)
+    return entry;
+
+  entry = _entry_new(path);
+  g_hash_table_insert(self->entries_by_path, entry->path, entry);
+  g_ptr_array_add(self->entries, entry);
+  return entry;
+}
+
+gboolean
+graphite_aggregator_add(GraphiteAggregator *self, const gchar *path, const gchar *value, gint64 timestamp)
+{
+  gboolean is_integer;
+  gint64 i = 0;
+  gdouble d;
+
+  if (!_is_valid_path(path) || !_parse_numeric_value(value, &is_integer, &i, &d))
+    return FALSE;
+
+  GraphiteAggregatorEntry *entry = _lookup_or_insert_entry(self, path);
+  if (self->mode == GRAPHITE_AGGREGATION_SUM)
+    {
+      entry->is_integer &= is_integer;
+      entry->int_value += i;
+      entry->double_value += d;
+    }
+  else
+    {
+      entry->is_integer = is_integer;
+      entry->int_value = i;
+      entry->double_value = d;
+    }
+
+  entry->timestamp = MAX(entry->timestamp, timestamp);
+  return TRUE;
+}
+
+guint
+graphite_aggregator_get_num_paths(GraphiteAggregator *self)
+{
+  return self->entries->len;
+}
+
+void
+graphite_aggregator_reset(GraphiteAggregator *self)
+{
+  g_hash_table_remove_all(self->entries_by_path);
+  g_ptr_array_set_size(self->entries, 0);
+}
+
+/* Appends one plaintext protocol line per metric path to @output and
+ * starts a new aggregation interval.  Returns the number of lines. */
+gsize
+graphite_aggregator_format_and_reset(GraphiteAggregator *self, GString *output)
+{
+  gsize num_lines = self->entries->len;
+
+  for (guint i = 0; i < self->entries->len; i++)
+    _entry_format(g_ptr_array_index(self->entries, i), output);
+
+  graphite_aggregator_reset(self);
+  return num_lines;
+}
+
+GraphiteAggregator *
+graphite_aggregator_new(GraphiteAggregationMode mode)
+{
+  GraphiteAggregator *self = g_new0(GraphiteAggregator, 1);
+
+  self->mode = mode;
+  self->entries_by_path = g_hash_table_new(g_str_hash, g_str_equal);
+  self->entries = g_ptr_array_new_with_free_func((GDestroyNotify) _entry_free);
+  return self;
+}
+
+void
+graphite_aggregator_free(GraphiteAggregator *self)
+{
+  g_hash_table_destroy(self->entries_by_path);
+  g_ptr_array_free(self->entries, TRUE);
+  g_free(self);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef GRAPHITE_AGGREGATOR_H_INCLUDED
+#define GRAPHITE_AGGREGATOR_H_INCLUDED
+
+#include "syslog-ng.h"
+
+typedef enum
+{
+  GRAPHITE_AGGREGATION_LAST,
+  GRAPHITE_AGGREGATION_SUM,
+} GraphiteAggregationMode;
+
+typedef struct _GraphiteAggregator GraphiteAggregator;
+
+gboolean graphite_aggregation_mode_from_str(const gchar *mode_str, GraphiteAggregationMode *mode);
+
+gboolean graphite_aggregator_add(GraphiteAggregator *self, const gchar *path, const gchar *value, gint64 timestamp);
+gsize graphite_aggregator_format_and_reset(GraphiteAggregator *self, GString *output);
+guint graphite_aggregator_get_num_paths(GraphiteAggregator *self);
+void graphite_aggregator_reset(GraphiteAggregator *self);
+
+GraphiteAggregator *graphite_aggregator_new(GraphiteAggregationMode mode);
+void graphite_aggregator_free(GraphiteAggregator *self);
+
+#endif
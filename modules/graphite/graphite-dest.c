@@ -0,0 +1,476 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "graphite-dest.h"
+#include "host-resolve.h"
+#include "gsocket.h"
+#include "fdhelpers.h"
+#include "scratch-buffers.h"
+#include "logmsg/type-hinting.h"
+#include "stats/stats.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+/*
+ * graphite-native() sends metrics over the Graphite plaintext protocol.
+ *
+ * Instead of formatting one line per message and writing it to a network()
+ * destination, the values extracted from a batch of messages are
+ * aggregated per metric path (keeping the last or the sum of the values),
+ * and the aggregated lines are sent using a single write when the batch is
+ * flushed, e.g. when batch-lines() is reached or batch-timeout() expires.
+ *
+ * The connection is a plain TCP socket with keepalive enabled.  Sends
+ * (and connects) time out after timeout() seconds, a stalled server then
+ * causes the usual disconnect, time-reopen() and retry of the batch
+ * instead of blocking the worker indefinitely.
+ */
+
+typedef struct
+{
+  LogThreadedDestWorker super;
+  gint fd;
+  GraphiteAggregator *aggregator;
+  GString *buffer;
+} GraphiteDestWorker;
+
+typedef struct
+{
+  GraphiteDestWorker *worker;
+  gint64 timestamp;
+} GraphiteMetricsForeachState;
+
+static void
+_socket_setup(GraphiteDestWorker *self)
+{
+  GraphiteDestDriver *owner = (GraphiteDestDriver *) self->super.owner;
+  gint on = 1;
+
+  g_fd_set_cloexec(self->fd, TRUE);
+  setsockopt(self->fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+
+  if (owner->timeout > 0)
+    {
+      struct timeval timeout = { .tv_sec = owner->timeout };
+
+      /* also applies to connect() */
+      setsockopt(self->fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+}
+
+static gboolean
+_socket_connect(GraphiteDestWorker *self)
+{
+  GraphiteDestDriver *owner = (GraphiteDestDriver *) self->super.owner;
+  GSockAddr *remote_sa = NULL;
+
+  if (!resolve_hostname_to_sockaddr(&remote_sa, owner->address_family, owner->host))
+    {
+      msg_error("graphite: failed to resolve hostname",
+                evt_tag_str("host", owner->host),
+                evt_tag_str("driver", owner->super.super.super.id),
+                log_pipe_location_tag(&owner->super.super.super.super));
+      return FALSE;
+    }
+  g_sockaddr_set_port(remote_sa, owner->port);
+
+  self->fd = socket(remote_sa->sa.sa_family, SOCK_STREAM, 0);
+  if (self->fd < 0)
+    {
+      msg_error("graphite: error creating socket",
+                evt_tag_error("error"),
+                evt_tag_str("driver", owner->super.super.super.id),
+                log_pipe_location_tag(&owner->super.super.super.super));
+      g_sockaddr_unref(remote_sa);
+      return FALSE;
+    }
+
+  _socket_setup(self);
+  if (g_connect(self->fd, remote_sa) != G_IO_STATUS_NORMAL)
+    {
+      msg_error("graphite: error connecting to Graphite server",
+                evt_tag_str("host", owner->host),
+                evt_tag_int("port", owner->port),
+                evt_tag_error("error"),
+                evt_tag_str("driver", owner->super.super.super.id),
+                log_pipe_location_tag(&owner->super.super.super.super));
+      close(self->fd);
+      self->fd = -1;
+      g_sockaddr_unref(remote_sa);
+      return FALSE;
+    }
+
+  g_sockaddr_unref(remote_sa);
+  return TRUE;
+}
+
+static gboolean
+_socket_write_all(GraphiteDestWorker *self, const gchar *data, gsize len)
+{
+  gsize written = 0;
+
+  while (written < len)
+    {
+      gssize rc = write(self->fd, data + written, len - written);
+
+      if (rc < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return FALSE;
+        }
+      written += rc;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+graphite_dw_connect(LogThreadedDestWorker *s)
+{
+  GraphiteDestWorker *self = (GraphiteDestWorker *) s;
+
+  return _socket_connect(self);
+}
+
+static void
+graphite_dw_disconnect(LogThreadedDestWorker *s)
+{
+  GraphiteDestWorker *self = (GraphiteDestWorker *) s;
+
+  if (self->fd >= 0)
+    {
+      close(self->fd);
+      self->fd = -1;
+    }
+
+  /* rewound messages get aggregated again */
+  graphite_aggregator_reset(self->aggregator);
+}
+
+static gboolean
+_aggregate_metric(const gchar *name, LogMessageValueType type, const gchar *value,
+                  gsize value_len, gpointer user_data)
+{
+  GraphiteMetricsForeachState *state = (GraphiteMetricsForeachState *) user_data;
+  GraphiteDestDriver *owner = (GraphiteDestDriver *) state->worker->super.owner;
+
+  if (!graphite_aggregator_add(state->worker->aggregator, name, value, state->timestamp))
+    {
+      msg_debug("graphite: ignoring metric with an invalid path or a non-numeric value",
+                evt_tag_str("path", name),
+                evt_tag_str("value", value),
+                evt_tag_str("driver", owner->super.super.super.id),
+                log_pipe_location_tag(&owner->super.super.super.super));
+    }
+
+  return FALSE;
+}
+
+static gint64
+_format_timestamp(GraphiteDestWorker *self, LogMessage *msg)
+{
+  GraphiteDestDriver *owner = (GraphiteDestDriver *) self->super.owner;
+  GString *buf = scratch_buffers_alloc();
+  gint64 timestamp;
+
+  LogTemplateEvalOptions options = {&owner->template_options, LTZ_SEND, self->super.seq_num, NULL, LM_VT_STRING};
+  log_template_format(owner->timestamp, msg, &options, buf);
+
+  if (!type_cast_to_int64(buf->str, buf->len, &timestamp, NULL))
+    timestamp = msg->timestamps[LM_TS_RECVD].ut_sec;
+
+  return timestamp;
+}
+
+static LogThreadedResult
+graphite_dw_insert(LogThreadedDestWorker *s, LogMessage *msg)
+{
+  GraphiteDestWorker *self = (GraphiteDestWorker *) s;
+  GraphiteDestDriver *owner = (GraphiteDestDriver *) self->super.owner;
+  GraphiteMetricsForeachState state = { self, _format_timestamp(self, msg) };
+
+  LogTemplateEvalOptions options = {&owner->template_options, LTZ_SEND, self->super.seq_num, NULL, LM_VT_STRING};
+  value_pairs_foreach(owner->metrics, _aggregate_metric, msg, &options, &state);
+
+  return LTR_QUEUED;
+}
+
+static LogThreadedResult
+graphite_dw_flush(LogThreadedDestWorker *s, LogThreadedFlushMode mode)
+{
+  GraphiteDestWorker *self = (GraphiteDestWorker *) s;
+  GraphiteDestDriver *owner = (GraphiteDestDriver *) self->super.owner;
+
+  if (self->super.batch_size == 0)
+    return LTR_SUCCESS;
+
+  g_string_truncate(self->buffer, 0);
+  gsize num_lines = graphite_aggregator_format_and_reset(self->aggregator, self->buffer);
+
+  if (!_socket_write_all(self, self->buffer->str, self->buffer->len))
+    {
+      msg_error("graphite: error sending metrics to Graphite server",
+                evt_tag_str("host", owner->host),
+                evt_tag_int("port", owner->port),
+                evt_tag_int("batch_size", self->super.batch_size),
+                evt_tag_int("metric_lines", num_lines),
+                evt_tag_error("error"),
+                evt_tag_str("driver", owner->super.super.super.id),
+                log_pipe_location_tag(&owner->super.super.super.super));
+      return LTR_ERROR;
+    }
+
+  msg_debug("graphite: metrics sent to Graphite server",
+            evt_tag_str("host", owner->host),
+            evt_tag_int("port", owner->port),
+            evt_tag_int("batch_size", self->super.batch_size),
+            evt_tag_int("metric_lines", num_lines),
+            evt_tag_int("bytes", self->buffer->len),
+            evt_tag_str("driver", owner->super.super.super.id));
+
+  log_threaded_dest_worker_written_bytes_add(&self->super, self->buffer->len);
+  return LTR_SUCCESS;
+}
+
+static void
+graphite_dw_free(LogThreadedDestWorker *s)
+{
+  GraphiteDestWorker *self = (GraphiteDestWorker *) s;
+
+  graphite_aggregator_free(self->aggregator);
+  g_string_free(self->buffer, TRUE);
+  log_threaded_dest_worker_free_method(s);
+}
+
+static LogThreadedDestWorker *
+graphite_dw_new(LogThreadedDestDriver *o, gint worker_index)
+{
+  GraphiteDestWorker *self = g_new0(GraphiteDestWorker, 1);
+  GraphiteDestDriver *owner = (GraphiteDestDriver *) o;
+
+  log_threaded_dest_worker_init_instance(&self->super, o, worker_index);
+  self->super.connect = graphite_dw_connect;
+  self->super.disconnect = graphite_dw_disconnect;
+  self->super.insert = graphite_dw_insert;
+  self->super.flush = graphite_dw_flush;
+  self->super.free_fn = graphite_dw_free;
+
+  self->fd = -1;
+  self->aggregator = graphite_aggregator_new(owner->aggregation);
+  self->buffer = g_string_sized_new(65536);
+  return &self->super;
+}
+
+/*
+ * GraphiteDestDriver
+ */
+
+void
+graphite_dd_set_host(LogDriver *d, const gchar *host)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) d;
+
+  g_free(self->host);
+  self->host = g_strdup(host);
+}
+
+void
+graphite_dd_set_port(LogDriver *d, gint port)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) d;
+
+  self->port = port;
+}
+
+gboolean
+graphite_dd_set_ip_protocol(LogDriver *d, gint ip_protocol)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) d;
+
+  switch (ip_protocol)
+    {
+    case 4:
+      self->address_family = AF_INET;
+      return TRUE;
+#if SYSLOG_NG_ENABLE_IPV6
+    case 6:
+      self->address_family = AF_INET6;
+      return TRUE;
+#endif
+    default:
+      return FALSE;
+    }
+}
+
+void
+graphite_dd_set_timeout(LogDriver *d, gint timeout)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) d;
+
+  self->timeout = timeout;
+}
+
+void
+graphite_dd_set_metrics(LogDriver *d, ValuePairs *vp)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) d;
+
+  value_pairs_unref(self->metrics);
+  self->metrics = vp;
+}
+
+void
+graphite_dd_set_timestamp(LogDriver *d, LogTemplate *timestamp)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) d;
+
+  log_template_unref(self->timestamp);
+  self->timestamp = log_template_ref(timestamp);
+}
+
+gboolean
+graphite_dd_set_aggregation(LogDriver *d, const gchar *aggregation)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) d;
+
+  return graphite_aggregation_mode_from_str(aggregation, &self->aggregation);
+}
+
+LogTemplateOptions *
+graphite_dd_get_template_options(LogDriver *d)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) d;
+
+  return &self->template_options;
+}
+
+static const gchar *
+graphite_dd_format_stats_key(LogThreadedDestDriver *s, StatsClusterKeyBuilder *kb)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) s;
+
+  stats_cluster_key_builder_add_legacy_label(kb, stats_cluster_label("driver", "graphite"));
+  stats_cluster_key_builder_add_legacy_label(kb, stats_cluster_label("host", self->host));
+
+  gchar num[64];
+  g_snprintf(num, sizeof(num), "%u", self->port);
+  stats_cluster_key_builder_add_legacy_label(kb, stats_cluster_label("port", num));
+
+  return NULL;
+}
+
+static const gchar *
+graphite_dd_format_persist_name(const LogPipe *s)
+{
+  const GraphiteDestDriver *self = (const GraphiteDestDriver *) s;
+  static gchar persist_name[1024];
+
+  if (s->persist_name)
+    g_snprintf(persist_name, sizeof(persist_name), "graphite.%s", s->persist_name);
+  else
+    g_snprintf(persist_name, sizeof(persist_name), "graphite(%s,%u)", self->host, self->port);
+
+  return persist_name;
+}
+
+static gboolean
+graphite_dd_init(LogPipe *s)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) s;
+  GlobalConfig *cfg = log_pipe_get_config(s);
+
+  if (!self->metrics)
+    {
+      msg_error("graphite: the metrics() option is mandatory",
+                evt_tag_str("driver", self->super.super.super.id),
+                log_pipe_location_tag(s));
+      return FALSE;
+    }
+
+  log_template_options_init(&self->template_options, cfg);
+
+  if (!self->timestamp)
+    {
+      self->timestamp = log_template_new(cfg, NULL);
+      log_template_compile(self->timestamp, "$R_UNIXTIME", NULL);
+    }
+
+  if (!log_threaded_dest_driver_init_method(s))
+    return FALSE;
+
+  msg_verbose("Initializing Graphite destination",
+              evt_tag_str("host", self->host),
+              evt_tag_int("port", self->port),
+              evt_tag_int("batch_lines", self->super.batch_lines),
+              evt_tag_int("batch_timeout", self->super.batch_timeout),
+              evt_tag_str("driver", self->super.super.super.id),
+              log_pipe_location_tag(s));
+
+  return TRUE;
+}
+
+static void
+graphite_dd_free(LogPipe *s)
+{
+  GraphiteDestDriver *self = (GraphiteDestDriver *) s;
+
+  g_free(self->host);
+  value_pairs_unref(self->metrics);
+  log_template_unref(self->timestamp);
+  log_template_options_destroy(&self->template_options);
+
+  log_threaded_dest_driver_free(s);
+}
+
+LogDriver *
+graphite_dd_new(GlobalConfig *cfg)
+{
+  GraphiteDestDriver *self = g_new0(GraphiteDestDriver, 1);
+
+  log_threaded_dest_driver_init_instance(&self->super, cfg);
+
+  self->super.super.super.super.init = graphite_dd_init;
+  self->super.super.super.super.free_fn = graphite_dd_free;
+  self->super.super.super.super.generate_persist_name = graphite_dd_format_persist_name;
+  self->super.worker.construct = graphite_dw_new;
+
+  self->super.format_stats_key = graphite_dd_format_stats_key;
+  self->super.stats_source = stats_register_type("graphite");
+
+  self->host = g_strdup("127.0.0.1");
+  self->port = 2003;
+  self->address_family = AF_INET;
+  self->timeout = 10;
+  self->aggregation = GRAPHITE_AGGREGATION_LAST;
+
+  /* aggregation only pays off if a batch spans a longer period */
+  self->super.batch_lines = 10000;
+  self->super.batch_timeout = 1000;
+
+  log_template_options_defaults(&self->template_options);
+
+  return (LogDriver *) self;
+}
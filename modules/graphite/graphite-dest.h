@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef GRAPHITE_DEST_H_INCLUDED
+#define GRAPHITE_DEST_H_INCLUDED
+
+#include "logthrdest/logthrdestdrv.h"
+#include "value-pairs/value-pairs.h"
+#include "graphite-aggregator.h"
+
+typedef struct
+{
+  LogThreadedDestDriver super;
+
+  gchar *host;
+  gint port;
+  gint address_family;
+  gint timeout;
+  ValuePairs *metrics;
+  LogTemplate *timestamp;
+  GraphiteAggregationMode aggregation;
+  LogTemplateOptions template_options;
+} GraphiteDestDriver;
+
+LogDriver *graphite_dd_new(GlobalConfig *cfg);
+
+void graphite_dd_set_host(LogDriver *d, const gchar *host);
+void graphite_dd_set_port(LogDriver *d, gint port);
+gboolean graphite_dd_set_ip_protocol(LogDriver *d, gint ip_protocol);
+void graphite_dd_set_timeout(LogDriver *d, gint timeout);
+void graphite_dd_set_metrics(LogDriver *d, ValuePairs *vp);
+void graphite_dd_set_timestamp(LogDriver *d, LogTemplate *timestamp);
+gboolean graphite_dd_set_aggregation(LogDriver *d, const gchar *aggregation);
+LogTemplateOptions *graphite_dd_get_template_options(LogDriver *d);
+
+#endif
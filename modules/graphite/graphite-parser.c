@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "graphite-dest.h"
+#include "cfg-parser.h"
+#include "graphite-grammar.h"
+
+extern int graphite_debug;
+int graphite_parse(CfgLexer *lexer, LogDriver **instance, gpointer arg);
+
+static CfgLexerKeyword graphite_keywords[] =
+{
+  { "graphite_native",          KW_GRAPHITE_NATIVE },
+  { "host",                     KW_HOST },
+  { "port",                     KW_PORT },
+  { "metrics",                  KW_METRICS },
+  { "timestamp",                KW_TIMESTAMP },
+  { "aggregation",              KW_AGGREGATION },
+  { "ip_protocol",              KW_IP_PROTOCOL },
+  { "timeout",                  KW_TIMEOUT },
+  { NULL }
+};
+
+CfgParser graphite_parser =
+{
+#if SYSLOG_NG_ENABLE_DEBUG
+  .debug_flag = &graphite_debug,
+#endif
+  .name = "graphite",
+  .keywords = graphite_keywords,
+  .parse = (int (*)(CfgLexer *lexer, gpointer *instance, gpointer)) graphite_parse,
+  .cleanup = (void (*)(gpointer)) log_pipe_unref,
+};
+
+CFG_PARSER_IMPLEMENT_LEXER_BINDING(graphite_, GRAPHITE_, LogDriver **)
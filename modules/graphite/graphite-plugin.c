@@ -23,11 +23,17 @@
 #include "plugin.h"
 #include "plugin-types.h"
 #include "graphite-output.h"
+#include "graphite-parser.h"
 #include "cfg.h"
 
 static Plugin graphite_plugins[] =
 {
   TEMPLATE_FUNCTION_PLUGIN(tf_graphite, "graphite_output"),
+  {
+    .type = LL_CONTEXT_DESTINATION,
+    .name = "graphite_native",
+    .parser = &graphite_parser,
+  },
 };
 
 gboolean
@@ -41,7 +47,7 @@ const ModuleInfo module_info =
 {
   .canonical_name = "graphite",
   .version = SYSLOG_NG_VERSION,
-  .description = "The graphite module provides graphite output for syslog-ng.",
+  .description = "The graphite module provides graphite output and the graphite-native() destination for syslog-ng.",
   .core_revision = SYSLOG_NG_SOURCE_REVISION,
   .plugins = graphite_plugins,
   .plugins_len = G_N_ELEMENTS(graphite_plugins),
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ */
+
+#include <criterion/criterion.h>
+
+#include "graphite-aggregator.h"
+#include "apphook.h"
+
+static GString *
+_format(GraphiteAggregator *aggregator)
+{
+  GString *output = g_string_new(NULL);
+  graphite_aggregator_format_and_reset(aggregator, output);
+  return output;
+}
+
+static void
+_assert_formatted(GraphiteAggregator *aggregator, const gchar *expected)
+{
+  GString *output = _format(aggregator);
+  cr_assert_str_eq(output->str, expected);
+  g_string_free(output, TRUE);
+}
+
+Test(graphite_aggregator, test_aggregation_mode_from_str)
+{
+  GraphiteAggregationMode mode;
+
+  cr_assert(graphite_aggregation_mode_from_str("last", &mode));
+  cr_assert_eq(mode, GRAPHITE_AGGREGATION_LAST);
+  cr_assert(graphite_aggregation_mode_from_str("sum", &mode));
+  cr_assert_eq(mode, GRAPHITE_AGGREGATION_SUM);
+  cr_assert_not(graphite_aggregation_mode_from_str("avg", &mode));
+}
+
+Test(graphite_aggregator, test_last_keeps_the_last_value_per_path_in_first_seen_order)
+{
+  GraphiteAggregator *aggregator = graphite_aggregator_new(GRAPHITE_AGGREGATION_LAST);
+
+  cr_assert(graphite_aggregator_add(aggregator, "a.b", "1", 100));
+  cr_assert(graphite_aggregator_add(aggregator, "c.d", "0.25", 101));
+  cr_assert(graphite_aggregator_add(aggregator, "a.b", "3", 102));
+  cr_assert_eq(graphite_aggregator_get_num_paths(aggregator), 2);
+
+  _assert_formatted(aggregator,
+                    "a.b 3 102\n"
+                    "c.d 0.25 101\n");
+  cr_assert_eq(graphite_aggregator_get_num_paths(aggregator), 0);
+  _assert_formatted(aggregator, "");
+
+  graphite_aggregator_free(aggregator);
+}
+
+Test(graphite_aggregator, test_sum_adds_up_integers)
+{
+  GraphiteAggregator *aggregator = graphite_aggregator_new(GRAPHITE_AGGREGATION_SUM);
+
+  cr_assert(graphite_aggregator_add(aggregator, "requests", "1", 100));
+  cr_assert(graphite_aggregator_add(aggregator, "requests", "41", 99));
+  cr_assert(graphite_aggregator_add(aggregator, "errors", "-2", 100));
+
+  _assert_formatted(aggregator,
+                    "requests 42 100\n"
+                    "errors -2 100\n");
+
+  graphite_aggregator_free(aggregator);
+}
+
+Test(graphite_aggregator, test_sum_switches_to_double_on_first_fractional_value)
+{
+  GraphiteAggregator *aggregator = graphite_aggregator_new(GRAPHITE_AGGREGATION_SUM);
+
+  cr_assert(graphite_aggregator_add(aggregator, "latency", "1", 100));
+  cr_assert(graphite_aggregator_add(aggregator, "latency", "0.5", 100));
+  cr_assert(graphite_aggregator_add(aggregator, "latency", "2", 100));
+
+  _assert_formatted(aggregator, "latency 3.5 100\n");
+
+  graphite_aggregator_free(aggregator);
+}
+
+Test(graphite_aggregator, test_sum_rejects_non_numeric_values)
+{
+  GraphiteAggregator *aggregator = graphite_aggregator_new(GRAPHITE_AGGREGATION_SUM);
+
+  cr_assert_not(graphite_aggregator_add(aggregator, "requests", "foo", 100));
+  cr_assert_eq(graphite_aggregator_get_num_paths(aggregator), 0);
+
+  cr_assert(graphite_aggregator_add(aggregator, "requests", "5", 100));
+  cr_assert_not(graphite_aggregator_add(aggregator, "requests", "", 100));
+  _assert_formatted(aggregator, "requests 5 100\n");
+
+  graphite_aggregator_free(aggregator);
+}
+
+Test(graphite_aggregator, test_last_rejects_values_that_are_not_numbers)
+{
+  GraphiteAggregator *aggregator = graphite_aggregator_new(GRAPHITE_AGGREGATION_LAST);
+
+  cr_assert_not(graphite_aggregator_add(aggregator, "c.d", "foo", 100));
+  cr_assert_not(graphite_aggregator_add(aggregator, "c.d", "", 100));
+  cr_assert_not(graphite_aggregator_add(aggregator, "c.d", "1 100\nevil.path 1", 100));
+  cr_assert_not(graphite_aggregator_add(aggregator, "c.d", "1 2", 100));
+  cr_assert_eq(graphite_aggregator_get_num_paths(aggregator), 0);
+
+  cr_assert(graphite_aggregator_add(aggregator, "c.d", "5", 100));
+  cr_assert_not(graphite_aggregator_add(aggregator, "c.d", "bar", 101));
+  _assert_formatted(aggregator, "c.d 5 100\n");
+
+  graphite_aggregator_free(aggregator);
+}
+
+Test(graphite_aggregator, test_last_switches_between_integer_and_double_values)
+{
+  GraphiteAggregator *aggregator = graphite_aggregator_new(GRAPHITE_AGGREGATION_LAST);
+
+  cr_assert(graphite_aggregator_add(aggregator, "latency", "0.5", 100));
+  cr_assert(graphite_aggregator_add(aggregator, "latency", "2", 100));
+  _assert_formatted(aggregator, "latency 2 100\n");
+
+  cr_assert(graphite_aggregator_add(aggregator, "latency", "2", 100));
+  cr_assert(graphite_aggregator_add(aggregator, "latency", "1.5", 100));
+  _assert_formatted(aggregator, "latency 1.5 100\n");
+
+  graphite_aggregator_free(aggregator);
+}
+
+Test(graphite_aggregator, test_paths_with_whitespace_are_rejected)
+{
+  GraphiteAggregator *aggregator = graphite_aggregator_new(GRAPHITE_AGGREGATION_LAST);
+
+  cr_assert_not(graphite_aggregator_add(aggregator, "a b", "1", 100));
+  cr_assert_not(graphite_aggregator_add(aggregator, "a\nb", "1", 100));
+  cr_assert_not(graphite_aggregator_add(aggregator, "", "1", 100));
+  cr_assert_eq(graphite_aggregator_get_num_paths(aggregator), 0);
+
+  graphite_aggregator_free(aggregator);
+}
+
+TestSuite(graphite_aggregator, .init = app_startup, .fini = app_shutdown);
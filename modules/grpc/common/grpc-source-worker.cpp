@@ -38,6 +38,21 @@ SourceWorker::post(LogMessage *msg)
   log_threaded_source_worker_blocking_post(&super->super, msg);
 }
 
+bool
+SourceWorker::post_batch(std::vector<LogMessage *> &msgs)
+{
+  gsize posted = log_threaded_source_worker_blocking_post_batch(&super->super, msgs.data(), msgs.size());
+  bool all_posted = posted == msgs.size();
+
+  /* the worker is being terminated */
+  for (gsize i = posted; i < msgs.size(); i++)
+    log_msg_unref(msgs[i]);
+
+  log_threaded_source_worker_close_batch(&super->super);
+  msgs.clear();
+  return all_posted;
+}
+
 /* C Wrappers */
 
 static void
@@ -26,6 +26,8 @@
 
 #include "grpc-source.hpp"
 
+#include <vector>
+
 typedef struct GrpcSourceWorker_ GrpcSourceWorker;
 
 namespace syslogng {
@@ -40,6 +42,8 @@ public:
   virtual void run() = 0;
   virtual void request_exit() = 0;
   void post(LogMessage *msg);
+  /* returns false if not all messages could be posted, because the worker is terminating */
+  bool post_batch(std::vector<LogMessage *> &msgs);
 
 public:
   GrpcSourceWorker *super;
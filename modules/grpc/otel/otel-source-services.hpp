@@ -102,7 +102,8 @@ syslogng::grpc::otel::TraceServiceCall::Proceed(bool ok)
 
   ::grpc::Status response_status = ::grpc::Status::OK;
 
-  int msgs_in_fetch_round = 0;
+  std::vector<LogMessage *> batch;
+  batch.reserve(worker.driver.get_fetch_limit());
 
   for (const ResourceSpans &resource_spans : request.resource_spans())
     {
@@ -126,20 +127,15 @@ syslogng::grpc::otel::TraceServiceCall::Proceed(bool ok)
               ProtobufParser::store_raw_metadata(msg, ctx.peer(), resource, resource_spans_schema_url, scope,
                                                  scope_spans_schema_url);
               ProtobufParser::store_raw(msg, span);
-              worker.post(msg);
-
-              msgs_in_fetch_round++;
-              if (msgs_in_fetch_round == worker.driver.get_fetch_limit())
-                {
-                  log_threaded_source_worker_close_batch(&worker.super->super);
-                  msgs_in_fetch_round = 0;
-                }
+              batch.push_back(msg);
+              if (batch.size() == (std::size_t) worker.driver.get_fetch_limit() && !worker.post_batch(batch))
+                response_status = ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Server is unavailable");
             }
         }
     }
 
-  if (msgs_in_fetch_round != 0)
-    log_threaded_source_worker_close_batch(&worker.super->super);
+  if (!batch.empty() && !worker.post_batch(batch))
+    response_status = ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Server is unavailable");
 
   status = FINISH;
   responder.Finish(response, response_status, this);
@@ -159,7 +155,8 @@ syslogng::grpc::otel::LogsServiceCall::Proceed(bool ok)
 
   ::grpc::Status response_status = ::grpc::Status::OK;
 
-  int msgs_in_fetch_round = 0;
+  std::vector<LogMessage *> batch;
+  batch.reserve(worker.driver.get_fetch_limit());
 
   for (const ResourceLogs &resource_logs : request.resource_logs())
     {
@@ -191,20 +188,15 @@ syslogng::grpc::otel::LogsServiceCall::Proceed(bool ok)
                                                      scope_logs_schema_url);
                   ProtobufParser::store_raw(msg, log_record);
                 }
-              worker.post(msg);
-
-              msgs_in_fetch_round++;
-              if (msgs_in_fetch_round == worker.driver.get_fetch_limit())
-                {
-                  log_threaded_source_worker_close_batch(&worker.super->super);
-                  msgs_in_fetch_round = 0;
-                }
+              batch.push_back(msg);
+              if (batch.size() == (std::size_t) worker.driver.get_fetch_limit() && !worker.post_batch(batch))
+                response_status = ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Server is unavailable");
             }
         }
     }
 
-  if (msgs_in_fetch_round != 0)
-    log_threaded_source_worker_close_batch(&worker.super->super);
+  if (!batch.empty() && !worker.post_batch(batch))
+    response_status = ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Server is unavailable");
 
   status = FINISH;
   responder.Finish(response, response_status, this);
@@ -224,7 +216,8 @@ syslogng::grpc::otel::MetricsServiceCall::Proceed(bool ok)
 
   ::grpc::Status response_status = ::grpc::Status::OK;
 
-  int msgs_in_fetch_round = 0;
+  std::vector<LogMessage *> batch;
+  batch.reserve(worker.driver.get_fetch_limit());
 
   for (const ResourceMetrics &resource_metrics : request.resource_metrics())
     {
@@ -248,20 +241,15 @@ syslogng::grpc::otel::MetricsServiceCall::Proceed(bool ok)
               ProtobufParser::store_raw_metadata(msg, ctx.peer(), resource, resource_metrics_schema_url, scope,
                                                  scope_metrics_schema_url);
               ProtobufParser::store_raw(msg, metric);
-              worker.post(msg);
-
-              msgs_in_fetch_round++;
-              if (msgs_in_fetch_round == worker.driver.get_fetch_limit())
-                {
-                  log_threaded_source_worker_close_batch(&worker.super->super);
-                  msgs_in_fetch_round = 0;
-                }
+              batch.push_back(msg);
+              if (batch.size() == (std::size_t) worker.driver.get_fetch_limit() && !worker.post_batch(batch))
+                response_status = ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Server is unavailable");
             }
         }
     }
 
-  if (msgs_in_fetch_round != 0)
-    log_threaded_source_worker_close_batch(&worker.super->super);
+  if (!batch.empty() && !worker.post_batch(batch))
+    response_status = ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Server is unavailable");
 
   status = FINISH;
   responder.Finish(response, response_status, this);
@@ -274,7 +274,63 @@ deflate_compressor_new(void)
   rval->super.compress = _deflate_compressor_compress;
   return &rval->super;
 }
+
+static gboolean
+_inflate_content(GString *decompressed, const gchar *data, gsize length, gsize max_length)
+{
+  z_stream stream = {0};
+  gchar buffer[16384];
+  gint err;
+
+  /* MAX_WBITS + 32 lets zlib detect both the gzip and the zlib header */
+  if (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK)
+    return FALSE;
+
+  stream.next_in = (guchar *) data;
+  stream.avail_in = length;
+  do
+    {
+      stream.next_out = (guchar *) buffer;
+      stream.avail_out = sizeof(buffer);
+
+      err = inflate(&stream, Z_NO_FLUSH);
+      if (err != Z_OK && err != Z_STREAM_END)
+        break;
+
+      g_string_append_len(decompressed, buffer, sizeof(buffer) - stream.avail_out);
+      if (decompressed->len > max_length)
+        {
+          err = Z_BUF_ERROR;
+          break;
+        }
+    }
+  while (err != Z_STREAM_END && (stream.avail_in > 0 || stream.avail_out == 0));
+
+  inflateEnd(&stream);
+  return err == Z_STREAM_END;
+}
+#endif
+
+gboolean
+decompress_content(enum CurlCompressionTypes type, GString *decompressed, const gchar *data, gsize length,
+                   gsize max_length)
+{
+  switch (type)
+    {
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+    case CURL_COMPRESSION_GZIP:
+    case CURL_COMPRESSION_DEFLATE:
+      return _inflate_content(decompressed, data, length, max_length);
 #endif
+    case CURL_COMPRESSION_UNCOMPRESSED:
+      if (length > max_length)
+        return FALSE;
+      g_string_append_len(decompressed, data, length);
+      return TRUE;
+    default:
+      return FALSE;
+    }
+}
 
 
 Compressor *
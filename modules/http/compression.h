@@ -66,4 +66,8 @@ construct_compressor_by_type(enum CurlCompressionTypes type);
 enum CurlCompressionTypes
 compressor_lookup_type(const gchar *name);
 
+/* decompressing request bodies received by the http() source */
+gboolean decompress_content(enum CurlCompressionTypes type, GString *decompressed, const gchar *data, gsize length,
+                            gsize max_length);
+
 #endif //SYSLOG_NG_COMPRESSION_H
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "http-body-splitter.h"
+
+#include <string.h>
+
+static const gchar *http_body_format_names[] =
+{
+  [HTTP_BODY_FORMAT_AUTO] = "auto",
+  [HTTP_BODY_FORMAT_RAW] = "raw",
+  [HTTP_BODY_FORMAT_LINES] = "lines",
+  [HTTP_BODY_FORMAT_JSON] = "json",
+  [HTTP_BODY_FORMAT_SPLUNK_HEC] = "splunk-hec",
+  [HTTP_BODY_FORMAT_ELASTICSEARCH_BULK] = "elasticsearch-bulk",
+  [HTTP_BODY_FORMAT_OTLP] = "otlp",
+};
+
+gboolean
+http_body_format_lookup(const gchar *name, HttpBodyFormat *format)
+{
+  for (gint i = 0; i < G_N_ELEMENTS(http_body_format_names); i++)
+    {
+      if (strcmp(name, http_body_format_names[i]) == 0)
+        {
+          *format = i;
+          return TRUE;
+        }
+    }
+  return FALSE;
+}
+
+const gchar *
+http_body_format_get_name(HttpBodyFormat format)
+{
+  return http_body_format_names[format];
+}
+
+HttpBodyFormat
+http_body_format_detect(const gchar *path, const gchar *content_type)
+{
+  if (g_str_has_prefix(path, "/services/collector"))
+    return strstr(path, "/raw") ? HTTP_BODY_FORMAT_LINES : HTTP_BODY_FORMAT_SPLUNK_HEC;
+
+  if (g_str_has_suffix(path, "/_bulk"))
+    return HTTP_BODY_FORMAT_ELASTICSEARCH_BULK;
+
+  if (strcmp(path, "/v1/logs") == 0 || g_str_has_prefix(content_type, "application/x-protobuf"))
+    return HTTP_BODY_FORMAT_OTLP;
+
+  if (g_str_has_prefix(content_type, "application/json"))
+    return HTTP_BODY_FORMAT_JSON;
+
+  if (g_str_has_prefix(content_type, "text/") || g_str_has_prefix(content_type, "application/x-ndjson"))
+    return HTTP_BODY_FORMAT_LINES;
+
+  return HTTP_BODY_FORMAT_RAW;
+}
+
+static const gchar *
+_skip_whitespace(const gchar *p, const gchar *end)
+{
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    p++;
+  return p;
+}
+
+static const gchar *
+_skip_json_string(const gchar *p, const gchar *end)
+{
+  g_assert(*p == '"');
+
+  for (p++; p < end; p++)
+    {
+      if (*p == '\\')
+        p++;
+      else if (*p == '"')
+        return p + 1;
+    }
+  return NULL;
+}
+
+/*
+ * Returns the end of the JSON value starting at @p, without validating its
+ * contents: only string literals and the nesting of objects and arrays are
+ * tracked, the records are parsed later (e.g. by json-parser()).
+ */
+static const gchar *
+_skip_json_value(const gchar *p, const gchar *end)
+{
+  gint depth = 0;
+
+  while (p < end)
+    {
+      switch (*p)
+        {
+        case '"':
+          p = _skip_json_string(p, end);
+          if (!p)
+            return NULL;
+          if (depth == 0)
+            return p;
+          continue;
+        case '{':
+        case '[':
+          depth++;
+          break;
+        case '}':
+        case ']':
+          if (depth == 0)
+            return p;
+          depth--;
+          if (depth == 0)
+            return p + 1;
+          break;
+        case ',':
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+          if (depth == 0)
+            return p;
+          break;
+        default:
+          break;
+        }
+      p++;
+    }
+
+  return depth == 0 ? p : NULL;
+}
+
+static gboolean
+_split_json_array(const gchar *p, const gchar *end, HttpBodyRecordFunc func, gpointer user_data)
+{
+  g_assert(*p == '[');
+
+  p = _skip_whitespace(p + 1, end);
+  if (p < end && *p == ']')
+    return _skip_whitespace(p + 1, end) == end;
+
+  while (p < end)
+    {
+      const gchar *value_end = _skip_json_value(p, end);
+      if (!value_end || value_end == p)
+        return FALSE;
+
+      if (!func(p, value_end - p, user_data))
+        return TRUE;
+
+      p = _skip_whitespace(value_end, end);
+      if (p == end)
+        return FALSE;
+      if (*p == ']')
+        return _skip_whitespace(p + 1, end) == end;
+      if (*p != ',')
+        return FALSE;
+      p = _skip_whitespace(p + 1, end);
+    }
+  return FALSE;
+}
+
+/* newline delimited or simply concatenated JSON values, as sent by Splunk HEC clients */
+static gboolean
+_split_json_stream(const gchar *p, const gchar *end, HttpBodyRecordFunc func, gpointer user_data)
+{
+  for (p = _skip_whitespace(p, end); p < end; p = _skip_whitespace(p, end))
+    {
+      const gchar *value_end = _skip_json_value(p, end);
+      if (!value_end || value_end == p)
+        return FALSE;
+
+      if (!func(p, value_end - p, user_data))
+        return TRUE;
+      p = value_end;
+    }
+  return TRUE;
+}
+
+static gboolean
+_split_json(const gchar *body, gsize length, HttpBodyRecordFunc func, gpointer user_data)
+{
+  const gchar *end = body + length;
+  const gchar *p = _skip_whitespace(body, end);
+
+  if (p < end && *p == '[')
+    return _split_json_array(p, end, func, user_data);
+  return _split_json_stream(p, end, func, user_data);
+}
+
+static gboolean
+_foreach_line(const gchar *body, gsize length, HttpBodyRecordFunc func, gpointer user_data)
+{
+  const gchar *end = body + length;
+  const gchar *line = body;
+
+  while (line < end)
+    {
+      const gchar *eol = memchr(line, '\n', end - line);
+      const gchar *line_end = eol ? eol : end;
+      const gchar *next = eol ? eol + 1 : end;
+
+      if (line_end > line && line_end[-1] == '\r')
+        line_end--;
+
+      if (line_end > line && !func(line, line_end - line, user_data))
+        return FALSE;
+      line = next;
+    }
+  return TRUE;
+}
+
+typedef struct _HttpBulkSplitState
+{
+  HttpBodyRecordFunc func;
+  gpointer user_data;
+  gboolean expect_document;
+  gboolean error;
+} HttpBulkSplitState;
+
+static gboolean
+_bulk_action_has_document(const gchar *line, gsize length, gboolean *has_document)
+{
+  const gchar *end = line + length;
+  const gchar *p = _skip_whitespace(line, end);
+
+  if (p == end || *p != '{')
+    return FALSE;
+
+  p = _skip_whitespace(p + 1, end);
+  if (p == end || *p != '"')
+    return FALSE;
+
+  const gchar *action_end = _skip_json_string(p, end);
+  if (!action_end)
+    return FALSE;
+
+  /* every action is followed by a document, except for delete */
+  *has_document = !(action_end - p == 8 && memcmp(p, "\"delete\"", 8) == 0);
+  return TRUE;
+}
+
+static gboolean
+_split_bulk_line(const gchar *line, gsize length, gpointer user_data)
+{
+  HttpBulkSplitState *state = (HttpBulkSplitState *) user_data;
+
+  if (state->expect_document)
+    {
+      state->expect_document = FALSE;
+      return state->func(line, length, state->user_data);
+    }
+
+  if (!_bulk_action_has_document(line, length, &state->expect_document))
+    {
+      state->error = TRUE;
+      return FALSE;
+    }
+  return TRUE;
+}
+
+static gboolean
+_split_bulk(const gchar *body, gsize length, HttpBodyRecordFunc func, gpointer user_data)
+{
+  HttpBulkSplitState state = { .func = func, .user_data = user_data };
+
+  _foreach_line(body, length, _split_bulk_line, &state);
+  return !state.error && !state.expect_document;
+}
+
+gboolean
+http_body_split(HttpBodyFormat format, const gchar *body, gsize length, HttpBodyRecordFunc func, gpointer user_data)
+{
+  switch (format)
+    {
+    case HTTP_BODY_FORMAT_RAW:
+      if (length > 0)
+        func(body, length, user_data);
+      return TRUE;
+    case HTTP_BODY_FORMAT_LINES:
+      _foreach_line(body, length, func, user_data);
+      return TRUE;
+    case HTTP_BODY_FORMAT_JSON:
+    case HTTP_BODY_FORMAT_SPLUNK_HEC:
+      return _split_json(body, length, func, user_data);
+    case HTTP_BODY_FORMAT_ELASTICSEARCH_BULK:
+      return _split_bulk(body, length, func, user_data);
+    default:
+      return FALSE;
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef HTTP_BODY_SPLITTER_H_INCLUDED
+#define HTTP_BODY_SPLITTER_H_INCLUDED
+
+#include "syslog-ng.h"
+
+typedef enum
+{
+  HTTP_BODY_FORMAT_AUTO,
+  HTTP_BODY_FORMAT_RAW,
+  HTTP_BODY_FORMAT_LINES,
+  HTTP_BODY_FORMAT_JSON,
+  HTTP_BODY_FORMAT_SPLUNK_HEC,
+  HTTP_BODY_FORMAT_ELASTICSEARCH_BULK,
+  HTTP_BODY_FORMAT_OTLP,
+} HttpBodyFormat;
+
+/* returns FALSE to stop the iteration */
+typedef gboolean (*HttpBodyRecordFunc)(const gchar *record, gsize length, gpointer user_data);
+
+gboolean http_body_format_lookup(const gchar *name, HttpBodyFormat *format);
+HttpBodyFormat http_body_format_detect(const gchar *path, const gchar *content_type);
+const gchar *http_body_format_get_name(HttpBodyFormat format);
+
+gboolean http_body_split(HttpBodyFormat format, const gchar *body, gsize length,
+                         HttpBodyRecordFunc func, gpointer user_data);
+
+#endif
@@ -69,6 +69,26 @@ static CfgLexerKeyword http_keywords[] =
   { "delimiter",        KW_DELIMITER },
   { "accept_encoding",  KW_ACCEPT_ENCODING },
   { "content_compression",    KW_CONTENT_COMPRESSION },
+  { "ip",               KW_IP },
+  { "port",             KW_PORT },
+  { "auth_token",       KW_AUTH_TOKEN },
+  { "max_body_size",    KW_MAX_BODY_SIZE },
+  { "max_connections",  KW_MAX_CONNECTIONS },
+  { "body_format",      KW_BODY_FORMAT },
+  { "s3_native",        KW_S3_NATIVE },
+  { "bucket",           KW_BUCKET },
+  { "region",           KW_REGION },
+  { "access_key",       KW_ACCESS_KEY },
+  { "secret_key",       KW_SECRET_KEY },
+  { "storage_class",    KW_STORAGE_CLASS },
+  { "object_key",       KW_OBJECT_KEY },
+  { "chunk_size",       KW_CHUNK_SIZE },
+  { "max_object_size",  KW_MAX_OBJECT_SIZE },
+  { "flush_grace_period", KW_FLUSH_GRACE_PERIOD },
+  { "upload_threads",   KW_UPLOAD_THREADS },
+  { "max_pending_uploads", KW_MAX_PENDING_UPLOADS },
+  { "compression",      KW_COMPRESSION },
+  { "working_dir",      KW_WORKING_DIR },
   { NULL }
 };
 
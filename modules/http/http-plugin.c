@@ -31,6 +31,16 @@ static Plugin http_plugins[] =
     .name = "http",
     .parser = &http_parser,
   },
+  {
+    .type = LL_CONTEXT_SOURCE,
+    .name = "http",
+    .parser = &http_parser,
+  },
+  {
+    .type = LL_CONTEXT_DESTINATION,
+    .name = "s3-native",
+    .parser = &http_parser,
+  },
 };
 
 gboolean
@@ -44,7 +54,7 @@ const ModuleInfo module_info =
 {
   .canonical_name = "http",
   .version = SYSLOG_NG_VERSION,
-  .description = "The http module provides HTTP destination support for syslog-ng.",
+  .description = "The http module provides HTTP source and destination, and native S3 destination support for syslog-ng.",
   .core_revision = SYSLOG_NG_SOURCE_REVISION,
   .plugins = http_plugins,
   .plugins_len = G_N_ELEMENTS(http_plugins),
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "http-request-parser.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+#define HTTP_REQUEST_MAX_HEADER_SIZE 16384
+#define HTTP_REQUEST_MAX_CHUNK_LINE_SIZE 1024
+
+void
+http_request_init(HttpRequest *self)
+{
+  self->method = g_string_sized_new(8);
+  self->path = g_string_sized_new(64);
+  self->query = g_string_sized_new(64);
+  self->content_type = g_string_sized_new(32);
+  self->content_encoding = g_string_sized_new(16);
+  self->authorization = g_string_sized_new(64);
+  self->body = g_string_sized_new(4096);
+  self->keep_alive = FALSE;
+  memset(&self->parse_state, 0, sizeof(self->parse_state));
+}
+
+void
+http_request_clear(HttpRequest *self)
+{
+  g_string_free(self->method, TRUE);
+  g_string_free(self->path, TRUE);
+  g_string_free(self->query, TRUE);
+  g_string_free(self->content_type, TRUE);
+  g_string_free(self->content_encoding, TRUE);
+  g_string_free(self->authorization, TRUE);
+  g_string_free(self->body, TRUE);
+}
+
+void
+http_request_reset(HttpRequest *self)
+{
+  g_string_truncate(self->method, 0);
+  g_string_truncate(self->path, 0);
+  g_string_truncate(self->query, 0);
+  g_string_truncate(self->content_type, 0);
+  g_string_truncate(self->content_encoding, 0);
+  g_string_truncate(self->authorization, 0);
+  g_string_truncate(self->body, 0);
+  self->keep_alive = FALSE;
+  memset(&self->parse_state, 0, sizeof(self->parse_state));
+}
+
+static const gchar *
+_find(const gchar *haystack, const gchar *end, const gchar *needle, gsize needle_len)
+{
+  const gchar *p = haystack;
+
+  while ((p = memchr(p, needle[0], end - p)) != NULL)
+    {
+      if (end - p < needle_len)
+        return NULL;
+      if (memcmp(p, needle, needle_len) == 0)
+        return p;
+      p++;
+    }
+  return NULL;
+}
+
+static gboolean
+_parse_request_line(HttpRequest *self, const gchar *line, const gchar *end)
+{
+  const gchar *method_end = memchr(line, ' ', end - line);
+  if (!method_end || method_end == line)
+    return FALSE;
+
+  const gchar *target = method_end + 1;
+  const gchar *target_end = memchr(target, ' ', end - target);
+  if (!target_end || target_end == target)
+    return FALSE;
+
+  const gchar *version = target_end + 1;
+  if (end - version != 8 || strncmp(version, "HTTP/1.", 7) != 0)
+    return FALSE;
+
+  g_string_assign_len(self->method, line, method_end - line);
+
+  const gchar *query = memchr(target, '?', target_end - target);
+  if (query)
+    {
+      g_string_assign_len(self->path, target, query - target);
+      g_string_assign_len(self->query, query + 1, target_end - query - 1);
+    }
+  else
+    {
+      g_string_assign_len(self->path, target, target_end - target);
+    }
+
+  /* HTTP/1.1 connections are persistent by default, HTTP/1.0 ones are not */
+  self->keep_alive = version[7] != '0';
+  return TRUE;
+}
+
+static gboolean
+_header_name_equals(const gchar *name, gsize name_len, const gchar *expected)
+{
+  return strlen(expected) == name_len && g_ascii_strncasecmp(name, expected, name_len) == 0;
+}
+
+static gboolean
+_value_equals(const gchar *value, gsize value_len, const gchar *expected)
+{
+  return _header_name_equals(value, value_len, expected);
+}
+
+static gboolean
+_parse_header(HttpRequest *self, const gchar *line, const gchar *end)
+{
+  HttpRequestParseState *state = &self->parse_state;
+  const gchar *colon = memchr(line, ':', end - line);
+  if (!colon || colon == line)
+    return FALSE;
+
+  const gchar *name = line;
+  gsize name_len = colon - line;
+  const gchar *value = colon + 1;
+  const gchar *value_end = end;
+
+  while (value < value_end && (*value == ' ' || *value == '\t'))
+    value++;
+  while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t'))
+    value_end--;
+  gsize value_len = value_end - value;
+
+  if (_header_name_equals(name, name_len, "content-length"))
+    {
+      gchar *digits_end;
+      gchar *digits = g_strndup(value, value_len);
+
+      state->content_length = g_ascii_strtoull(digits, &digits_end, 10);
+      gboolean valid = digits[0] && *digits_end == 0;
+      g_free(digits);
+
+      if (!valid)
+        return FALSE;
+      state->has_content_length = TRUE;
+    }
+  else if (_header_name_equals(name, name_len, "transfer-encoding"))
+    {
+      if (!_value_equals(value, value_len, "chunked"))
+        return FALSE;
+      state->chunked = TRUE;
+    }
+  else if (_header_name_equals(name, name_len, "connection"))
+    {
+      if (_value_equals(value, value_len, "close"))
+        self->keep_alive = FALSE;
+      else if (_value_equals(value, value_len, "keep-alive"))
+        self->keep_alive = TRUE;
+    }
+  else if (_header_name_equals(name, name_len, "content-type"))
+    g_string_assign_len(self->content_type, value, value_len);
+  else if (_header_name_equals(name, name_len, "content-encoding"))
+    g_string_assign_len(self->content_encoding, value, value_len);
+  else if (_header_name_equals(name, name_len, "authorization"))
+    g_string_assign_len(self->authorization, value, value_len);
+
+  return TRUE;
+}
+
+/* chunks are only consumed as a whole, the parse state points to the next chunk-size line */
+static HttpRequestParseResult
+_parse_chunked_body(HttpRequest *self, const gchar *buffer, const gchar *end, gsize max_body_size)
+{
+  HttpRequestParseState *state = &self->parse_state;
+  const gchar *p = buffer + state->offset;
+
+  while (!state->trailer)
+    {
+      const gchar *size_end = _find(p, end, "\r\n", 2);
+      if (!size_end)
+        return end - p > HTTP_REQUEST_MAX_CHUNK_LINE_SIZE ? HTTP_REQUEST_PARSE_ERROR : HTTP_REQUEST_PARSE_INCOMPLETE;
+
+      gchar *hex_end;
+      guint64 chunk_size = g_ascii_strtoull(p, &hex_end, 16);
+      if (hex_end == p || (hex_end != size_end && *hex_end != ';'))
+        return HTTP_REQUEST_PARSE_ERROR;
+
+      /* also catches sizes that overflowed g_ascii_strtoull() */
+      if (chunk_size > G_MAXSSIZE)
+        return HTTP_REQUEST_PARSE_ERROR;
+
+      const gchar *data = size_end + 2;
+      if (chunk_size == 0)
+        {
+          state->trailer = TRUE;
+          p = data;
+          state->offset = p - buffer;
+          break;
+        }
+
+      if (self->body->len > max_body_size || chunk_size > max_body_size - self->body->len)
+        return HTTP_REQUEST_PARSE_TOO_LARGE;
+
+      if (end - data < chunk_size + 2)
+        return HTTP_REQUEST_PARSE_INCOMPLETE;
+
+      if (data[chunk_size] != '\r' || data[chunk_size + 1] != '\n')
+        return HTTP_REQUEST_PARSE_ERROR;
+
+      g_string_append_len(self->body, data, chunk_size);
+      p = data + chunk_size + 2;
+      state->offset = p - buffer;
+    }
+
+  /* skip the (optional) trailer section, terminated by an empty line */
+  while (TRUE)
+    {
+      const gchar *line_end = _find(p, end, "\r\n", 2);
+      if (!line_end)
+        return end - p > HTTP_REQUEST_MAX_HEADER_SIZE ? HTTP_REQUEST_PARSE_ERROR : HTTP_REQUEST_PARSE_INCOMPLETE;
+
+      gboolean empty_line = line_end == p;
+      p = line_end + 2;
+      state->offset = p - buffer;
+      if (empty_line)
+        break;
+    }
+
+  return HTTP_REQUEST_PARSE_SUCCESS;
+}
+
+static HttpRequestParseResult
+_parse_headers(HttpRequest *self, const gchar *buffer, const gchar *end)
+{
+  HttpRequestParseState *state = &self->parse_state;
+  gsize length = end - buffer;
+
+  /* the terminating "\r\n\r\n" may have been split between reads */
+  const gchar *headers_end = _find(buffer + state->offset, end, "\r\n\r\n", 4);
+  if (!headers_end)
+    {
+      state->offset = length > 3 ? length - 3 : 0;
+      return length > HTTP_REQUEST_MAX_HEADER_SIZE ? HTTP_REQUEST_PARSE_ERROR : HTTP_REQUEST_PARSE_INCOMPLETE;
+    }
+
+  const gchar *line_end = _find(buffer, headers_end + 2, "\r\n", 2);
+  if (!_parse_request_line(self, buffer, line_end))
+    return HTTP_REQUEST_PARSE_ERROR;
+
+  for (const gchar *line = line_end + 2; line < headers_end + 2; line = line_end + 2)
+    {
+      line_end = _find(line, headers_end + 2, "\r\n", 2);
+      if (!_parse_header(self, line, line_end))
+        return HTTP_REQUEST_PARSE_ERROR;
+    }
+
+  state->headers_done = TRUE;
+  state->offset = headers_end + 4 - buffer;
+  return HTTP_REQUEST_PARSE_SUCCESS;
+}
+
+static HttpRequestParseResult
+_parse_request(HttpRequest *self, const gchar *buffer, gsize length, gsize max_body_size, gsize *consumed)
+{
+  HttpRequestParseState *state = &self->parse_state;
+  const gchar *end = buffer + length;
+
+  if (!state->headers_done)
+    {
+      if (state->offset == 0)
+        http_request_reset(self);
+
+      HttpRequestParseResult result = _parse_headers(self, buffer, end);
+      if (result != HTTP_REQUEST_PARSE_SUCCESS)
+        return result;
+    }
+
+  if (state->chunked)
+    {
+      HttpRequestParseResult result = _parse_chunked_body(self, buffer, end, max_body_size);
+      if (result != HTTP_REQUEST_PARSE_SUCCESS)
+        return result;
+    }
+  else if (state->has_content_length)
+    {
+      const gchar *body = buffer + state->offset;
+
+      if (state->content_length > max_body_size)
+        return HTTP_REQUEST_PARSE_TOO_LARGE;
+
+      if (end - body < state->content_length)
+        return HTTP_REQUEST_PARSE_INCOMPLETE;
+
+      g_string_append_len(self->body, body, state->content_length);
+      state->offset += state->content_length;
+    }
+
+  *consumed = state->offset;
+  return HTTP_REQUEST_PARSE_SUCCESS;
+}
+
+HttpRequestParseResult
+http_request_parse(HttpRequest *self, const gchar *buffer, gsize length, gsize max_body_size, gsize *consumed)
+{
+  HttpRequestParseResult result = _parse_request(self, buffer, length, max_body_size, consumed);
+
+  if (result != HTTP_REQUEST_PARSE_INCOMPLETE)
+    memset(&self->parse_state, 0, sizeof(self->parse_state));
+  return result;
+}
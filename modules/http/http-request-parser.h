@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef HTTP_REQUEST_PARSER_H_INCLUDED
+#define HTTP_REQUEST_PARSER_H_INCLUDED
+
+#include "syslog-ng.h"
+
+typedef enum
+{
+  HTTP_REQUEST_PARSE_INCOMPLETE,
+  HTTP_REQUEST_PARSE_SUCCESS,
+  HTTP_REQUEST_PARSE_ERROR,
+  HTTP_REQUEST_PARSE_TOO_LARGE,
+} HttpRequestParseResult;
+
+/* progress of the parser, kept between HTTP_REQUEST_PARSE_INCOMPLETE results */
+typedef struct _HttpRequestParseState
+{
+  gsize offset;
+  gboolean headers_done;
+  gboolean chunked;
+  gboolean trailer;
+  gboolean has_content_length;
+  guint64 content_length;
+} HttpRequestParseState;
+
+typedef struct _HttpRequest
+{
+  GString *method;
+  GString *path;
+  GString *query;
+  GString *content_type;
+  GString *content_encoding;
+  GString *authorization;
+  GString *body;
+  gboolean keep_alive;
+  HttpRequestParseState parse_state;
+} HttpRequest;
+
+void http_request_init(HttpRequest *self);
+void http_request_clear(HttpRequest *self);
+void http_request_reset(HttpRequest *self);
+
+/*
+ * Parses a complete HTTP/1.x request from the start of @buffer, the body
+ * is stored as-is (after decoding the chunked transfer encoding).  Returns
+ * HTTP_REQUEST_PARSE_INCOMPLETE if more data is needed, in which case the
+ * caller should call it again with the same buffer start once more data
+ * has arrived: the parser continues where it left off, so the already
+ * processed part of the request is not parsed again.  Any other result
+ * starts a new request on the next call, http_request_reset() can be used
+ * to abandon an incomplete one.  @consumed is set to the length of the
+ * request on success.
+ */
+HttpRequestParseResult http_request_parse(HttpRequest *self, const gchar *buffer, gsize length,
+                                          gsize max_body_size, gsize *consumed);
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "http-source-response.h"
+
+#include <string.h>
+
+void
+http_source_response_set(HttpSourceResponse *self, gint status, const gchar *reason, const gchar *body)
+{
+  self->status = status;
+  self->reason = reason;
+  self->body = body;
+}
+
+void
+http_source_response_format(const HttpSourceResponse *self, GString *buffer)
+{
+  g_string_printf(buffer,
+                  "HTTP/1.1 %d %s\r\n"
+                  "Server: axosyslog\r\n"
+                  "Content-Type: application/json\r\n"
+                  "Content-Length: %" G_GSIZE_FORMAT "\r\n"
+                  "Connection: %s\r\n",
+                  self->status, self->reason, strlen(self->body),
+                  self->close_connection ? "close" : "keep-alive");
+  if (self->status == 429 || self->status == 503)
+    g_string_append(buffer, "Retry-After: 1\r\n");
+  g_string_append(buffer, "\r\n");
+
+  if (!self->omit_body)
+    g_string_append(buffer, self->body);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef HTTP_SOURCE_RESPONSE_H_INCLUDED
+#define HTTP_SOURCE_RESPONSE_H_INCLUDED
+
+#include "syslog-ng.h"
+
+typedef struct _HttpSourceResponse
+{
+  gint status;
+  const gchar *reason;
+  const gchar *body;
+  gboolean close_connection;
+  /* responses to HEAD requests carry the headers of the body, but not the body itself */
+  gboolean omit_body;
+} HttpSourceResponse;
+
+void http_source_response_set(HttpSourceResponse *self, gint status, const gchar *reason, const gchar *body);
+void http_source_response_format(const HttpSourceResponse *self, GString *buffer);
+
+#endif
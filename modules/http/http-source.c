@@ -0,0 +1,811 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "http-source.h"
+#include "http-request-parser.h"
+#include "http-body-splitter.h"
+#include "http-source-response.h"
+#include "compression.h"
+#include "logthrsource/logthrsourcedrv.h"
+#include "gsockaddr.h"
+#include "fdhelpers.h"
+#include "messages.h"
+#include "timeutils/cache.h"
+
+#include <sys/socket.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#define HTTP_SOURCE_READ_SIZE 65536
+#define HTTP_SOURCE_SEND_TIMEOUT 1000
+
+typedef struct _HttpSourceDriver
+{
+  LogThreadedSourceDriver super;
+  gchar *ip;
+  gint port;
+  gchar *auth_token;
+  gsize max_body_size;
+  gint max_connections;
+  gint max_connections_per_worker;
+  gint idle_timeout;
+  HttpBodyFormat body_format;
+  gint listen_fd;
+} HttpSourceDriver;
+
+typedef struct _HttpSourceConnection
+{
+  gint fd;
+  GSockAddr *peer_addr;
+  GString *buffer;
+  HttpRequest request;
+  time_t last_activity;
+
+  /* records of the current request, the ones from pending_posted on did not fit into the window yet */
+  GPtrArray *pending_msgs;
+  guint pending_posted;
+  HttpSourceResponse pending_response;
+} HttpSourceConnection;
+
+/*
+ * Every worker runs its own poll() loop over the shared listening socket
+ * and the connections it has accepted, so the source scales with the
+ * number of workers().  While the source window is exhausted, new requests
+ * are rejected with 429 and the client is expected to retry.  The records
+ * of an accepted request are posted as far as the window allows, the rest
+ * is kept on its connection and posted when the window opens up again:
+ * the connection is not read and its response is not sent until then,
+ * while the other connections of the worker are served as usual.
+ */
+typedef struct _HttpSourceWorker
+{
+  LogThreadedSourceWorker super;
+  gint wakeup_fds[2];
+  gboolean exit_requested;
+  GPtrArray *connections;
+  GString *decompressed;
+} HttpSourceWorker;
+
+static NVHandle handle_http_path;
+static NVHandle handle_http_method;
+
+static HttpSourceConnection *
+_connection_new(gint fd, GSockAddr *peer_addr)
+{
+  HttpSourceConnection *self = g_new0(HttpSourceConnection, 1);
+
+  self->fd = fd;
+  self->peer_addr = peer_addr;
+  self->buffer = g_string_sized_new(HTTP_SOURCE_READ_SIZE);
+  http_request_init(&self->request);
+  self->last_activity = get_cached_realtime_sec();
+  self->pending_msgs = g_ptr_array_new();
+  return self;
+}
+
+static void
+_connection_drop_pending_msgs(HttpSourceConnection *self)
+{
+  for (guint i = self->pending_posted; i < self->pending_msgs->len; i++)
+    log_msg_unref(g_ptr_array_index(self->pending_msgs, i));
+
+  g_ptr_array_set_size(self->pending_msgs, 0);
+  self->pending_posted = 0;
+}
+
+static void
+_connection_free(HttpSourceConnection *self)
+{
+  _connection_drop_pending_msgs(self);
+  g_ptr_array_free(self->pending_msgs, TRUE);
+
+  close(self->fd);
+  g_sockaddr_unref(self->peer_addr);
+  g_string_free(self->buffer, TRUE);
+  http_request_clear(&self->request);
+  g_free(self);
+}
+
+static inline gboolean
+_connection_has_pending_msgs(HttpSourceConnection *self)
+{
+  return self->pending_msgs->len > 0;
+}
+
+static gboolean
+_connection_send(HttpSourceConnection *self, const gchar *data, gsize length)
+{
+  while (length > 0)
+    {
+      gssize rc = send(self->fd, data, length, MSG_NOSIGNAL);
+      if (rc < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          if (errno != EAGAIN && errno != EWOULDBLOCK)
+            return FALSE;
+
+          struct pollfd pfd = { .fd = self->fd, .events = POLLOUT };
+          if (poll(&pfd, 1, HTTP_SOURCE_SEND_TIMEOUT) <= 0)
+            return FALSE;
+          continue;
+        }
+      data += rc;
+      length -= rc;
+    }
+  return TRUE;
+}
+
+static gboolean
+_connection_send_response(HttpSourceConnection *self, const HttpSourceResponse *response)
+{
+  GString *buffer = g_string_sized_new(256);
+
+  http_source_response_format(response, buffer);
+  gboolean result = _connection_send(self, buffer->str, buffer->len);
+  g_string_free(buffer, TRUE);
+  return result;
+}
+
+static const gchar *
+_success_response_body(HttpBodyFormat format)
+{
+  switch (format)
+    {
+    case HTTP_BODY_FORMAT_SPLUNK_HEC:
+      return "{\"text\":\"Success\",\"code\":0}";
+    case HTTP_BODY_FORMAT_ELASTICSEARCH_BULK:
+      return "{\"took\":0,\"errors\":false,\"items\":[]}";
+    default:
+      return "{\"status\":\"received\"}";
+    }
+}
+
+/* runs in constant time, so that the token cannot be guessed byte-by-byte from the response times */
+static gboolean
+_token_equals(const gchar *token, const gchar *expected)
+{
+  gsize token_len = strlen(token);
+  gsize expected_len = strlen(expected);
+  guchar diff = token_len != expected_len;
+
+  for (gsize i = 0; i < expected_len; i++)
+    diff |= expected[i] ^ (i < token_len ? token[i] : 0);
+
+  return diff == 0;
+}
+
+static gboolean
+_is_authorized(HttpSourceDriver *self, HttpRequest *request)
+{
+  if (!self->auth_token)
+    return TRUE;
+
+  /* "Bearer <token>" or "Splunk <token>", the scheme is not checked */
+  const gchar *token = strchr(request->authorization->str, ' ');
+  if (!token)
+    return FALSE;
+
+  while (*token == ' ')
+    token++;
+  return _token_equals(token, self->auth_token);
+}
+
+typedef struct _HttpSourcePostState
+{
+  HttpSourceWorker *worker;
+  HttpSourceConnection *connection;
+  HttpRequest *request;
+  gboolean aborted;
+} HttpSourcePostState;
+
+static gboolean
+_collect_record(const gchar *record, gsize length, gpointer user_data)
+{
+  HttpSourcePostState *state = (HttpSourcePostState *) user_data;
+  HttpSourceWorker *worker = state->worker;
+
+  if (worker->super.under_termination)
+    {
+      state->aborted = TRUE;
+      return FALSE;
+    }
+
+  LogMessage *msg = log_msg_new_empty();
+  log_msg_set_value(msg, LM_V_MESSAGE, record, length);
+  log_msg_set_value(msg, handle_http_method, state->request->method->str, state->request->method->len);
+  log_msg_set_value(msg, handle_http_path, state->request->path->str, state->request->path->len);
+  log_msg_set_saddr(msg, state->connection->peer_addr);
+
+  g_ptr_array_add(state->connection->pending_msgs, msg);
+  return TRUE;
+}
+
+/*
+ * Posts the pending records of the connection without blocking the worker,
+ * returns TRUE if all of them have been posted.
+ */
+static gboolean
+_post_pending_msgs(HttpSourceWorker *self, HttpSourceConnection *connection)
+{
+  GPtrArray *msgs = connection->pending_msgs;
+  guint first = connection->pending_posted;
+
+  while (connection->pending_posted < msgs->len && log_threaded_source_worker_free_to_send(&self->super))
+    log_threaded_source_worker_post(&self->super, g_ptr_array_index(msgs, connection->pending_posted++));
+
+  if (connection->pending_posted != first)
+    log_threaded_source_worker_close_batch(&self->super);
+
+  if (connection->pending_posted < msgs->len)
+    return FALSE;
+
+  g_ptr_array_set_size(msgs, 0);
+  connection->pending_posted = 0;
+  return TRUE;
+}
+
+static const GString *
+_decode_body(HttpSourceWorker *self, HttpRequest *request, HttpSourceResponse *response)
+{
+  HttpSourceDriver *control = (HttpSourceDriver *) self->super.control;
+  const gchar *encoding = request->content_encoding->str;
+
+  if (!encoding[0] || strcmp(encoding, "identity") == 0)
+    return request->body;
+
+  enum CurlCompressionTypes type = compressor_lookup_type(encoding);
+  if (type == CURL_COMPRESSION_UNKNOWN)
+    {
+      http_source_response_set(response, 415, "Unsupported Media Type",
+                               "{\"status\":\"unsupported content-encoding\"}");
+      return NULL;
+    }
+
+  g_string_truncate(self->decompressed, 0);
+  if (!decompress_content(type, self->decompressed, request->body->str, request->body->len, control->max_body_size))
+    {
+      http_source_response_set(response, 400, "Bad Request", "{\"status\":\"decompression failed\"}");
+      return NULL;
+    }
+  return self->decompressed;
+}
+
+static void
+_handle_request(HttpSourceWorker *self, HttpSourceConnection *connection, HttpRequest *request,
+                HttpSourceResponse *response)
+{
+  HttpSourceDriver *control = (HttpSourceDriver *) self->super.control;
+  const gchar *method = request->method->str;
+
+  if (strcmp(method, "GET") == 0 || strcmp(method, "HEAD") == 0)
+    {
+      /* health checks and version probes of the clients */
+      http_source_response_set(response, 200, "OK", "{\"status\":\"ok\"}");
+      return;
+    }
+
+  if (strcmp(method, "POST") != 0 && strcmp(method, "PUT") != 0)
+    {
+      http_source_response_set(response, 405, "Method Not Allowed", "{\"status\":\"method not allowed\"}");
+      return;
+    }
+
+  if (!_is_authorized(control, request))
+    {
+      http_source_response_set(response, 401, "Unauthorized", "{\"status\":\"unauthorized\"}");
+      return;
+    }
+
+  HttpBodyFormat format = control->body_format;
+  if (format == HTTP_BODY_FORMAT_AUTO)
+    format = http_body_format_detect(request->path->str, request->content_type->str);
+
+  if (format == HTTP_BODY_FORMAT_OTLP)
+    {
+      http_source_response_set(response, 415, "Unsupported Media Type",
+                               "{\"status\":\"OTLP payloads are not supported, use the opentelemetry() source\"}");
+      return;
+    }
+
+  if (!log_threaded_source_worker_free_to_send(&self->super))
+    {
+      http_source_response_set(response, 429, "Too Many Requests", "{\"status\":\"flow-controlled\"}");
+      return;
+    }
+
+  const GString *body = _decode_body(self, request, response);
+  if (!body)
+    return;
+
+  HttpSourcePostState state = { .worker = self, .connection = connection, .request = request };
+  gboolean valid = http_body_split(format, body->str, body->len, _collect_record, &state);
+
+  if (state.aborted)
+    {
+      /* the client is going to retry the whole request */
+      _connection_drop_pending_msgs(connection);
+      http_source_response_set(response, 503, "Service Unavailable", "{\"status\":\"shutting down\"}");
+      response->close_connection = TRUE;
+    }
+  else if (!valid)
+    {
+      msg_debug("http(): Invalid request body",
+                evt_tag_str("driver", control->super.super.super.id),
+                evt_tag_str("path", request->path->str),
+                evt_tag_str("body_format", http_body_format_get_name(format)));
+      http_source_response_set(response, 400, "Bad Request", "{\"status\":\"invalid body\"}");
+    }
+  else
+    {
+      http_source_response_set(response, 200, "OK", _success_response_body(format));
+    }
+}
+
+/* returns FALSE if the connection has to be closed */
+static gboolean
+_process_requests(HttpSourceWorker *self, HttpSourceConnection *connection)
+{
+  HttpSourceDriver *control = (HttpSourceDriver *) self->super.control;
+
+  if (_connection_has_pending_msgs(connection))
+    {
+      if (!_post_pending_msgs(self, connection))
+        return TRUE;
+
+      HttpSourceResponse *response = &connection->pending_response;
+      if (!_connection_send_response(connection, response) || response->close_connection)
+        return FALSE;
+    }
+
+  while (connection->buffer->len > 0)
+    {
+      HttpSourceResponse response = { 0 };
+      gsize consumed = 0;
+
+      switch (http_request_parse(&connection->request, connection->buffer->str, connection->buffer->len,
+                                 control->max_body_size, &consumed))
+        {
+        case HTTP_REQUEST_PARSE_INCOMPLETE:
+          return TRUE;
+        case HTTP_REQUEST_PARSE_ERROR:
+          http_source_response_set(&response, 400, "Bad Request", "{\"status\":\"bad request\"}");
+          response.close_connection = TRUE;
+          break;
+        case HTTP_REQUEST_PARSE_TOO_LARGE:
+          http_source_response_set(&response, 413, "Payload Too Large", "{\"status\":\"payload too large\"}");
+          response.close_connection = TRUE;
+          break;
+        case HTTP_REQUEST_PARSE_SUCCESS:
+          response.close_connection = !connection->request.keep_alive;
+          response.omit_body = strcmp(connection->request.method->str, "HEAD") == 0;
+          _handle_request(self, connection, &connection->request, &response);
+          g_string_erase(connection->buffer, 0, consumed);
+
+          if (!_post_pending_msgs(self, connection))
+            {
+              connection->pending_response = response;
+              return TRUE;
+            }
+          break;
+        default:
+          g_assert_not_reached();
+        }
+
+      if (!_connection_send_response(connection, &response) || response.close_connection)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+_read_connection(HttpSourceWorker *self, HttpSourceConnection *connection)
+{
+  gsize old_len = connection->buffer->len;
+
+  g_string_set_size(connection->buffer, old_len + HTTP_SOURCE_READ_SIZE);
+  gssize rc = recv(connection->fd, connection->buffer->str + old_len, HTTP_SOURCE_READ_SIZE, 0);
+  g_string_set_size(connection->buffer, old_len + MAX(rc, 0));
+
+  if (rc < 0)
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+  if (rc == 0)
+    return FALSE;
+
+  connection->last_activity = get_cached_realtime_sec();
+  return _process_requests(self, connection);
+}
+
+static void
+_accept_connections(HttpSourceWorker *self)
+{
+  HttpSourceDriver *control = (HttpSourceDriver *) self->super.control;
+
+  while (self->connections->len < control->max_connections_per_worker)
+    {
+      struct sockaddr_storage peer;
+      socklen_t peer_len = sizeof(peer);
+
+      gint fd = accept(control->listen_fd, (struct sockaddr *) &peer, &peer_len);
+      if (fd < 0)
+        {
+          if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            msg_error("http(): Error accepting connection",
+                      evt_tag_str("driver", control->super.super.super.id),
+                      evt_tag_error("error"));
+          return;
+        }
+
+      g_fd_set_nonblock(fd, TRUE);
+      g_fd_set_cloexec(fd, TRUE);
+      g_ptr_array_add(self->connections, _connection_new(fd, g_sockaddr_new((struct sockaddr *) &peer, peer_len)));
+    }
+}
+
+static void
+_close_idle_connections(HttpSourceWorker *self)
+{
+  HttpSourceDriver *control = (HttpSourceDriver *) self->super.control;
+  time_t now = get_cached_realtime_sec();
+
+  for (gint i = self->connections->len - 1; i >= 0; i--)
+    {
+      HttpSourceConnection *connection = g_ptr_array_index(self->connections, i);
+
+      if (!_connection_has_pending_msgs(connection) && connection->last_activity + control->idle_timeout < now)
+        g_ptr_array_remove_index_fast(self->connections, i);
+    }
+}
+
+static void
+_drain_wakeup_pipe(HttpSourceWorker *self)
+{
+  gchar buffer[64];
+
+  while (read(self->wakeup_fds[0], buffer, sizeof(buffer)) > 0)
+    ;
+}
+
+/* runs in a dedicated thread */
+static void
+_worker_run(LogThreadedSourceWorker *s)
+{
+  HttpSourceWorker *self = (HttpSourceWorker *) s;
+  HttpSourceDriver *control = (HttpSourceDriver *) s->control;
+  GArray *pfds = g_array_new(FALSE, FALSE, sizeof(struct pollfd));
+
+  while (!g_atomic_int_get(&self->exit_requested))
+    {
+      struct pollfd pfd = { .events = POLLIN };
+
+      g_array_set_size(pfds, 0);
+      pfd.fd = self->wakeup_fds[0];
+      g_array_append_val(pfds, pfd);
+      pfd.fd = self->connections->len < control->max_connections_per_worker ? control->listen_fd : -1;
+      g_array_append_val(pfds, pfd);
+      for (gint i = 0; i < self->connections->len; i++)
+        {
+          HttpSourceConnection *connection = g_ptr_array_index(self->connections, i);
+
+          /* connections waiting for the window are not read, poll() ignores negative fds */
+          pfd.fd = _connection_has_pending_msgs(connection) ? -1 : connection->fd;
+          g_array_append_val(pfds, pfd);
+        }
+
+      gint rc = poll((struct pollfd *) pfds->data, pfds->len, 1000);
+      if (rc < 0 && errno != EINTR)
+        {
+          msg_error("http(): poll() failed",
+                    evt_tag_str("driver", control->super.super.super.id),
+                    evt_tag_error("error"));
+          break;
+        }
+
+      invalidate_cached_realtime();
+      if (g_atomic_int_get(&self->exit_requested))
+        break;
+
+      struct pollfd *polled = (struct pollfd *) pfds->data;
+      if (rc > 0 && polled[0].revents)
+        _drain_wakeup_pipe(self);
+
+      /* walk backwards, so that removals do not shift the unprocessed entries */
+      for (gint i = self->connections->len - 1; i >= 0; i--)
+        {
+          HttpSourceConnection *connection = g_ptr_array_index(self->connections, i);
+          gboolean keep_connection;
+
+          if (_connection_has_pending_msgs(connection))
+            keep_connection = _process_requests(self, connection);
+          else if (rc > 0 && polled[i + 2].revents)
+            keep_connection = _read_connection(self, connection);
+          else
+            continue;
+
+          if (!keep_connection)
+            g_ptr_array_remove_index_fast(self->connections, i);
+        }
+
+      if (rc > 0 && polled[1].revents)
+        _accept_connections(self);
+
+      _close_idle_connections(self);
+    }
+
+  g_ptr_array_set_size(self->connections, 0);
+  g_array_free(pfds, TRUE);
+}
+
+static void
+_worker_interrupt_poll(HttpSourceWorker *self)
+{
+  if (write(self->wakeup_fds[1], "", 1) < 0)
+    {
+      /* the pipe is full, the worker is going to wake up anyway */
+    }
+}
+
+static void
+_worker_request_exit(LogThreadedSourceWorker *s)
+{
+  HttpSourceWorker *self = (HttpSourceWorker *) s;
+
+  g_atomic_int_set(&self->exit_requested, TRUE);
+  _worker_interrupt_poll(self);
+}
+
+/* the window has opened up, the pending records of the connections can be posted */
+static void
+_worker_wakeup(LogThreadedSourceWorker *s)
+{
+  _worker_interrupt_poll((HttpSourceWorker *) s);
+}
+
+static void
+_worker_free(LogPipe *s)
+{
+  HttpSourceWorker *self = (HttpSourceWorker *) s;
+
+  close(self->wakeup_fds[0]);
+  close(self->wakeup_fds[1]);
+  g_ptr_array_free(self->connections, TRUE);
+  g_string_free(self->decompressed, TRUE);
+
+  log_threaded_source_worker_free(s);
+}
+
+static LogThreadedSourceWorker *
+_construct_worker(LogThreadedSourceDriver *s, gint worker_index)
+{
+  HttpSourceWorker *self = g_new0(HttpSourceWorker, 1);
+  log_threaded_source_worker_init_instance(&self->super, s, worker_index);
+
+  self->super.run = _worker_run;
+  self->super.request_exit = _worker_request_exit;
+  self->super.wakeup = _worker_wakeup;
+  self->super.super.super.free_fn = _worker_free;
+
+  g_assert(pipe(self->wakeup_fds) == 0);
+  g_fd_set_cloexec(self->wakeup_fds[0], TRUE);
+  g_fd_set_cloexec(self->wakeup_fds[1], TRUE);
+  g_fd_set_nonblock(self->wakeup_fds[0], TRUE);
+  g_fd_set_nonblock(self->wakeup_fds[1], TRUE);
+
+  self->connections = g_ptr_array_new_with_free_func((GDestroyNotify) _connection_free);
+  self->decompressed = g_string_sized_new(4096);
+
+  return &self->super;
+}
+
+static gboolean
+_open_listen_socket(HttpSourceDriver *self)
+{
+  GSockAddr *bind_addr = g_sockaddr_inet_or_inet6_new(self->ip ? : "0.0.0.0", self->port);
+  gchar buf[64];
+  gint on = 1;
+
+  if (!bind_addr)
+    {
+      msg_error("http(): Invalid ip() address",
+                evt_tag_str("ip", self->ip),
+                log_pipe_location_tag(&self->super.super.super.super));
+      return FALSE;
+    }
+
+  gint fd = socket(g_sockaddr_get_sa(bind_addr)->sa_family, SOCK_STREAM, 0);
+  if (fd < 0)
+    goto error;
+
+  g_fd_set_nonblock(fd, TRUE);
+  g_fd_set_cloexec(fd, TRUE);
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+  if (bind(fd, g_sockaddr_get_sa(bind_addr), g_sockaddr_len(bind_addr)) < 0 || listen(fd, SOMAXCONN) < 0)
+    goto error;
+
+  g_sockaddr_unref(bind_addr);
+  self->listen_fd = fd;
+  return TRUE;
+
+error:
+  msg_error("http(): Error opening listening socket",
+            evt_tag_str("addr", g_sockaddr_format(bind_addr, buf, sizeof(buf), GSA_FULL)),
+            evt_tag_error("error"),
+            log_pipe_location_tag(&self->super.super.super.super));
+  if (fd >= 0)
+    close(fd);
+  g_sockaddr_unref(bind_addr);
+  return FALSE;
+}
+
+static void
+_close_listen_socket(HttpSourceDriver *self)
+{
+  if (self->listen_fd < 0)
+    return;
+
+  close(self->listen_fd);
+  self->listen_fd = -1;
+}
+
+static gboolean
+_init(LogPipe *s)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  if (!_open_listen_socket(self))
+    return FALSE;
+
+  handle_http_path = log_msg_get_value_handle("http.path");
+  handle_http_method = log_msg_get_value_handle("http.method");
+
+  /* max-connections() is the limit of the whole source */
+  self->max_connections_per_worker = MAX(1, self->max_connections / self->super.num_workers);
+
+  if (!log_threaded_source_driver_init_method(s))
+    {
+      _close_listen_socket(self);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+_deinit(LogPipe *s)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  gboolean result = log_threaded_source_driver_deinit_method(s);
+  _close_listen_socket(self);
+  return result;
+}
+
+static void
+_free(LogPipe *s)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  g_free(self->ip);
+  g_free(self->auth_token);
+  log_threaded_source_driver_free_method(s);
+}
+
+static void
+_format_stats_key(LogThreadedSourceDriver *s, StatsClusterKeyBuilder *kb)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  stats_cluster_key_builder_add_legacy_label(kb, stats_cluster_label("driver", "http"));
+
+  gchar num[16];
+  g_snprintf(num, sizeof(num), "%d", self->port);
+  stats_cluster_key_builder_add_legacy_label(kb, stats_cluster_label("port", num));
+}
+
+void
+http_sd_set_ip(LogDriver *s, const gchar *ip)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  g_free(self->ip);
+  self->ip = g_strdup(ip);
+}
+
+void
+http_sd_set_port(LogDriver *s, gint port)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  self->port = port;
+}
+
+void
+http_sd_set_auth_token(LogDriver *s, const gchar *auth_token)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  g_free(self->auth_token);
+  self->auth_token = auth_token[0] ? g_strdup(auth_token) : NULL;
+}
+
+void
+http_sd_set_max_body_size(LogDriver *s, gsize max_body_size)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  self->max_body_size = max_body_size;
+}
+
+void
+http_sd_set_max_connections(LogDriver *s, gint max_connections)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  self->max_connections = max_connections;
+}
+
+void
+http_sd_set_idle_timeout(LogDriver *s, gint idle_timeout)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  self->idle_timeout = idle_timeout;
+}
+
+gboolean
+http_sd_set_body_format(LogDriver *s, const gchar *body_format)
+{
+  HttpSourceDriver *self = (HttpSourceDriver *) s;
+
+  return http_body_format_lookup(body_format, &self->body_format);
+}
+
+LogDriver *
+http_sd_new(GlobalConfig *cfg)
+{
+  HttpSourceDriver *self = g_new0(HttpSourceDriver, 1);
+  log_threaded_source_driver_init_instance(&self->super, cfg);
+
+  self->super.super.super.super.init = _init;
+  self->super.super.super.super.deinit = _deinit;
+  self->super.super.super.super.free_fn = _free;
+  self->super.format_stats_key = _format_stats_key;
+  self->super.worker_construct = _construct_worker;
+
+  /* batches are closed after each request */
+  self->super.auto_close_batches = FALSE;
+  log_threaded_source_driver_set_transport_name(&self->super, "http");
+
+  self->port = 80;
+  self->max_body_size = 16 * 1024 * 1024;
+  self->max_connections = 1000;
+  self->idle_timeout = 60;
+  self->body_format = HTTP_BODY_FORMAT_AUTO;
+  self->listen_fd = -1;
+
+  return &self->super.super.super;
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef HTTP_SOURCE_H_INCLUDED
+#define HTTP_SOURCE_H_INCLUDED
+
+#include "driver.h"
+
+LogDriver *http_sd_new(GlobalConfig *cfg);
+
+void http_sd_set_ip(LogDriver *s, const gchar *ip);
+void http_sd_set_port(LogDriver *s, gint port);
+void http_sd_set_auth_token(LogDriver *s, const gchar *auth_token);
+void http_sd_set_max_body_size(LogDriver *s, gsize max_body_size);
+void http_sd_set_max_connections(LogDriver *s, gint max_connections);
+void http_sd_set_idle_timeout(LogDriver *s, gint idle_timeout);
+gboolean http_sd_set_body_format(LogDriver *s, const gchar *body_format);
+
+#endif
@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "s3-client.h"
+#include "messages.h"
+#include "compat/curl.h"
+
+#include <string.h>
+#include <time.h>
+
+#define S3_CLIENT_MAX_RESPONSE_LENGTH 65536
+
+struct _S3Client
+{
+  const S3ClientOptions *options;
+  S3Credentials credentials;
+  gchar *endpoint;
+  gchar *host;
+  gchar *base_path;
+};
+
+typedef struct _S3Response
+{
+  glong status;
+  GString *body;
+  gchar *etag;
+} S3Response;
+
+void
+s3_client_options_defaults(S3ClientOptions *self)
+{
+  self->region = g_strdup("us-east-1");
+  self->storage_class = g_strdup("STANDARD");
+  self->content_type = g_strdup("application/octet-stream");
+  self->peer_verify = TRUE;
+  self->timeout = 60;
+}
+
+void
+s3_client_options_destroy(S3ClientOptions *self)
+{
+  g_free(self->url);
+  g_free(self->bucket);
+  g_free(self->region);
+  g_free(self->access_key);
+  g_free(self->secret_key);
+  g_free(self->storage_class);
+  g_free(self->content_type);
+  g_free(self->ca_file);
+}
+
+S3Client *
+s3_client_new(const S3ClientOptions *options)
+{
+  S3Client *self = g_new0(S3Client, 1);
+
+  self->options = options;
+  self->credentials.access_key = options->access_key;
+  self->credentials.secret_key = options->secret_key;
+  self->credentials.region = options->region;
+
+  if (options->url && options->url[0])
+    self->endpoint = g_strdup(options->url);
+  else
+    self->endpoint = g_strdup_printf("https://s3.%s.amazonaws.com", options->region);
+
+  /* path-style addressing: <scheme>://<host>[:<port>][<base_path>]/<bucket>/<key> */
+  const gchar *host = strstr(self->endpoint, "://");
+  host = host ? host + 3 : self->endpoint;
+
+  const gchar *path = strchr(host, '/');
+  if (path)
+    {
+      self->host = g_strndup(host, path - host);
+      self->base_path = g_strdup(path);
+      g_strchomp(self->base_path);
+      while (g_str_has_suffix(self->base_path, "/"))
+        self->base_path[strlen(self->base_path) - 1] = 0;
+      self->endpoint[path - self->endpoint] = 0;
+    }
+  else
+    {
+      self->host = g_strdup(host);
+      self->base_path = g_strdup("");
+    }
+
+  return self;
+}
+
+void
+s3_client_free(S3Client *self)
+{
+  g_free(self->endpoint);
+  g_free(self->host);
+  g_free(self->base_path);
+  g_free(self);
+}
+
+static size_t
+_curl_write_function(gchar *ptr, size_t size, size_t nmemb, gpointer userdata)
+{
+  S3Response *response = (S3Response *) userdata;
+  gsize count = size * nmemb;
+
+  if (response->body->len < S3_CLIENT_MAX_RESPONSE_LENGTH)
+    g_string_append_len(response->body, ptr, MIN(count, S3_CLIENT_MAX_RESPONSE_LENGTH - response->body->len));
+  return count;
+}
+
+static size_t
+_curl_header_function(gchar *buffer, size_t size, size_t nitems, gpointer userdata)
+{
+  S3Response *response = (S3Response *) userdata;
+  gsize count = size * nitems;
+
+  if (count > 5 && g_ascii_strncasecmp(buffer, "etag:", 5) == 0)
+    {
+      g_free(response->etag);
+      response->etag = g_strstrip(g_strndup(buffer + 5, count - 5));
+    }
+  return count;
+}
+
+static void
+_format_canonical_uri(S3Client *self, const gchar *key, GString *uri)
+{
+  g_string_append(uri, self->base_path);
+  g_string_append_c(uri, '/');
+  s3_uri_encode(uri, self->options->bucket, TRUE);
+  g_string_append_c(uri, '/');
+  s3_uri_encode(uri, key, FALSE);
+}
+
+static void
+_format_amz_date(gchar *amz_date, gsize size)
+{
+  time_t now = time(NULL);
+  struct tm tm;
+
+  gmtime_r(&now, &tm);
+  strftime(amz_date, size, "%Y%m%dT%H%M%SZ", &tm);
+}
+
+static gboolean
+_perform(S3Client *self, const gchar *method, const gchar *key, const gchar *canonical_query,
+         const gchar *content_type, const gchar *data, gsize length, S3Response *response)
+{
+  GString *uri = g_string_sized_new(256);
+  GPtrArray *headers = g_ptr_array_new_with_free_func(g_free);
+  struct curl_slist *curl_headers = NULL;
+  gchar amz_date[32];
+  gboolean result = FALSE;
+  CURL *curl = NULL;
+
+  _format_canonical_uri(self, key, uri);
+  _format_amz_date(amz_date, sizeof(amz_date));
+  gchar *payload_hash = s3_sha256_hex(data ? data : "", length);
+
+  g_ptr_array_add(headers, g_strdup_printf("host:%s", self->host));
+  g_ptr_array_add(headers, g_strdup_printf("x-amz-content-sha256:%s", payload_hash));
+  g_ptr_array_add(headers, g_strdup_printf("x-amz-date:%s", amz_date));
+  if (content_type)
+    g_ptr_array_add(headers, g_strdup_printf("content-type:%s", content_type));
+  if (strcmp(canonical_query, "uploads=") == 0 && self->options->storage_class && self->options->storage_class[0])
+    g_ptr_array_add(headers, g_strdup_printf("x-amz-storage-class:%s", self->options->storage_class));
+
+  gchar *authorization = s3_sign_request(&self->credentials, method, uri->str, canonical_query, headers,
+                                         payload_hash, amz_date);
+
+  for (guint i = 0; i < headers->len; i++)
+    {
+      gchar *header = g_ptr_array_index(headers, i);
+      gchar *separator = strchr(header, ':');
+      gchar *formatted = g_strdup_printf("%.*s: %s", (gint) (separator - header), header, separator + 1);
+
+      curl_headers = curl_slist_append(curl_headers, formatted);
+      g_free(formatted);
+    }
+  gchar *authorization_header = g_strdup_printf("Authorization: %s", authorization);
+  curl_headers = curl_slist_append(curl_headers, authorization_header);
+  curl_headers = curl_slist_append(curl_headers, "Expect:");
+
+  gchar *url = g_strdup_printf("%s%s%s%s", self->endpoint, uri->str, canonical_query[0] ? "?" : "", canonical_query);
+
+  curl = curl_easy_init();
+  if (!curl)
+    goto exit;
+
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, curl_headers);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data ? data : "");
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) length);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _curl_write_function);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, response);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, _curl_header_function);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, response);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT, self->options->timeout);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, self->options->peer_verify ? 1L : 0L);
+  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, self->options->peer_verify ? 2L : 0L);
+  if (self->options->ca_file)
+    curl_easy_setopt(curl, CURLOPT_CAINFO, self->options->ca_file);
+
+  CURLcode ret = curl_easy_perform(curl);
+  if (ret != CURLE_OK)
+    {
+      msg_error("s3-native(): error sending request",
+                evt_tag_str("url", url),
+                evt_tag_str("method", method),
+                evt_tag_str("error", curl_easy_strerror(ret)));
+      goto exit;
+    }
+
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response->status);
+
+  /* CompleteMultipartUpload may report an error with a 200 status code */
+  if (response->status / 100 != 2 || strstr(response->body->str, "<Error>"))
+    {
+      msg_error("s3-native(): request failed",
+                evt_tag_str("url", url),
+                evt_tag_str("method", method),
+                evt_tag_long("status", response->status),
+                evt_tag_str("response", response->body->str));
+      goto exit;
+    }
+
+  result = TRUE;
+
+exit:
+  if (curl)
+    curl_easy_cleanup(curl);
+  curl_slist_free_all(curl_headers);
+  g_free(url);
+  g_free(authorization_header);
+  g_free(authorization);
+  g_free(payload_hash);
+  g_ptr_array_free(headers, TRUE);
+  g_string_free(uri, TRUE);
+  return result;
+}
+
+static void
+s3_response_init(S3Response *self)
+{
+  self->status = 0;
+  self->body = g_string_sized_new(512);
+  self->etag = NULL;
+}
+
+static void
+s3_response_clear(S3Response *self)
+{
+  g_string_free(self->body, TRUE);
+  g_free(self->etag);
+}
+
+static gchar *
+_extract_xml_element(const gchar *xml, const gchar *name)
+{
+  gchar *open_tag = g_strdup_printf("<%s>", name);
+  gchar *close_tag = g_strdup_printf("</%s>", name);
+  gchar *result = NULL;
+
+  const gchar *start = strstr(xml, open_tag);
+  if (start)
+    {
+      start += strlen(open_tag);
+      const gchar *end = strstr(start, close_tag);
+      if (end)
+        result = g_strndup(start, end - start);
+    }
+
+  g_free(open_tag);
+  g_free(close_tag);
+  return result;
+}
+
+gchar *
+s3_client_create_multipart_upload(S3Client *self, const gchar *key)
+{
+  S3Response response;
+  gchar *upload_id = NULL;
+
+  s3_response_init(&response);
+  if (_perform(self, "POST", key, "uploads=", self->options->content_type, NULL, 0, &response))
+    {
+      upload_id = _extract_xml_element(response.body->str, "UploadId");
+      if (!upload_id)
+        msg_error("s3-native(): missing UploadId in CreateMultipartUpload response",
+                  evt_tag_str("key", key),
+                  evt_tag_str("response", response.body->str));
+    }
+  s3_response_clear(&response);
+  return upload_id;
+}
+
+static gchar *
+_format_upload_query(const gchar *upload_id, gint part_number)
+{
+  GString *query = g_string_sized_new(128);
+
+  if (part_number > 0)
+    g_string_append_printf(query, "partNumber=%d&", part_number);
+  g_string_append(query, "uploadId=");
+  s3_uri_encode(query, upload_id, TRUE);
+  return g_string_free(query, FALSE);
+}
+
+gchar *
+s3_client_upload_part(S3Client *self, const gchar *key, const gchar *upload_id, gint part_number,
+                      const gchar *data, gsize length)
+{
+  S3Response response;
+  gchar *etag = NULL;
+  gchar *query = _format_upload_query(upload_id, part_number);
+
+  s3_response_init(&response);
+  if (_perform(self, "PUT", key, query, NULL, data, length, &response))
+    {
+      etag = response.etag;
+      response.etag = NULL;
+      if (!etag)
+        msg_error("s3-native(): missing ETag in UploadPart response",
+                  evt_tag_str("key", key),
+                  evt_tag_int("part_number", part_number));
+    }
+  s3_response_clear(&response);
+  g_free(query);
+  return etag;
+}
+
+gboolean
+s3_client_complete_multipart_upload(S3Client *self, const gchar *key, const gchar *upload_id, GPtrArray *etags)
+{
+  S3Response response;
+  GString *body = g_string_sized_new(128 + etags->len * 96);
+  gchar *query = _format_upload_query(upload_id, 0);
+
+  g_string_append(body, "<CompleteMultipartUpload>");
+  for (guint i = 0; i < etags->len; i++)
+    {
+      const gchar *etag = g_ptr_array_index(etags, i);
+
+      /* part numbers do not have to be contiguous, a lost part is skipped */
+      if (!etag)
+        continue;
+      g_string_append_printf(body, "<Part><PartNumber>%u</PartNumber><ETag>%s</ETag></Part>", i + 1, etag);
+    }
+  g_string_append(body, "</CompleteMultipartUpload>");
+
+  s3_response_init(&response);
+  gboolean result = _perform(self, "POST", key, query, "application/xml", body->str, body->len, &response);
+  s3_response_clear(&response);
+
+  g_free(query);
+  g_string_free(body, TRUE);
+  return result;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef S3_CLIENT_H_INCLUDED
+#define S3_CLIENT_H_INCLUDED
+
+#include "syslog-ng.h"
+#include "s3-signer.h"
+
+typedef struct _S3ClientOptions
+{
+  gchar *url;
+  gchar *bucket;
+  gchar *region;
+  gchar *access_key;
+  gchar *secret_key;
+  gchar *storage_class;
+  gchar *content_type;
+  gchar *ca_file;
+  gboolean peer_verify;
+  glong timeout;
+} S3ClientOptions;
+
+typedef struct _S3Client S3Client;
+
+void s3_client_options_defaults(S3ClientOptions *self);
+void s3_client_options_destroy(S3ClientOptions *self);
+
+S3Client *s3_client_new(const S3ClientOptions *options);
+void s3_client_free(S3Client *self);
+
+/* These are blocking calls, and can be used from multiple threads in parallel. */
+gchar *s3_client_create_multipart_upload(S3Client *self, const gchar *key);
+gchar *s3_client_upload_part(S3Client *self, const gchar *key, const gchar *upload_id, gint part_number,
+                             const gchar *data, gsize length);
+gboolean s3_client_complete_multipart_upload(S3Client *self, const gchar *key, const gchar *upload_id,
+                                             GPtrArray *etags);
+
+#endif
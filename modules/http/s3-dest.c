@@ -0,0 +1,893 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "s3-dest.h"
+#include "s3-client.h"
+#include "s3-object.h"
+#include "compat/curl.h"
+#include "logthrdest/logthrdestdrv.h"
+#include "mainloop-worker.h"
+#include "reloc.h"
+#include "messages.h"
+#include "timeutils/cache.h"
+#include "timeutils/misc.h"
+
+#include <iv.h>
+#include <glib/gstdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+
+#define S3_MIN_CHUNK_SIZE (5 * 1024 * 1024)
+#define S3_MAX_PARTS 10000
+#define S3_UPLOAD_MAX_BACKOFF 60
+#define S3_ROTATE_CHECK_INTERVAL 1000
+
+typedef struct _S3DestDriver
+{
+  LogThreadedDestDriver super;
+  S3ClientOptions client_options;
+  LogTemplateOptions template_options;
+  LogTemplate *object_key;
+  LogTemplate *template;
+  gsize chunk_size;
+  gsize max_object_size;
+  gint flush_grace_period;
+  gint upload_threads;
+  gint max_pending_uploads;
+  gboolean compression;
+  gchar *working_dir;
+  gchar *state_prefix;
+
+  S3Client *client;
+  GThreadPool *upload_pool;
+  GMutex lock;
+  GCond cond;
+  gint pending_uploads;
+  gboolean stopping;
+} S3DestDriver;
+
+/*
+ * Workers only append to the part files of their own objects, closed
+ * parts are uploaded by a pool of upload-threads(), so a slow part upload
+ * does not block formatting and compressing the next one.  Object state
+ * shared with the upload threads is protected by the driver lock.
+ */
+typedef struct _S3DestWorker
+{
+  LogThreadedDestWorker super;
+  GHashTable *objects;
+  GString *target;
+  GString *message;
+  struct iv_timer rotate_timer;
+} S3DestWorker;
+
+/* part_number is 0 for completing the upload */
+typedef struct _S3UploadTask
+{
+  S3Object *object;
+  gint part_number;
+} S3UploadTask;
+
+/*
+ * Upload threads
+ */
+
+static gboolean
+_is_stopping(S3DestDriver *self)
+{
+  g_mutex_lock(&self->lock);
+  gboolean stopping = self->stopping;
+  g_mutex_unlock(&self->lock);
+
+  return stopping;
+}
+
+static gboolean
+_wait_before_retry(S3DestDriver *self, gint *backoff)
+{
+  gint64 end_time = g_get_monotonic_time() + *backoff * G_TIME_SPAN_SECOND;
+
+  g_mutex_lock(&self->lock);
+  while (!self->stopping && g_cond_wait_until(&self->cond, &self->lock, end_time))
+    ;
+  gboolean stopping = self->stopping;
+  g_mutex_unlock(&self->lock);
+
+  *backoff = MIN(*backoff * 2, S3_UPLOAD_MAX_BACKOFF);
+  return !stopping;
+}
+
+static gboolean
+_ensure_upload_id(S3DestDriver *self, S3Object *object)
+{
+  g_mutex_lock(&object->upload_id_lock);
+  if (!object->upload_id)
+    {
+      gchar *upload_id = s3_client_create_multipart_upload(self->client, object->key);
+      if (upload_id)
+        {
+          g_mutex_lock(&self->lock);
+          object->upload_id = upload_id;
+          s3_object_save_state(object);
+          g_mutex_unlock(&self->lock);
+        }
+    }
+  gboolean result = object->upload_id != NULL;
+  g_mutex_unlock(&object->upload_id_lock);
+
+  return result;
+}
+
+/* returns whether the object has become ready for completion */
+static gboolean
+_upload_part(S3DestDriver *self, S3Object *object, gint part_number)
+{
+  gchar *path = s3_object_format_part_path(object, part_number);
+  gchar *contents = NULL;
+  gsize length = 0;
+  gchar *etag = NULL;
+  GError *error = NULL;
+
+  if (g_file_get_contents(path, &contents, &length, &error))
+    {
+      gint backoff = 1;
+
+      while (!etag)
+        {
+          if (_ensure_upload_id(self, object))
+            etag = s3_client_upload_part(self->client, object->key, object->upload_id, part_number, contents, length);
+
+          if (!etag && !_wait_before_retry(self, &backoff))
+            break;
+        }
+      g_free(contents);
+
+      /* stopping, the part stays pending and is uploaded after restart */
+      if (!etag)
+        {
+          g_free(path);
+          return FALSE;
+        }
+
+      msg_debug("s3-native(): part uploaded",
+                evt_tag_str("key", object->key),
+                evt_tag_int("part_number", part_number),
+                evt_tag_long("length", length));
+    }
+  else
+    {
+      msg_error("s3-native(): error reading part file, part is skipped",
+                evt_tag_str("key", object->key),
+                evt_tag_str("path", path),
+                evt_tag_str("error", error->message));
+      g_clear_error(&error);
+    }
+
+  g_mutex_lock(&self->lock);
+  g_free(g_ptr_array_index(object->etags, part_number - 1));
+  g_ptr_array_index(object->etags, part_number - 1) = etag;
+  object->pending_parts--;
+  s3_object_save_state(object);
+  gboolean ready = object->finished && object->pending_parts == 0;
+  g_mutex_unlock(&self->lock);
+
+  unlink(path);
+  g_free(path);
+  return ready;
+}
+
+static gboolean
+_has_uploaded_parts(S3Object *object)
+{
+  for (guint i = 0; i < object->etags->len; i++)
+    {
+      if (g_ptr_array_index(object->etags, i))
+        return TRUE;
+    }
+  return FALSE;
+}
+
+static void
+_complete_upload(S3DestDriver *self, S3Object *object)
+{
+  if (!_has_uploaded_parts(object))
+    {
+      msg_error("s3-native(): no parts were uploaded, dropping object",
+                evt_tag_str("key", object->key));
+      s3_object_remove_state(object);
+      return;
+    }
+
+  gint backoff = 1;
+  while (!s3_client_complete_multipart_upload(self->client, object->key, object->upload_id, object->etags))
+    {
+      if (!_wait_before_retry(self, &backoff))
+        return;
+    }
+
+  msg_info("s3-native(): object uploaded",
+           evt_tag_str("bucket", self->client_options.bucket),
+           evt_tag_str("key", object->key),
+           evt_tag_int("parts", object->etags->len));
+  s3_object_remove_state(object);
+}
+
+static void
+_upload_thread(gpointer data, gpointer user_data)
+{
+  S3UploadTask *task = (S3UploadTask *) data;
+  S3DestDriver *self = (S3DestDriver *) user_data;
+
+  gboolean stopping = _is_stopping(self);
+  gboolean ready = FALSE;
+
+  if (task->part_number > 0 && !stopping)
+    ready = _upload_part(self, task->object, task->part_number);
+  else
+    ready = !stopping;
+
+  g_mutex_lock(&self->lock);
+  self->pending_uploads--;
+  g_cond_broadcast(&self->cond);
+  g_mutex_unlock(&self->lock);
+
+  if (ready)
+    _complete_upload(self, task->object);
+
+  s3_object_unref(task->object);
+  g_free(task);
+}
+
+/* Blocks the worker while max-pending-uploads() parts are waiting for
+ * upload, so that closed parts do not pile up in working-dir(). */
+static void
+_wait_for_upload_slot(S3DestDriver *self)
+{
+  g_mutex_lock(&self->lock);
+  while (self->pending_uploads >= self->max_pending_uploads && !self->stopping && !main_loop_worker_job_quit())
+    g_cond_wait_until(&self->cond, &self->lock, g_get_monotonic_time() + G_TIME_SPAN_SECOND);
+  g_mutex_unlock(&self->lock);
+}
+
+static void
+_queue_upload(S3DestDriver *self, S3Object *object, gint part_number)
+{
+  S3UploadTask *task = g_new0(S3UploadTask, 1);
+
+  task->object = s3_object_ref(object);
+  task->part_number = part_number;
+
+  g_mutex_lock(&self->lock);
+  self->pending_uploads++;
+  g_mutex_unlock(&self->lock);
+
+  g_thread_pool_push(self->upload_pool, task, NULL);
+}
+
+/*
+ * Worker
+ */
+
+static S3Object *
+_create_object(S3DestWorker *self, const gchar *target)
+{
+  S3DestDriver *owner = (S3DestDriver *) self->super.owner;
+  time_t now = get_cached_realtime_sec();
+  struct tm tm;
+  gchar timestamp[32];
+
+  gmtime_r(&now, &tm);
+  strftime(timestamp, sizeof(timestamp), "%Y%m%dT%H%M%S", &tm);
+
+  gchar *key = g_strdup_printf("%s-%s-%08x%s", target, timestamp, g_random_int(), owner->compression ? ".gz" : "");
+  gchar *key_hash = g_compute_checksum_for_string(G_CHECKSUM_SHA1, key, -1);
+  gchar *state_base = g_strdup_printf("%s/%s-%s", owner->working_dir, owner->state_prefix, key_hash);
+
+  S3Object *object = s3_object_new(state_base, target, key, owner->compression);
+  s3_object_save_state(object);
+  g_hash_table_insert(self->objects, object->target, object);
+
+  g_free(state_base);
+  g_free(key_hash);
+  g_free(key);
+  return object;
+}
+
+static gboolean
+_close_part(S3DestWorker *self, S3Object *object, gboolean finish)
+{
+  S3DestDriver *owner = (S3DestDriver *) self->super.owner;
+
+  if (!finish)
+    _wait_for_upload_slot(owner);
+
+  g_mutex_lock(&owner->lock);
+  gint part_number = s3_object_close_part(object);
+  if (finish)
+    object->finished = TRUE;
+  if (part_number >= 0)
+    s3_object_save_state(object);
+  gboolean ready = finish && object->pending_parts == 0;
+  g_mutex_unlock(&owner->lock);
+
+  if (part_number < 0)
+    return FALSE;
+
+  if (part_number > 0)
+    _queue_upload(owner, object, part_number);
+  else if (ready)
+    _queue_upload(owner, object, 0);
+  return TRUE;
+}
+
+static gboolean
+_finish_object(S3DestWorker *self, S3Object *object)
+{
+  gboolean result = _close_part(self, object, TRUE);
+
+  g_hash_table_remove(self->objects, object->target);
+  return result;
+}
+
+static LogThreadedResult
+_insert(LogThreadedDestWorker *s, LogMessage *msg)
+{
+  S3DestWorker *self = (S3DestWorker *) s;
+  S3DestDriver *owner = (S3DestDriver *) s->owner;
+  LogTemplateEvalOptions options = {&owner->template_options, LTZ_SEND, s->seq_num, NULL, LM_VT_STRING};
+
+  log_template_format(owner->object_key, msg, &options, self->target);
+  log_template_format(owner->template, msg, &options, self->message);
+
+  S3Object *object = g_hash_table_lookup(self->objects, self->target->str);
+  if (!object)
+    object = _create_object(self, self->target->str);
+
+  if (!s3_object_append(object, self->message->str, self->message->len))
+    return LTR_ERROR;
+  object->last_write = get_cached_realtime_sec();
+
+  if (object->object_size >= owner->max_object_size ||
+      (object->part_size >= owner->chunk_size && object->part_number >= S3_MAX_PARTS))
+    {
+      if (!_finish_object(self, object))
+        return LTR_ERROR;
+    }
+  else if (object->part_size >= owner->chunk_size)
+    {
+      if (!_close_part(self, object, FALSE))
+        return LTR_ERROR;
+    }
+
+  return LTR_QUEUED;
+}
+
+static LogThreadedResult
+_flush(LogThreadedDestWorker *s, LogThreadedFlushMode mode)
+{
+  S3DestWorker *self = (S3DestWorker *) s;
+  GHashTableIter iter;
+  gpointer value;
+
+  g_hash_table_iter_init(&iter, self->objects);
+  while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+      if (!s3_object_sync((S3Object *) value))
+        return LTR_ERROR;
+    }
+
+  return LTR_SUCCESS;
+}
+
+static void
+_rearm_rotate_timer(S3DestWorker *self)
+{
+  iv_validate_now();
+  self->rotate_timer.expires = iv_now;
+  timespec_add_msec(&self->rotate_timer.expires, S3_ROTATE_CHECK_INTERVAL);
+  iv_timer_register(&self->rotate_timer);
+}
+
+/* finishes the objects not written for flush-grace-period() seconds */
+static void
+_rotate_idle_objects(gpointer s)
+{
+  S3DestWorker *self = (S3DestWorker *) s;
+  S3DestDriver *owner = (S3DestDriver *) self->super.owner;
+  time_t now = get_cached_realtime_sec();
+  GHashTableIter iter;
+  gpointer value;
+
+  g_hash_table_iter_init(&iter, self->objects);
+  while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+      S3Object *object = (S3Object *) value;
+
+      if (now - object->last_write < owner->flush_grace_period)
+        continue;
+
+      s3_object_sync(object);
+      _close_part(self, object, TRUE);
+      g_hash_table_iter_remove(&iter);
+    }
+
+  _rearm_rotate_timer(self);
+}
+
+static gboolean
+_worker_init(LogThreadedDestWorker *s)
+{
+  S3DestWorker *self = (S3DestWorker *) s;
+  S3DestDriver *owner = (S3DestDriver *) s->owner;
+
+  if (owner->flush_grace_period > 0)
+    _rearm_rotate_timer(self);
+
+  return log_threaded_dest_worker_init_method(s);
+}
+
+/* unfinished objects are left in working-dir(), and are finished by the
+ * next start of the driver */
+static void
+_worker_deinit(LogThreadedDestWorker *s)
+{
+  S3DestWorker *self = (S3DestWorker *) s;
+  S3DestDriver *owner = (S3DestDriver *) s->owner;
+  GHashTableIter iter;
+  gpointer value;
+
+  if (iv_timer_registered(&self->rotate_timer))
+    iv_timer_unregister(&self->rotate_timer);
+
+  g_hash_table_iter_init(&iter, self->objects);
+  while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+      S3Object *object = (S3Object *) value;
+
+      s3_object_sync(object);
+      g_mutex_lock(&owner->lock);
+      s3_object_save_state(object);
+      g_mutex_unlock(&owner->lock);
+    }
+  g_hash_table_remove_all(self->objects);
+
+  log_threaded_dest_worker_deinit_method(s);
+}
+
+static void
+_worker_free(LogThreadedDestWorker *s)
+{
+  S3DestWorker *self = (S3DestWorker *) s;
+
+  g_hash_table_destroy(self->objects);
+  g_string_free(self->target, TRUE);
+  g_string_free(self->message, TRUE);
+
+  log_threaded_dest_worker_free_method(s);
+}
+
+static LogThreadedDestWorker *
+_construct_worker(LogThreadedDestDriver *o, gint worker_index)
+{
+  S3DestWorker *self = g_new0(S3DestWorker, 1);
+
+  log_threaded_dest_worker_init_instance(&self->super, o, worker_index);
+  self->super.init = _worker_init;
+  self->super.deinit = _worker_deinit;
+  self->super.insert = _insert;
+  self->super.flush = _flush;
+  self->super.free_fn = _worker_free;
+
+  self->objects = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) s3_object_unref);
+  self->target = g_string_sized_new(256);
+  self->message = g_string_sized_new(1024);
+
+  IV_TIMER_INIT(&self->rotate_timer);
+  self->rotate_timer.cookie = self;
+  self->rotate_timer.handler = _rotate_idle_objects;
+
+  return &self->super;
+}
+
+/*
+ * Driver
+ */
+
+/* finishes the uploads interrupted by a previous shutdown or crash */
+static void
+_recover_objects(S3DestDriver *self)
+{
+  GDir *dir = g_dir_open(self->working_dir, 0, NULL);
+  const gchar *name;
+
+  if (!dir)
+    return;
+
+  gchar *prefix = g_strdup_printf("%s-", self->state_prefix);
+  while ((name = g_dir_read_name(dir)))
+    {
+      if (!g_str_has_prefix(name, prefix) || !g_str_has_suffix(name, ".state"))
+        continue;
+
+      gchar *path = g_build_filename(self->working_dir, name, NULL);
+      S3Object *object = s3_object_load(path);
+      g_free(path);
+
+      if (!object)
+        continue;
+
+      msg_info("s3-native(): resuming interrupted upload",
+               evt_tag_str("key", object->key),
+               evt_tag_str("upload_id", object->upload_id));
+
+      if (!object->finished)
+        s3_object_recover_part(object);
+      object->finished = TRUE;
+
+      object->pending_parts = 0;
+      for (gint part_number = 1; part_number < object->part_number; part_number++)
+        {
+          if (!g_ptr_array_index(object->etags, part_number - 1))
+            object->pending_parts++;
+        }
+      s3_object_save_state(object);
+
+      if (object->pending_parts == 0)
+        _queue_upload(self, object, 0);
+
+      for (gint part_number = 1; part_number < object->part_number; part_number++)
+        {
+          if (!g_ptr_array_index(object->etags, part_number - 1))
+            _queue_upload(self, object, part_number);
+        }
+      s3_object_unref(object);
+    }
+
+  g_free(prefix);
+  g_dir_close(dir);
+}
+
+void
+s3_dd_set_url(LogDriver *d, const gchar *url)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  g_free(self->client_options.url);
+  self->client_options.url = g_strdup(url);
+}
+
+void
+s3_dd_set_bucket(LogDriver *d, const gchar *bucket)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  g_free(self->client_options.bucket);
+  self->client_options.bucket = g_strdup(bucket);
+}
+
+void
+s3_dd_set_region(LogDriver *d, const gchar *region)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  g_free(self->client_options.region);
+  self->client_options.region = g_strdup(region);
+}
+
+void
+s3_dd_set_access_key(LogDriver *d, const gchar *access_key)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  g_free(self->client_options.access_key);
+  self->client_options.access_key = g_strdup(access_key);
+}
+
+void
+s3_dd_set_secret_key(LogDriver *d, const gchar *secret_key)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  g_free(self->client_options.secret_key);
+  self->client_options.secret_key = g_strdup(secret_key);
+}
+
+void
+s3_dd_set_storage_class(LogDriver *d, const gchar *storage_class)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  g_free(self->client_options.storage_class);
+  self->client_options.storage_class = g_strdup(storage_class);
+}
+
+void
+s3_dd_set_ca_file(LogDriver *d, const gchar *ca_file)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  g_free(self->client_options.ca_file);
+  self->client_options.ca_file = g_strdup(ca_file);
+}
+
+void
+s3_dd_set_peer_verify(LogDriver *d, gboolean peer_verify)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  self->client_options.peer_verify = peer_verify;
+}
+
+void
+s3_dd_set_timeout(LogDriver *d, glong timeout)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  self->client_options.timeout = timeout;
+}
+
+void
+s3_dd_set_object_key(LogDriver *d, LogTemplate *object_key)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  log_template_unref(self->object_key);
+  self->object_key = log_template_ref(object_key);
+}
+
+void
+s3_dd_set_template(LogDriver *d, LogTemplate *template)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  log_template_unref(self->template);
+  self->template = log_template_ref(template);
+}
+
+void
+s3_dd_set_chunk_size(LogDriver *d, gsize chunk_size)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  self->chunk_size = chunk_size;
+}
+
+void
+s3_dd_set_max_object_size(LogDriver *d, gsize max_object_size)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  self->max_object_size = max_object_size;
+}
+
+void
+s3_dd_set_flush_grace_period(LogDriver *d, gint flush_grace_period)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  self->flush_grace_period = flush_grace_period;
+}
+
+void
+s3_dd_set_upload_threads(LogDriver *d, gint upload_threads)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  self->upload_threads = upload_threads;
+}
+
+void
+s3_dd_set_max_pending_uploads(LogDriver *d, gint max_pending_uploads)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  self->max_pending_uploads = max_pending_uploads;
+}
+
+gboolean
+s3_dd_set_compression(LogDriver *d, gboolean compression)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  if (compression && !SYSLOG_NG_HTTP_COMPRESSION_ENABLED)
+    return FALSE;
+
+  self->compression = compression;
+  return TRUE;
+}
+
+void
+s3_dd_set_working_dir(LogDriver *d, const gchar *working_dir)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  g_free(self->working_dir);
+  self->working_dir = g_strdup(working_dir);
+}
+
+LogTemplateOptions *
+s3_dd_get_template_options(LogDriver *d)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  return &self->template_options;
+}
+
+static const gchar *
+_format_persist_name(const LogPipe *d)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+  static gchar persist_name[1024];
+
+  if (d->persist_name)
+    g_snprintf(persist_name, sizeof(persist_name), "s3-native.%s", d->persist_name);
+  else
+    g_snprintf(persist_name, sizeof(persist_name), "s3-native(%s,%s)", self->client_options.bucket,
+               self->object_key ? self->object_key->template_str : "");
+
+  return persist_name;
+}
+
+static const gchar *
+_format_stats_key(LogThreadedDestDriver *d, StatsClusterKeyBuilder *kb)
+{
+  S3DestDriver *self = (S3DestDriver *) d;
+
+  stats_cluster_key_builder_add_legacy_label(kb, stats_cluster_label("driver", "s3-native"));
+  stats_cluster_key_builder_add_legacy_label(kb, stats_cluster_label("bucket", self->client_options.bucket));
+
+  return NULL;
+}
+
+static gboolean
+_init(LogPipe *s)
+{
+  S3DestDriver *self = (S3DestDriver *) s;
+  GlobalConfig *cfg = log_pipe_get_config(s);
+
+  if (!self->client_options.bucket || !self->object_key)
+    {
+      msg_error("s3-native(): bucket() and object-key() must be set",
+                log_pipe_location_tag(s));
+      return FALSE;
+    }
+
+  if (!self->client_options.access_key || !self->client_options.secret_key)
+    {
+      msg_error("s3-native(): access-key() and secret-key() must be set",
+                log_pipe_location_tag(s));
+      return FALSE;
+    }
+
+  if (self->chunk_size < S3_MIN_CHUNK_SIZE)
+    {
+      msg_warning("WARNING: s3-native(): chunk-size() is smaller than the minimal part size of S3, increasing it",
+                  evt_tag_long("chunk_size", self->chunk_size),
+                  evt_tag_int("min_chunk_size", S3_MIN_CHUNK_SIZE),
+                  log_pipe_location_tag(s));
+      self->chunk_size = S3_MIN_CHUNK_SIZE;
+    }
+
+  if (!self->working_dir)
+    self->working_dir = g_build_filename(get_installation_path_for(SYSLOG_NG_PATH_LOCALSTATEDIR), "s3-native", NULL);
+
+  if (g_mkdir_with_parents(self->working_dir, 0700) < 0)
+    {
+      msg_error("s3-native(): error creating working-dir()",
+                evt_tag_str("working_dir", self->working_dir),
+                evt_tag_error("error"),
+                log_pipe_location_tag(s));
+      return FALSE;
+    }
+
+  if (!self->template)
+    {
+      self->template = log_template_new(cfg, NULL);
+      log_template_compile(self->template, "${MESSAGE}\n", NULL);
+    }
+
+  if (!log_threaded_dest_driver_init_method(s))
+    return FALSE;
+
+  log_template_options_init(&self->template_options, cfg);
+
+  g_free(self->state_prefix);
+  gchar *persist_hash = g_compute_checksum_for_string(G_CHECKSUM_SHA1, log_pipe_get_persist_name(s), -1);
+  self->state_prefix = g_strndup(persist_hash, 16);
+  g_free(persist_hash);
+
+  self->client = s3_client_new(&self->client_options);
+  self->stopping = FALSE;
+  self->upload_pool = g_thread_pool_new(_upload_thread, self, self->upload_threads, FALSE, NULL);
+
+  _recover_objects(self);
+  return TRUE;
+}
+
+static gboolean
+_deinit(LogPipe *s)
+{
+  S3DestDriver *self = (S3DestDriver *) s;
+
+  /* in-flight uploads are abandoned, they are resumed after restart */
+  g_mutex_lock(&self->lock);
+  self->stopping = TRUE;
+  g_cond_broadcast(&self->cond);
+  g_mutex_unlock(&self->lock);
+
+  g_thread_pool_free(self->upload_pool, FALSE, TRUE);
+  self->upload_pool = NULL;
+  s3_client_free(self->client);
+  self->client = NULL;
+
+  return log_threaded_dest_driver_deinit_method(s);
+}
+
+static void
+_free(LogPipe *s)
+{
+  S3DestDriver *self = (S3DestDriver *) s;
+
+  s3_client_options_destroy(&self->client_options);
+  log_template_options_destroy(&self->template_options);
+  log_template_unref(self->object_key);
+  log_template_unref(self->template);
+  g_free(self->working_dir);
+  g_free(self->state_prefix);
+  g_mutex_clear(&self->lock);
+  g_cond_clear(&self->cond);
+
+  curl_global_cleanup();
+
+  log_threaded_dest_driver_free(s);
+}
+
+LogDriver *
+s3_dd_new(GlobalConfig *cfg)
+{
+  S3DestDriver *self = g_new0(S3DestDriver, 1);
+
+  log_threaded_dest_driver_init_instance(&self->super, cfg);
+  log_template_options_defaults(&self->template_options);
+  s3_client_options_defaults(&self->client_options);
+
+  self->super.super.super.super.init = _init;
+  self->super.super.super.super.deinit = _deinit;
+  self->super.super.super.super.free_fn = _free;
+  self->super.super.super.super.generate_persist_name = _format_persist_name;
+  self->super.format_stats_key = _format_stats_key;
+  self->super.stats_source = stats_register_type("s3-native");
+  self->super.worker.construct = _construct_worker;
+
+  curl_global_init(CURL_GLOBAL_ALL);
+
+  self->chunk_size = S3_MIN_CHUNK_SIZE;
+  self->max_object_size = MIN(G_MAXSIZE, G_GUINT64_CONSTANT(5) << 40);
+  self->flush_grace_period = 60;
+  self->upload_threads = 8;
+  self->max_pending_uploads = 32;
+  g_mutex_init(&self->lock);
+  g_cond_init(&self->cond);
+
+  return &self->super.super.super;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef S3_DEST_H_INCLUDED
+#define S3_DEST_H_INCLUDED
+
+#include "driver.h"
+#include "template/templates.h"
+
+LogDriver *s3_dd_new(GlobalConfig *cfg);
+
+void s3_dd_set_url(LogDriver *d, const gchar *url);
+void s3_dd_set_bucket(LogDriver *d, const gchar *bucket);
+void s3_dd_set_region(LogDriver *d, const gchar *region);
+void s3_dd_set_access_key(LogDriver *d, const gchar *access_key);
+void s3_dd_set_secret_key(LogDriver *d, const gchar *secret_key);
+void s3_dd_set_storage_class(LogDriver *d, const gchar *storage_class);
+void s3_dd_set_ca_file(LogDriver *d, const gchar *ca_file);
+void s3_dd_set_peer_verify(LogDriver *d, gboolean peer_verify);
+void s3_dd_set_timeout(LogDriver *d, glong timeout);
+void s3_dd_set_object_key(LogDriver *d, LogTemplate *object_key);
+void s3_dd_set_template(LogDriver *d, LogTemplate *template);
+void s3_dd_set_chunk_size(LogDriver *d, gsize chunk_size);
+void s3_dd_set_max_object_size(LogDriver *d, gsize max_object_size);
+void s3_dd_set_flush_grace_period(LogDriver *d, gint flush_grace_period);
+void s3_dd_set_upload_threads(LogDriver *d, gint upload_threads);
+void s3_dd_set_max_pending_uploads(LogDriver *d, gint max_pending_uploads);
+gboolean s3_dd_set_compression(LogDriver *d, gboolean compression);
+void s3_dd_set_working_dir(LogDriver *d, const gchar *working_dir);
+LogTemplateOptions *s3_dd_get_template_options(LogDriver *d);
+
+#endif
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "s3-object.h"
+#include "messages.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#define S3_OBJECT_DEFLATE_CHUNK 65536
+#define S3_OBJECT_STATE_GROUP "object"
+
+S3Object *
+s3_object_new(const gchar *state_base, const gchar *target, const gchar *key, gboolean compress)
+{
+  S3Object *self = g_new0(S3Object, 1);
+
+  self->ref_cnt = 1;
+  self->target = g_strdup(target);
+  self->key = g_strdup(key);
+  self->state_base = g_strdup(state_base);
+  self->compress = compress;
+  self->part_number = 1;
+  self->etags = g_ptr_array_new_with_free_func(g_free);
+  self->pending = g_string_sized_new(S3_OBJECT_DEFLATE_CHUNK);
+  g_mutex_init(&self->upload_id_lock);
+
+  return self;
+}
+
+S3Object *
+s3_object_ref(S3Object *self)
+{
+  g_atomic_int_inc(&self->ref_cnt);
+  return self;
+}
+
+static void
+_close_part_file(S3Object *self)
+{
+  if (!self->part_file)
+    return;
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+  if (self->compress)
+    deflateEnd(&self->zstream);
+#endif
+  fclose(self->part_file);
+  self->part_file = NULL;
+}
+
+void
+s3_object_unref(S3Object *self)
+{
+  if (!g_atomic_int_dec_and_test(&self->ref_cnt))
+    return;
+
+  _close_part_file(self);
+  g_mutex_clear(&self->upload_id_lock);
+  g_string_free(self->pending, TRUE);
+  g_ptr_array_free(self->etags, TRUE);
+  g_free(self->target);
+  g_free(self->key);
+  g_free(self->upload_id);
+  g_free(self->state_base);
+  g_free(self);
+}
+
+gchar *
+s3_object_format_part_path(S3Object *self, gint part_number)
+{
+  return g_strdup_printf("%s.part-%05d", self->state_base, part_number);
+}
+
+static gchar *
+_format_state_path(S3Object *self)
+{
+  return g_strdup_printf("%s.state", self->state_base);
+}
+
+static gboolean
+_open_part(S3Object *self)
+{
+  gchar *path = s3_object_format_part_path(self, self->part_number);
+
+  self->part_file = fopen(path, "wb");
+  if (!self->part_file)
+    {
+      msg_error("s3-native(): error opening part file",
+                evt_tag_str("path", path),
+                evt_tag_error("error"));
+      g_free(path);
+      return FALSE;
+    }
+  g_free(path);
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+  if (self->compress)
+    {
+      memset(&self->zstream, 0, sizeof(self->zstream));
+      if (deflateInit2(&self->zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8,
+                       Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+          msg_error("s3-native(): error initializing gzip compression");
+          fclose(self->part_file);
+          self->part_file = NULL;
+          return FALSE;
+        }
+    }
+#endif
+
+  self->part_size = 0;
+  return TRUE;
+}
+
+static void
+_account_output(S3Object *self, gsize length)
+{
+  self->part_size += length;
+  self->object_size += length;
+}
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+static gboolean
+_deflate(S3Object *self, const gchar *data, gsize length, gint flush)
+{
+  self->zstream.next_in = (Bytef *) data;
+  self->zstream.avail_in = length;
+
+  do
+    {
+      gsize offset = self->pending->len;
+
+      g_string_set_size(self->pending, offset + S3_OBJECT_DEFLATE_CHUNK);
+      self->zstream.next_out = (Bytef *) self->pending->str + offset;
+      self->zstream.avail_out = S3_OBJECT_DEFLATE_CHUNK;
+
+      gint ret = deflate(&self->zstream, flush);
+
+      gsize produced = S3_OBJECT_DEFLATE_CHUNK - self->zstream.avail_out;
+      g_string_set_size(self->pending, offset + produced);
+      _account_output(self, produced);
+
+      if (ret == Z_STREAM_ERROR)
+        return FALSE;
+    }
+  while (self->zstream.avail_out == 0);
+
+  return TRUE;
+}
+#endif
+
+gboolean
+s3_object_append(S3Object *self, const gchar *data, gsize length)
+{
+  if (!self->part_file && !_open_part(self))
+    return FALSE;
+
+  self->dirty = TRUE;
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+  if (self->compress)
+    return _deflate(self, data, length, Z_NO_FLUSH);
+#endif
+
+  g_string_append_len(self->pending, data, length);
+  _account_output(self, length);
+  return TRUE;
+}
+
+static gboolean
+_write_pending(S3Object *self)
+{
+  if (self->pending->len == 0)
+    return TRUE;
+
+  if (fwrite(self->pending->str, 1, self->pending->len, self->part_file) != self->pending->len ||
+      fflush(self->part_file) != 0)
+    {
+      msg_error("s3-native(): error writing part file",
+                evt_tag_str("key", self->key),
+                evt_tag_int("part_number", self->part_number),
+                evt_tag_error("error"));
+      return FALSE;
+    }
+
+  g_string_truncate(self->pending, 0);
+  return TRUE;
+}
+
+/* Writes everything appended so far to the part file.  The compressed
+ * stream is flushed to a byte boundary, so that a part interrupted by a
+ * crash can still be decompressed up to this point. */
+gboolean
+s3_object_sync(S3Object *self)
+{
+  if (!self->part_file || !self->dirty)
+    return TRUE;
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+  if (self->compress && !_deflate(self, NULL, 0, Z_SYNC_FLUSH))
+    return FALSE;
+#endif
+
+  self->dirty = FALSE;
+  return _write_pending(self);
+}
+
+/* Returns the number of the part closed, or 0 if the current part was
+ * empty.  The part is ready for upload once this returns. */
+gint
+s3_object_close_part(S3Object *self)
+{
+  if (!self->part_file)
+    return 0;
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+  if (self->compress && !_deflate(self, NULL, 0, Z_FINISH))
+    return -1;
+#endif
+
+  if (!_write_pending(self))
+    return -1;
+
+  fsync(fileno(self->part_file));
+  _close_part_file(self);
+  self->dirty = FALSE;
+
+  gint closed_part_number = self->part_number;
+  self->part_number++;
+  g_ptr_array_set_size(self->etags, closed_part_number);
+  self->pending_parts++;
+
+  return closed_part_number;
+}
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+/* the part file may end in the middle of a gzip member, everything up to
+ * the last sync point is recovered */
+static void
+_inflate_partial(const gchar *data, gsize length, GString *result)
+{
+  z_stream zstream;
+
+  memset(&zstream, 0, sizeof(zstream));
+  if (inflateInit2(&zstream, MAX_WBITS + 16) != Z_OK)
+    return;
+
+  zstream.next_in = (Bytef *) data;
+  zstream.avail_in = length;
+
+  gint ret;
+  do
+    {
+      gsize offset = result->len;
+
+      g_string_set_size(result, offset + S3_OBJECT_DEFLATE_CHUNK);
+      zstream.next_out = (Bytef *) result->str + offset;
+      zstream.avail_out = S3_OBJECT_DEFLATE_CHUNK;
+
+      ret = inflate(&zstream, Z_SYNC_FLUSH);
+      g_string_set_size(result, offset + S3_OBJECT_DEFLATE_CHUNK - zstream.avail_out);
+    }
+  while (ret == Z_OK && (zstream.avail_in > 0 || zstream.avail_out == 0));
+
+  inflateEnd(&zstream);
+}
+#endif
+
+/* Closes the part that was being written when the upload was interrupted. */
+gint
+s3_object_recover_part(S3Object *self)
+{
+  gchar *path = s3_object_format_part_path(self, self->part_number);
+  gchar *contents = NULL;
+  gsize length = 0;
+  gint result = 0;
+
+  if (!g_file_get_contents(path, &contents, &length, NULL) || length == 0)
+    goto exit;
+
+  GString *data = g_string_sized_new(length);
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+  if (self->compress)
+    _inflate_partial(contents, length, data);
+  else
+#endif
+    g_string_append_len(data, contents, length);
+
+  if (data->len > 0 && s3_object_append(self, data->str, data->len))
+    result = s3_object_close_part(self);
+  g_string_free(data, TRUE);
+
+exit:
+  if (result <= 0)
+    unlink(path);
+  g_free(contents);
+  g_free(path);
+  return result;
+}
+
+gboolean
+s3_object_save_state(S3Object *self)
+{
+  GKeyFile *state = g_key_file_new();
+  const gchar **etags = g_new0(const gchar *, self->etags->len + 1);
+  GError *error = NULL;
+
+  for (guint i = 0; i < self->etags->len; i++)
+    {
+      const gchar *etag = g_ptr_array_index(self->etags, i);
+      etags[i] = etag ? etag : "";
+    }
+
+  g_key_file_set_string(state, S3_OBJECT_STATE_GROUP, "target", self->target);
+  g_key_file_set_string(state, S3_OBJECT_STATE_GROUP, "key", self->key);
+  g_key_file_set_string(state, S3_OBJECT_STATE_GROUP, "upload-id", self->upload_id ? self->upload_id : "");
+  g_key_file_set_boolean(state, S3_OBJECT_STATE_GROUP, "compress", self->compress);
+  g_key_file_set_boolean(state, S3_OBJECT_STATE_GROUP, "finished", self->finished);
+  g_key_file_set_integer(state, S3_OBJECT_STATE_GROUP, "part-number", self->part_number);
+  g_key_file_set_string_list(state, S3_OBJECT_STATE_GROUP, "etags", etags, self->etags->len);
+
+  gsize length;
+  gchar *contents = g_key_file_to_data(state, &length, NULL);
+  gchar *path = _format_state_path(self);
+
+  gboolean result = g_file_set_contents(path, contents, length, &error);
+  if (!result)
+    {
+      msg_error("s3-native(): error saving upload state",
+                evt_tag_str("path", path),
+                evt_tag_str("error", error->message));
+      g_clear_error(&error);
+    }
+
+  g_free(path);
+  g_free(contents);
+  g_free(etags);
+  g_key_file_free(state);
+  return result;
+}
+
+S3Object *
+s3_object_load(const gchar *state_file)
+{
+  GKeyFile *state = g_key_file_new();
+  GError *error = NULL;
+  S3Object *self = NULL;
+
+  if (!g_str_has_suffix(state_file, ".state") || !g_key_file_load_from_file(state, state_file, G_KEY_FILE_NONE, &error))
+    goto exit;
+
+  gchar *target = g_key_file_get_string(state, S3_OBJECT_STATE_GROUP, "target", &error);
+  gchar *key = g_key_file_get_string(state, S3_OBJECT_STATE_GROUP, "key", error ? NULL : &error);
+  gchar *state_base = g_strndup(state_file, strlen(state_file) - strlen(".state"));
+
+  if (!error)
+    self = s3_object_new(state_base, target, key,
+                         g_key_file_get_boolean(state, S3_OBJECT_STATE_GROUP, "compress", NULL));
+
+  g_free(state_base);
+  g_free(target);
+  g_free(key);
+
+  if (!self)
+    goto exit;
+
+  gchar *upload_id = g_key_file_get_string(state, S3_OBJECT_STATE_GROUP, "upload-id", NULL);
+  if (upload_id && upload_id[0])
+    self->upload_id = upload_id;
+  else
+    g_free(upload_id);
+
+  self->finished = g_key_file_get_boolean(state, S3_OBJECT_STATE_GROUP, "finished", NULL);
+  self->part_number = MAX(1, g_key_file_get_integer(state, S3_OBJECT_STATE_GROUP, "part-number", NULL));
+
+  gsize num_etags = 0;
+  gchar **etags = g_key_file_get_string_list(state, S3_OBJECT_STATE_GROUP, "etags", &num_etags, NULL);
+  for (gsize i = 0; i < num_etags && i < (gsize) self->part_number - 1; i++)
+    g_ptr_array_add(self->etags, etags[i][0] ? g_strdup(etags[i]) : NULL);
+  g_ptr_array_set_size(self->etags, self->part_number - 1);
+  g_strfreev(etags);
+
+exit:
+  if (error)
+    {
+      msg_error("s3-native(): error loading upload state",
+                evt_tag_str("path", state_file),
+                evt_tag_str("error", error->message));
+      g_clear_error(&error);
+    }
+  g_key_file_free(state);
+  return self;
+}
+
+void
+s3_object_remove_state(S3Object *self)
+{
+  for (gint part_number = 1; part_number <= self->part_number; part_number++)
+    {
+      gchar *path = s3_object_format_part_path(self, part_number);
+      unlink(path);
+      g_free(path);
+    }
+
+  gchar *path = _format_state_path(self);
+  unlink(path);
+  g_free(path);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef S3_OBJECT_H_INCLUDED
+#define S3_OBJECT_H_INCLUDED
+
+#include "syslog-ng.h"
+#include "compression.h"
+
+#include <stdio.h>
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+#include <zlib.h>
+#endif
+
+/*
+ * An object being uploaded with the S3 multipart API.  Parts are
+ * accumulated in files under working-dir(), and every closed part is
+ * uploaded independently.  With compression enabled, every part is a
+ * separate gzip member, so the concatenated object is a valid gzip file.
+ *
+ * The state of the upload (object key, upload id, ETags of the uploaded
+ * parts) is persisted next to the part files, so that an upload
+ * interrupted by a restart can be finished later.
+ */
+typedef struct _S3Object
+{
+  gint ref_cnt;
+  gchar *target;
+  gchar *key;
+  gchar *upload_id;
+  gchar *state_base;
+  gboolean compress;
+  gboolean finished;
+
+  /* the part being written currently, and the ETags of the closed ones */
+  gint part_number;
+  GPtrArray *etags;
+  gint pending_parts;
+
+  FILE *part_file;
+  GString *pending;
+  gboolean dirty;
+  gsize part_size;
+  gsize object_size;
+  time_t last_write;
+
+  GMutex upload_id_lock;
+
+#if SYSLOG_NG_HTTP_COMPRESSION_ENABLED
+  z_stream zstream;
+#endif
+} S3Object;
+
+S3Object *s3_object_new(const gchar *state_base, const gchar *target, const gchar *key, gboolean compress);
+S3Object *s3_object_load(const gchar *state_file);
+S3Object *s3_object_ref(S3Object *self);
+void s3_object_unref(S3Object *self);
+
+gboolean s3_object_append(S3Object *self, const gchar *data, gsize length);
+gboolean s3_object_sync(S3Object *self);
+gint s3_object_close_part(S3Object *self);
+gint s3_object_recover_part(S3Object *self);
+
+gchar *s3_object_format_part_path(S3Object *self, gint part_number);
+gboolean s3_object_save_state(S3Object *self);
+void s3_object_remove_state(S3Object *self);
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "s3-signer.h"
+
+#include <string.h>
+
+#define S3_SIGNATURE_ALGORITHM "AWS4-HMAC-SHA256"
+#define S3_SERVICE "s3"
+
+void
+s3_uri_encode(GString *result, const gchar *value, gboolean encode_slash)
+{
+  for (const guchar *p = (const guchar *) value; *p; p++)
+    {
+      if (g_ascii_isalnum(*p) || *p == '-' || *p == '_' || *p == '.' || *p == '~' || (*p == '/' && !encode_slash))
+        g_string_append_c(result, *p);
+      else
+        g_string_append_printf(result, "%%%02X", *p);
+    }
+}
+
+gchar *
+s3_sha256_hex(const gchar *data, gsize length)
+{
+  return g_compute_checksum_for_data(G_CHECKSUM_SHA256, (const guchar *) data, length);
+}
+
+static void
+_hmac_sha256(const guint8 *key, gsize key_length, const gchar *data, guint8 *digest)
+{
+  GHmac *hmac = g_hmac_new(G_CHECKSUM_SHA256, key, key_length);
+  gsize digest_length = 32;
+
+  g_hmac_update(hmac, (const guchar *) data, strlen(data));
+  g_hmac_get_digest(hmac, digest, &digest_length);
+  g_hmac_unref(hmac);
+}
+
+static gint
+_compare_headers(gconstpointer a, gconstpointer b)
+{
+  const gchar *header_a = *(const gchar **) a;
+  const gchar *header_b = *(const gchar **) b;
+
+  gsize name_a = strcspn(header_a, ":");
+  gsize name_b = strcspn(header_b, ":");
+  gint result = strncmp(header_a, header_b, MIN(name_a, name_b));
+
+  return result ? result : (gint) name_a - (gint) name_b;
+}
+
+static gchar *
+_format_canonical_request(const gchar *method, const gchar *canonical_uri, const gchar *canonical_query,
+                          GPtrArray *headers, const gchar *payload_hash, GString *signed_headers)
+{
+  GString *request = g_string_sized_new(512);
+
+  g_string_append_printf(request, "%s\n%s\n%s\n", method, canonical_uri, canonical_query);
+
+  g_ptr_array_sort(headers, _compare_headers);
+  for (guint i = 0; i < headers->len; i++)
+    {
+      const gchar *header = g_ptr_array_index(headers, i);
+
+      g_string_append_printf(request, "%s\n", header);
+      if (i > 0)
+        g_string_append_c(signed_headers, ';');
+      g_string_append_len(signed_headers, header, strcspn(header, ":"));
+    }
+
+  g_string_append_printf(request, "\n%s\n%s", signed_headers->str, payload_hash);
+  return g_string_free(request, FALSE);
+}
+
+gchar *
+s3_sign_request(const S3Credentials *credentials, const gchar *method,
+                const gchar *canonical_uri, const gchar *canonical_query,
+                GPtrArray *headers, const gchar *payload_hash, const gchar *amz_date)
+{
+  GString *signed_headers = g_string_sized_new(128);
+  gchar *canonical_request = _format_canonical_request(method, canonical_uri, canonical_query, headers,
+                                                       payload_hash, signed_headers);
+  gchar *canonical_request_hash = s3_sha256_hex(canonical_request, strlen(canonical_request));
+  gchar *date = g_strndup(amz_date, 8);
+  gchar *scope = g_strdup_printf("%s/%s/" S3_SERVICE "/aws4_request", date, credentials->region);
+  gchar *string_to_sign = g_strdup_printf(S3_SIGNATURE_ALGORITHM "\n%s\n%s\n%s",
+                                          amz_date, scope, canonical_request_hash);
+
+  gchar *secret = g_strdup_printf("AWS4%s", credentials->secret_key);
+  guint8 key[32];
+
+  _hmac_sha256((const guint8 *) secret, strlen(secret), date, key);
+  _hmac_sha256(key, sizeof(key), credentials->region, key);
+  _hmac_sha256(key, sizeof(key), S3_SERVICE, key);
+  _hmac_sha256(key, sizeof(key), "aws4_request", key);
+
+  gchar *signature = g_compute_hmac_for_string(G_CHECKSUM_SHA256, key, sizeof(key), string_to_sign, -1);
+  gchar *authorization = g_strdup_printf(S3_SIGNATURE_ALGORITHM " Credential=%s/%s, SignedHeaders=%s, Signature=%s",
+                                         credentials->access_key, scope, signed_headers->str, signature);
+
+  g_free(signature);
+  g_free(secret);
+  g_free(string_to_sign);
+  g_free(scope);
+  g_free(date);
+  g_free(canonical_request_hash);
+  g_free(canonical_request);
+  g_string_free(signed_headers, TRUE);
+  return authorization;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef S3_SIGNER_H_INCLUDED
+#define S3_SIGNER_H_INCLUDED
+
+#include "syslog-ng.h"
+
+typedef struct _S3Credentials
+{
+  const gchar *access_key;
+  const gchar *secret_key;
+  const gchar *region;
+} S3Credentials;
+
+void s3_uri_encode(GString *result, const gchar *value, gboolean encode_slash);
+gchar *s3_sha256_hex(const gchar *data, gsize length);
+
+/*
+ * Returns the value of the Authorization header of an AWS Signature
+ * Version 4 signed S3 request.  @headers contains "name:value" strings
+ * with lowercase names, it has to contain host, x-amz-content-sha256 and
+ * x-amz-date at least.  @amz_date is in the YYYYMMDD'T'HHMMSS'Z' format.
+ */
+gchar *s3_sign_request(const S3Credentials *credentials, const gchar *method,
+                       const gchar *canonical_uri, const gchar *canonical_query,
+                       GPtrArray *headers, const gchar *payload_hash, const gchar *amz_date);
+
+#endif
@@ -160,6 +160,28 @@ Test(compression, compressor_deflate_compression)
   compressor_free(compressor);
   g_string_free(result, TRUE);
 }
+
+Test(compression, decompress_content_gzip_and_deflate)
+{
+  result = g_string_new("");
+  cr_assert(decompress_content(CURL_COMPRESSION_GZIP, result, (const gchar *) test_message_gzipped_bytes,
+                               test_message_gzipped_length, 65536));
+  cr_assert_str_eq(result->str, test_message);
+
+  g_string_truncate(result, 0);
+  cr_assert(decompress_content(CURL_COMPRESSION_DEFLATE, result, (const gchar *) test_message_deflated_bytes,
+                               test_message_deflated_length, 65536));
+  cr_assert_str_eq(result->str, test_message);
+
+  g_string_truncate(result, 0);
+  cr_assert_not(decompress_content(CURL_COMPRESSION_GZIP, result, (const gchar *) test_message_gzipped_bytes,
+                                   test_message_gzipped_length, 16), "decompression should stop at max_length");
+
+  g_string_truncate(result, 0);
+  cr_assert_not(decompress_content(CURL_COMPRESSION_GZIP, result, (const gchar *) test_message_gzipped_bytes,
+                                   test_message_gzipped_length / 2, 65536), "truncated input should be rejected");
+  g_string_free(result, TRUE);
+}
 #endif
 
 #endif
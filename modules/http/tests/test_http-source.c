@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "http-request-parser.h"
+#include "http-body-splitter.h"
+#include "http-source-response.h"
+
+#include <string.h>
+
+static HttpRequest request;
+
+/* each call parses a new request, see _parse_in_pieces() for the incremental case */
+static HttpRequestParseResult
+_parse(const gchar *raw, gsize *consumed)
+{
+  http_request_reset(&request);
+  return http_request_parse(&request, raw, strlen(raw), 1024, consumed);
+}
+
+static HttpRequestParseResult
+_parse_in_pieces(const gchar *raw, gsize piece_size, gsize *consumed)
+{
+  HttpRequestParseResult result = HTTP_REQUEST_PARSE_INCOMPLETE;
+  gsize length = strlen(raw);
+
+  http_request_reset(&request);
+  for (gsize available = MIN(piece_size, length); result == HTTP_REQUEST_PARSE_INCOMPLETE;
+       available = MIN(available + piece_size, length))
+    {
+      result = http_request_parse(&request, raw, available, 1024, consumed);
+      if (available == length)
+        break;
+    }
+  return result;
+}
+
+static gboolean
+_collect_record(const gchar *record, gsize length, gpointer user_data)
+{
+  GPtrArray *records = (GPtrArray *) user_data;
+
+  g_ptr_array_add(records, g_strndup(record, length));
+  return TRUE;
+}
+
+static GPtrArray *
+_split(HttpBodyFormat format, const gchar *body, gboolean expected_result)
+{
+  GPtrArray *records = g_ptr_array_new_with_free_func(g_free);
+
+  cr_assert_eq(http_body_split(format, body, strlen(body), _collect_record, records), expected_result,
+               "unexpected split result for body: %s", body);
+  return records;
+}
+
+static void
+_assert_records(GPtrArray *records, const gchar **expected, gint expected_len)
+{
+  cr_assert_eq(records->len, expected_len, "unexpected number of records: %d", records->len);
+  for (gint i = 0; i < expected_len; i++)
+    cr_assert_str_eq(g_ptr_array_index(records, i), expected[i]);
+  g_ptr_array_free(records, TRUE);
+}
+
+Test(http_request_parser, content_length_body_is_parsed)
+{
+  const gchar *raw =
+    "POST /services/collector/event?channel=foo HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "Content-Type: application/json\r\n"
+    "Authorization: Splunk token\r\n"
+    "Content-Length: 5\r\n"
+    "\r\n"
+    "hello"
+    "GET / HTTP/1.1\r\n\r\n";
+  gsize consumed = 0;
+
+  cr_assert_eq(_parse(raw, &consumed), HTTP_REQUEST_PARSE_SUCCESS);
+  cr_assert_str_eq(request.method->str, "POST");
+  cr_assert_str_eq(request.path->str, "/services/collector/event");
+  cr_assert_str_eq(request.query->str, "channel=foo");
+  cr_assert_str_eq(request.content_type->str, "application/json");
+  cr_assert_str_eq(request.authorization->str, "Splunk token");
+  cr_assert_str_eq(request.body->str, "hello");
+  cr_assert(request.keep_alive);
+  cr_assert_eq(consumed, strlen(raw) - strlen("GET / HTTP/1.1\r\n\r\n"));
+}
+
+Test(http_request_parser, chunked_body_is_decoded)
+{
+  const gchar *raw =
+    "POST /_bulk HTTP/1.1\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "5\r\nhello\r\n"
+    "6;ext=1\r\n world\r\n"
+    "0\r\n"
+    "\r\n";
+  gsize consumed = 0;
+
+  cr_assert_eq(_parse(raw, &consumed), HTTP_REQUEST_PARSE_SUCCESS);
+  cr_assert_str_eq(request.body->str, "hello world");
+  cr_assert_eq(consumed, strlen(raw));
+}
+
+Test(http_request_parser, incomplete_requests_are_detected)
+{
+  gsize consumed = 0;
+
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nContent-Len", &consumed), HTTP_REQUEST_PARSE_INCOMPLETE);
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nContent-Length: 10\r\n\r\nhello", &consumed),
+               HTTP_REQUEST_PARSE_INCOMPLETE);
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n", &consumed),
+               HTTP_REQUEST_PARSE_INCOMPLETE);
+}
+
+Test(http_request_parser, invalid_and_too_large_requests_are_rejected)
+{
+  gsize consumed = 0;
+
+  cr_assert_eq(_parse("POST /\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_ERROR);
+  cr_assert_eq(_parse("POST / HTTP/2.0\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_ERROR);
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nContent-Length: abc\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_ERROR);
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nContent-Length: 4096\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_TOO_LARGE);
+}
+
+Test(http_request_parser, requests_arriving_in_pieces_are_parsed_incrementally)
+{
+  const gchar *raw =
+    "POST /_bulk HTTP/1.1\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "Content-Type: application/x-ndjson\r\n"
+    "\r\n"
+    "5\r\nhello\r\n"
+    "6;ext=1\r\n world\r\n"
+    "0\r\n"
+    "Trailer: value\r\n"
+    "\r\n"
+    "GET / HTTP/1.1\r\n\r\n";
+  gsize consumed = 0;
+
+  for (gsize piece_size = 1; piece_size < 16; piece_size++)
+    {
+      cr_assert_eq(_parse_in_pieces(raw, piece_size, &consumed), HTTP_REQUEST_PARSE_SUCCESS);
+      cr_assert_str_eq(request.method->str, "POST");
+      cr_assert_str_eq(request.content_type->str, "application/x-ndjson");
+      cr_assert_str_eq(request.body->str, "hello world", "piece size: %d", (gint) piece_size);
+      cr_assert_eq(consumed, strlen(raw) - strlen("GET / HTTP/1.1\r\n\r\n"));
+    }
+
+  cr_assert_eq(_parse_in_pieces("POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\nhello world", 3, &consumed),
+               HTTP_REQUEST_PARSE_SUCCESS);
+  cr_assert_str_eq(request.body->str, "hello world");
+
+  /* the request following a complete one starts from scratch */
+  const gchar *next = "GET /health HTTP/1.0\r\n\r\n";
+  cr_assert_eq(http_request_parse(&request, next, strlen(next), 1024, &consumed), HTTP_REQUEST_PARSE_SUCCESS);
+  cr_assert_str_eq(request.path->str, "/health");
+  cr_assert_str_eq(request.body->str, "");
+
+  /* complete chunks are decoded only once, the next call continues after them */
+  const gchar *partial = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n6\r\n wo";
+  http_request_reset(&request);
+  cr_assert_eq(http_request_parse(&request, partial, strlen(partial), 1024, &consumed), HTTP_REQUEST_PARSE_INCOMPLETE);
+  cr_assert_str_eq(request.body->str, "hello");
+  cr_assert_eq(http_request_parse(&request, partial, strlen(partial), 1024, &consumed), HTTP_REQUEST_PARSE_INCOMPLETE);
+  cr_assert_str_eq(request.body->str, "hello");
+}
+
+Test(http_request_parser, huge_chunk_sizes_do_not_overflow_the_body_limit)
+{
+  gsize consumed = 0;
+
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                      "2\r\nab\r\n"
+                      "FFFFFFFFFFFFFFFE\r\nxx\r\n"
+                      "0\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_ERROR);
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                      "FFFFFFFFFFFFFFFFFFFF\r\nxx\r\n"
+                      "0\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_ERROR);
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                      "2\r\nab\r\n"
+                      "7FFFFFFFFFFFFFFE\r\nxx\r\n"
+                      "0\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_TOO_LARGE);
+  cr_assert_eq(_parse("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                      "3FF\r\nxx\r\n"
+                      "2\r\nab\r\n", &consumed), HTTP_REQUEST_PARSE_INCOMPLETE);
+}
+
+Test(http_request_parser, connection_persistence_follows_the_protocol_version)
+{
+  gsize consumed = 0;
+
+  cr_assert_eq(_parse("GET / HTTP/1.0\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_SUCCESS);
+  cr_assert_not(request.keep_alive);
+
+  cr_assert_eq(_parse("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_SUCCESS);
+  cr_assert(request.keep_alive);
+
+  cr_assert_eq(_parse("GET / HTTP/1.1\r\nConnection: close\r\n\r\n", &consumed), HTTP_REQUEST_PARSE_SUCCESS);
+  cr_assert_not(request.keep_alive);
+}
+
+Test(http_source_response, head_responses_have_the_headers_but_not_the_body)
+{
+  GString *buffer = g_string_new(NULL);
+  HttpSourceResponse response = { 0 };
+
+  http_source_response_set(&response, 200, "OK", "{\"status\":\"ok\"}");
+  http_source_response_format(&response, buffer);
+  cr_assert(g_str_has_prefix(buffer->str, "HTTP/1.1 200 OK\r\n"));
+  cr_assert_not_null(strstr(buffer->str, "Content-Length: 15\r\n"));
+  cr_assert(g_str_has_suffix(buffer->str, "\r\n\r\n{\"status\":\"ok\"}"));
+
+  response.omit_body = TRUE;
+  http_source_response_format(&response, buffer);
+  cr_assert_not_null(strstr(buffer->str, "Content-Length: 15\r\n"));
+  cr_assert(g_str_has_suffix(buffer->str, "Connection: keep-alive\r\n\r\n"), "%s", buffer->str);
+
+  g_string_free(buffer, TRUE);
+}
+
+Test(http_body_splitter, body_format_is_detected_from_path_and_content_type)
+{
+  cr_assert_eq(http_body_format_detect("/services/collector/event", ""), HTTP_BODY_FORMAT_SPLUNK_HEC);
+  cr_assert_eq(http_body_format_detect("/services/collector/raw", ""), HTTP_BODY_FORMAT_LINES);
+  cr_assert_eq(http_body_format_detect("/logs/_bulk", "application/x-ndjson"), HTTP_BODY_FORMAT_ELASTICSEARCH_BULK);
+  cr_assert_eq(http_body_format_detect("/v1/logs", "application/x-protobuf"), HTTP_BODY_FORMAT_OTLP);
+  cr_assert_eq(http_body_format_detect("/", "application/json; charset=utf-8"), HTTP_BODY_FORMAT_JSON);
+  cr_assert_eq(http_body_format_detect("/", "text/plain"), HTTP_BODY_FORMAT_LINES);
+  cr_assert_eq(http_body_format_detect("/", ""), HTTP_BODY_FORMAT_RAW);
+}
+
+Test(http_body_splitter, lines_are_split_at_newlines)
+{
+  const gchar *expected[] = { "foo", "bar", "baz" };
+
+  _assert_records(_split(HTTP_BODY_FORMAT_LINES, "foo\r\nbar\n\nbaz", TRUE), expected, G_N_ELEMENTS(expected));
+}
+
+Test(http_body_splitter, json_arrays_and_streams_are_split_into_values)
+{
+  const gchar *expected[] = { "{\"a\":\"[1,2]\"}", "{\"b\":{\"c\":[1,2]}}", "\"str\\\"ing\"", "42" };
+
+  _assert_records(_split(HTTP_BODY_FORMAT_JSON, " [{\"a\":\"[1,2]\"}, {\"b\":{\"c\":[1,2]}},\"str\\\"ing\",42] ", TRUE),
+                  expected, G_N_ELEMENTS(expected));
+  _assert_records(_split(HTTP_BODY_FORMAT_JSON, "{\"a\":\"[1,2]\"}\n{\"b\":{\"c\":[1,2]}} \"str\\\"ing\" 42", TRUE),
+                  expected, G_N_ELEMENTS(expected));
+
+  g_ptr_array_free(_split(HTTP_BODY_FORMAT_JSON, "[{\"a\":1}", FALSE), TRUE);
+  g_ptr_array_free(_split(HTTP_BODY_FORMAT_JSON, "{\"a\":1", FALSE), TRUE);
+}
+
+Test(http_body_splitter, splunk_hec_events_can_be_concatenated)
+{
+  const gchar *expected[] = { "{\"event\":\"foo\"}", "{\"event\":{\"msg\":\"}{\"}}" };
+
+  _assert_records(_split(HTTP_BODY_FORMAT_SPLUNK_HEC, "{\"event\":\"foo\"}{\"event\":{\"msg\":\"}{\"}}", TRUE),
+                  expected, G_N_ELEMENTS(expected));
+}
+
+Test(http_body_splitter, elasticsearch_bulk_documents_are_extracted)
+{
+  const gchar *body =
+    "{\"index\":{\"_index\":\"logs\"}}\n"
+    "{\"message\":\"foo\"}\n"
+    "{\"delete\":{\"_id\":\"1\"}}\n"
+    "{\"create\":{}}\n"
+    "{\"message\":\"bar\"}\n";
+  const gchar *expected[] = { "{\"message\":\"foo\"}", "{\"message\":\"bar\"}" };
+
+  _assert_records(_split(HTTP_BODY_FORMAT_ELASTICSEARCH_BULK, body, TRUE), expected, G_N_ELEMENTS(expected));
+
+  g_ptr_array_free(_split(HTTP_BODY_FORMAT_ELASTICSEARCH_BULK, "{\"index\":{}}\n", FALSE), TRUE);
+  g_ptr_array_free(_split(HTTP_BODY_FORMAT_ELASTICSEARCH_BULK, "not json\n", FALSE), TRUE);
+}
+
+static void
+setup(void)
+{
+  http_request_init(&request);
+}
+
+static void
+teardown(void)
+{
+  http_request_clear(&request);
+}
+
+TestSuite(http_request_parser, .init = setup, .fini = teardown);
+TestSuite(http_body_splitter);
+TestSuite(http_source_response);
@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "kubernetes-metadata-cache.h"
+#include "messages.h"
+
+#include <string.h>
+
+/*
+ * The cache is a read-mostly map of the pods on the node.  Readers look up
+ * pods in an immutable, reference counted snapshot.  The single writer (the
+ * watch thread) publishes a modified copy of the snapshot for every change,
+ * which is cheap for the number of pods on a node.
+ *
+ * Readers do not lock anything: they register themselves in the reader
+ * counter of the current epoch and use the snapshot published at that
+ * point.  Publishing a snapshot flips the epoch, and the writer frees the
+ * replaced snapshot once the readers of the previous epoch are gone, which
+ * only takes as long as a hashtable lookup.
+ */
+
+#define KUBERNETES_MAX_POD_KEY_LENGTH 512
+
+typedef struct _KubernetesSnapshot
+{
+  GHashTable *pods;
+} KubernetesSnapshot;
+
+struct _KubernetesMetadataCache
+{
+  gchar *prefix;
+  gchar *key_delimiter;
+
+  NVHandle pod_uuid_handle;
+  NVHandle container_name_handle;
+  NVHandle container_image_handle;
+  NVHandle container_hash_handle;
+  NVHandle docker_id_handle;
+
+  KubernetesSnapshot *current;
+  gint epoch;
+  gint readers[2];
+};
+
+static void
+_add_value(GArray *values, NVHandle handle, const gchar *value)
+{
+  KubernetesValue kv = { .handle = handle, .value = g_strdup(value) };
+
+  g_array_append_val(values, kv);
+}
+
+static void
+_free_values(GArray *values)
+{
+  for (guint i = 0; i < values->len; i++)
+    g_free(g_array_index(values, KubernetesValue, i).value);
+  g_array_free(values, TRUE);
+}
+
+static void
+_container_free(KubernetesContainer *self)
+{
+  _free_values(self->values);
+  g_free(self->name);
+  g_free(self);
+}
+
+KubernetesPod *
+kubernetes_pod_ref(KubernetesPod *self)
+{
+  g_atomic_int_inc(&self->ref_cnt);
+  return self;
+}
+
+void
+kubernetes_pod_unref(KubernetesPod *self)
+{
+  if (!g_atomic_int_dec_and_test(&self->ref_cnt))
+    return;
+
+  g_ptr_array_free(self->containers, TRUE);
+  _free_values(self->values);
+  g_free(self->key);
+  g_free(self);
+}
+
+const KubernetesContainer *
+kubernetes_pod_lookup_container(KubernetesPod *self, const gchar *name, gssize name_len)
+{
+  if (self->containers->len == 0)
+    return NULL;
+
+  if (name)
+    {
+      if (name_len < 0)
+        name_len = strlen(name);
+
+      for (guint i = 0; i < self->containers->len; i++)
+        {
+          KubernetesContainer *container = g_ptr_array_index(self->containers, i);
+          if (strncmp(container->name, name, name_len) == 0 && container->name[name_len] == 0)
+            return container;
+        }
+    }
+
+  /* the same as the Python implementation did */
+  return g_ptr_array_index(self->containers, 0);
+}
+
+static const gchar *
+_get_string(struct json_object *object, const gchar *key)
+{
+  struct json_object *value;
+
+  if (!object || !json_object_object_get_ex(object, key, &value) || !json_object_is_type(value, json_type_string))
+    return NULL;
+  return json_object_get_string(value);
+}
+
+static struct json_object *
+_get_object(struct json_object *object, const gchar *key, json_type type)
+{
+  struct json_object *value;
+
+  if (!object || !json_object_object_get_ex(object, key, &value) || !json_object_is_type(value, type))
+    return NULL;
+  return value;
+}
+
+static void
+_add_dict_values(KubernetesMetadataCache *self, GArray *values, struct json_object *dict, const gchar *name)
+{
+  if (!dict)
+    return;
+
+  GString *value_name = g_string_sized_new(128);
+  json_object_object_foreach(dict, key, value)
+  {
+    if (!json_object_is_type(value, json_type_string))
+      continue;
+
+    g_string_printf(value_name, "%s%s%s%s", self->prefix, name, self->key_delimiter, key);
+    _add_value(values, log_msg_get_value_handle(value_name->str), json_object_get_string(value));
+  }
+  g_string_free(value_name, TRUE);
+}
+
+static const gchar *
+_strip_scheme(const gchar *value)
+{
+  const gchar *separator = strstr(value, "://");
+
+  return separator ? separator + 3 : value;
+}
+
+static KubernetesContainer *
+_container_new_from_json(KubernetesMetadataCache *self, struct json_object *status)
+{
+  const gchar *name = _get_string(status, "name");
+
+  if (!name)
+    return NULL;
+
+  KubernetesContainer *container = g_new0(KubernetesContainer, 1);
+  container->name = g_strdup(name);
+  container->values = g_array_new(FALSE, FALSE, sizeof(KubernetesValue));
+
+  _add_value(container->values, self->container_name_handle, name);
+
+  const gchar *image = _get_string(status, "image");
+  if (image)
+    _add_value(container->values, self->container_image_handle, image);
+
+  const gchar *image_id = _get_string(status, "imageID");
+  if (image_id)
+    {
+      if (g_str_has_prefix(image_id, "docker-pullable://"))
+        image_id += strlen("docker-pullable://");
+      _add_value(container->values, self->container_hash_handle, image_id);
+    }
+
+  const gchar *container_id = _get_string(status, "containerID");
+  if (container_id)
+    _add_value(container->values, self->docker_id_handle, _strip_scheme(container_id));
+
+  return container;
+}
+
+static KubernetesPod *
+_pod_new_from_json(KubernetesMetadataCache *self, struct json_object *object)
+{
+  struct json_object *metadata = _get_object(object, "metadata", json_type_object);
+  const gchar *namespace_name = _get_string(metadata, "namespace");
+  const gchar *pod_name = _get_string(metadata, "name");
+
+  if (!namespace_name || !pod_name)
+    return NULL;
+
+  KubernetesPod *pod = g_new0(KubernetesPod, 1);
+  pod->ref_cnt = 1;
+  pod->key = g_strdup_printf("%s/%s", namespace_name, pod_name);
+  pod->values = g_array_new(FALSE, FALSE, sizeof(KubernetesValue));
+  pod->containers = g_ptr_array_new_with_free_func((GDestroyNotify) _container_free);
+
+  const gchar *uid = _get_string(metadata, "uid");
+  if (uid)
+    _add_value(pod->values, self->pod_uuid_handle, uid);
+
+  _add_dict_values(self, pod->values, _get_object(metadata, "labels", json_type_object), "labels");
+  _add_dict_values(self, pod->values, _get_object(metadata, "annotations", json_type_object), "annotations");
+
+  struct json_object *status = _get_object(object, "status", json_type_object);
+  struct json_object *container_statuses = _get_object(status, "containerStatuses", json_type_array);
+  for (gsize i = 0; container_statuses && i < json_object_array_length(container_statuses); i++)
+    {
+      KubernetesContainer *container = _container_new_from_json(self, json_object_array_get_idx(container_statuses, i));
+      if (container)
+        g_ptr_array_add(pod->containers, container);
+    }
+
+  return pod;
+}
+
+static KubernetesSnapshot *
+_snapshot_new(KubernetesSnapshot *source)
+{
+  KubernetesSnapshot *self = g_new0(KubernetesSnapshot, 1);
+
+  self->pods = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) kubernetes_pod_unref);
+  if (source)
+    {
+      GHashTableIter iter;
+      gpointer value;
+
+      g_hash_table_iter_init(&iter, source->pods);
+      while (g_hash_table_iter_next(&iter, NULL, &value))
+        {
+          KubernetesPod *pod = (KubernetesPod *) value;
+          g_hash_table_insert(self->pods, pod->key, kubernetes_pod_ref(pod));
+        }
+    }
+  return self;
+}
+
+static void
+_snapshot_free(KubernetesSnapshot *self)
+{
+  g_hash_table_destroy(self->pods);
+  g_free(self);
+}
+
+static KubernetesSnapshot *
+_enter_current_snapshot(KubernetesMetadataCache *self, gint *epoch)
+{
+  while (TRUE)
+    {
+      gint current_epoch = g_atomic_int_get(&self->epoch);
+
+      g_atomic_int_inc(&self->readers[current_epoch]);
+      if (g_atomic_int_get(&self->epoch) == current_epoch)
+        {
+          *epoch = current_epoch;
+          return g_atomic_pointer_get(&self->current);
+        }
+      /* raced with a publish, the snapshot we would see may already be freed */
+      g_atomic_int_add(&self->readers[current_epoch], -1);
+    }
+}
+
+static void
+_leave_snapshot(KubernetesMetadataCache *self, gint epoch)
+{
+  g_atomic_int_add(&self->readers[epoch], -1);
+}
+
+static void
+_publish(KubernetesMetadataCache *self, KubernetesSnapshot *snapshot)
+{
+  KubernetesSnapshot *old = self->current;
+  gint old_epoch = self->epoch;
+
+  g_atomic_pointer_set(&self->current, snapshot);
+  g_atomic_int_set(&self->epoch, !old_epoch);
+
+  while (g_atomic_int_get(&self->readers[old_epoch]) > 0)
+    g_thread_yield();
+
+  _snapshot_free(old);
+}
+
+void
+kubernetes_metadata_cache_replace(KubernetesMetadataCache *self, struct json_object *pod_list)
+{
+  KubernetesSnapshot *snapshot = _snapshot_new(NULL);
+  struct json_object *items = _get_object(pod_list, "items", json_type_array);
+
+  for (gsize i = 0; items && i < json_object_array_length(items); i++)
+    {
+      KubernetesPod *pod = _pod_new_from_json(self, json_object_array_get_idx(items, i));
+      if (pod)
+        g_hash_table_replace(snapshot->pods, pod->key, pod);
+    }
+
+  _publish(self, snapshot);
+}
+
+gboolean
+kubernetes_metadata_cache_apply_event(KubernetesMetadataCache *self, const gchar *type, struct json_object *object)
+{
+  KubernetesPod *pod = _pod_new_from_json(self, object);
+
+  if (!pod)
+    return FALSE;
+
+  KubernetesSnapshot *snapshot;
+  if (strcmp(type, "ADDED") == 0 || strcmp(type, "MODIFIED") == 0)
+    {
+      snapshot = _snapshot_new(self->current);
+      g_hash_table_replace(snapshot->pods, pod->key, pod);
+    }
+  else if (strcmp(type, "DELETED") == 0)
+    {
+      snapshot = _snapshot_new(self->current);
+      g_hash_table_remove(snapshot->pods, pod->key);
+      kubernetes_pod_unref(pod);
+    }
+  else
+    {
+      kubernetes_pod_unref(pod);
+      return FALSE;
+    }
+
+  _publish(self, snapshot);
+  return TRUE;
+}
+
+KubernetesPod *
+kubernetes_metadata_cache_lookup(KubernetesMetadataCache *self,
+                                 const gchar *namespace_name, gssize namespace_name_len,
+                                 const gchar *pod_name, gssize pod_name_len)
+{
+  gchar key[KUBERNETES_MAX_POD_KEY_LENGTH];
+
+  if (namespace_name_len < 0)
+    namespace_name_len = strlen(namespace_name);
+  if (pod_name_len < 0)
+    pod_name_len = strlen(pod_name);
+
+  if ((gsize) (namespace_name_len + pod_name_len) + 2 > sizeof(key))
+    return NULL;
+
+  memcpy(key, namespace_name, namespace_name_len);
+  key[namespace_name_len] = '/';
+  memcpy(key + namespace_name_len + 1, pod_name, pod_name_len);
+  key[namespace_name_len + 1 + pod_name_len] = 0;
+
+  gint epoch;
+  KubernetesSnapshot *snapshot = _enter_current_snapshot(self, &epoch);
+
+  KubernetesPod *pod = g_hash_table_lookup(snapshot->pods, key);
+  if (pod)
+    kubernetes_pod_ref(pod);
+
+  _leave_snapshot(self, epoch);
+  return pod;
+}
+
+gsize
+kubernetes_metadata_cache_get_size(KubernetesMetadataCache *self)
+{
+  gint epoch;
+  KubernetesSnapshot *snapshot = _enter_current_snapshot(self, &epoch);
+  gsize size = g_hash_table_size(snapshot->pods);
+
+  _leave_snapshot(self, epoch);
+  return size;
+}
+
+static NVHandle
+_get_prefixed_handle(KubernetesMetadataCache *self, const gchar *name)
+{
+  gchar *value_name = g_strdup_printf("%s%s", self->prefix, name);
+  NVHandle handle = log_msg_get_value_handle(value_name);
+
+  g_free(value_name);
+  return handle;
+}
+
+KubernetesMetadataCache *
+kubernetes_metadata_cache_new(const gchar *prefix, const gchar *key_delimiter)
+{
+  KubernetesMetadataCache *self = g_new0(KubernetesMetadataCache, 1);
+
+  self->prefix = g_strdup(prefix);
+  self->key_delimiter = g_strdup(key_delimiter);
+
+  self->pod_uuid_handle = _get_prefixed_handle(self, "pod_uuid");
+  self->container_name_handle = _get_prefixed_handle(self, "container_name");
+  self->container_image_handle = _get_prefixed_handle(self, "container_image");
+  self->container_hash_handle = _get_prefixed_handle(self, "container_hash");
+  self->docker_id_handle = _get_prefixed_handle(self, "docker_id");
+
+  self->current = _snapshot_new(NULL);
+  return self;
+}
+
+void
+kubernetes_metadata_cache_free(KubernetesMetadataCache *self)
+{
+  _snapshot_free(self->current);
+
+  g_free(self->prefix);
+  g_free(self->key_delimiter);
+  g_free(self);
+}
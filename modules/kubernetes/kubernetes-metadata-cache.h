@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef KUBERNETES_METADATA_CACHE_H_INCLUDED
+#define KUBERNETES_METADATA_CACHE_H_INCLUDED
+
+#include "syslog-ng.h"
+#include "logmsg/logmsg.h"
+#include "compat/json.h"
+
+typedef struct _KubernetesValue
+{
+  NVHandle handle;
+  gchar *value;
+} KubernetesValue;
+
+typedef struct _KubernetesContainer
+{
+  gchar *name;
+  GArray *values;
+} KubernetesContainer;
+
+/* immutable once published to the cache, the values are keyed by
+ * NVHandles resolved when the pod is received */
+typedef struct _KubernetesPod
+{
+  gint ref_cnt;
+  gchar *key;
+  GArray *values;
+  GPtrArray *containers;
+} KubernetesPod;
+
+typedef struct _KubernetesMetadataCache KubernetesMetadataCache;
+
+KubernetesPod *kubernetes_pod_ref(KubernetesPod *self);
+void kubernetes_pod_unref(KubernetesPod *self);
+const KubernetesContainer *kubernetes_pod_lookup_container(KubernetesPod *self, const gchar *name, gssize name_len);
+
+KubernetesMetadataCache *kubernetes_metadata_cache_new(const gchar *prefix, const gchar *key_delimiter);
+void kubernetes_metadata_cache_free(KubernetesMetadataCache *self);
+
+/* readers, these can be called from any thread */
+KubernetesPod *kubernetes_metadata_cache_lookup(KubernetesMetadataCache *self,
+                                                const gchar *namespace_name, gssize namespace_name_len,
+                                                const gchar *pod_name, gssize pod_name_len);
+gsize kubernetes_metadata_cache_get_size(KubernetesMetadataCache *self);
+
+/* writers, these must be called from a single thread */
+void kubernetes_metadata_cache_replace(KubernetesMetadataCache *self, struct json_object *pod_list);
+gboolean kubernetes_metadata_cache_apply_event(KubernetesMetadataCache *self, const gchar *type,
+                                               struct json_object *pod);
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "kubernetes-metadata-parser.h"
+#include "kubernetes-watch.h"
+
+/*
+ * Enriches messages with the metadata of the pod they were logged by.  The
+ * pod is identified by the ${<prefix>namespace_name} and
+ * ${<prefix>pod_name} values, as extracted from the log file name by
+ * kubernetes-metadata-parser().  Unlike the Python implementation, a pod
+ * missing from the cache never blocks the message: it is forwarded
+ * without metadata, until the watch delivers the pod.
+ */
+typedef struct _KubernetesMetadataParser
+{
+  LogParser super;
+  KubernetesWatch *watch;
+  NVHandle namespace_name_handle;
+  NVHandle pod_name_handle;
+  NVHandle container_name_handle;
+} KubernetesMetadataParser;
+
+static void
+_set_values(LogMessage *msg, GArray *values)
+{
+  for (guint i = 0; i < values->len; i++)
+    {
+      KubernetesValue *kv = &g_array_index(values, KubernetesValue, i);
+      gssize value_len;
+
+      log_msg_get_value(msg, kv->handle, &value_len);
+      if (value_len == 0)
+        log_msg_set_value(msg, kv->handle, kv->value, -1);
+    }
+}
+
+static gboolean
+_process(LogParser *s, LogMessage **pmsg, const LogPathOptions *path_options, const gchar *input, gsize input_len)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  KubernetesMetadataCache *cache = kubernetes_watch_get_cache(self->watch);
+  gssize namespace_name_len, pod_name_len;
+
+  const gchar *namespace_name = log_msg_get_value(*pmsg, self->namespace_name_handle, &namespace_name_len);
+  const gchar *pod_name = log_msg_get_value(*pmsg, self->pod_name_handle, &pod_name_len);
+  if (namespace_name_len == 0 || pod_name_len == 0)
+    return TRUE;
+
+  KubernetesPod *pod = kubernetes_metadata_cache_lookup(cache, namespace_name, namespace_name_len,
+                                                        pod_name, pod_name_len);
+  if (!pod)
+    {
+      msg_trace("kubernetes-metadata(): pod not found in cache",
+                evt_tag_mem("namespace_name", namespace_name, namespace_name_len),
+                evt_tag_mem("pod_name", pod_name, pod_name_len),
+                evt_tag_msg_reference(*pmsg));
+      return TRUE;
+    }
+
+  LogMessage *msg = log_msg_make_writable(pmsg, path_options);
+  _set_values(msg, pod->values);
+
+  gssize container_name_len;
+  const gchar *container_name = log_msg_get_value_if_set(msg, self->container_name_handle, &container_name_len);
+  const KubernetesContainer *container = kubernetes_pod_lookup_container(pod, container_name, container_name_len);
+  if (container)
+    _set_values(msg, container->values);
+
+  kubernetes_pod_unref(pod);
+  return TRUE;
+}
+
+void
+kubernetes_metadata_parser_set_api_server(LogParser *s, const gchar *api_server)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  KubernetesWatchOptions *options = kubernetes_watch_get_options(self->watch);
+
+  g_free(options->api_server);
+  options->api_server = g_strdup(api_server);
+}
+
+void
+kubernetes_metadata_parser_set_token_file(LogParser *s, const gchar *token_file)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  KubernetesWatchOptions *options = kubernetes_watch_get_options(self->watch);
+
+  g_free(options->token_file);
+  options->token_file = g_strdup(token_file);
+}
+
+void
+kubernetes_metadata_parser_set_ca_file(LogParser *s, const gchar *ca_file)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  KubernetesWatchOptions *options = kubernetes_watch_get_options(self->watch);
+
+  g_free(options->ca_file);
+  options->ca_file = g_strdup(ca_file);
+}
+
+void
+kubernetes_metadata_parser_set_node_name(LogParser *s, const gchar *node_name)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  KubernetesWatchOptions *options = kubernetes_watch_get_options(self->watch);
+
+  g_free(options->node_name);
+  options->node_name = g_strdup(node_name);
+}
+
+void
+kubernetes_metadata_parser_set_peer_verify(LogParser *s, gboolean peer_verify)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+
+  kubernetes_watch_get_options(self->watch)->peer_verify = peer_verify;
+}
+
+void
+kubernetes_metadata_parser_set_prefix(LogParser *s, const gchar *prefix)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  KubernetesWatchOptions *options = kubernetes_watch_get_options(self->watch);
+
+  g_free(options->prefix);
+  options->prefix = g_strdup(prefix);
+}
+
+void
+kubernetes_metadata_parser_set_key_delimiter(LogParser *s, const gchar *key_delimiter)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  KubernetesWatchOptions *options = kubernetes_watch_get_options(self->watch);
+
+  g_free(options->key_delimiter);
+  options->key_delimiter = g_strdup(key_delimiter);
+}
+
+static NVHandle
+_get_prefixed_handle(const gchar *prefix, const gchar *name)
+{
+  gchar *value_name = g_strdup_printf("%s%s", prefix, name);
+  NVHandle handle = log_msg_get_value_handle(value_name);
+
+  g_free(value_name);
+  return handle;
+}
+
+static gboolean
+_init(LogPipe *s)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  const gchar *prefix = kubernetes_watch_get_options(self->watch)->prefix;
+
+  self->namespace_name_handle = _get_prefixed_handle(prefix, "namespace_name");
+  self->pod_name_handle = _get_prefixed_handle(prefix, "pod_name");
+  self->container_name_handle = _get_prefixed_handle(prefix, "container_name");
+
+  if (!kubernetes_watch_start(self->watch))
+    return FALSE;
+
+  return log_parser_init_method(s);
+}
+
+static gboolean
+_deinit(LogPipe *s)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+
+  kubernetes_watch_stop(self->watch);
+  return log_parser_deinit_method(s);
+}
+
+static LogPipe *
+_clone(LogPipe *s)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+  KubernetesMetadataParser *cloned = (KubernetesMetadataParser *) kubernetes_metadata_parser_new(s->cfg);
+
+  /* clones share the cache and the watch thread */
+  kubernetes_watch_unref(cloned->watch);
+  cloned->watch = kubernetes_watch_ref(self->watch);
+
+  log_parser_clone_settings(&self->super, &cloned->super);
+  return &cloned->super.super;
+}
+
+static void
+_free(LogPipe *s)
+{
+  KubernetesMetadataParser *self = (KubernetesMetadataParser *) s;
+
+  kubernetes_watch_unref(self->watch);
+  log_parser_free_method(s);
+}
+
+LogParser *
+kubernetes_metadata_parser_new(GlobalConfig *cfg)
+{
+  KubernetesMetadataParser *self = g_new0(KubernetesMetadataParser, 1);
+
+  log_parser_init_instance(&self->super, cfg);
+  self->super.super.init = _init;
+  self->super.super.deinit = _deinit;
+  self->super.super.clone = _clone;
+  self->super.super.free_fn = _free;
+  self->super.process = _process;
+
+  self->watch = kubernetes_watch_new();
+  return &self->super;
+}
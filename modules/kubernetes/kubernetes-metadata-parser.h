@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef KUBERNETES_METADATA_PARSER_H_INCLUDED
+#define KUBERNETES_METADATA_PARSER_H_INCLUDED
+
+#include "parser/parser-expr.h"
+
+LogParser *kubernetes_metadata_parser_new(GlobalConfig *cfg);
+
+void kubernetes_metadata_parser_set_api_server(LogParser *s, const gchar *api_server);
+void kubernetes_metadata_parser_set_token_file(LogParser *s, const gchar *token_file);
+void kubernetes_metadata_parser_set_ca_file(LogParser *s, const gchar *ca_file);
+void kubernetes_metadata_parser_set_node_name(LogParser *s, const gchar *node_name);
+void kubernetes_metadata_parser_set_peer_verify(LogParser *s, gboolean peer_verify);
+void kubernetes_metadata_parser_set_prefix(LogParser *s, const gchar *prefix);
+void kubernetes_metadata_parser_set_key_delimiter(LogParser *s, const gchar *key_delimiter);
+
+#endif
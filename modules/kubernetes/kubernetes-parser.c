@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "kubernetes-metadata-parser.h"
+#include "cfg-parser.h"
+#include "kubernetes-grammar.h"
+
+extern int kubernetes_debug;
+
+int kubernetes_parse(CfgLexer *lexer, LogParser **instance, gpointer arg);
+
+static CfgLexerKeyword kubernetes_keywords[] =
+{
+  { "kubernetes_metadata", KW_KUBERNETES_METADATA },
+  { "api_server",       KW_API_SERVER },
+  { "token_file",       KW_TOKEN_FILE },
+  { "ca_file",          KW_CA_FILE },
+  { "node_name",        KW_NODE_NAME },
+  { "peer_verify",      KW_PEER_VERIFY },
+  { "prefix",           KW_PREFIX },
+  { "key_delimiter",    KW_KEY_DELIMITER },
+  { NULL }
+};
+
+CfgParser kubernetes_parser =
+{
+#if SYSLOG_NG_ENABLE_DEBUG
+  .debug_flag = &kubernetes_debug,
+#endif
+  .name = "kubernetes",
+  .keywords = kubernetes_keywords,
+  .parse = (gint (*)(CfgLexer *, gpointer *, gpointer)) kubernetes_parse,
+  .cleanup = (void (*)(gpointer)) log_pipe_unref,
+};
+
+CFG_PARSER_IMPLEMENT_LEXER_BINDING(kubernetes_, KUBERNETES_, LogParser **)
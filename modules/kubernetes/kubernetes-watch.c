@@ -0,0 +1,458 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "kubernetes-watch.h"
+#include "messages.h"
+#include "compat/curl.h"
+
+#include <string.h>
+
+#define KUBERNETES_SERVICE_ACCOUNT_DIR "/var/run/secrets/kubernetes.io/serviceaccount"
+#define KUBERNETES_WATCH_TIMEOUT 300
+#define KUBERNETES_MAX_BACKOFF 60
+#define KUBERNETES_MAX_LIST_SIZE (64 * 1024 * 1024)
+
+struct _KubernetesWatch
+{
+  gint ref_cnt;
+  gint users;
+  KubernetesWatchOptions options;
+  KubernetesMetadataCache *cache;
+
+  GThread *thread;
+  GMutex lock;
+  GCond cond;
+  gboolean stopping;
+
+  gchar *api_server;
+  gchar *resource_version;
+  GString *buffer;
+  glong status;
+};
+
+typedef gboolean (*KubernetesResponseHandler)(KubernetesWatch *self);
+
+static gboolean
+_is_stopping(KubernetesWatch *self)
+{
+  g_mutex_lock(&self->lock);
+  gboolean stopping = self->stopping;
+  g_mutex_unlock(&self->lock);
+
+  return stopping;
+}
+
+static gboolean
+_wait_before_retry(KubernetesWatch *self, gint *backoff)
+{
+  gint64 end_time = g_get_monotonic_time() + *backoff * G_TIME_SPAN_SECOND;
+
+  g_mutex_lock(&self->lock);
+  while (!self->stopping && g_cond_wait_until(&self->cond, &self->lock, end_time))
+    ;
+  gboolean stopping = self->stopping;
+  g_mutex_unlock(&self->lock);
+
+  *backoff = MIN(*backoff * 2, KUBERNETES_MAX_BACKOFF);
+  return !stopping;
+}
+
+static void
+_set_resource_version(KubernetesWatch *self, struct json_object *object)
+{
+  struct json_object *metadata, *resource_version;
+
+  if (!json_object_object_get_ex(object, "metadata", &metadata) ||
+      !json_object_object_get_ex(metadata, "resourceVersion", &resource_version) ||
+      !json_object_is_type(resource_version, json_type_string))
+    return;
+
+  g_free(self->resource_version);
+  self->resource_version = g_strdup(json_object_get_string(resource_version));
+}
+
+/* returns FALSE if the stream has to be restarted with a new LIST */
+static gboolean
+_process_watch_event(KubernetesWatch *self, const gchar *line, gsize length)
+{
+  struct json_object *event = json_tokener_parse(line);
+  struct json_object *type, *object;
+  gboolean result = TRUE;
+
+  if (!event ||
+      !json_object_object_get_ex(event, "type", &type) ||
+      !json_object_object_get_ex(event, "object", &object))
+    {
+      msg_warning("kubernetes-metadata(): invalid watch event, restarting from a new list",
+                  evt_tag_mem("event", line, length));
+      result = FALSE;
+      goto exit;
+    }
+
+  const gchar *event_type = json_object_get_string(type);
+  if (strcmp(event_type, "ERROR") == 0)
+    {
+      /* typically 410 Gone, the resource version is too old to resume from */
+      msg_debug("kubernetes-metadata(): watch expired, restarting from a new list",
+                evt_tag_mem("event", line, length));
+      result = FALSE;
+      goto exit;
+    }
+
+  if (strcmp(event_type, "BOOKMARK") != 0)
+    kubernetes_metadata_cache_apply_event(self->cache, event_type, object);
+  _set_resource_version(self, object);
+
+exit:
+  if (event)
+    json_object_put(event);
+  if (!result)
+    {
+      g_free(self->resource_version);
+      self->resource_version = NULL;
+    }
+  return result;
+}
+
+static gboolean
+_process_watch_lines(KubernetesWatch *self)
+{
+  gchar *line = self->buffer->str;
+  gchar *eol;
+
+  while ((eol = memchr(line, '\n', self->buffer->len - (line - self->buffer->str))))
+    {
+      *eol = 0;
+      if (eol > line && !_process_watch_event(self, line, eol - line))
+        return FALSE;
+      line = eol + 1;
+    }
+
+  g_string_erase(self->buffer, 0, line - self->buffer->str);
+  return TRUE;
+}
+
+static size_t
+_curl_write_function(gchar *ptr, size_t size, size_t nmemb, gpointer userdata)
+{
+  CURL *curl = (CURL *) userdata;
+  KubernetesWatch *self;
+  gsize count = size * nmemb;
+
+  curl_easy_getinfo(curl, CURLINFO_PRIVATE, (gchar **) &self);
+  if (self->status == 0)
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &self->status);
+
+  if (self->buffer->len + count > KUBERNETES_MAX_LIST_SIZE)
+    return 0;
+
+  g_string_append_len(self->buffer, ptr, count);
+
+  /* watch responses are processed as they stream in */
+  if (self->status == 200 && self->resource_version && !_process_watch_lines(self))
+    return 0;
+
+  return count;
+}
+
+static int
+_curl_xferinfo_function(gpointer userdata, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
+                        curl_off_t ulnow)
+{
+  return _is_stopping((KubernetesWatch *) userdata);
+}
+
+static struct curl_slist *
+_format_headers(KubernetesWatch *self)
+{
+  struct curl_slist *headers = curl_slist_append(NULL, "Accept: application/json");
+  gchar *token = NULL;
+
+  if (self->options.token_file && g_file_get_contents(self->options.token_file, &token, NULL, NULL))
+    {
+      gchar *authorization = g_strdup_printf("Authorization: Bearer %s", g_strstrip(token));
+      headers = curl_slist_append(headers, authorization);
+      g_free(authorization);
+      g_free(token);
+    }
+  return headers;
+}
+
+static gchar *
+_format_url(KubernetesWatch *self)
+{
+  GString *url = g_string_new(self->api_server);
+
+  g_string_append(url, "/api/v1/pods?");
+  if (self->options.node_name)
+    {
+      gchar *selector = g_uri_escape_string(self->options.node_name, NULL, FALSE);
+      g_string_append_printf(url, "fieldSelector=spec.nodeName%%3D%s&", selector);
+      g_free(selector);
+    }
+
+  if (self->resource_version)
+    {
+      gchar *resource_version = g_uri_escape_string(self->resource_version, NULL, FALSE);
+      g_string_append_printf(url, "watch=1&allowWatchBookmarks=true&timeoutSeconds=%d&resourceVersion=%s",
+                             KUBERNETES_WATCH_TIMEOUT, resource_version);
+      g_free(resource_version);
+    }
+  else
+    {
+      g_string_truncate(url, url->len - 1);
+    }
+
+  return g_string_free(url, FALSE);
+}
+
+/* a LIST request without a resource version, a WATCH request otherwise */
+static gboolean
+_perform(KubernetesWatch *self)
+{
+  gboolean watching = self->resource_version != NULL;
+  gchar *url = _format_url(self);
+  struct curl_slist *headers = _format_headers(self);
+  gboolean result = FALSE;
+
+  g_string_truncate(self->buffer, 0);
+  self->status = 0;
+
+  CURL *curl = curl_easy_init();
+  if (!curl)
+    goto exit;
+
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  curl_easy_setopt(curl, CURLOPT_PRIVATE, self);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _curl_write_function);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, curl);
+  curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+  curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, _curl_xferinfo_function);
+  curl_easy_setopt(curl, CURLOPT_XFERINFODATA, self);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 30L);
+  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, self->options.peer_verify ? 1L : 0L);
+  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, self->options.peer_verify ? 2L : 0L);
+  if (self->options.ca_file)
+    curl_easy_setopt(curl, CURLOPT_CAINFO, self->options.ca_file);
+
+  CURLcode ret = curl_easy_perform(curl);
+
+  /* the write callback aborted the watch to restart from a new list */
+  if (watching && !self->resource_version)
+    {
+      result = TRUE;
+      goto exit;
+    }
+
+  if (ret != CURLE_OK)
+    {
+      if (ret != CURLE_ABORTED_BY_CALLBACK)
+        msg_error("kubernetes-metadata(): error querying the Kubernetes API",
+                  evt_tag_str("url", url),
+                  evt_tag_str("error", curl_easy_strerror(ret)));
+      goto exit;
+    }
+
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &self->status);
+  if (self->status != 200)
+    {
+      msg_error("kubernetes-metadata(): unexpected response from the Kubernetes API",
+                evt_tag_str("url", url),
+                evt_tag_long("status", self->status),
+                evt_tag_mem("response", self->buffer->str, MIN(self->buffer->len, 1024)));
+      g_free(self->resource_version);
+      self->resource_version = NULL;
+      goto exit;
+    }
+
+  if (watching)
+    {
+      result = TRUE;
+      goto exit;
+    }
+
+  struct json_object *pod_list = json_tokener_parse(self->buffer->str);
+  if (!pod_list)
+    {
+      msg_error("kubernetes-metadata(): invalid pod list received from the Kubernetes API",
+                evt_tag_str("url", url));
+      goto exit;
+    }
+
+  kubernetes_metadata_cache_replace(self->cache, pod_list);
+  _set_resource_version(self, pod_list);
+  json_object_put(pod_list);
+
+  msg_debug("kubernetes-metadata(): pod list received",
+            evt_tag_str("url", url),
+            evt_tag_long("pods", kubernetes_metadata_cache_get_size(self->cache)),
+            evt_tag_str("resource_version", self->resource_version));
+  result = TRUE;
+
+exit:
+  if (curl)
+    curl_easy_cleanup(curl);
+  curl_slist_free_all(headers);
+  g_free(url);
+  return result;
+}
+
+static gpointer
+_watch_thread(gpointer s)
+{
+  KubernetesWatch *self = (KubernetesWatch *) s;
+  gint backoff = 1;
+
+  while (!_is_stopping(self))
+    {
+      if (_perform(self))
+        backoff = 1;
+      else if (!_wait_before_retry(self, &backoff))
+        break;
+    }
+
+  return NULL;
+}
+
+static gchar *
+_detect_api_server(void)
+{
+  const gchar *host = g_getenv("KUBERNETES_SERVICE_HOST");
+  const gchar *port = g_getenv("KUBERNETES_SERVICE_PORT");
+
+  if (!host || !port)
+    return NULL;
+
+  if (strchr(host, ':'))
+    return g_strdup_printf("https://[%s]:%s", host, port);
+  return g_strdup_printf("https://%s:%s", host, port);
+}
+
+gboolean
+kubernetes_watch_start(KubernetesWatch *self)
+{
+  if (self->users++ > 0)
+    return TRUE;
+
+  g_free(self->api_server);
+  self->api_server = self->options.api_server ? g_strdup(self->options.api_server) : _detect_api_server();
+  if (!self->api_server)
+    {
+      msg_error("kubernetes-metadata(): api-server() is not set and not running in a Kubernetes cluster");
+      self->users--;
+      return FALSE;
+    }
+  while (g_str_has_suffix(self->api_server, "/"))
+    self->api_server[strlen(self->api_server) - 1] = 0;
+
+  if (!self->options.node_name && g_getenv("NODE_NAME"))
+    self->options.node_name = g_strdup(g_getenv("NODE_NAME"));
+
+  self->cache = kubernetes_metadata_cache_new(self->options.prefix, self->options.key_delimiter);
+  self->stopping = FALSE;
+  self->thread = g_thread_new("k8s-watch", _watch_thread, self);
+  return TRUE;
+}
+
+void
+kubernetes_watch_stop(KubernetesWatch *self)
+{
+  if (--self->users > 0)
+    return;
+
+  g_mutex_lock(&self->lock);
+  self->stopping = TRUE;
+  g_cond_broadcast(&self->cond);
+  g_mutex_unlock(&self->lock);
+
+  g_thread_join(self->thread);
+  self->thread = NULL;
+
+  kubernetes_metadata_cache_free(self->cache);
+  self->cache = NULL;
+  g_free(self->resource_version);
+  self->resource_version = NULL;
+}
+
+KubernetesWatchOptions *
+kubernetes_watch_get_options(KubernetesWatch *self)
+{
+  return &self->options;
+}
+
+KubernetesMetadataCache *
+kubernetes_watch_get_cache(KubernetesWatch *self)
+{
+  return self->cache;
+}
+
+KubernetesWatch *
+kubernetes_watch_new(void)
+{
+  KubernetesWatch *self = g_new0(KubernetesWatch, 1);
+
+  self->ref_cnt = 1;
+  g_mutex_init(&self->lock);
+  g_cond_init(&self->cond);
+  self->buffer = g_string_sized_new(65536);
+
+  self->options.token_file = g_strdup(KUBERNETES_SERVICE_ACCOUNT_DIR "/token");
+  if (g_file_test(KUBERNETES_SERVICE_ACCOUNT_DIR "/ca.crt", G_FILE_TEST_EXISTS))
+    self->options.ca_file = g_strdup(KUBERNETES_SERVICE_ACCOUNT_DIR "/ca.crt");
+  self->options.peer_verify = TRUE;
+  self->options.prefix = g_strdup(".k8s.");
+  self->options.key_delimiter = g_strdup(".");
+
+  curl_global_init(CURL_GLOBAL_ALL);
+  return self;
+}
+
+KubernetesWatch *
+kubernetes_watch_ref(KubernetesWatch *self)
+{
+  self->ref_cnt++;
+  return self;
+}
+
+void
+kubernetes_watch_unref(KubernetesWatch *self)
+{
+  if (--self->ref_cnt > 0)
+    return;
+
+  g_assert(self->users == 0);
+
+  g_free(self->options.api_server);
+  g_free(self->options.token_file);
+  g_free(self->options.ca_file);
+  g_free(self->options.node_name);
+  g_free(self->options.prefix);
+  g_free(self->options.key_delimiter);
+  g_free(self->api_server);
+  g_string_free(self->buffer, TRUE);
+  g_mutex_clear(&self->lock);
+  g_cond_clear(&self->cond);
+  curl_global_cleanup();
+  g_free(self);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#ifndef KUBERNETES_WATCH_H_INCLUDED
+#define KUBERNETES_WATCH_H_INCLUDED
+
+#include "syslog-ng.h"
+#include "kubernetes-metadata-cache.h"
+
+typedef struct _KubernetesWatchOptions
+{
+  gchar *api_server;
+  gchar *token_file;
+  gchar *ca_file;
+  gchar *node_name;
+  gboolean peer_verify;
+  gchar *prefix;
+  gchar *key_delimiter;
+} KubernetesWatchOptions;
+
+/*
+ * Keeps a KubernetesMetadataCache up-to-date with a LIST+WATCH stream of
+ * the pods, running on a background thread.  A single instance is shared
+ * by the clones of a parser, the thread runs while any of them is
+ * initialized.
+ */
+typedef struct _KubernetesWatch KubernetesWatch;
+
+KubernetesWatch *kubernetes_watch_new(void);
+KubernetesWatch *kubernetes_watch_ref(KubernetesWatch *self);
+void kubernetes_watch_unref(KubernetesWatch *self);
+
+KubernetesWatchOptions *kubernetes_watch_get_options(KubernetesWatch *self);
+KubernetesMetadataCache *kubernetes_watch_get_cache(KubernetesWatch *self);
+
+gboolean kubernetes_watch_start(KubernetesWatch *self);
+void kubernetes_watch_stop(KubernetesWatch *self);
+
+#endif
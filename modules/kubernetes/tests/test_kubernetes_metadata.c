@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+#include "libtest/msg_parse_lib.h"
+
+#include "kubernetes-metadata-cache.h"
+#include "kubernetes-metadata-parser.h"
+#include "kubernetes-watch.h"
+#include "apphook.h"
+#include "cfg.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <string.h>
+
+#define POD_A \
+  "{\"metadata\":{\"name\":\"pod-a\",\"namespace\":\"default\",\"uid\":\"uid-a\",\"resourceVersion\":\"100\"," \
+  "\"labels\":{\"app\":\"nginx\"},\"annotations\":{\"team\":\"web\"}}," \
+  "\"status\":{\"containerStatuses\":[" \
+  "{\"name\":\"nginx\",\"image\":\"nginx:1.25\",\"imageID\":\"docker-pullable://nginx@sha256:1234\"," \
+  "\"containerID\":\"containerd://abcdef\"}," \
+  "{\"name\":\"sidecar\",\"image\":\"envoy:1.30\",\"imageID\":\"envoy@sha256:5678\"," \
+  "\"containerID\":\"docker://123456\"}]}}"
+
+#define POD_B \
+  "{\"metadata\":{\"name\":\"pod-b\",\"namespace\":\"kube-system\",\"uid\":\"uid-b\",\"resourceVersion\":\"101\"," \
+  "\"labels\":{\"app\":\"dns\"}}}"
+
+#define POD_LIST "{\"kind\":\"PodList\",\"metadata\":{\"resourceVersion\":\"100\"},\"items\":[" POD_A "]}"
+
+static struct json_object *
+_parse_json(const gchar *json)
+{
+  struct json_object *object = json_tokener_parse(json);
+
+  cr_assert(object, "invalid json in test: %s", json);
+  return object;
+}
+
+static const gchar *
+_lookup_value(GArray *values, const gchar *name)
+{
+  NVHandle handle = log_msg_get_value_handle(name);
+
+  for (guint i = 0; i < values->len; i++)
+    {
+      KubernetesValue *kv = &g_array_index(values, KubernetesValue, i);
+      if (kv->handle == handle)
+        return kv->value;
+    }
+  return NULL;
+}
+
+static KubernetesMetadataCache *
+_new_populated_cache(void)
+{
+  KubernetesMetadataCache *cache = kubernetes_metadata_cache_new(".k8s.", ".");
+  struct json_object *pod_list = _parse_json(POD_LIST);
+
+  kubernetes_metadata_cache_replace(cache, pod_list);
+  json_object_put(pod_list);
+  return cache;
+}
+
+static void
+_apply_event(KubernetesMetadataCache *cache, const gchar *type, const gchar *json)
+{
+  struct json_object *pod = _parse_json(json);
+
+  cr_assert(kubernetes_metadata_cache_apply_event(cache, type, pod));
+  json_object_put(pod);
+}
+
+Test(kubernetes_metadata_cache, pods_are_looked_up_by_namespace_and_name)
+{
+  KubernetesMetadataCache *cache = _new_populated_cache();
+
+  cr_assert_eq(kubernetes_metadata_cache_get_size(cache), 1);
+  cr_assert_null(kubernetes_metadata_cache_lookup(cache, "kube-system", -1, "pod-a", -1));
+
+  KubernetesPod *pod = kubernetes_metadata_cache_lookup(cache, "default", -1, "pod-a-and-more", 5);
+  cr_assert(pod);
+  cr_assert_str_eq(_lookup_value(pod->values, ".k8s.pod_uuid"), "uid-a");
+  cr_assert_str_eq(_lookup_value(pod->values, ".k8s.labels.app"), "nginx");
+  cr_assert_str_eq(_lookup_value(pod->values, ".k8s.annotations.team"), "web");
+
+  const KubernetesContainer *container = kubernetes_pod_lookup_container(pod, "sidecar", -1);
+  cr_assert_str_eq(_lookup_value(container->values, ".k8s.container_image"), "envoy:1.30");
+  cr_assert_str_eq(_lookup_value(container->values, ".k8s.container_hash"), "envoy@sha256:5678");
+  cr_assert_str_eq(_lookup_value(container->values, ".k8s.docker_id"), "123456");
+
+  container = kubernetes_pod_lookup_container(pod, "unknown", -1);
+  cr_assert_str_eq(container->name, "nginx");
+  cr_assert_str_eq(_lookup_value(container->values, ".k8s.container_hash"), "nginx@sha256:1234");
+  cr_assert_str_eq(_lookup_value(container->values, ".k8s.docker_id"), "abcdef");
+
+  kubernetes_pod_unref(pod);
+  kubernetes_metadata_cache_free(cache);
+}
+
+Test(kubernetes_metadata_cache, watch_events_update_and_evict_pods)
+{
+  KubernetesMetadataCache *cache = _new_populated_cache();
+  KubernetesPod *old_pod = kubernetes_metadata_cache_lookup(cache, "default", -1, "pod-a", -1);
+
+  _apply_event(cache, "ADDED", POD_B);
+  _apply_event(cache, "MODIFIED",
+               "{\"metadata\":{\"name\":\"pod-a\",\"namespace\":\"default\",\"labels\":{\"app\":\"apache\"}}}");
+
+  cr_assert_eq(kubernetes_metadata_cache_get_size(cache), 2);
+
+  KubernetesPod *pod = kubernetes_metadata_cache_lookup(cache, "default", -1, "pod-a", -1);
+  cr_assert_str_eq(_lookup_value(pod->values, ".k8s.labels.app"), "apache");
+  kubernetes_pod_unref(pod);
+
+  /* readers holding the previous version are not affected */
+  cr_assert_str_eq(_lookup_value(old_pod->values, ".k8s.labels.app"), "nginx");
+  kubernetes_pod_unref(old_pod);
+
+  _apply_event(cache, "DELETED", POD_A);
+  cr_assert_eq(kubernetes_metadata_cache_get_size(cache), 1);
+  cr_assert_null(kubernetes_metadata_cache_lookup(cache, "default", -1, "pod-a", -1));
+
+  struct json_object *invalid = _parse_json("{\"metadata\":{\"name\":\"no-namespace\"}}");
+  cr_assert_not(kubernetes_metadata_cache_apply_event(cache, "ADDED", invalid));
+  json_object_put(invalid);
+
+  kubernetes_metadata_cache_free(cache);
+}
+
+static gint lookups_stopping;
+
+static gpointer
+_lookup_continuously(gpointer user_data)
+{
+  KubernetesMetadataCache *cache = (KubernetesMetadataCache *) user_data;
+
+  while (!g_atomic_int_get(&lookups_stopping))
+    {
+      KubernetesPod *pod = kubernetes_metadata_cache_lookup(cache, "default", -1, "pod-a", -1);
+
+      cr_assert(pod);
+      cr_assert(_lookup_value(pod->values, ".k8s.labels.app"));
+      kubernetes_pod_unref(pod);
+    }
+  return NULL;
+}
+
+Test(kubernetes_metadata_cache, snapshots_are_not_freed_under_concurrent_readers)
+{
+  KubernetesMetadataCache *cache = _new_populated_cache();
+  GThread *readers[4];
+
+  g_atomic_int_set(&lookups_stopping, FALSE);
+  for (gint i = 0; i < G_N_ELEMENTS(readers); i++)
+    readers[i] = g_thread_new("lookup", _lookup_continuously, cache);
+
+  /* every event publishes a new snapshot and drops the previous one */
+  for (gint i = 0; i < 2000; i++)
+    _apply_event(cache, "MODIFIED", i % 2 ? POD_A :
+                 "{\"metadata\":{\"name\":\"pod-a\",\"namespace\":\"default\",\"labels\":{\"app\":\"apache\"}}}");
+
+  g_atomic_int_set(&lookups_stopping, TRUE);
+  for (gint i = 0; i < G_N_ELEMENTS(readers); i++)
+    g_thread_join(readers[i]);
+
+  cr_assert_eq(kubernetes_metadata_cache_get_size(cache), 1);
+  kubernetes_metadata_cache_free(cache);
+}
+
+/*
+ * A fake API server, serving a pod list and a watch stream that stays open
+ * after the events are sent, like the real one does.
+ */
+
+static gint server_fd;
+static gint server_port;
+static GThread *server_thread;
+static volatile gboolean server_stopping;
+
+static void
+_send_all(gint fd, const gchar *data)
+{
+  gsize length = strlen(data);
+
+  while (length > 0)
+    {
+      gssize sent = send(fd, data, length, MSG_NOSIGNAL);
+      if (sent <= 0)
+        return;
+      data += sent;
+      length -= sent;
+    }
+}
+
+static void
+_serve_connection(gint fd, gint *watch_count)
+{
+  GString *request = g_string_new("");
+  gchar buffer[4096];
+
+  while (!strstr(request->str, "\r\n\r\n"))
+    {
+      gssize received = recv(fd, buffer, sizeof(buffer), 0);
+      if (received <= 0)
+        goto exit;
+      g_string_append_len(request, buffer, received);
+    }
+
+  cr_assert(strstr(request->str, "GET /api/v1/pods?fieldSelector=spec.nodeName%3Dnode-1"));
+
+  if (!strstr(request->str, "watch=1"))
+    {
+      gchar *response = g_strdup_printf("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                                        "Content-Length: %d\r\nConnection: close\r\n\r\n%s",
+                                        (gint) strlen(POD_LIST), POD_LIST);
+      _send_all(fd, response);
+      g_free(response);
+      goto exit;
+    }
+
+  cr_assert(strstr(request->str, "resourceVersion=100") || *watch_count > 0);
+  _send_all(fd, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n");
+  if ((*watch_count)++ == 0)
+    {
+      _send_all(fd, "{\"type\":\"ADDED\",\"object\":" POD_B "}\n");
+      _send_all(fd, "{\"type\":\"DELETED\",\"object\":" POD_A "}\n");
+    }
+
+  while (!server_stopping)
+    g_usleep(10000);
+
+exit:
+  g_string_free(request, TRUE);
+  close(fd);
+}
+
+static gpointer
+_fake_api_server(gpointer user_data)
+{
+  gint watch_count = 0;
+
+  while (!server_stopping)
+    {
+      struct pollfd pfd = { .fd = server_fd, .events = POLLIN };
+
+      if (poll(&pfd, 1, 10) <= 0)
+        continue;
+
+      gint fd = accept(server_fd, NULL, NULL);
+      if (fd >= 0)
+        _serve_connection(fd, &watch_count);
+    }
+  return NULL;
+}
+
+static void
+_start_fake_api_server(void)
+{
+  struct sockaddr_in addr = { .sin_family = AF_INET };
+  socklen_t addr_len = sizeof(addr);
+
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  server_fd = socket(AF_INET, SOCK_STREAM, 0);
+  cr_assert(server_fd >= 0);
+  cr_assert(bind(server_fd, (struct sockaddr *) &addr, sizeof(addr)) == 0);
+  cr_assert(listen(server_fd, 16) == 0);
+  cr_assert(getsockname(server_fd, (struct sockaddr *) &addr, &addr_len) == 0);
+  server_port = ntohs(addr.sin_port);
+
+  server_stopping = FALSE;
+  server_thread = g_thread_new("fake-api-server", _fake_api_server, NULL);
+}
+
+static void
+_stop_fake_api_server(void)
+{
+  server_stopping = TRUE;
+  g_thread_join(server_thread);
+  close(server_fd);
+}
+
+static LogParser *
+_new_parser(void)
+{
+  LogParser *parser = kubernetes_metadata_parser_new(configuration);
+  gchar *api_server = g_strdup_printf("http://127.0.0.1:%d", server_port);
+
+  kubernetes_metadata_parser_set_api_server(parser, api_server);
+  kubernetes_metadata_parser_set_token_file(parser, NULL);
+  kubernetes_metadata_parser_set_node_name(parser, "node-1");
+  g_free(api_server);
+  return parser;
+}
+
+static LogMessage *
+_process(LogParser *parser, const gchar *namespace_name, const gchar *pod_name, const gchar *container_name)
+{
+  LogMessage *msg = log_msg_new_empty();
+  LogPathOptions path_options = LOG_PATH_OPTIONS_INIT;
+
+  log_msg_set_value_by_name(msg, ".k8s.namespace_name", namespace_name, -1);
+  log_msg_set_value_by_name(msg, ".k8s.pod_name", pod_name, -1);
+  log_msg_set_value_by_name(msg, ".k8s.container_name", container_name, -1);
+  log_msg_set_value_by_name(msg, ".k8s.labels.app", "preset", -1);
+
+  cr_assert(log_parser_process_message(parser, &msg, &path_options));
+  return msg;
+}
+
+static LogMessage *
+_wait_for_pod(LogParser *parser, const gchar *namespace_name, const gchar *pod_name, const gchar *container_name,
+              gboolean present)
+{
+  NVHandle pod_uuid = log_msg_get_value_handle(".k8s.pod_uuid");
+  LogMessage *msg = NULL;
+
+  for (gint i = 0; i < 500; i++)
+    {
+      if (msg)
+        log_msg_unref(msg);
+      msg = _process(parser, namespace_name, pod_name, container_name);
+      if (log_msg_is_value_set(msg, pod_uuid) == present)
+        break;
+      g_usleep(10000);
+    }
+  return msg;
+}
+
+Test(kubernetes_metadata_parser, messages_are_enriched_from_the_watched_pods)
+{
+  LogParser *parser = _new_parser();
+  LogPipe *cloned = log_pipe_clone(&parser->super);
+
+  cr_assert(log_pipe_init(&parser->super));
+  cr_assert(log_pipe_init(cloned));
+
+  /* the pod list contains pod-a, the watch adds pod-b and then deletes pod-a */
+  LogMessage *msg = _wait_for_pod((LogParser *) cloned, "kube-system", "pod-b", "dns", TRUE);
+  assert_log_message_value_by_name(msg, ".k8s.pod_uuid", "uid-b");
+  assert_log_message_value_by_name(msg, ".k8s.labels.app", "preset");
+  log_msg_unref(msg);
+
+  msg = _wait_for_pod(parser, "default", "pod-a", "nginx", FALSE);
+  assert_log_message_value_unset_by_name(msg, ".k8s.pod_uuid");
+  log_msg_unref(msg);
+
+  log_pipe_deinit(cloned);
+  log_pipe_deinit(&parser->super);
+  log_pipe_unref(cloned);
+  log_pipe_unref(&parser->super);
+}
+
+static void
+setup(void)
+{
+  configuration = cfg_new_snippet();
+  app_startup();
+  _start_fake_api_server();
+}
+
+static void
+teardown(void)
+{
+  _stop_fake_api_server();
+  app_shutdown();
+  cfg_free(configuration);
+}
+
+TestSuite(kubernetes_metadata_parser, .init = setup, .fini = teardown);
+TestSuite(kubernetes_metadata_cache, .init = app_startup, .fini = app_shutdown);
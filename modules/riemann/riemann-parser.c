@@ -44,6 +44,7 @@ static CfgLexerKeyword riemann_keywords[] =
   { "metric",                   KW_METRIC },
   { "ttl",                      KW_TTL },
   { "attributes",               KW_ATTRIBUTES },
+  { "pipeline_depth",           KW_PIPELINE_DEPTH },
 
   { "ca_file",                  KW_CA_FILE },
   { "cert_file",                KW_CERT_FILE },
@@ -53,6 +53,13 @@ _set_timeout_on_connection(RiemannDestWorker *self)
     }
 }
 
+static void
+_forget_in_flight_batches(RiemannDestWorker *self)
+{
+  g_queue_clear(self->in_flight.batches);
+  self->in_flight.messages = 0;
+}
+
 static gboolean
 riemann_dd_connect(LogThreadedDestWorker *s)
 {
@@ -88,6 +95,10 @@ riemann_dd_disconnect(LogThreadedDestWorker *s)
   riemann_client_disconnect(self->client);
   riemann_client_free(self->client);
   self->client = NULL;
+
+  /* responses for in-flight messages are lost with the connection, the
+   * corresponding log messages are still in the backlog and get rewound */
+  _forget_in_flight_batches(self);
 }
 
 /*
@@ -327,40 +338,21 @@ riemann_worker_insert_one(RiemannDestWorker *self, LogMessage *msg)
   return success;
 }
 
-static LogThreadedResult
-riemann_worker_flush(LogThreadedDestWorker *s, LogThreadedFlushMode mode)
+static gboolean
+_check_response(RiemannDestWorker *self, riemann_message_t *r, gint batch_size)
 {
-  RiemannDestWorker *self = (RiemannDestWorker *) s;
   RiemannDestDriver *owner = (RiemannDestDriver *) self->super.owner;
-  riemann_message_t *message;
-  riemann_message_t *r;
 
-  if (self->event.n == 0)
-    return LTR_SUCCESS;
-
-  message = riemann_message_new();
-
-  riemann_message_set_events_n(message, self->event.n, self->event.list);
-  r = riemann_communicate(self->client, message);
-
-  /*
-   * riemann_client_send_message_oneshot() will free self->event.list,
-   * whether the send succeeds or fails. So we need to reallocate it,
-   * and save as many messages as possible.
-   */
-  self->event.n = 0;
-  self->event.list = (riemann_event_t **) malloc(sizeof (riemann_event_t *) *
-                                                 MAX(1, owner->super.batch_lines));
   if (!r)
     {
-      msg_error("riemann: error calling riemann_communicate()",
+      msg_error("riemann: error receiving response from Riemann server",
                 evt_tag_str("server", owner->server),
                 evt_tag_int("port", owner->port),
-                evt_tag_int("batch_size", self->event.n),
+                evt_tag_int("batch_size", batch_size),
                 evt_tag_str("errno", g_strerror(errno)),
                 evt_tag_str("driver", owner->super.super.super.id),
                 log_pipe_location_tag(&owner->super.super.super.super));
-      return LTR_ERROR;
+      return FALSE;
     }
 
   if ((r->error) || (r->has_ok && !r->ok))
@@ -368,27 +360,173 @@ riemann_worker_flush(LogThreadedDestWorker *s, LogThreadedFlushMode mode)
       msg_error("riemann: flushing messages to Riemann server failed",
                 evt_tag_str("server", owner->server),
                 evt_tag_int("port", owner->port),
-                evt_tag_int("batch_size", self->event.n),
+                evt_tag_int("batch_size", batch_size),
                 evt_tag_int("ok", r->ok),
                 evt_tag_str("error", r->error),
                 evt_tag_str("driver", owner->super.super.super.id),
                 log_pipe_location_tag(&owner->super.super.super.super));
       riemann_message_free(r);
-      return LTR_ERROR;
+      return FALSE;
     }
-  else
+
+  msg_debug("riemann: flushing messages to Riemann server successful",
+            evt_tag_str("server", owner->server),
+            evt_tag_int("port", owner->port),
+            evt_tag_int("batch_size", batch_size),
+            evt_tag_int("ok", r->ok),
+            evt_tag_str("error", r->error),
+            evt_tag_str("driver", owner->super.super.super.id),
+            log_pipe_location_tag(&owner->super.super.super.super));
+  riemann_message_free(r);
+  return TRUE;
+}
+
+static riemann_message_t *
+_take_events_as_message(RiemannDestWorker *self)
+{
+  RiemannDestDriver *owner = (RiemannDestDriver *) self->super.owner;
+  riemann_message_t *message = riemann_message_new();
+
+  /*
+   * riemann_message_set_events_n() takes over the ownership of
+   * self->event.list, which is freed together with the message, whether
+   * the send succeeds or fails. So we need to reallocate it, and save as
+   * many messages as possible.
+   */
+  riemann_message_set_events_n(message, self->event.n, self->event.list);
+  self->event.n = 0;
+  self->event.list = (riemann_event_t **) malloc(sizeof (riemann_event_t *) *
+                                                 MAX(1, owner->super.batch_lines));
+  return message;
+}
+
+static LogThreadedResult
+_flush_synchronously(RiemannDestWorker *self)
+{
+  gint batch_size = self->event.n;
+  riemann_message_t *r = riemann_communicate(self->client, _take_events_as_message(self));
+
+  if (!_check_response(self, r, batch_size))
+    return LTR_ERROR;
+
+  return LTR_SUCCESS;
+}
+
+static gboolean
+_send_batch(RiemannDestWorker *self)
+{
+  RiemannDestDriver *owner = (RiemannDestDriver *) self->super.owner;
+  gint batch_size = self->event.n;
+  riemann_message_t *message = _take_events_as_message(self);
+  gint rc = riemann_client_send_message(self->client, message);
+
+  riemann_message_free(message);
+  if (rc != 0)
     {
-      msg_debug("riemann: flushing messages to Riemann server successful",
+      msg_error("riemann: error sending message to Riemann server",
                 evt_tag_str("server", owner->server),
                 evt_tag_int("port", owner->port),
-                evt_tag_int("batch_size", self->event.n),
-                evt_tag_int("ok", r->ok),
-                evt_tag_str("error", r->error),
+                evt_tag_int("batch_size", batch_size),
+                evt_tag_int("in_flight", g_queue_get_length(self->in_flight.batches)),
+                evt_tag_str("error", g_strerror(-rc)),
                 evt_tag_str("driver", owner->super.super.super.id),
                 log_pipe_location_tag(&owner->super.super.super.super));
-      riemann_message_free(r);
-      return LTR_SUCCESS;
+      return FALSE;
+    }
+
+  /* messages dropped by riemann_worker_insert_one() are part of the
+   * batch_size of the worker, so they are acknowledged together with the
+   * events that were actually sent */
+  gint messages = self->super.batch_size - self->in_flight.messages;
+  g_queue_push_tail(self->in_flight.batches, GINT_TO_POINTER(messages));
+  self->in_flight.messages += messages;
+  return TRUE;
+}
+
+static gboolean
+_receive_oldest_response(RiemannDestWorker *self)
+{
+  gint messages = GPOINTER_TO_INT(g_queue_peek_head(self->in_flight.batches));
+  riemann_message_t *r = riemann_client_recv_message(self->client);
+
+  if (!_check_response(self, r, messages))
+    return FALSE;
+
+  g_queue_pop_head(self->in_flight.batches);
+  self->in_flight.messages -= messages;
+  log_threaded_dest_worker_ack_messages(&self->super, messages);
+  return TRUE;
+}
+
+/*
+ * Pipelined mode: Riemann responds to messages sent over a TCP/TLS
+ * connection in order, so we keep up to pipeline-depth() messages in
+ * flight and only wait for the oldest response once the pipeline is full.
+ * Log messages are acknowledged explicitly as their responses arrive.
+ */
+static LogThreadedResult
+_pipeline_send(RiemannDestWorker *self)
+{
+  RiemannDestDriver *owner = (RiemannDestDriver *) self->super.owner;
+
+  if (self->event.n > 0 && !_send_batch(self))
+    goto error;
+
+  while (g_queue_get_length(self->in_flight.batches) >= owner->pipeline_depth)
+    {
+      if (!_receive_oldest_response(self))
+        goto error;
     }
+
+  return LTR_EXPLICIT_ACK_MGMT;
+
+error:
+  /* everything that has not been acknowledged yet is still part of
+   * batch_size, the LTR_ERROR processing will rewind them all */
+  _forget_in_flight_batches(self);
+  return LTR_ERROR;
+}
+
+/* flush() is called whenever the queue runs empty or on reload, in which
+ * case we send what we have and wait for all in-flight responses */
+static LogThreadedResult
+_pipeline_drain(RiemannDestWorker *self)
+{
+  LogThreadedResult result = _pipeline_send(self);
+
+  if (result != LTR_EXPLICIT_ACK_MGMT)
+    return result;
+
+  while (!g_queue_is_empty(self->in_flight.batches))
+    {
+      if (!_receive_oldest_response(self))
+        {
+          _forget_in_flight_batches(self);
+          return LTR_ERROR;
+        }
+    }
+
+  /* whatever is left are messages that failed to convert after the last
+   * Riemann message was sent */
+  if (self->super.batch_size > 0)
+    log_threaded_dest_worker_drop_messages(&self->super, self->super.batch_size);
+
+  return LTR_EXPLICIT_ACK_MGMT;
+}
+
+static LogThreadedResult
+riemann_worker_flush(LogThreadedDestWorker *s, LogThreadedFlushMode mode)
+{
+  RiemannDestWorker *self = (RiemannDestWorker *) s;
+  RiemannDestDriver *owner = (RiemannDestDriver *) self->super.owner;
+
+  if (owner->pipeline_depth > 1)
+    return _pipeline_drain(self);
+
+  if (self->event.n == 0)
+    return LTR_SUCCESS;
+
+  return _flush_synchronously(self);
 }
 
 static LogThreadedResult
@@ -435,13 +573,32 @@ _insert_batch(RiemannDestWorker *self, LogMessage *msg)
   return LTR_QUEUED;
 }
 
+/* In pipelined mode the batches are cut here instead of relying on the
+ * batch_size of the worker, as that also counts the in-flight messages. */
+static LogThreadedResult
+_insert_pipelined(RiemannDestWorker *self, LogMessage *msg)
+{
+  RiemannDestDriver *owner = (RiemannDestDriver *) self->super.owner;
+
+  /* a message that fails to convert stays in batch_size and is acknowledged
+   * together with the Riemann message it would have been part of */
+  _insert_batch(self, msg);
+
+  if (self->event.n >= MAX(1, owner->super.batch_lines))
+    return _pipeline_send(self);
+
+  return LTR_EXPLICIT_ACK_MGMT;
+}
+
 static LogThreadedResult
 riemann_worker_insert(LogThreadedDestWorker *s, LogMessage *msg)
 {
   RiemannDestWorker *self = (RiemannDestWorker *) s;
   RiemannDestDriver *owner = (RiemannDestDriver *) self->super.owner;
 
-  if (owner->super.batch_lines <= 1)
+  if (owner->pipeline_depth > 1)
+    return _insert_pipelined(self, msg);
+  else if (owner->super.batch_lines <= 1)
     return _insert_single(self, msg);
   else
     return _insert_batch(self, msg);
@@ -453,6 +610,7 @@ riemann_dw_free(LogThreadedDestWorker *s)
   RiemannDestWorker *self = (RiemannDestWorker *) s;
 
   free(self->event.list);
+  g_queue_free(self->in_flight.batches);
   if (self->client)
     riemann_client_free(self->client);
   log_threaded_dest_worker_free_method(s);
@@ -463,8 +621,6 @@ riemann_dw_new(LogThreadedDestDriver *owner, gint worker_index)
 {
   RiemannDestWorker *self = g_new0(RiemannDestWorker, 1);
 
-  /* we don't support multiple workers */
-  g_assert(worker_index == 0);
   log_threaded_dest_worker_init_instance(&self->super, owner, worker_index);
 
   self->super.connect = riemann_dd_connect;
@@ -474,5 +630,6 @@ riemann_dw_new(LogThreadedDestDriver *owner, gint worker_index)
   self->super.flush = riemann_worker_flush;
   self->event.list = (riemann_event_t **) malloc(sizeof (riemann_event_t *) *
                                                  MAX(1, owner->batch_lines));
+  self->in_flight.batches = g_queue_new();
   return &self->super;
 }
@@ -37,6 +37,14 @@ typedef struct
     riemann_event_t **list;
     gint n;
   } event;
+
+  /* number of log messages belonging to each Riemann message that was
+   * sent but not yet acknowledged by the server, oldest first */
+  struct
+  {
+    GQueue *batches;
+    gint messages;
+  } in_flight;
 } RiemannDestWorker;
 
 LogThreadedDestWorker *riemann_dw_new(LogThreadedDestDriver *owner, gint worker_index);
@@ -166,6 +166,13 @@ riemann_dd_set_timeout(LogDriver *d, guint timeout)
   self->timeout = timeout;
 }
 
+void
+riemann_dd_set_pipeline_depth(LogDriver *d, gint pipeline_depth)
+{
+  RiemannDestDriver *self = (RiemannDestDriver *)d;
+  self->pipeline_depth = pipeline_depth;
+}
+
 void
 riemann_dd_set_tls_cacert(LogDriver *d, const gchar *path)
 {
@@ -287,10 +294,21 @@ riemann_dd_init(LogPipe *s)
 
   _value_pairs_always_exclude_properties(self);
 
+  if (self->type == RIEMANN_CLIENT_UDP && self->pipeline_depth > 1)
+    {
+      msg_warning("WARNING: riemann: pipeline-depth() has no effect with UDP transport, as Riemann does not send "
+                  "responses over UDP",
+                  evt_tag_int("pipeline_depth", self->pipeline_depth),
+                  evt_tag_str("driver", self->super.super.super.id),
+                  log_pipe_location_tag(&self->super.super.super.super));
+      self->pipeline_depth = 1;
+    }
 
   msg_verbose("Initializing Riemann destination",
               evt_tag_str("server", self->server),
               evt_tag_int("port", self->port),
+              evt_tag_int("pipeline_depth", self->pipeline_depth),
+              evt_tag_int("workers", self->super.num_workers),
               evt_tag_str("driver", self->super.super.super.id),
               log_pipe_location_tag(&self->super.super.super.super));
 
@@ -340,6 +358,7 @@ riemann_dd_new(GlobalConfig *cfg)
 
   self->port = -1;
   self->type = RIEMANN_CLIENT_TCP;
+  self->pipeline_depth = 1;
   self->super.batch_lines = 0; /* don't inherit global value */
 
   log_template_options_defaults(&self->template_options);
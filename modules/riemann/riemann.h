@@ -37,6 +37,7 @@ typedef struct
   gint port;
   riemann_client_type_t type;
   guint timeout;
+  gint pipeline_depth;
 
   struct
   {
@@ -83,6 +84,7 @@ void riemann_dd_set_tls_cacert(LogDriver *d, const gchar *path);
 void riemann_dd_set_tls_cert(LogDriver *d, const gchar *path);
 void riemann_dd_set_tls_key(LogDriver *d, const gchar *path);
 void riemann_dd_set_timeout(LogDriver *d, guint timeout);
+void riemann_dd_set_pipeline_depth(LogDriver *d, gint pipeline_depth);
 void riemann_dd_set_event_time_unit(LogDriver *d, gint unit);
 
 #endif
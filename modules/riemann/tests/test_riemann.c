@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include <criterion/criterion.h>
+
+#include "riemann.h"
+#include "apphook.h"
+#include "cfg.h"
+
+static LogDriver *
+_create_driver(const gchar *type, gint pipeline_depth)
+{
+  LogDriver *driver = riemann_dd_new(configuration);
+
+  cr_assert(riemann_dd_set_connection_type(driver, type));
+  if (pipeline_depth)
+    riemann_dd_set_pipeline_depth(driver, pipeline_depth);
+  return driver;
+}
+
+static void
+_destroy_driver(LogDriver *driver)
+{
+  log_pipe_deinit(&driver->super);
+  log_pipe_unref(&driver->super);
+}
+
+static void
+setup(void)
+{
+  app_startup();
+  configuration = cfg_new_snippet();
+}
+
+static void
+teardown(void)
+{
+  cfg_free(configuration);
+  app_shutdown();
+}
+
+TestSuite(riemann, .init = setup, .fini = teardown);
+
+Test(riemann, pipelining_is_disabled_by_default)
+{
+  LogDriver *driver = _create_driver("tcp", 0);
+
+  cr_assert(log_pipe_init(&driver->super));
+  cr_assert_eq(((RiemannDestDriver *) driver)->pipeline_depth, 1);
+
+  _destroy_driver(driver);
+}
+
+Test(riemann, pipeline_depth_is_kept_with_tcp)
+{
+  LogDriver *driver = _create_driver("tcp", 8);
+
+  cr_assert(log_pipe_init(&driver->super));
+  cr_assert_eq(((RiemannDestDriver *) driver)->pipeline_depth, 8);
+
+  _destroy_driver(driver);
+}
+
+Test(riemann, pipeline_depth_falls_back_to_one_with_udp)
+{
+  LogDriver *driver = _create_driver("udp", 8);
+
+  cr_assert(log_pipe_init(&driver->super));
+  cr_assert_eq(((RiemannDestDriver *) driver)->pipeline_depth, 1,
+               "Riemann does not respond over UDP, responses must not be waited for");
+
+  _destroy_driver(driver);
+}
@@ -518,6 +518,7 @@ fi
 %{_libdir}/syslog-ng/libxml.so
 %{_libdir}/syslog-ng/libpacctformat.so
 %{_libdir}/syslog-ng/libmetrics-probe.so
+%{_libdir}/syslog-ng/plugin-manifest
 
 %if %{with systemd}
 %{_unitdir}/syslog-ng.service
@@ -622,6 +623,7 @@ fi
 %files http
 %{_libdir}/syslog-ng/libhttp.so
 %{_libdir}/syslog-ng/libazure-auth-header.so
+%{_libdir}/syslog-ng/libkubernetes.so
 
 %files slog
 %{_libdir}/syslog-ng/libsecure-logging.so
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Axoflow
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * As an additional exemption you are allowed to compile & link against the
+ * OpenSSL libraries as published by the OpenSSL project. See the file
+ * COPYING for details.
+ *
+ */
+
+#include "profile.h"
+#include "syslog-ng.h"
+
+static gint profile_options_top = 20;
+static gchar *profile_options_sort = NULL;
+static gboolean profile_options_reset = FALSE;
+static gboolean profile_options_stacks = FALSE;
+
+GOptionEntry profile_options[] =
+{
+  {
+    "top", 'n', 0, G_OPTION_ARG_INT, &profile_options_top,
+    "number of config objects to print, 0 prints all of them (default: 20)", "<n>"
+  },
+  {
+    "sort", 's', 0, G_OPTION_ARG_STRING, &profile_options_sort,
+    "sort the report by this column (default: time)", "<time|invocations|dropped>"
+  },
+  {
+    "reset", 'r', 0, G_OPTION_ARG_NONE, &profile_options_reset,
+    "reset the profile counters, or the stack samples with --stacks", NULL
+  },
+  {
+    "stacks", 'S', 0, G_OPTION_ARG_NONE, &profile_options_stacks,
+    "print the stack samples as folded stacks for flame graph tools, enabled by stats(stack-sample-frequency())", NULL
+  },
+  { NULL }
+};
+
+gint
+slng_profile(int argc, char *argv[], const gchar *mode, GOptionContext *ctx)
+{
+  if (profile_options_stacks)
+    return dispatch_command(profile_options_reset ? "PROFILE_STACKS RESET" : "PROFILE_STACKS");
+
+  if (profile_options_reset)
+    return dispatch_command("PROFILE RESET");
+
+  GString *command = g_string_new("PROFILE");
+  g_string_append_printf(command, " TOP %d", profile_options_top);
+  if (profile_options_sort)
+    g_string_append_printf(command, " SORT %s", profile_options_sort);
+
+  gint ret = dispatch_command(command->str);
+
+  g_string_free(command, TRUE);
+  return ret;
+}
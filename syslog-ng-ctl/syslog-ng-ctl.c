@@ -37,6 +37,7 @@
 #include "commands/query.h"
 #include "commands/license.h"
 #include "commands/healthcheck.h"
+#include "commands/profile.h"
 #include "commands/attach.h"
 
 #include <stdio.h>
@@ -128,6 +129,7 @@ static CommandDescriptor modes[] =
   { "list-files", no_options, "Print files present in config", slng_listfiles, NULL },
   { "export-config-graph", no_options, "export configuration graph", slng_export_config_graph, NULL },
   { "healthcheck", healthcheck_options, "Health check", slng_healthcheck, NULL },
+  { "profile", profile_options, "Print the per config object profile, enabled by stats(profile-sample-rate())", slng_profile, NULL },
   { NULL, NULL },
 };
 
@@ -61,6 +61,8 @@
 
 static gboolean display_version = FALSE;
 static gboolean display_module_registry = FALSE;
+static gboolean update_module_manifest = FALSE;
+static gchar *generate_module_manifest = NULL;
 static gboolean dummy = FALSE;
 
 static MainLoopOptions main_loop_options;
@@ -74,6 +76,8 @@ static GOptionEntry syslogng_options[] =
   { "version",           'V',         0, G_OPTION_ARG_NONE, &display_version, "Display version number (" SYSLOG_NG_PACKAGE_NAME " " SYSLOG_NG_COMBINED_VERSION ")", NULL },
   { "module-path",         0,         0, G_OPTION_ARG_STRING, &resolved_configurable_paths.initial_module_path, "Set the list of colon separated directories to search for modules, default=" SYSLOG_NG_MODULE_PATH, "<path>" },
   { "module-registry",     0,         0, G_OPTION_ARG_NONE, &display_module_registry, "Display module information", NULL },
+  { "update-module-manifest", 0,      0, G_OPTION_ARG_NONE, &update_module_manifest, "Regenerate the module manifest in each module directory, used to avoid loading all modules during discovery", NULL },
+  { "generate-module-manifest", 0,    0, G_OPTION_ARG_STRING, &generate_module_manifest, "Write a single module manifest for all the module directories to the given file, used at build time", "<file>" },
   { "no-module-discovery", 0,         0, G_OPTION_ARG_NONE, &main_loop_options.disable_module_discovery, "Disable module auto-discovery, all modules need to be loaded explicitly by the configuration", NULL },
   { "seed",              'S',         0, G_OPTION_ARG_NONE, &dummy, "Does nothing, the need to seed the random generator is autodetected", NULL},
 #ifdef YYDEBUG
@@ -82,6 +86,7 @@ static GOptionEntry syslogng_options[] =
   { "cfgfile",           'f',         0, G_OPTION_ARG_STRING, &resolved_configurable_paths.cfgfilename, "Set config file name, default=" PATH_SYSLOG_NG_CONF, "<config>" },
   { "persist-file",      'R',         0, G_OPTION_ARG_STRING, &resolved_configurable_paths.persist_file, "Set the name of the persistent configuration file, default=" PATH_PERSIST_CONFIG, "<fname>" },
   { "preprocess-into",     0,         0, G_OPTION_ARG_STRING, &main_loop_options.preprocess_into, "Write the preprocessed configuration file to the file specified and quit", "output" },
+  { "config-cache",        0,         0, G_OPTION_ARG_STRING, &main_loop_options.config_cache, "Cache the preprocessed configuration in the file specified and reuse it while none of its source files change", "<fname>" },
   { "syntax-only",       's',         0, G_OPTION_ARG_NONE, &main_loop_options.syntax_only, "Only read and parse config file", NULL},
   { "check-startup",       0,         0, G_OPTION_ARG_NONE, &main_loop_options.check_startup, "Check if syslog-ng would start up and then exit", NULL},
   { "config-id",           0,         0, G_OPTION_ARG_NONE, &main_loop_options.config_id, "Parse config file, print configuration ID, and quit", NULL},
@@ -280,6 +285,17 @@ main(int argc, char *argv[])
       plugin_list_modules(stdout, TRUE);
       return 0;
     }
+  if (update_module_manifest)
+    {
+      interactive_mode();
+      return plugin_update_module_manifests(resolved_configurable_paths.initial_module_path) ? 0 : 1;
+    }
+  if (generate_module_manifest)
+    {
+      interactive_mode();
+      return plugin_generate_module_manifest(resolved_configurable_paths.initial_module_path,
+                                             generate_module_manifest) ? 0 : 1;
+    }
 
   setup_caps();
 